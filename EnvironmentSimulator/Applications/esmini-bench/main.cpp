@@ -0,0 +1,1187 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+/*
+ * This application runs a fixed set of headless workloads and reports throughput, peak memory and number of heap allocations.
+ *
+ * Workloads: OpenDRIVE load, XYZ2TrackPos projection, MoveAlongS, lane level routing, dense traffic (NaturalDriver) and swarm scenario stepping,
+ * batch stepping of many short episodes, OSI ground truth serialization (when built with OSI), .dat write and read and latency of world state
+ * publishing in shared memory compared to UDP.
+ *
+ * Results are written as JSON. If a baseline result file is given, each workload is compared to the baseline and the
+ * application returns non zero if any workload is slower, or allocates more, than baseline by more than given threshold.
+ *
+ * Example: esmini-bench --res_path ../resources --output bench.json --baseline bench_ref.json --threshold 0.15
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CommonMini.hpp"
+#include "RoadManager.hpp"
+#include "LaneIndependentRouter.hpp"
+#include "ScenarioBatch.hpp"
+#include "ScenarioEngine.hpp"
+#include "ScenarioGateway.hpp"
+#include "playerbase.hpp"
+#include "Replay.hpp"
+#include "SharedState.hpp"
+#include "UDP.hpp"
+#include "pugixml.hpp"
+
+#ifdef _USE_OSI
+#include "OSIReporter.hpp"
+#endif  // _USE_OSI
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#define BENCH_DEFAULT_OUTPUT    "bench.json"
+#define BENCH_DEFAULT_THRESHOLD 0.1
+#define BENCH_DAT_FILENAME      "bench_tmp.dat"
+#define BENCH_UDP_PORT          48197
+#define BENCH_UDP_DATA_SIZE     8192  // same fragment size as OSI over UDP
+#define BENCH_DT                0.05
+
+using namespace roadmanager;
+using namespace scenarioengine;
+
+// Count all heap allocations of the process, by replacing global operator new
+
+static std::atomic<unsigned long long> alloc_counter{0};
+
+void* operator new(std::size_t size)
+{
+    alloc_counter.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::malloc(size > 0 ? size : 1);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+    typedef struct
+    {
+        std::string        name;
+        std::string        unit;         // what is counted as one operation
+        unsigned long long ops;          // number of operations
+        unsigned int       entities;     // average number of entities, 0 if not applicable
+        double             time;         // total time (s)
+        unsigned long long allocations;  // number of heap allocations during the workload
+        long long          peak_rss_kb;  // peak resident memory during the workload, -1 if not available
+    } BenchResult;
+
+    typedef struct
+    {
+        std::string               res_path;
+        std::string               output;
+        std::string               baseline;
+        double                    threshold;
+        unsigned int              frames;
+        unsigned int              iterations;
+        std::string               filter;
+        std::vector<unsigned int> entities;
+    } BenchConfig;
+
+    // Reset peak memory counter where supported, so that the peak of each workload can be measured
+    void ResetPeakRSS()
+    {
+#ifdef __linux__
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        if (clear_refs.is_open())
+        {
+            clear_refs << "5";  // reset VmHWM
+        }
+#endif
+    }
+
+    long long GetPeakRSS()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return static_cast<long long>(counters.PeakWorkingSetSize / 1024);
+        }
+        return -1;
+#elif defined(__linux__)
+        std::ifstream status("/proc/self/status");
+        std::string   line;
+        while (std::getline(status, line))
+        {
+            if (line.compare(0, 6, "VmHWM:") == 0)
+            {
+                return std::atoll(line.c_str() + 6);
+            }
+        }
+        return -1;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+#ifdef __APPLE__
+            return static_cast<long long>(usage.ru_maxrss / 1024);  // bytes
+#else
+            return static_cast<long long>(usage.ru_maxrss);  // kilobytes
+#endif
+        }
+        return -1;
+#endif
+    }
+
+    // Measure time and allocations between construction and Stop(), excluding any paused sections. Peak memory covers all.
+    class Measurement
+    {
+    public:
+        Measurement(const std::string& name, const std::string& unit, bool paused = false) : name_(name), unit_(unit)
+        {
+            ResetPeakRSS();
+            if (!paused)
+            {
+                Resume();
+            }
+        }
+
+        void Resume()
+        {
+            allocations_start_ = alloc_counter.load();
+            start_             = std::chrono::steady_clock::now();
+            running_           = true;
+        }
+
+        void Pause()
+        {
+            if (running_)
+            {
+                time_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+                allocations_ += alloc_counter.load() - allocations_start_;
+                running_ = false;
+            }
+        }
+
+        BenchResult Stop(unsigned long long ops, unsigned int entities = 0)
+        {
+            Pause();
+
+            BenchResult result;
+            result.name        = name_;
+            result.unit        = unit_;
+            result.ops         = ops;
+            result.entities    = entities;
+            result.time        = time_;
+            result.allocations = allocations_;
+            result.peak_rss_kb = GetPeakRSS();
+            return result;
+        }
+
+    private:
+        std::string                           name_;
+        std::string                           unit_;
+        bool                                  running_           = false;
+        double                                time_              = 0.0;
+        unsigned long long                    allocations_       = 0;
+        unsigned long long                    allocations_start_ = 0;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    double NsPerOp(const BenchResult& r)
+    {
+        return r.ops > 0 ? 1e9 * r.time / static_cast<double>(r.ops) : 0.0;
+    }
+
+    double AllocationsPerOp(const BenchResult& r)
+    {
+        return r.ops > 0 ? static_cast<double>(r.allocations) / static_cast<double>(r.ops) : 0.0;
+    }
+
+    std::string ResourcePath(const BenchConfig& config, const std::string& relative_path)
+    {
+        return std::filesystem::absolute(std::filesystem::path(config.res_path) / relative_path).generic_string();
+    }
+
+    int LoadRoad(const BenchConfig& config, const std::string& odr_file)
+    {
+        if (!Position::LoadOpenDrive(ResourcePath(config, "xodr/" + odr_file).c_str()))
+        {
+            printf("Failed to load %s\n", odr_file.c_str());
+            return -1;
+        }
+        return 0;
+    }
+
+    int BenchOdrLoad(const BenchConfig& config, const std::string& odr_file, std::vector<BenchResult>& results)
+    {
+        Measurement m("xodr_load_" + FileNameWithoutExtOf(odr_file), "load");
+        for (unsigned int i = 0; i < config.iterations; i++)
+        {
+            if (LoadRoad(config, odr_file) != 0)
+            {
+                return -1;
+            }
+        }
+        results.push_back(m.Stop(config.iterations));
+
+        return 0;
+    }
+
+    int BenchXYZ2TrackPos(const BenchConfig& config, const std::string& odr_file, std::vector<BenchResult>& results)
+    {
+        if (LoadRoad(config, odr_file) != 0)
+        {
+            return -1;
+        }
+
+        // Sample points around the road network, fixed seed for equal workload in every run
+        OpenDrive*                             odr = Position::GetOpenDrive();
+        std::mt19937                           gen(0);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        std::vector<std::pair<double, double>> points;
+        Position                               pos;
+
+        for (unsigned int i = 0; i < 1000 * config.iterations; i++)
+        {
+            Road* road = odr->GetRoadByIdx(static_cast<unsigned int>(dist(gen) * odr->GetNumOfRoads()) % odr->GetNumOfRoads());
+            pos.SetTrackPos(road->GetId(), dist(gen) * road->GetLength(), 20.0 * (dist(gen) - 0.5));
+            points.push_back(std::make_pair(pos.GetX(), pos.GetY()));
+        }
+
+        Measurement m("xyz2trackpos_" + FileNameWithoutExtOf(odr_file), "query");
+        for (auto& point : points)
+        {
+            pos.XYZ2TrackPos(point.first, point.second, 0.0);
+        }
+        results.push_back(m.Stop(points.size()));
+
+        return 0;
+    }
+
+    int BenchMoveAlongS(const BenchConfig& config, const std::string& odr_file, std::vector<BenchResult>& results)
+    {
+        if (LoadRoad(config, odr_file) != 0)
+        {
+            return -1;
+        }
+
+        // Start in first driving lane found
+        OpenDrive* odr = Position::GetOpenDrive();
+        Position   start_pos;
+        bool       found = false;
+        for (unsigned int i = 0; i < odr->GetNumOfRoads() && !found; i++)
+        {
+            LaneSection* lane_section = odr->GetRoadByIdx(i)->GetLaneSectionByIdx(0);
+            for (unsigned int j = 0; lane_section != nullptr && j < lane_section->GetNumberOfLanes() && !found; j++)
+            {
+                Lane* lane = lane_section->GetLaneByIdx(j);
+                if (lane->IsDriving() && lane->GetId() != 0)
+                {
+                    start_pos.SetLanePos(odr->GetRoadByIdx(i)->GetId(), lane->GetId(), 0.0, 0.0);
+                    found = true;
+                }
+            }
+        }
+
+        if (!found)
+        {
+            printf("No driving lane found in %s\n", odr_file.c_str());
+            return -1;
+        }
+
+        SE_Env::Inst().GetRand().SetSeed(0);  // junction choices
+        Position           pos      = start_pos;
+        unsigned long long n_steps  = 100000ULL * config.iterations;
+        Measurement        m("move_along_s_" + FileNameWithoutExtOf(odr_file), "move");
+        for (unsigned long long i = 0; i < n_steps; i++)
+        {
+            if (static_cast<int>(pos.MoveAlongS(0.5)) < 0)
+            {
+                pos = start_pos;  // end of road or other issue, start over
+            }
+        }
+        results.push_back(m.Stop(n_steps));
+
+        return 0;
+    }
+
+    // Calculate lane level routes, as FollowRoute controllers do, between random pairs of driving lanes. Uncached, each route is
+    // searched for. Cached, the pairs are requested over and over, like by many vehicles heading for the same destinations.
+    int BenchRouting(const BenchConfig& config, const std::string& odr_file, bool cached, std::vector<BenchResult>& results)
+    {
+        if (LoadRoad(config, odr_file) != 0)
+        {
+            return -1;
+        }
+
+        // Middle of driving lanes next to reference line, in driving direction (right hand traffic)
+        OpenDrive*            odr = Position::GetOpenDrive();
+        std::vector<Position> lane_positions;
+        for (unsigned int i = 0; i < odr->GetNumOfRoads(); i++)
+        {
+            Road* road = odr->GetRoadByIdx(i);
+            for (int lane_id : {-1, 1})
+            {
+                LaneSection* lane_section = road->GetLaneSectionByS(road->GetLength() / 2);
+                Lane*        lane         = lane_section != nullptr ? lane_section->GetLaneById(lane_id) : nullptr;
+                if (road->GetJunction() == ID_UNDEFINED && lane != nullptr && lane->IsDriving())
+                {
+                    Position pos(road->GetId(), lane_id, road->GetLength() / 2, 0.0);
+                    pos.SetHeadingRelativeRoadDirection(lane_id < 0 ? 0.0 : M_PI);
+                    lane_positions.push_back(pos);
+                }
+            }
+        }
+
+        if (lane_positions.size() < 2)
+        {
+            printf("Not enough driving lanes in %s\n", odr_file.c_str());
+            return -1;
+        }
+
+        // Fixed seed for equal workload in every run
+        std::mt19937                                 gen(0);
+        std::uniform_int_distribution<size_t>        dist(0, lane_positions.size() - 1);
+        std::vector<std::pair<Position*, Position*>> pairs;
+        while (pairs.size() < 100)
+        {
+            Position* start  = &lane_positions[dist(gen)];
+            Position* target = &lane_positions[dist(gen)];
+            if (start->GetTrackId() != target->GetTrackId())
+            {
+                pairs.push_back(std::make_pair(start, target));
+            }
+        }
+
+        LaneIndependentRouter::ClearPathCache();
+        LaneIndependentRouter router(odr);
+        unsigned long long    n_routes = 100ULL * config.iterations;
+        unsigned long long    n_found  = 0;
+        Measurement           m(std::string(cached ? "route_cached_" : "route_") + FileNameWithoutExtOf(odr_file), "route");
+        for (unsigned long long i = 0; i < n_routes; i++)
+        {
+            if (!cached)
+            {
+                LaneIndependentRouter::ClearPathCache();
+            }
+            std::pair<Position*, Position*>& pair = pairs[i % pairs.size()];
+            if (!router.CalculatePath(*pair.first, *pair.second).empty())
+            {
+                n_found++;
+            }
+        }
+        BenchResult result = m.Stop(n_routes);
+        results.push_back(result);
+        printf("    routes per second: %.0f (%llu of %llu found)\n",
+               result.time > 0.0 ? static_cast<double>(n_routes) / result.time : 0.0,
+               n_found,
+               n_routes);
+
+        return 0;
+    }
+
+    // Create a scenario with given number of vehicles spread over the six lanes of the E6 road, optionally driven by NaturalDriver
+    std::string CreateTrafficScenario(const BenchConfig& config, unsigned int n_vehicles, bool natural_driver)
+    {
+        const int    lanes[]     = {-2, -3, -4, 2, 3, 4};
+        const int    n_lanes     = static_cast<int>(sizeof(lanes) / sizeof(lanes[0]));
+        const double s_start     = 20.0;
+        const double s_end       = 1300.0;
+        unsigned int lane_length = (n_vehicles + n_lanes - 1) / n_lanes;
+        double       spacing     = (s_end - s_start) / MAX(1U, lane_length);
+
+        std::ostringstream xml;
+        xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<OpenSCENARIO>\n";
+        xml << "<FileHeader revMajor=\"1\" revMinor=\"2\" date=\"2024-01-01T00:00:00\" description=\"bench traffic\" author=\"esmini\"/>\n";
+        xml << "<CatalogLocations>\n";
+        xml << "<VehicleCatalog><Directory path=\"" << ResourcePath(config, "xosc/Catalogs/Vehicles") << "\"/></VehicleCatalog>\n";
+        xml << "<ControllerCatalog><Directory path=\"" << ResourcePath(config, "xosc/Catalogs/Controllers") << "\"/></ControllerCatalog>\n";
+        xml << "</CatalogLocations>\n";
+        xml << "<RoadNetwork><LogicFile filepath=\"" << ResourcePath(config, "xodr/e6mini.xodr") << "\"/></RoadNetwork>\n";
+        xml << "<Entities>\n";
+        for (unsigned int i = 0; i < n_vehicles; i++)
+        {
+            xml << "<ScenarioObject name=\"Car" << i << "\">";
+            xml << "<CatalogReference catalogName=\"VehicleCatalog\" entryName=\"car_white\"/>";
+            if (natural_driver)
+            {
+                xml << "<ObjectController><CatalogReference catalogName=\"ControllerCatalog\" entryName=\"NaturalDriver\">";
+                xml << "<ParameterAssignments><ParameterAssignment parameterRef=\"DesiredSpeed\" value=\"" << 20 + i % 10 << "\"/>";
+                xml << "</ParameterAssignments></CatalogReference></ObjectController>";
+            }
+            xml << "</ScenarioObject>\n";
+        }
+        xml << "</Entities>\n<Storyboard>\n<Init>\n<Actions>\n";
+        for (unsigned int i = 0; i < n_vehicles; i++)
+        {
+            int    lane = lanes[i % n_lanes];
+            double s    = s_start + spacing * (i / n_lanes);
+            xml << "<Private entityRef=\"Car" << i << "\">";
+            xml << "<PrivateAction><TeleportAction><Position><LanePosition roadId=\"0\" laneId=\"" << lane << "\" offset=\"0\" s=\"" << s
+                << "\"/></Position></TeleportAction></PrivateAction>";
+            xml << "<PrivateAction><LongitudinalAction><SpeedAction>";
+            xml << "<SpeedActionDynamics dynamicsShape=\"step\" dynamicsDimension=\"time\" value=\"0\"/>";
+            xml << "<SpeedActionTarget><AbsoluteTargetSpeed value=\"20\"/></SpeedActionTarget>";
+            xml << "</SpeedAction></LongitudinalAction></PrivateAction>";
+            if (natural_driver)
+            {
+                xml << "<PrivateAction><ActivateControllerAction longitudinal=\"true\" lateral=\"true\"/></PrivateAction>";
+            }
+            xml << "</Private>\n";
+        }
+        xml << "</Actions>\n</Init>\n";
+        xml << "<StopTrigger><ConditionGroup><Condition name=\"StopCondition\" delay=\"0\" conditionEdge=\"none\">";
+        xml << "<ByValueCondition><SimulationTimeCondition value=\"1000\" rule=\"greaterThan\"/></ByValueCondition>";
+        xml << "</Condition></ConditionGroup></StopTrigger>\n";
+        xml << "</Storyboard>\n</OpenSCENARIO>\n";
+
+        return xml.str();
+    }
+
+    void StepScenario(ScenarioEngine* se, double dt)
+    {
+        se->step(dt);
+        se->prepareGroundTruth(dt);
+        se->getScenarioGateway()->clearDirtyBits();
+    }
+
+    // Create and initialize scenario of vehicles with default controller, creation and first step excluded from measurements
+    ScenarioEngine* CreateScenario(const BenchConfig& config, unsigned int n_vehicles)
+    {
+        ScenarioEngine*    se = nullptr;
+        pugi::xml_document doc;
+
+        SE_Env::Inst().GetRand().SetSeed(0);
+
+        if (!doc.load_string(CreateTrafficScenario(config, n_vehicles, false).c_str()))
+        {
+            printf("Failed to create traffic scenario\n");
+            return nullptr;
+        }
+
+        try
+        {
+            se = new ScenarioEngine(doc);
+        }
+        catch (const std::exception& e)
+        {
+            printf("Failed to create scenario: %s\n", e.what());
+            return nullptr;
+        }
+
+        StepScenario(se, 0.0);
+
+        return se;
+    }
+
+    // Run complete player frames, since controllers like NaturalDriver depend on the player
+    int BenchTraffic(const BenchConfig&        config,
+                     const std::string&        name,
+                     unsigned int              n_vehicles,
+                     const std::string&        xosc_file,
+                     std::vector<BenchResult>& results)
+    {
+        std::vector<std::string> args = {"esmini-bench", "--headless", "--disable_log", "--seed", "0", "--fixed_timestep", std::to_string(BENCH_DT)};
+        if (xosc_file.empty())
+        {
+            args.insert(args.end(), {"--osc_str", CreateTrafficScenario(config, n_vehicles, true)});
+        }
+        else
+        {
+            args.insert(args.end(), {"--osc", ResourcePath(config, "xosc/" + xosc_file)});
+        }
+        if (SE_Env::Inst().GetOptions().IsOptionArgumentSet("disable_stdout"))
+        {
+            args.push_back("--disable_stdout");
+        }
+
+        std::vector<char*> argv;
+        for (auto& arg : args)
+        {
+            argv.push_back(&arg[0]);
+        }
+
+        std::unique_ptr<ScenarioPlayer> player;
+        try
+        {
+            player = std::make_unique<ScenarioPlayer>(static_cast<int>(argv.size()), argv.data());
+            if (player->Init() != 0)
+            {
+                printf("Failed to initialize scenario\n");
+                return -1;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            printf("Failed to create scenario: %s\n", e.what());
+            return -1;
+        }
+
+        player->Frame(BENCH_DT);  // warm up, e.g. spawn swarm vehicles
+
+        // Keep amount of work roughly constant, e.g. 2000 vehicles are stepped a tenth of the frames of 200 vehicles
+        unsigned int n_frames = n_vehicles > 100 ? MAX(10U, config.frames * 100 / n_vehicles) : config.frames;
+
+        // Swarm vehicles come and go, hence average number of entities
+        unsigned long long entity_steps = 0;
+
+        Measurement m(name, "step");
+        for (unsigned int i = 0; i < n_frames; i++)
+        {
+            player->Frame(BENCH_DT);
+            entity_steps += player->scenarioEngine->entities_.object_.size();
+        }
+        results.push_back(m.Stop(n_frames, static_cast<unsigned int>(entity_steps / n_frames)));
+
+        return 0;
+    }
+
+    // Many instances of a short scenario stepped in lockstep, each reset when done like in reinforcement learning
+    int BenchBatch(const BenchConfig& config, const std::string& name, unsigned int n_threads, std::vector<BenchResult>& results)
+    {
+        const unsigned int n_instances     = 64;
+        const unsigned int episode_n_steps = 50;
+
+        ScenarioBatch batch;
+        if (batch.Init(ResourcePath(config, "xosc/cut-in.xosc"), n_instances, n_threads) != 0)
+        {
+            printf("Failed to initialize scenario batch\n");
+            return -1;
+        }
+
+        // Instances start at different steps, so that resets are spread out over time
+        std::vector<unsigned int> n_steps(n_instances);
+        for (unsigned int i = 0; i < n_instances; i++)
+        {
+            n_steps[i] = i % episode_n_steps;
+        }
+
+        unsigned long long n_episodes = 0;
+        Measurement        m(name, "instance-step");
+        for (unsigned int i = 0; i < config.frames; i++)
+        {
+            if (batch.Step(BENCH_DT) != 0)
+            {
+                printf("Failed to step scenario batch\n");
+                return -1;
+            }
+
+            for (unsigned int j = 0; j < n_instances; j++)
+            {
+                if (++n_steps[j] >= episode_n_steps || batch.GetQuitFlag(j))
+                {
+                    batch.Reset(j);
+                    n_steps[j] = 0;
+                    n_episodes++;
+                }
+            }
+        }
+        BenchResult result = m.Stop(static_cast<unsigned long long>(config.frames) * n_instances,
+                                    static_cast<unsigned int>(batch.GetEngine(0)->entities_.object_.size()));
+        results.push_back(result);
+        printf("    threads: %u episodes per second: %.0f\n",
+               batch.GetNumberOfThreads(),
+               result.time > 0.0 ? static_cast<double>(n_episodes) / result.time : 0.0);
+
+        return 0;
+    }
+
+#ifdef _USE_OSI
+    int BenchOSIGroundTruth(const BenchConfig& config, unsigned int n_vehicles, std::vector<BenchResult>& results)
+    {
+        ScenarioEngine* se = CreateScenario(config, n_vehicles);
+        if (se == nullptr)
+        {
+            return -1;
+        }
+
+        OSIReporter* osi_reporter = new OSIReporter(se);
+        se->storyBoard.SetOSIReporter(osi_reporter);
+
+        // First update includes static ground truth, e.g. road network, excluded from measurement
+        int size = 0;
+        osi_reporter->UpdateOSIGroundTruth(se->getScenarioGateway()->objectState_);
+        osi_reporter->GetOSIGroundTruth(&size);
+
+        // Step the scenario untimed, measure only update and serialization of the ground truth
+        Measurement        m("osi_groundtruth_" + std::to_string(n_vehicles), "frame", true);
+        unsigned long long bytes = 0;
+        for (unsigned int i = 0; i < config.frames; i++)
+        {
+            se->step(BENCH_DT);
+            se->prepareGroundTruth(BENCH_DT);
+
+            m.Resume();
+            osi_reporter->UpdateOSIGroundTruth(se->getScenarioGateway()->objectState_);
+            osi_reporter->GetOSIGroundTruth(&size);
+            m.Pause();
+
+            se->getScenarioGateway()->clearDirtyBits();
+            bytes += static_cast<unsigned long long>(size);
+        }
+        results.push_back(m.Stop(config.frames, static_cast<unsigned int>(se->entities_.object_.size())));
+        printf("    avg ground truth size: %llu bytes\n", bytes / config.frames);
+
+        delete osi_reporter;
+        delete se;
+
+        return 0;
+    }
+#endif  // _USE_OSI
+
+    int BenchDat(const BenchConfig& config, unsigned int n_vehicles, std::vector<BenchResult>& results)
+    {
+        ScenarioEngine* se = CreateScenario(config, n_vehicles);
+        if (se == nullptr)
+        {
+            return -1;
+        }
+
+        ScenarioGateway* gateway    = se->getScenarioGateway();
+        unsigned int     n_entities = static_cast<unsigned int>(se->entities_.object_.size());
+
+        if (gateway->RecordToFile(BENCH_DAT_FILENAME, se->getOdrFilename(), se->getSceneGraphFilename(), std::string(esmini_git_rev())) != 0)
+        {
+            printf("Failed to open %s\n", BENCH_DAT_FILENAME);
+            delete se;
+            return -1;
+        }
+
+        // Step the scenario untimed, measure only writing of the states
+        Measurement write_measurement("dat_write_" + std::to_string(n_vehicles), "frame", true);
+        for (unsigned int i = 0; i < config.frames; i++)
+        {
+            se->step(BENCH_DT);
+            se->prepareGroundTruth(BENCH_DT);
+
+            write_measurement.Resume();
+            gateway->WriteStatesToFile(se->getSimulationTime(), BENCH_DT);
+            write_measurement.Pause();
+
+            gateway->clearDirtyBits();
+        }
+        delete se;  // closes the file
+
+        results.push_back(write_measurement.Stop(config.frames, n_entities));
+
+        Measurement read_measurement("dat_read_" + std::to_string(n_vehicles), "frame");
+        {
+            Replay replay(BENCH_DAT_FILENAME);
+        }
+        results.push_back(read_measurement.Stop(config.frames, n_entities));
+
+        std::remove(BENCH_DAT_FILENAME);
+
+        return 0;
+    }
+
+#ifndef _WIN32
+    typedef struct
+    {
+        int          counter;  // fragment number, negative for last one
+        unsigned int datasize;
+        double       time;
+        char         data[BENCH_UDP_DATA_SIZE];
+    } BenchUDPPacket;
+
+    double SteadyTime()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Publish entity states and wait for a reader thread to receive them, one frame at a time. Result time is the sum of latencies from
+    // start of publishing until the reader has its copy. UDP sends the states as raw bytes, fragmented like OSI, i.e. without serialization.
+    int BenchSharedState(const BenchConfig& config, unsigned int n_entities, std::vector<BenchResult>& results)
+    {
+        unsigned int                      n_frames = 10 * config.frames;
+        std::vector<SE_SharedEntityState> states(n_entities);
+        std::atomic<unsigned int>         n_received(0);
+        std::atomic<bool>                 failed(false);
+        double                            latency = 0.0;
+
+        for (unsigned int i = 0; i < n_entities; i++)
+        {
+            states[i].id = static_cast<int>(i);
+            states[i].x  = i;
+            StrCopy(states[i].name, ("obj" + std::to_string(i)).c_str(), SHARED_STATE_NAME_SIZE);
+        }
+
+        auto wait_for = [&n_received](unsigned int count)
+        {
+            while (n_received.load(std::memory_order_acquire) < count)
+            {
+                std::this_thread::yield();
+            }
+        };
+
+        std::string          name = "/esmini_bench_" + std::to_string(getpid());
+        SE_SharedStateWriter writer;
+        SE_SharedStateReader reader;
+        if (writer.Open(name, n_entities) != 0 || reader.Open(name) != 0)
+        {
+            printf("Failed to create shared memory %s\n", name.c_str());
+            return -1;
+        }
+
+        Measurement shm_measurement("shm_latency_" + std::to_string(n_entities), "frame", true);
+        std::thread shm_reader(
+            [&]()
+            {
+                SE_SharedFrameCopy copy;
+                for (unsigned int i = 0; i < n_frames; i++)
+                {
+                    while (reader.GetFrameCount() <= i)
+                    {
+                        std::this_thread::yield();
+                    }
+                    if (reader.CopyLatest(copy) != 0 || copy.entities.size() != n_entities)
+                    {
+                        failed = true;
+                    }
+                    latency += SteadyTime() - copy.time;
+                    n_received.store(i + 1, std::memory_order_release);
+                }
+            });
+        for (unsigned int i = 0; i < n_frames; i++)
+        {
+            SE_SharedEntityState* entities = writer.BeginFrame(SteadyTime());
+            std::copy(states.begin(), states.end(), entities);
+            writer.EndFrame(n_entities);
+            wait_for(i + 1);
+        }
+        shm_reader.join();
+
+        if (failed)
+        {
+            printf("Failed to read published frames\n");
+            return -1;
+        }
+
+        BenchResult shm_result = shm_measurement.Stop(n_frames, n_entities);
+        shm_result.time        = latency;
+        results.push_back(shm_result);
+
+        BenchUDPPacket packet;
+        UDPServer server(BENCH_UDP_PORT, 500);
+        UDPClient client(BENCH_UDP_PORT, "127.0.0.1");
+        if (server.GetStatus() != 0 || client.GetStatus() != 0)
+        {
+            printf("Failed to open UDP port %d\n", BENCH_UDP_PORT);
+            return -1;
+        }
+
+        latency = 0.0;
+        n_received.store(0);
+        Measurement udp_measurement("udp_latency_" + std::to_string(n_entities), "frame", true);
+        std::thread udp_reader(
+            [&]()
+            {
+                std::vector<char> buf(n_entities * sizeof(SE_SharedEntityState));
+                BenchUDPPacket    received;
+                for (unsigned int i = 0; i < n_frames && !failed; i++)
+                {
+                    size_t size = 0;
+                    do
+                    {
+                        if (server.Receive(reinterpret_cast<char*>(&received), sizeof(received)) <= 0 || size + received.datasize > buf.size())
+                        {
+                            failed = true;
+                            break;
+                        }
+                        memcpy(&buf[size], received.data, received.datasize);
+                        size += received.datasize;
+                    } while (received.counter > 0);
+                    latency += SteadyTime() - received.time;
+                    n_received.store(i + 1, std::memory_order_release);
+                }
+                n_received.store(n_frames, std::memory_order_release);
+            });
+        for (unsigned int i = 0; i < n_frames && !failed; i++)
+        {
+            const char* data = reinterpret_cast<const char*>(states.data());
+            size_t      size = states.size() * sizeof(SE_SharedEntityState);
+            packet.time      = SteadyTime();
+            for (size_t sent = 0, counter = 1; sent < size; counter++)
+            {
+                packet.datasize = static_cast<unsigned int>(MIN(size - sent, BENCH_UDP_DATA_SIZE));
+                packet.counter  = static_cast<int>(sent + packet.datasize < size ? counter : -counter);
+                memcpy(packet.data, data + sent, packet.datasize);
+                client.Send(reinterpret_cast<char*>(&packet), static_cast<unsigned int>(offsetof(BenchUDPPacket, data) + packet.datasize));
+                sent += packet.datasize;
+            }
+            wait_for(i + 1);
+        }
+        udp_reader.join();
+
+        if (failed)
+        {
+            printf("Failed to receive frames over UDP\n");
+            return -1;
+        }
+
+        BenchResult udp_result = udp_measurement.Stop(n_frames, n_entities);
+        udp_result.time        = latency;
+        results.push_back(udp_result);
+
+        return 0;
+    }
+#endif  // _WIN32
+
+    bool IsSelected(const BenchConfig& config, const std::string& name)
+    {
+        return config.filter.empty() || name.find(config.filter) != std::string::npos;
+    }
+
+    void PrintResult(const BenchResult& r)
+    {
+        printf("%-32s %10.3f ms %14.1f ns/%-6s %12.1f ns/entity-step %10.1f allocs/%-6s %10lld kB peak RSS\n",
+               r.name.c_str(),
+               1e3 * r.time,
+               NsPerOp(r),
+               r.unit.c_str(),
+               r.entities > 0 ? NsPerOp(r) / r.entities : 0.0,
+               AllocationsPerOp(r),
+               r.unit.c_str(),
+               r.peak_rss_kb);
+    }
+
+    // One workload per line, which is what ReadResults() expects
+    int WriteResults(const std::string& filename, const std::vector<BenchResult>& results)
+    {
+        std::ofstream file(filename);
+        if (!file.is_open())
+        {
+            printf("Failed to open %s for writing\n", filename.c_str());
+            return -1;
+        }
+
+        file << "{\n  \"esmini_git_rev\": \"" << esmini_git_rev() << "\",\n  \"workloads\": [\n";
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const BenchResult& r = results[i];
+            file << "    {\"name\": \"" << r.name << "\", \"unit\": \"" << r.unit << "\", \"ops\": " << r.ops << ", \"entities\": " << r.entities
+                 << ", \"time_s\": " << r.time << ", \"ops_per_s\": " << (r.time > 0.0 ? static_cast<double>(r.ops) / r.time : 0.0)
+                 << ", \"ns_per_op\": " << NsPerOp(r) << ", \"ns_per_entity_step\": " << (r.entities > 0 ? NsPerOp(r) / r.entities : 0.0)
+                 << ", \"allocations\": " << r.allocations << ", \"allocations_per_op\": " << AllocationsPerOp(r)
+                 << ", \"peak_rss_kb\": " << r.peak_rss_kb << "}" << (i < results.size() - 1 ? "," : "") << "\n";
+        }
+        file << "  ]\n}\n";
+
+        return 0;
+    }
+
+    double GetJsonNumber(const std::string& line, const std::string& key)
+    {
+        size_t pos = line.find("\"" + key + "\":");
+        if (pos == std::string::npos)
+        {
+            return 0.0;
+        }
+        return std::atof(line.c_str() + pos + key.length() + 3);
+    }
+
+    std::string GetJsonString(const std::string& line, const std::string& key)
+    {
+        size_t pos = line.find("\"" + key + "\": \"");
+        if (pos == std::string::npos)
+        {
+            return "";
+        }
+        pos += key.length() + 5;
+        return line.substr(pos, line.find('"', pos) - pos);
+    }
+
+    // Read result file as written by WriteResults(), not a general JSON parser
+    int ReadResults(const std::string& filename, std::vector<BenchResult>& results)
+    {
+        std::ifstream file(filename);
+        if (!file.is_open())
+        {
+            printf("Failed to open %s\n", filename.c_str());
+            return -1;
+        }
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::string name = GetJsonString(line, "name");
+            if (name.empty())
+            {
+                continue;
+            }
+
+            BenchResult r;
+            r.name        = name;
+            r.unit        = GetJsonString(line, "unit");
+            r.ops         = static_cast<unsigned long long>(GetJsonNumber(line, "ops"));
+            r.entities    = static_cast<unsigned int>(GetJsonNumber(line, "entities"));
+            r.time        = GetJsonNumber(line, "time_s");
+            r.allocations = static_cast<unsigned long long>(GetJsonNumber(line, "allocations"));
+            r.peak_rss_kb = static_cast<long long>(GetJsonNumber(line, "peak_rss_kb"));
+            results.push_back(r);
+        }
+
+        return 0;
+    }
+
+    // Compare time and allocations per operation, return number of regressions
+    int CompareResults(const std::vector<BenchResult>& results, const std::vector<BenchResult>& baseline, double threshold)
+    {
+        int n_regressions = 0;
+
+        printf("\nComparison to baseline (threshold %.0f%%):\n", 100 * threshold);
+        for (auto& r : results)
+        {
+            auto base = std::find_if(baseline.begin(), baseline.end(), [&r](const BenchResult& b) { return b.name == r.name; });
+            if (base == baseline.end())
+            {
+                printf("%-32s not in baseline\n", r.name.c_str());
+                continue;
+            }
+
+            double time_ratio = NsPerOp(*base) > 0.0 ? NsPerOp(r) / NsPerOp(*base) : 1.0;
+            bool   slower     = time_ratio > 1.0 + threshold;
+            bool   allocates  = AllocationsPerOp(r) > AllocationsPerOp(*base) * (1.0 + threshold) + SMALL_NUMBER;
+
+            printf("%-32s time %+7.1f%%  allocs/%s %10.1f -> %-10.1f %s\n",
+                   r.name.c_str(),
+                   100 * (time_ratio - 1.0),
+                   r.unit.c_str(),
+                   AllocationsPerOp(*base),
+                   AllocationsPerOp(r),
+                   slower || allocates ? "REGRESSION" : "ok");
+
+            if (slower || allocates)
+            {
+                n_regressions++;
+            }
+        }
+
+        return n_regressions;
+    }
+
+    void PrintUsage(const char* app)
+    {
+        printf("Usage: %s [options]\n", app);
+        printf("  --res_path <path>       Path to esmini resources folder (default ../resources)\n");
+        printf("  --output <file>         Result JSON file (default %s)\n", BENCH_DEFAULT_OUTPUT);
+        printf("  --baseline <file>       Compare to baseline result file, return non zero on regression\n");
+        printf("  --threshold <fraction>  Allowed relative regression (default %.2f)\n", BENCH_DEFAULT_THRESHOLD);
+        printf("  --entities <n,n,...>    Number of vehicles in dense traffic workloads (default 100,500,2000)\n");
+        printf("  --frames <n>            Number of steps in scenario workloads, reduced for more than 100 vehicles (default 200)\n");
+        printf("  --iterations <n>        Scale of road manager workloads (default 10)\n");
+        printf("  --workload <substring>  Run only workloads with matching name\n");
+        printf("  --verbose               Log scenario info to console\n");
+    }
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    BenchConfig config = {"../resources", BENCH_DEFAULT_OUTPUT, "", BENCH_DEFAULT_THRESHOLD, 200, 10, "", {100, 500, 2000}};
+    bool        verbose = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg  = argv[i];
+        bool        last = i == argc - 1;
+
+        if (arg == "--verbose")
+        {
+            verbose = true;
+        }
+        else if (arg == "--res_path" && !last)
+        {
+            config.res_path = argv[++i];
+        }
+        else if (arg == "--output" && !last)
+        {
+            config.output = argv[++i];
+        }
+        else if (arg == "--baseline" && !last)
+        {
+            config.baseline = argv[++i];
+        }
+        else if (arg == "--threshold" && !last)
+        {
+            config.threshold = std::atof(argv[++i]);
+        }
+        else if (arg == "--frames" && !last)
+        {
+            int frames    = std::atoi(argv[++i]);
+            config.frames = static_cast<unsigned int>(MAX(1, frames));
+        }
+        else if (arg == "--iterations" && !last)
+        {
+            int iterations    = std::atoi(argv[++i]);
+            config.iterations = static_cast<unsigned int>(MAX(1, iterations));
+        }
+        else if (arg == "--workload" && !last)
+        {
+            config.filter = argv[++i];
+        }
+        else if (arg == "--entities" && !last)
+        {
+            config.entities.clear();
+            for (auto& n : SplitString(argv[++i], ','))
+            {
+                int n_entities = std::atoi(n.c_str());
+                config.entities.push_back(static_cast<unsigned int>(MAX(1, n_entities)));
+            }
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : -1;
+        }
+    }
+
+    if (config.entities.empty())
+    {
+        PrintUsage(argv[0]);
+        return -1;
+    }
+
+    if (!std::filesystem::exists(ResourcePath(config, "xodr/e6mini.xodr")))
+    {
+        printf("Resources not found in %s, see --res_path\n", config.res_path.c_str());
+        return -1;
+    }
+
+    if (!verbose)
+    {
+        SE_Env::Inst().GetOptions().SetOptionValue("disable_stdout", "", false, true);
+    }
+    SE_Env::Inst().GetOptions().SetOptionValue("disable_log", "", false, true);
+
+    std::vector<BenchResult> results;
+    int                      retval = 0;
+
+    auto run = [&](const std::string& name, std::function<int()> workload)
+    {
+        if (retval == 0 && IsSelected(config, name))
+        {
+            printf("Running %s\n", name.c_str());
+            size_t n_results = results.size();
+            retval           = workload();
+            for (size_t i = n_results; i < results.size(); i++)
+            {
+                PrintResult(results[i]);
+            }
+        }
+    };
+
+    for (const std::string odr_file : {"e6mini.xodr", "fabriksgatan.xodr", "multi_intersections.xodr"})
+    {
+        run("xodr_load_" + FileNameWithoutExtOf(odr_file), [&]() { return BenchOdrLoad(config, odr_file, results); });
+    }
+
+    for (const std::string odr_file : {"e6mini.xodr", "multi_intersections.xodr"})
+    {
+        run("xyz2trackpos_" + FileNameWithoutExtOf(odr_file), [&]() { return BenchXYZ2TrackPos(config, odr_file, results); });
+        run("move_along_s_" + FileNameWithoutExtOf(odr_file), [&]() { return BenchMoveAlongS(config, odr_file, results); });
+    }
+
+    run("route_multi_intersections", [&]() { return BenchRouting(config, "multi_intersections.xodr", false, results); });
+    run("route_cached_multi_intersections", [&]() { return BenchRouting(config, "multi_intersections.xodr", true, results); });
+
+    run("swarm", [&]() { return BenchTraffic(config, "swarm", 0, "swarm.xosc", results); });
+
+    for (auto n : config.entities)
+    {
+        run("traffic_" + std::to_string(n), [&]() { return BenchTraffic(config, "traffic_" + std::to_string(n), n, "", results); });
+    }
+
+    run("batch_cut_in_serial", [&]() { return BenchBatch(config, "batch_cut_in_serial", 1, results); });
+    run("batch_cut_in_parallel", [&]() { return BenchBatch(config, "batch_cut_in_parallel", 0, results); });
+
+#ifdef _USE_OSI
+    run("osi_groundtruth_" + std::to_string(config.entities[0]), [&]() { return BenchOSIGroundTruth(config, config.entities[0], results); });
+#endif  // _USE_OSI
+
+    run("dat_" + std::to_string(config.entities[0]), [&]() { return BenchDat(config, config.entities[0], results); });
+
+#ifndef _WIN32
+    run("shm_udp_latency_" + std::to_string(config.entities[0]), [&]() { return BenchSharedState(config, config.entities[0], results); });
+#endif  // _WIN32
+
+    if (retval != 0)
+    {
+        printf("Benchmark failed\n");
+        return -1;
+    }
+
+    if (WriteResults(config.output, results) != 0)
+    {
+        return -1;
+    }
+    printf("Results written to %s\n", config.output.c_str());
+
+    if (!config.baseline.empty())
+    {
+        std::vector<BenchResult> baseline;
+        if (ReadResults(config.baseline, baseline) != 0)
+        {
+            return -1;
+        }
+
+        int n_regressions = CompareResults(results, baseline, config.threshold);
+        if (n_regressions > 0)
+        {
+            printf("%d workload(s) regressed more than %.0f%%\n", n_regressions, 100 * config.threshold);
+            return 1;
+        }
+    }
+
+    return 0;
+}
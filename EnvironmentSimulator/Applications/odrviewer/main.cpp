@@ -466,6 +466,7 @@ int main(int argc, char **argv)
     opt.AddOption("path", "Search path prefix for assets, e.g. OpenDRIVE files.", "path", "", false, false);
     opt.AddOption("pause", "Pause simulation after initialization. Press 'space' to start.");
     opt.AddOption("road_features", "Show OpenDRIVE road features. Modes: on, off. Toggle key 'o'", "mode", "on");
+    opt.AddOption("road_model_cache", "Cache generated road 3D models in given folder, reused while OpenDRIVE and settings are unchanged", "path");
     opt.AddOption("save_generated_model", "Save generated 3D model (n/a when a scenegraph is loaded)");
     opt.AddOption("seed", "Specify seed number for random generator", "number");
     opt.AddOption("speed_factor", "speed_factor <number>", "speed_factor", std::to_string(global_speed_factor));
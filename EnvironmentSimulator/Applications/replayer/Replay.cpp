@@ -160,36 +160,26 @@ int Replay::ParsePackets(const std::string& filename)
             }
             case static_cast<id_t>(Dat::PacketId::OBJ_ID):
             {
-                if (dat_reader.ReadPacket(header, current_object_id_) != 0)
+                int obj_id;
+                if (dat_reader.ReadPacket(header, obj_id) != 0)
                 {
                     LOG_ERROR("Failed reading object ID.");
                     return -1;
                 }
-
-                if (objects_timeline_.count(current_object_id_) == 0)
-                {
-                    // Initialize timelines for this object
-                    objects_timeline_[current_object_id_] = {};
-                    current_object_timeline_              = &objects_timeline_[current_object_id_];
-                    current_object_timeline_->odometer_.values.emplace_back(timestamp_, 0.0f);
-                    if (timestamp_ > 0.0)
-                    {
-                        current_object_timeline_->active_.values.emplace_back(0.0f, false);  // Object was inactive from start of simulation
-                        current_object_timeline_->active_.values.emplace_back(timestamp_, true);
-                    }
-                    else
-                    {
-                        current_object_timeline_->active_.values.emplace_back(timestamp_, true);  // Object is active at the start of simulation
-                    }
-                }
-                else
+                SetCurrentObject(obj_id);
+                break;
+            }
+            case static_cast<id_t>(Dat::PacketId::OBJ_STATE):
+            {
+                Dat::ObjState state;
+                unsigned int  mask = 0;
+                if (dat_reader.ReadObjectState(header, state, mask) != 0)
                 {
-                    current_object_timeline_ = &objects_timeline_[current_object_id_];
-                    if (current_object_timeline_->active_.values.back().second != true)
-                    {
-                        current_object_timeline_->active_.values.emplace_back(timestamp_, true);
-                    }
+                    LOG_ERROR("Failed reading object state.");
+                    return -1;
                 }
+                SetCurrentObject(state.obj_id_);
+                AddObjectState(state, mask);
                 break;
             }
             case static_cast<id_t>(Dat::PacketId::SPEED):
@@ -393,6 +383,7 @@ int Replay::ParsePackets(const std::string& filename)
             case static_cast<id_t>(Dat::PacketId::OBJ_DELETED):
             {
                 current_object_timeline_->active_.values.emplace_back(timestamp_, false);
+                dat_reader.DeleteObjectState(current_object_id_);
                 break;
             }
             case static_cast<id_t>(Dat::PacketId::DT):
@@ -501,6 +492,130 @@ int Replay::ParsePackets(const std::string& filename)
     return 0;
 }
 
+void Replay::SetCurrentObject(int obj_id)
+{
+    current_object_id_ = obj_id;
+
+    if (objects_timeline_.count(current_object_id_) == 0)
+    {
+        // Initialize timelines for this object
+        objects_timeline_[current_object_id_] = {};
+        current_object_timeline_              = &objects_timeline_[current_object_id_];
+        current_object_timeline_->odometer_.values.emplace_back(timestamp_, 0.0f);
+        if (timestamp_ > 0.0)
+        {
+            current_object_timeline_->active_.values.emplace_back(0.0f, false);  // Object was inactive from start of simulation
+            current_object_timeline_->active_.values.emplace_back(timestamp_, true);
+        }
+        else
+        {
+            current_object_timeline_->active_.values.emplace_back(timestamp_, true);  // Object is active at the start of simulation
+        }
+    }
+    else
+    {
+        current_object_timeline_ = &objects_timeline_[current_object_id_];
+        if (current_object_timeline_->active_.values.back().second != true)
+        {
+            current_object_timeline_->active_.values.emplace_back(timestamp_, true);
+        }
+    }
+}
+
+void Replay::AddObjectState(const Dat::ObjState& state, unsigned int mask)
+{
+    PropertyTimeline* timeline = current_object_timeline_;
+    auto              changed  = [mask](Dat::CompactField field) { return (mask & Dat::CompactFieldBit(field)) != 0; };
+
+    if (changed(Dat::CompactField::SPEED))
+    {
+        timeline->speed_.values.emplace_back(timestamp_, state.speed_);
+    }
+    if (changed(Dat::CompactField::POSE_X) || changed(Dat::CompactField::POSE_Y) || changed(Dat::CompactField::POSE_Z) ||
+        changed(Dat::CompactField::POSE_H) || changed(Dat::CompactField::POSE_P) || changed(Dat::CompactField::POSE_R))
+    {
+        timeline->pose_.values.emplace_back(timestamp_, state.pose_);
+    }
+    if (changed(Dat::CompactField::MODEL_ID))
+    {
+        timeline->model_id_.values.emplace_back(timestamp_, state.model_id_);
+    }
+    if (changed(Dat::CompactField::OBJ_TYPE))
+    {
+        timeline->obj_type_.values.emplace_back(timestamp_, state.obj_type_);
+    }
+    if (changed(Dat::CompactField::OBJ_CATEGORY))
+    {
+        timeline->obj_category_.values.emplace_back(timestamp_, state.obj_category_);
+    }
+    if (changed(Dat::CompactField::CTRL_TYPE))
+    {
+        timeline->ctrl_type_.values.emplace_back(timestamp_, state.ctrl_type_);
+        if (state.ctrl_type_ == 100)  // Ghost controller, save the id
+        {
+            ghost_controller_id_ = current_object_id_;
+        }
+    }
+    if (changed(Dat::CompactField::WHEEL_ANGLE))
+    {
+        timeline->wheel_angle_.values.emplace_back(timestamp_, state.wheel_angle_);
+    }
+    if (changed(Dat::CompactField::WHEEL_ROT))
+    {
+        timeline->wheel_rot_.values.emplace_back(timestamp_, state.wheel_rot_);
+    }
+    if (changed(Dat::CompactField::BOUNDING_BOX))
+    {
+        OSCBoundingBox bounding_box = {{state.bounding_box_.x, state.bounding_box_.y, state.bounding_box_.z},
+                                       {state.bounding_box_.width, state.bounding_box_.length, state.bounding_box_.height}};
+        timeline->bounding_box_.values.emplace_back(timestamp_, bounding_box);
+    }
+    if (changed(Dat::CompactField::SCALE_MODE))
+    {
+        timeline->scale_mode_.values.emplace_back(timestamp_, state.scale_mode_);
+    }
+    if (changed(Dat::CompactField::VISIBILITY_MASK))
+    {
+        timeline->visibility_mask_.values.emplace_back(timestamp_, state.visibility_mask_);
+    }
+    if (changed(Dat::CompactField::NAME))
+    {
+        timeline->name_.values.emplace_back(timestamp_, state.name_);
+    }
+    if (changed(Dat::CompactField::ROAD_ID))
+    {
+        timeline->road_id_.values.emplace_back(timestamp_, state.road_id_);
+    }
+    if (changed(Dat::CompactField::LANE_ID))
+    {
+        timeline->lane_id_.values.emplace_back(timestamp_, state.lane_id_);
+    }
+    if (changed(Dat::CompactField::POS_OFFSET))
+    {
+        timeline->pos_offset_.values.emplace_back(timestamp_, state.pos_offset_);
+    }
+    if (changed(Dat::CompactField::POS_T))
+    {
+        timeline->pos_t_.values.emplace_back(timestamp_, state.pos_t_);
+    }
+    if (changed(Dat::CompactField::POS_S))
+    {
+        timeline->pos_s_.values.emplace_back(timestamp_, state.pos_s_);
+    }
+    if (changed(Dat::CompactField::REFPOINT_X_OFFSET))
+    {
+        timeline->refpoint_x_offset_.values.emplace_back(timestamp_, state.refpoint_x_offset_);
+    }
+    if (changed(Dat::CompactField::MODEL_X_OFFSET))
+    {
+        timeline->model_x_offset_.values.emplace_back(timestamp_, state.model_x_offset_);
+    }
+    if (changed(Dat::CompactField::MODEL3D))
+    {
+        timeline->model3d_.values.emplace_back(timestamp_, state.model3d_);
+    }
+}
+
 void Replay::ParseDatHeader(Dat::DatReader& dat_reader, const std::string& filename)
 {
     // Read raw header BEFORE reading packets
@@ -330,6 +330,8 @@ namespace scenarioengine
         void        FillEmptyTimestamps(const double start, const double end, const double dt, std::vector<double>& v);
         void        CreateMergedDatfile(const std::string filename) const;
         void        ParseDatHeader(Dat::DatReader& dat_reader, const std::string& filename);
+        void        SetCurrentObject(int obj_id);
+        void        AddObjectState(const Dat::ObjState& state, unsigned int mask);
 
         /**
                 Go to specific time
@@ -0,0 +1,422 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <algorithm>
+#include "SafetyMetrics.hpp"
+#include "logger.hpp"
+
+using namespace scenarioengine;
+
+#define GHOST_CTRL_TYPE        100  // control type 100 indicates ghost
+#define PET_MIN_FOOTPRINT_DIST 0.2  // minimum distance between footprints along the path of an entity (m)
+
+namespace
+{
+    // Establish world coordinates of bounding box center
+    void GetBoundingBoxCenter(const SafetyEntityState& e, double& x, double& y)
+    {
+        double dx = 0.0;
+        double dy = 0.0;
+        RotateVec2D(static_cast<double>(e.bb.center_.x_), static_cast<double>(e.bb.center_.y_), e.h, dx, dy);
+        x = e.x + dx;
+        y = e.y + dy;
+    }
+
+    // Bounding box corner vertices, starting at first quadrant, counter clockwise
+    void GetBoundingBoxCorners(const SafetyEntityState& e, double (&vertices)[4][2])
+    {
+        double cx     = static_cast<double>(e.bb.center_.x_);
+        double cy     = static_cast<double>(e.bb.center_.y_);
+        double length = static_cast<double>(e.bb.dimensions_.length_);
+        double width  = static_cast<double>(e.bb.dimensions_.width_);
+
+        double vtmp[4][2] = {{cx + length / 2.0, cy + width / 2.0},
+                             {cx - length / 2.0, cy + width / 2.0},
+                             {cx - length / 2.0, cy - width / 2.0},
+                             {cx + length / 2.0, cy - width / 2.0}};
+
+        for (int i = 0; i < 4; i++)
+        {
+            RotateVec2D(vtmp[i][0], vtmp[i][1], e.h, vertices[i][0], vertices[i][1]);
+            vertices[i][0] += e.x;
+            vertices[i][1] += e.y;
+        }
+    }
+
+    // Check whether projections of the two boxes on the normals of the first one's edges are separated
+    bool IsSeparated(const double (&v0)[4][2], const double (&v1)[4][2])
+    {
+        for (int i = 0; i < 2; i++)  // only two unique axes of a rectangle
+        {
+            double axis[2] = {v0[i + 1][1] - v0[i][1], v0[i][0] - v0[i + 1][0]};
+            double min0    = LARGE_NUMBER;
+            double max0    = -LARGE_NUMBER;
+            double min1    = LARGE_NUMBER;
+            double max1    = -LARGE_NUMBER;
+
+            for (int j = 0; j < 4; j++)
+            {
+                double p0 = axis[0] * v0[j][0] + axis[1] * v0[j][1];
+                double p1 = axis[0] * v1[j][0] + axis[1] * v1[j][1];
+                min0      = MIN(min0, p0);
+                max0      = MAX(max0, p0);
+                min1      = MIN(min1, p1);
+                max1      = MAX(max1, p1);
+            }
+
+            if (max0 < min1 || max1 < min0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}  // namespace
+
+SafetyAnalyzer::SafetyAnalyzer(double range, double pet_max) : range_(range), pet_max_(pet_max)
+{
+}
+
+double SafetyAnalyzer::BoundingBoxDistance(const SafetyEntityState& e0, const SafetyEntityState& e1, bool& overlap)
+{
+    double vertices[2][4][2];
+
+    GetBoundingBoxCorners(e0, vertices[0]);
+    GetBoundingBoxCorners(e1, vertices[1]);
+
+    // separating axis theorem
+    overlap = !IsSeparated(vertices[0], vertices[1]) && !IsSeparated(vertices[1], vertices[0]);
+    if (overlap)
+    {
+        return 0.0;
+    }
+
+    // not overlapping, find shortest distance from any vertex of one box to any edge of the other one
+    double min_dist = LARGE_NUMBER;
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                const double(&edge0)[2] = vertices[(i + 1) % 2][k];
+                const double(&edge1)[2] = vertices[(i + 1) % 2][(k + 1) % 4];
+                double dist =
+                    DistanceFromPointToEdge2D(vertices[i][j][0], vertices[i][j][1], edge0[0], edge0[1], edge1[0], edge1[1], nullptr, nullptr);
+                min_dist = MIN(min_dist, dist);
+            }
+        }
+    }
+
+    return min_dist;
+}
+
+SafetyAnalyzer::PairState* SafetyAnalyzer::FindPair(int id0, int id1)
+{
+    auto it = pairs_.find(std::make_pair(MIN(id0, id1), MAX(id0, id1)));
+    return it == pairs_.end() ? nullptr : &it->second;
+}
+
+SafetyAnalyzer::PairState& SafetyAnalyzer::GetPair(int id0, int id1)
+{
+    std::pair<int, int> key = std::make_pair(MIN(id0, id1), MAX(id0, id1));
+
+    auto it = pairs_.find(key);
+    if (it == pairs_.end())
+    {
+        PairState state;
+        state.metrics     = {key.first, key.second, LARGE_NUMBER, 0.0, LARGE_NUMBER, 0.0, LARGE_NUMBER, 0, -1.0};
+        state.overlapping = false;
+        state.last_frame  = -1;
+        it                = pairs_.emplace(key, state).first;
+    }
+
+    return it->second;
+}
+
+void SafetyAnalyzer::AddFootprint(const SafetyEntityState& entity, double time)
+{
+    double x          = 0.0;
+    double y          = 0.0;
+    double half_width = 0.5 * static_cast<double>(entity.bb.dimensions_.width_);
+    GetBoundingBoxCenter(entity, x, y);
+
+    max_width_ = MAX(max_width_, 2 * half_width);
+
+    auto it = last_footprint_.find(entity.id);
+    if (it != last_footprint_.end())
+    {
+        Footprint& last = footprints_[it->second];
+        if (PointSquareDistance2D(x, y, last.x, last.y) < pow(MAX(PET_MIN_FOOTPRINT_DIST, half_width), 2))
+        {
+            // still at the same spot
+            last.t_last = time;
+            return;
+        }
+    }
+
+    footprints_.push_back({x, y, time, time, half_width, entity.id});
+    last_footprint_[entity.id] = footprints_.size() - 1;
+}
+
+void SafetyAnalyzer::AddFrame(double time, const std::vector<SafetyEntityState>& entities)
+{
+    if (n_frames_ == 0)
+    {
+        start_time_ = time;
+    }
+    stop_time_ = time;
+
+    // bounding circles, sorted by left edge for the sweep
+    order_.resize(entities.size());
+    center_.resize(entities.size());
+    radius_.resize(entities.size());
+    for (size_t i = 0; i < entities.size(); i++)
+    {
+        order_[i] = i;
+        GetBoundingBoxCenter(entities[i], center_[i][0], center_[i][1]);
+        radius_[i] = 0.5 * hypot(static_cast<double>(entities[i].bb.dimensions_.length_), static_cast<double>(entities[i].bb.dimensions_.width_));
+        AddFootprint(entities[i], time);
+    }
+    std::sort(order_.begin(), order_.end(), [this](size_t a, size_t b) { return center_[a][0] - radius_[a] < center_[b][0] - radius_[b]; });
+
+    for (size_t i = 0; i < order_.size(); i++)
+    {
+        size_t a = order_[i];
+
+        for (size_t j = i + 1; j < order_.size(); j++)
+        {
+            size_t b = order_[j];
+
+            if (center_[b][0] - radius_[b] > center_[a][0] + radius_[a] + range_)
+            {
+                break;  // sorted, so no more candidates for a
+            }
+
+            if (fabs(center_[b][1] - center_[a][1]) > radius_[a] + radius_[b] + range_)
+            {
+                continue;
+            }
+
+            n_pair_tests_++;
+
+            bool   overlap = false;
+            double dist    = BoundingBoxDistance(entities[a], entities[b], overlap);
+
+            if (dist > range_ && FindPair(entities[a].id, entities[b].id) == nullptr)
+            {
+                continue;
+            }
+
+            PairState&         state = GetPair(entities[a].id, entities[b].id);
+            SafetyPairMetrics& pair  = state.metrics;
+
+            if (dist < pair.min_distance)
+            {
+                pair.min_distance      = dist;
+                pair.min_distance_time = time;
+            }
+
+            // a collision event is the start of an overlap, also when pair was out of range previous frame
+            bool was_overlapping = state.overlapping && state.last_frame == n_frames_ - 1;
+            if (overlap && !was_overlapping)
+            {
+                if (pair.collisions == 0)
+                {
+                    pair.first_collision_time = time;
+                }
+                pair.collisions++;
+            }
+            state.overlapping = overlap;
+            state.last_frame  = n_frames_;
+
+            if (!overlap)
+            {
+                // time to collision along line of sight, assuming constant velocities
+                double p[2] = {center_[b][0] - center_[a][0], center_[b][1] - center_[a][1]};
+                double v[2] = {entities[b].speed * cos(entities[b].h) - entities[a].speed * cos(entities[a].h),
+                               entities[b].speed * sin(entities[b].h) - entities[a].speed * sin(entities[a].h)};
+                double len  = GetLengthOfVector2D(p[0], p[1]);
+
+                if (len > SMALL_NUMBER)
+                {
+                    double closing_speed = -(p[0] * v[0] + p[1] * v[1]) / len;
+                    if (closing_speed > SMALL_NUMBER && dist / closing_speed < pair.min_ttc)
+                    {
+                        pair.min_ttc      = dist / closing_speed;
+                        pair.min_ttc_time = time;
+                    }
+                }
+            }
+        }
+    }
+
+    n_frames_++;
+}
+
+void SafetyAnalyzer::CalculatePET()
+{
+    // Spatial hash of footprints. Cell size is at least the widest entity, so any footprints closer than their
+    // combined half widths are found in the same or neighboring cells.
+    double                                            cell_size = MAX(1.0, max_width_);
+    std::unordered_map<int64_t, std::vector<size_t>> grid;
+
+    auto cell_key = [](int64_t ix, int64_t iy) { return (ix << 32) ^ (iy & 0xffffffff); };
+
+    for (size_t i = 0; i < footprints_.size(); i++)
+    {
+        const Footprint& fp = footprints_[i];
+        int64_t          ix = static_cast<int64_t>(floor(fp.x / cell_size));
+        int64_t          iy = static_cast<int64_t>(floor(fp.y / cell_size));
+
+        // compare with footprints already in the grid, so that each pair of footprints is checked only once
+        for (int64_t dx = -1; dx < 2; dx++)
+        {
+            for (int64_t dy = -1; dy < 2; dy++)
+            {
+                auto it = grid.find(cell_key(ix + dx, iy + dy));
+                if (it == grid.end())
+                {
+                    continue;
+                }
+
+                for (size_t j : it->second)
+                {
+                    const Footprint& other = footprints_[j];
+                    if (other.id == fp.id ||
+                        PointSquareDistance2D(fp.x, fp.y, other.x, other.y) > (fp.half_width + other.half_width) * (fp.half_width + other.half_width))
+                    {
+                        continue;
+                    }
+
+                    // time from one leaving the spot until the other reaches it, 0 if present at the same time
+                    double pet = MAX(0.0, MAX(fp.t_first, other.t_first) - MIN(fp.t_last, other.t_last));
+                    if (pet > pet_max_)
+                    {
+                        continue;
+                    }
+
+                    SafetyPairMetrics& pair = GetPair(fp.id, other.id).metrics;
+                    pair.pet                = MIN(pair.pet, pet);
+                }
+            }
+        }
+
+        grid[cell_key(ix, iy)].push_back(i);
+    }
+}
+
+void SafetyAnalyzer::Finish(SafetyRunMetrics& metrics)
+{
+    CalculatePET();
+
+    metrics.start_time           = start_time_;
+    metrics.stop_time            = stop_time_;
+    metrics.n_frames             = n_frames_;
+    metrics.n_entities           = static_cast<int>(last_footprint_.size());
+    metrics.n_pair_tests         = n_pair_tests_;
+    metrics.min_distance         = LARGE_NUMBER;
+    metrics.min_ttc              = LARGE_NUMBER;
+    metrics.min_pet              = LARGE_NUMBER;
+    metrics.collisions           = 0;
+    metrics.first_collision_time = -1.0;
+    metrics.pairs.clear();
+
+    for (auto& [key, state] : pairs_)
+    {
+        const SafetyPairMetrics& pair = state.metrics;
+
+        metrics.min_distance = MIN(metrics.min_distance, pair.min_distance);
+        metrics.min_ttc      = MIN(metrics.min_ttc, pair.min_ttc);
+        metrics.min_pet      = MIN(metrics.min_pet, pair.pet);
+        metrics.collisions += pair.collisions;
+        if (pair.collisions > 0 && (metrics.first_collision_time < 0.0 || pair.first_collision_time < metrics.first_collision_time))
+        {
+            metrics.first_collision_time = pair.first_collision_time;
+        }
+        metrics.pairs.push_back(pair);
+    }
+}
+
+int SafetyAnalyzer::AnalyzeReplay(Replay& replay, SafetyRunMetrics& metrics)
+{
+    if (replay.timestamps_.empty())
+    {
+        return -1;
+    }
+
+    std::vector<int> ids;
+    for (const auto& [id, timeline] : replay.objects_timeline_)
+    {
+        // skip ghosts, both regular (by controller type) and ghost restart ones (by negative id)
+        if (id >= 0 && (timeline.ctrl_type_.values.empty() || timeline.ctrl_type_.values[0].second != GHOST_CTRL_TYPE))
+        {
+            ids.push_back(id);
+        }
+    }
+
+    std::vector<SafetyEntityState> entities;
+    entities.reserve(ids.size());
+
+    for (size_t i = 0; i < replay.timestamps_.size(); i++)
+    {
+        double time = replay.timestamps_[i];
+
+        entities.clear();
+        for (int id : ids)
+        {
+            ReplayEntry entry = replay.GetReplayEntryAtTimeIncremental(id, time);
+            if (!entry.state.info.active)
+            {
+                continue;
+            }
+
+            entities.push_back({id,
+                                static_cast<double>(entry.state.pos.x),
+                                static_cast<double>(entry.state.pos.y),
+                                static_cast<double>(entry.state.pos.h),
+                                static_cast<double>(entry.state.info.speed),
+                                entry.state.info.boundingbox});
+        }
+
+        AddFrame(time, entities);
+    }
+
+    Finish(metrics);
+
+    return 0;
+}
+
+int SafetyAnalyzer::AnalyzeFile(const std::string& filename, SafetyRunMetrics& metrics, double range, double pet_max)
+{
+    metrics.filename = filename;
+
+    try
+    {
+        Replay         replay(filename);
+        SafetyAnalyzer analyzer(range, pet_max);
+
+        if (analyzer.AnalyzeReplay(replay, metrics) != 0)
+        {
+            LOG_ERROR("No data to analyze in {}", filename);
+            return -1;
+        }
+    }
+    catch (const std::exception&)
+    {
+        // reason already logged by the parser
+        return -1;
+    }
+
+    return 0;
+}
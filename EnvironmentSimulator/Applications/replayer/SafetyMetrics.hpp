@@ -0,0 +1,140 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <string>
+#include <array>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include "CommonMini.hpp"
+#include "Replay.hpp"
+
+namespace scenarioengine
+{
+    // State of an entity in one frame, as needed for the safety metrics
+    typedef struct
+    {
+        int            id;
+        double         x;
+        double         y;
+        double         h;
+        double         speed;
+        OSCBoundingBox bb;
+    } SafetyEntityState;
+
+    // Surrogate safety metrics of a pair of entities, id0 < id1
+    typedef struct
+    {
+        int    id0;
+        int    id1;
+        double min_distance;          // smallest gap between bounding boxes (m), 0 when overlapping
+        double min_distance_time;     // time of min_distance (s)
+        double min_ttc;               // smallest time to collision assuming constant velocities (s)
+        double min_ttc_time;          // time of min_ttc (s)
+        double pet;                   // post encroachment time, smallest time between one entity leaving and the other reaching a spot (s)
+        int    collisions;            // number of collision events, i.e. start of bounding box overlap
+        double first_collision_time;  // time of first collision event (s), -1 if no collision
+    } SafetyPairMetrics;
+
+    // Summary of a recording
+    typedef struct
+    {
+        std::string                    filename;
+        double                         start_time;
+        double                         stop_time;
+        int                            n_frames;
+        int                            n_entities;
+        int                            n_pair_tests;  // number of narrow phase tests, i.e. pairs passing the broad phase
+        double                         min_distance;
+        double                         min_ttc;
+        double                         min_pet;
+        int                            collisions;
+        double                         first_collision_time;
+        std::vector<SafetyPairMetrics> pairs;  // pairs that came within range at some point, ordered by ids
+    } SafetyRunMetrics;
+
+    /**
+        Calculate surrogate safety metrics for all pairs of entities over a sequence of frames.
+        Pairs are found per frame by sweep and prune of bounding circles along x-axis (broad phase), then bounding
+        boxes are checked for overlap and distance (narrow phase). PET is calculated from spatially hashed footprints
+        of the entity paths once all frames are added.
+    */
+    class SafetyAnalyzer
+    {
+    public:
+        /**
+            @param range Max distance between bounding boxes for a pair to be considered (m)
+            @param pet_max Max post encroachment time to consider (s)
+        */
+        SafetyAnalyzer(double range = 50.0, double pet_max = 10.0);
+
+        void AddFrame(double time, const std::vector<SafetyEntityState>& entities);
+        void Finish(SafetyRunMetrics& metrics);
+
+        /**
+            Analyze all active entities at each timestamp of a recording
+            @return 0 on success, -1 on failure
+        */
+        int AnalyzeReplay(Replay& replay, SafetyRunMetrics& metrics);
+
+        /**
+            Parse and analyze a recording (.dat) file
+            @return 0 on success, -1 on failure
+        */
+        static int AnalyzeFile(const std::string& filename, SafetyRunMetrics& metrics, double range = 50.0, double pet_max = 10.0);
+
+        /**
+            Find minimum distance between two bounding boxes, 0 if overlapping
+        */
+        static double BoundingBoxDistance(const SafetyEntityState& e0, const SafetyEntityState& e1, bool& overlap);
+
+    private:
+        typedef struct
+        {
+            double x;
+            double y;
+            double t_first;  // time of arrival
+            double t_last;   // time of departure
+            double half_width;
+            int    id;
+        } Footprint;
+
+        typedef struct
+        {
+            SafetyPairMetrics metrics;
+            bool              overlapping;
+            int               last_frame;  // latest frame pair passed the broad phase, -1 if never
+        } PairState;
+
+        PairState* FindPair(int id0, int id1);
+        PairState& GetPair(int id0, int id1);
+        void       AddFootprint(const SafetyEntityState& entity, double time);
+        void       CalculatePET();
+
+        double                                   range_;
+        double                                   pet_max_;
+        double                                   start_time_   = 0.0;
+        double                                   stop_time_    = 0.0;
+        int                                      n_frames_     = 0;
+        int                                      n_pair_tests_ = 0;
+        double                                   max_width_    = 0.0;
+        std::map<std::pair<int, int>, PairState> pairs_;
+        std::vector<Footprint>                   footprints_;
+        std::unordered_map<int, size_t>          last_footprint_;  // entity id -> index of latest footprint
+        std::vector<size_t>                      order_;           // reused sort buffer for the sweep
+        std::vector<std::array<double, 2>>       center_;          // reused bounding box center buffer
+        std::vector<double>                      radius_;          // reused bounding circle radius buffer
+    };
+
+}  // namespace scenarioengine
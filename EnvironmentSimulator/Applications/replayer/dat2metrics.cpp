@@ -0,0 +1,237 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+/*
+ * This application calculates surrogate safety metrics from binary recordings (.dat), e.g. for screening large sets of
+ * scenario variations. Files are analyzed in parallel, one per thread.
+ *
+ * Per recording: min distance, min time to collision (TTC), min post encroachment time (PET) and collision events.
+ * Results are written in CSV format, one line per recording. Optionally the same metrics per pair of entities are
+ * written to a separate CSV file, one line per pair and recording.
+ *
+ * Example: dat2metrics --output metrics.csv --pairs pairs.csv results/
+ */
+
+#include <algorithm>
+#include <clocale>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "CommonMini.hpp"
+#include "SafetyMetrics.hpp"
+
+#if __has_include(<filesystem>)
+#include <filesystem>
+namespace fs = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem;
+#else
+#error "Missing <filesystem> header"
+#endif
+
+using namespace scenarioengine;
+
+#define DEFAULT_RANGE   50.0
+#define DEFAULT_PET_MAX 10.0
+
+namespace
+{
+    void PrintUsage(const char* app)
+    {
+        printf("Usage: %s [options] <file.dat | directory> ...\n", app);
+        printf("  Directories are searched (not recursively) for .dat files\n");
+        printf("  --output <file>     Result CSV file (default stdout)\n");
+        printf("  --pairs <file>      Pair CSV file, one line per pair of entities that came within range\n");
+        printf("  --range <m>         Max distance between bounding boxes for a pair to be considered (default %.1f)\n", DEFAULT_RANGE);
+        printf("  --pet_max <s>       Max post encroachment time to consider (default %.1f)\n", DEFAULT_PET_MAX);
+        printf("  --threads <n>       Number of threads, 0 = number of hardware threads (default 0)\n");
+    }
+
+    // Print value with given precision, or "inf" if not set
+    std::string ValueString(double value, int precision = 3)
+    {
+        if (value > LARGE_NUMBER - SMALL_NUMBER)
+        {
+            return "inf";
+        }
+        char str[64];
+        snprintf(str, sizeof(str), "%.*f", precision, value);
+        return str;
+    }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> filenames;
+    std::string              output;
+    std::string              pairs_output;
+    double                   range     = DEFAULT_RANGE;
+    double                   pet_max   = DEFAULT_PET_MAX;
+    unsigned int             n_threads = 0;
+
+    std::setlocale(LC_ALL, "C.UTF-8");
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg  = argv[i];
+        bool        last = i == argc - 1;
+
+        if (arg == "--pairs" && !last)
+        {
+            pairs_output = argv[++i];
+        }
+        else if (arg == "--output" && !last)
+        {
+            output = argv[++i];
+        }
+        else if (arg == "--range" && !last)
+        {
+            range = std::atof(argv[++i]);
+        }
+        else if (arg == "--pet_max" && !last)
+        {
+            pet_max = std::atof(argv[++i]);
+        }
+        else if (arg == "--threads" && !last)
+        {
+            n_threads = static_cast<unsigned int>(MAX(0, std::atoi(argv[++i])));
+        }
+        else if (arg.rfind("--", 0) != 0 && fs::is_directory(arg))
+        {
+            std::vector<std::string> dir_files;
+            for (const auto& entry : fs::directory_iterator(arg))
+            {
+                if (entry.is_regular_file() && entry.path().extension() == ".dat")
+                {
+                    dir_files.push_back(entry.path().string());
+                }
+            }
+            std::sort(dir_files.begin(), dir_files.end());
+            filenames.insert(filenames.end(), dir_files.begin(), dir_files.end());
+        }
+        else if (arg.rfind("--", 0) != 0)
+        {
+            filenames.push_back(arg);
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            return arg == "--help" ? 0 : -1;
+        }
+    }
+
+    if (filenames.empty())
+    {
+        PrintUsage(argv[0]);
+        return -1;
+    }
+
+    // keep console clean for the CSV output
+    SE_Env::Inst().GetOptions().SetOptionValue("disable_stdout", "", false, true);
+    SE_Env::Inst().GetOptions().SetOptionValue("disable_log", "", false, true);
+
+    std::vector<SafetyRunMetrics> results(filenames.size());
+    std::vector<int>              status(filenames.size(), -1);
+
+    SE_ThreadPool pool(n_threads);
+    pool.ParallelFor(filenames.size(), [&](size_t i) { status[i] = SafetyAnalyzer::AnalyzeFile(filenames[i], results[i], range, pet_max); });
+
+    FILE* file = stdout;
+    if (!output.empty())
+    {
+        file = fopen(output.c_str(), "w");
+        if (file == nullptr)
+        {
+            printf("Failed to create file %s\n", output.c_str());
+            return -1;
+        }
+    }
+
+    FILE* pairs_file = nullptr;
+    if (!pairs_output.empty())
+    {
+        pairs_file = fopen(pairs_output.c_str(), "w");
+        if (pairs_file == nullptr)
+        {
+            printf("Failed to create file %s\n", pairs_output.c_str());
+            if (file != stdout)
+            {
+                fclose(file);
+            }
+            return -1;
+        }
+        fprintf(pairs_file,
+                "file, id_a, id_b, min_distance, min_distance_time, min_ttc, min_ttc_time, pet, collisions, first_collision_time\n");
+    }
+
+    fprintf(file, "file, start, stop, frames, entities, pair_tests, collisions, first_collision_time, min_distance, min_ttc, min_pet\n");
+
+    int n_failed = 0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const SafetyRunMetrics& r = results[i];
+
+        if (status[i] != 0)
+        {
+            fprintf(stderr, "Failed to analyze %s\n", filenames[i].c_str());
+            n_failed++;
+            continue;
+        }
+
+        fprintf(file,
+                "%s, %.3f, %.3f, %d, %d, %d, %d, %s, %s, %s, %s\n",
+                r.filename.c_str(),
+                r.start_time,
+                r.stop_time,
+                r.n_frames,
+                r.n_entities,
+                r.n_pair_tests,
+                r.collisions,
+                r.collisions > 0 ? ValueString(r.first_collision_time).c_str() : "-",
+                ValueString(r.min_distance).c_str(),
+                ValueString(r.min_ttc).c_str(),
+                ValueString(r.min_pet).c_str());
+
+        if (pairs_file != nullptr)
+        {
+            for (const auto& p : r.pairs)
+            {
+                fprintf(pairs_file,
+                        "%s, %d, %d, %s, %.3f, %s, %.3f, %s, %d, %s\n",
+                        r.filename.c_str(),
+                        p.id0,
+                        p.id1,
+                        ValueString(p.min_distance).c_str(),
+                        p.min_distance_time,
+                        ValueString(p.min_ttc).c_str(),
+                        p.min_ttc_time,
+                        ValueString(p.pet).c_str(),
+                        p.collisions,
+                        p.collisions > 0 ? ValueString(p.first_collision_time).c_str() : "-");
+            }
+        }
+    }
+
+    if (file != stdout)
+    {
+        fclose(file);
+    }
+
+    if (pairs_file != nullptr)
+    {
+        fclose(pairs_file);
+    }
+
+    return n_failed > 0 ? -1 : 0;
+}
@@ -464,6 +464,8 @@ int main(int argc, char** argv)
     opt.AddOption("dir",
                   "Directory containing replays to overlay, pair with \"file\" argument, where \"file\" is .dat filename match substring",
                   "path");
+#ifdef _USE_OSG
+#endif  // _USE_OSG
     opt.AddOption("fixed_timestep", "Use fixed timestep for the replay", "s", "");
 #ifdef _USE_OSG
     opt.AddOption("ground_plane", "Add a large flat ground surface");
@@ -494,6 +496,7 @@ int main(int argc, char** argv)
     opt.AddOption("res_path", "Path to resources root folder - relative or absolut", "path");
 #ifdef _USE_OSG
     opt.AddOption("road_features", "Show OpenDRIVE road features. Modes: on, off. Toggle key 'o'", "mode", "on");
+    opt.AddOption("road_model_cache", "Cache generated road 3D models in given folder, reused while OpenDRIVE and settings are unchanged", "path");
 #endif  // _USEOSG
     opt.AddOption("save_merged", "Save merged data into one dat file, instead of viewing", "filename");
     opt.AddOption("start_time", "Start playing at timestamp", "ms");
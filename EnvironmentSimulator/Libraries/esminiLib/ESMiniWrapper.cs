@@ -145,6 +145,23 @@ namespace ESMini
         public Dimensions dimensions_;   // Width, length and height of the bounding box.
     };
 
+    [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+    [Serializable]
+    public struct FrameProfileEntry
+    {
+        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 64)]
+        public string name;              // name of measured phase, e.g. "Storyboard" or controller/condition type
+        public int count;                // number of measurements
+        public float total;              // accumulated time (ms)
+        public float min;                // shortest measurement (ms)
+        public float max;                // longest measurement (ms)
+        public float last;               // latest measurement (ms)
+        public float p50;                // median (ms), estimated from histogram
+        public float p95;                // 95th percentile (ms), estimated from histogram
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 16)]
+        public int[] histogram;          // number of measurements in log2 buckets of microseconds: [0,2), [2,4), [4,8) ... [32768, inf)
+    };
+
 
     public static class ESMiniLib
     {
@@ -244,6 +261,41 @@ namespace ESMini
         [DllImport(LIB_NAME, EntryPoint = "SE_Close")]
         public static extern void SE_Close();
 
+        [DllImport(LIB_NAME, EntryPoint = "SE_CreateCheckpoint")]
+        /// <summary>Store complete runtime state of the simulation in memory</summary>
+        /// <return>Handle (>= 0) to the checkpoint, -1 on failure</return>
+        public static extern int SE_CreateCheckpoint();
+
+        [DllImport(LIB_NAME, EntryPoint = "SE_RestoreCheckpoint")]
+        /// <summary>Restore simulation state from a checkpoint</summary>
+        /// <param name="handle">Handle of the checkpoint, as returned by SE_CreateCheckpoint()</param>
+        /// <return>0 if successful, -1 if not</return>
+        public static extern int SE_RestoreCheckpoint(int handle);
+
+        [DllImport(LIB_NAME, EntryPoint = "SE_DeleteCheckpoint")]
+        /// <summary>Delete a checkpoint and release its memory</summary>
+        /// <param name="handle">Handle of the checkpoint, as returned by SE_CreateCheckpoint()</param>
+        /// <return>0 if successful, -1 if not</return>
+        public static extern int SE_DeleteCheckpoint(int handle);
+
+        [DllImport(LIB_NAME, EntryPoint = "SE_GetNumberOfFrameProfileEntries")]
+        /// <summary>Get number of measured phases of the frame profiler, see option --profile</summary>
+        /// <return>Number of profile entries, 0 if profiling is disabled</return>
+        public static extern int SE_GetNumberOfFrameProfileEntries();
+
+        [DllImport(LIB_NAME, EntryPoint = "SE_GetFrameProfile")]
+        /// <summary>Get aggregated time measurements of one phase of the frame</summary>
+        /// <param name="index">Index of the entry, 0 .. SE_GetNumberOfFrameProfileEntries() - 1</param>
+        /// <param name="entry">Reference to a FrameProfileEntry struct to be filled in</param>
+        /// <return>0 if successful, -1 if not</return>
+        public static extern int SE_GetFrameProfile(int index, ref FrameProfileEntry entry);
+
+        [DllImport(LIB_NAME, EntryPoint = "SE_WriteFrameProfileTrace")]
+        /// <summary>Save profiled events in Chrome trace JSON format, requires option --profile_trace</summary>
+        /// <param name="filename">Name of the trace file</param>
+        /// <return>0 if successful, -1 if not</return>
+        public static extern int SE_WriteFrameProfileTrace(string filename);
+
         [DllImport(LIB_NAME, EntryPoint = "SE_GetQuitFlag")]
         /// <summary>Is esmini about to quit?</summary>
         /// <return>0 if not, 1 if yes, -1 if some error e.g. scenario not loaded</return>
@@ -666,6 +718,17 @@ namespace ESMini
         /// <returns>osi3::GroundTruth*</returns>
         public static extern IntPtr SE_GetOSIGroundTruthRaw();
 
+        [DllImport(LIB_NAME, EntryPoint = "SE_GetOSIDynamicGroundTruthRaw")]
+        /// <summary>Dynamic part of the OSI GroundTruth, see SE_GetOSIStaticGroundTruthRaw</summary>
+        /// <returns>osi3::GroundTruth*</returns>
+        public static extern IntPtr SE_GetOSIDynamicGroundTruthRaw();
+
+        [DllImport(LIB_NAME, EntryPoint = "SE_GetOSIStaticGroundTruthRaw")]
+        /// <summary>Static part of the OSI GroundTruth to report, merged into dynamic part it equals SE_GetOSIGroundTruthRaw</summary>
+        /// <param name="revision">Changes whenever static data is updated</param>
+        /// <returns>osi3::GroundTruth*, or null if no static data to report</returns>
+        public static extern IntPtr SE_GetOSIStaticGroundTruthRaw(ref int revision);
+
         [DllImport(LIB_NAME, EntryPoint = "SE_GetOSIRoadLane")]
         //[return: MarshalAs(UnmanagedType.LPStr)]
         /// <summary>Get information of the lane where the object with object_id is</summary>
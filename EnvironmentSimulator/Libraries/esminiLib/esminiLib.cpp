@@ -27,6 +27,8 @@
 #include "OSCCondition.hpp"
 #include "Storyboard.hpp"
 #include "OSCParameterDistribution.hpp"
+#include "Profiler.hpp"
+#include "ScenarioBatch.hpp"
 
 using namespace scenarioengine;
 
@@ -59,8 +61,33 @@ static std::vector<SE_ObjCallback> objCallback;
 // List of 3D models populated from any found found model_ids.txt file
 static std::map<int, std::string> entity_model_map_;
 
+// In-memory checkpoints of the simulation state, see SE_CreateCheckpoint()
+static std::map<int, std::unique_ptr<SE_StateBuffer>> checkpoints_;
+static int                                            checkpoint_counter_ = 0;
+
+// Road feature lookahead state per object, see SE_GetNumberOfRoadFeaturesAhead()
+static std::map<int, roadmanager::RoadFeatureCursor> feature_cursors_;
+
+// Parallel scenario instances, see SE_BatchInit()
+static std::unique_ptr<ScenarioBatch> batch_;
+
+static ScenarioGateway *getBatchGateway(int instance)
+{
+    if (batch_ == nullptr || instance < 0)
+    {
+        return nullptr;
+    }
+
+    ScenarioEngine *engine = batch_->GetEngine(static_cast<unsigned int>(instance));
+
+    return engine != nullptr ? engine->getScenarioGateway() : nullptr;
+}
+
 static void resetScenario(void)
 {
+    checkpoints_.clear();
+    feature_cursors_.clear();
+
     if (player != nullptr)
     {
         delete player;
@@ -392,6 +419,14 @@ static int GetRoadInfoAtGhostTrailTime(int object_id, float time, SE_RoadInfo *r
 
 static int InitScenario()
 {
+    if (batch_ != nullptr)
+    {
+        // batch instances refer to the loaded road network, which would be replaced
+        LOG_ERROR("Scenario batch active, call SE_BatchClose() before SE_Init()");
+        resetScenario();
+        return -1;
+    }
+
     // Harmonize parsing and printing of floating point numbers. I.e. 1.57e+4 == 15700.0 not 15,700.0 or 1 or 1.57
     std::setlocale(LC_ALL, "C.UTF-8");
     ConvertArguments();
@@ -966,6 +1001,214 @@ extern "C"
         txtLogger.Stop();
     }
 
+    SE_DLL_API int SE_CreateCheckpoint()
+    {
+        if (player == nullptr)
+        {
+            return -1;
+        }
+
+        std::unique_ptr<SE_StateBuffer> buf = std::make_unique<SE_StateBuffer>();
+        if (player->StoreState(*buf) != 0)
+        {
+            return -1;
+        }
+
+        checkpoints_[checkpoint_counter_] = std::move(buf);
+
+        return checkpoint_counter_++;
+    }
+
+    SE_DLL_API int SE_RestoreCheckpoint(int handle)
+    {
+        if (player == nullptr || checkpoints_.find(handle) == checkpoints_.end())
+        {
+            return -1;
+        }
+
+        return player->RestoreState(*checkpoints_[handle]);
+    }
+
+    SE_DLL_API int SE_DeleteCheckpoint(int handle)
+    {
+        return checkpoints_.erase(handle) > 0 ? 0 : -1;
+    }
+
+    SE_DLL_API int SE_BatchInit(const char *oscFilename, int n_instances, int n_threads, int disable_ctrls)
+    {
+        if (oscFilename == nullptr || n_instances < 1 || n_threads < 0)
+        {
+            return -1;
+        }
+
+        if (player != nullptr)
+        {
+            // the scenario refers to the loaded road network, which would be replaced
+            LOG_ERROR("Scenario active, call SE_Close() before SE_BatchInit()");
+            return -1;
+        }
+
+        // Harmonize parsing and printing of floating point numbers, see InitScenario()
+        std::setlocale(LC_ALL, "C.UTF-8");
+
+        if (batch_ == nullptr)
+        {
+            batch_ = std::make_unique<ScenarioBatch>();
+        }
+
+        if (batch_->Init(oscFilename, static_cast<unsigned int>(n_instances), static_cast<unsigned int>(n_threads), disable_ctrls != 0) != 0)
+        {
+            batch_.reset();
+            return -1;
+        }
+
+        return 0;
+    }
+
+    SE_DLL_API int SE_BatchGetNumberOfInstances()
+    {
+        return batch_ != nullptr ? static_cast<int>(batch_->GetNumberOfInstances()) : 0;
+    }
+
+    SE_DLL_API int SE_BatchStepDT(float dt)
+    {
+        if (batch_ == nullptr)
+        {
+            return -1;
+        }
+
+        return batch_->Step(static_cast<double>(dt));
+    }
+
+    SE_DLL_API int SE_BatchResetInstance(int instance)
+    {
+        if (batch_ == nullptr || instance < 0)
+        {
+            return -1;
+        }
+
+        return batch_->Reset(static_cast<unsigned int>(instance));
+    }
+
+    SE_DLL_API int SE_BatchGetQuitFlags(int *quit_flags)
+    {
+        if (batch_ == nullptr || quit_flags == nullptr)
+        {
+            return -1;
+        }
+
+        for (unsigned int i = 0; i < batch_->GetNumberOfInstances(); i++)
+        {
+            quit_flags[i] = batch_->GetQuitFlag(i) ? 1 : 0;
+        }
+
+        return 0;
+    }
+
+    SE_DLL_API int SE_BatchGetObjectStates(int max_objects, SE_ScenarioObjectState *states, int *n_objects)
+    {
+        if (batch_ == nullptr || states == nullptr || max_objects < 0)
+        {
+            return -1;
+        }
+
+        for (unsigned int i = 0; i < batch_->GetNumberOfInstances(); i++)
+        {
+            ScenarioGateway *gateway = getBatchGateway(static_cast<int>(i));
+            int              n       = gateway != nullptr ? MIN(gateway->getNumberOfObjects(), max_objects) : 0;
+
+            for (int j = 0; j < n; j++)
+            {
+                copyStateFromScenarioGateway(&states[i * static_cast<unsigned int>(max_objects) + static_cast<unsigned int>(j)],
+                                             &gateway->getObjectStatePtrByIdx(j)->state_);
+            }
+
+            if (n_objects != nullptr)
+            {
+                n_objects[i] = n;
+            }
+        }
+
+        return 0;
+    }
+
+    SE_DLL_API int SE_BatchReportObjectPosXYH(int instance, int object_id, float timestamp, float x, float y, float h)
+    {
+        ScenarioGateway *gateway = getBatchGateway(instance);
+        if (gateway == nullptr || gateway->getObjectStatePtrById(object_id) == nullptr)
+        {
+            return -1;
+        }
+
+        gateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::WORLD_POS_XYH, object_id, timestamp, {x, y, h}));
+
+        return 0;
+    }
+
+    SE_DLL_API int SE_BatchReportObjectSpeed(int instance, int object_id, float speed)
+    {
+        ScenarioGateway *gateway = getBatchGateway(instance);
+        if (gateway == nullptr || gateway->getObjectStatePtrById(object_id) == nullptr)
+        {
+            return -1;
+        }
+
+        gateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::SPEED, object_id, 0.0, {speed}));
+
+        return 0;
+    }
+
+    SE_DLL_API void SE_BatchClose()
+    {
+        batch_.reset();
+    }
+
+    SE_DLL_API int SE_GetNumberOfFrameProfileEntries()
+    {
+        if (!SE_Profiler::Inst().IsEnabled())
+        {
+            return 0;
+        }
+
+        return SE_Profiler::Inst().GetNumberOfEntries();
+    }
+
+    SE_DLL_API int SE_GetFrameProfile(int index, SE_FrameProfileEntry *entry)
+    {
+        SE_Profiler::Entry profile_entry;
+
+        if (entry == nullptr || !SE_Profiler::Inst().IsEnabled() || SE_Profiler::Inst().GetEntry(index, profile_entry) != 0)
+        {
+            return -1;
+        }
+
+        StrCopy(entry->name, profile_entry.name.c_str(), SE_PROFILE_NAME_SIZE);
+        entry->count = static_cast<int>(profile_entry.count);
+        entry->total = static_cast<float>(1e3 * profile_entry.total);
+        entry->min   = profile_entry.count > 0 ? static_cast<float>(1e3 * profile_entry.min) : 0.0f;
+        entry->max   = static_cast<float>(1e3 * profile_entry.max);
+        entry->last  = static_cast<float>(1e3 * profile_entry.last);
+        entry->p50   = static_cast<float>(1e3 * SE_Profiler::GetPercentile(profile_entry, 50.0));
+        entry->p95   = static_cast<float>(1e3 * SE_Profiler::GetPercentile(profile_entry, 95.0));
+        static_assert(SE_PROFILE_HISTOGRAM_SIZE == PROFILER_HISTOGRAM_SIZE, "Profiler histogram size mismatch");
+        for (int i = 0; i < SE_PROFILE_HISTOGRAM_SIZE; i++)
+        {
+            entry->histogram[i] = static_cast<int>(profile_entry.histogram[i]);
+        }
+
+        return 0;
+    }
+
+    SE_DLL_API int SE_WriteFrameProfileTrace(const char *filename)
+    {
+        if (filename == nullptr || !SE_Profiler::Inst().IsEnabled())
+        {
+            return -1;
+        }
+
+        return SE_Profiler::Inst().WriteTrace(filename);
+    }
+
     SE_DLL_API void SE_LogToConsole(bool mode)
     {
         if (mode)
@@ -1204,6 +1447,8 @@ extern "C"
             return -1;
         }
 
+        feature_cursors_.erase(object_id);
+
         if (player != nullptr)
         {
             for (auto &ctrl : obj->controllers_)
@@ -1228,7 +1473,7 @@ extern "C"
             return -1;
         }
 
-        player->scenarioGateway->updateObjectWorldPos(object_id, timestamp, x, y, z, h, p, r);
+        player->scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::WORLD_POS, object_id, timestamp, {x, y, z, h, p, r}));
 
         return 0;
     }
@@ -1241,7 +1486,9 @@ extern "C"
             return -1;
         }
 
-        player->scenarioGateway->updateObjectWorldPosMode(object_id, timestamp, x, y, z, h, p, r, mode);
+        ObjectStateUpdate update(ObjectStateUpdate::Type::WORLD_POS_MODE, object_id, timestamp, {x, y, z, h, p, r});
+        update.mode = mode;
+        player->scenarioGateway->ReportUpdate(update);
 
         return 0;
     }
@@ -1254,7 +1501,7 @@ extern "C"
             return -1;
         }
 
-        player->scenarioGateway->updateObjectWorldPosXYH(object_id, timestamp, x, y, h);
+        player->scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::WORLD_POS_XYH, object_id, timestamp, {x, y, h}));
 
         return 0;
     }
@@ -1267,7 +1514,10 @@ extern "C"
             return -1;
         }
 
-        player->scenarioGateway->updateObjectLanePos(object_id, timestamp, roadId, laneId, laneOffset, s);
+        ObjectStateUpdate update(ObjectStateUpdate::Type::LANE_POS, object_id, timestamp, {laneOffset, s});
+        update.road_id = roadId;
+        update.lane_id = laneId;
+        player->scenarioGateway->ReportUpdate(update);
 
         return 0;
     }
@@ -1279,7 +1529,7 @@ extern "C"
         {
             return -1;
         }
-        player->scenarioGateway->updateObjectSpeed(object_id, 0.0, speed);
+        player->scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::SPEED, object_id, 0.0, {speed}));
 
         return 0;
     }
@@ -1292,26 +1542,7 @@ extern "C"
             return -1;
         }
 
-        player->scenarioGateway->reportObjectRoadPos(object_id,
-                                                     obj->g_id_,
-                                                     obj->name_,
-                                                     obj->type_,
-                                                     obj->category_,
-                                                     obj->role_,
-                                                     obj->model_id_,
-                                                     obj->GetModel3DFilename(),
-                                                     obj->GetControllerTypeActiveOnDomain(ControlDomains::DOMAIN_LONG),
-                                                     obj->boundingbox_,
-                                                     static_cast<int>(obj->scaleMode_),
-                                                     obj->visibilityMask_,
-                                                     0.0,
-                                                     obj->GetSpeed(),
-                                                     obj->wheel_angle_,
-                                                     obj->wheel_rot_,
-                                                     obj->rear_axle_.positionZ,
-                                                     obj->pos_.GetTrackId(),
-                                                     t,
-                                                     obj->pos_.GetS());
+        player->scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::LATERAL_ROAD_POS, object_id, 0.0, {t}));
 
         return 0;
     }
@@ -1325,27 +1556,7 @@ extern "C"
             return -1;
         }
 
-        player->scenarioGateway->reportObjectLanePos(object_id,
-                                                     obj->g_id_,
-                                                     obj->name_,
-                                                     obj->type_,
-                                                     obj->category_,
-                                                     obj->role_,
-                                                     obj->model_id_,
-                                                     obj->GetModel3DFilename(),
-                                                     obj->GetControllerTypeActiveOnDomain(ControlDomains::DOMAIN_LONG),
-                                                     obj->boundingbox_,
-                                                     static_cast<int>(obj->scaleMode_),
-                                                     obj->visibilityMask_,
-                                                     0.0,
-                                                     obj->GetSpeed(),
-                                                     obj->wheel_angle_,
-                                                     obj->wheel_rot_,
-                                                     obj->rear_axle_.positionZ,
-                                                     obj->pos_.GetTrackId(),
-                                                     obj->pos_.GetLaneId(),
-                                                     laneOffset,
-                                                     obj->pos_.GetS());
+        player->scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::LATERAL_LANE_POS, object_id, 0.0, {laneOffset}));
 
         return 0;
     }
@@ -1358,9 +1569,12 @@ extern "C"
         {
             return -1;
         }
-        player->scenarioGateway->updateObjectVel(object_id, 0.0, x_vel, y_vel, z_vel);
-        // Also update velocities directly in scenario object, in case we're in a callback
-        obj->SetVel(x_vel, y_vel, z_vel);
+        player->scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::VEL, object_id, 0.0, {x_vel, y_vel, z_vel}));
+        if (player->scenarioGateway->IsSimulationThread())
+        {
+            // Also update velocities directly in scenario object, in case we're in a callback
+            obj->SetVel(x_vel, y_vel, z_vel);
+        }
 
         return 0;
     }
@@ -1373,9 +1587,12 @@ extern "C"
         {
             return -1;
         }
-        player->scenarioGateway->updateObjectAngularVel(object_id, 0.0, h_rate, p_rate, r_rate);
-        // Also update accelerations directly in scenario object, in case we're in a callback
-        obj->SetAngularVel(h_rate, p_rate, r_rate);
+        player->scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::ANGULAR_VEL, object_id, 0.0, {h_rate, p_rate, r_rate}));
+        if (player->scenarioGateway->IsSimulationThread())
+        {
+            // Also update accelerations directly in scenario object, in case we're in a callback
+            obj->SetAngularVel(h_rate, p_rate, r_rate);
+        }
 
         return 0;
     }
@@ -1388,9 +1605,12 @@ extern "C"
         {
             return -1;
         }
-        player->scenarioGateway->updateObjectAcc(object_id, 0.0, x_acc, y_acc, z_acc);
-        // Also update accelerations directly in scenario object, in case we're in a callback
-        obj->SetAcc(x_acc, y_acc, z_acc);
+        player->scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::ACC, object_id, 0.0, {x_acc, y_acc, z_acc}));
+        if (player->scenarioGateway->IsSimulationThread())
+        {
+            // Also update accelerations directly in scenario object, in case we're in a callback
+            obj->SetAcc(x_acc, y_acc, z_acc);
+        }
 
         return 0;
     }
@@ -1403,9 +1623,12 @@ extern "C"
         {
             return -1;
         }
-        player->scenarioGateway->updateObjectAngularAcc(object_id, 0.0, h_acc, p_acc, r_acc);
-        // Also update accelerations directly in scenario object, in case we're in a callback
-        obj->SetAngularAcc(h_acc, p_acc, r_acc);
+        player->scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::ANGULAR_ACC, object_id, 0.0, {h_acc, p_acc, r_acc}));
+        if (player->scenarioGateway->IsSimulationThread())
+        {
+            // Also update accelerations directly in scenario object, in case we're in a callback
+            obj->SetAngularAcc(h_acc, p_acc, r_acc);
+        }
 
         return 0;
     }
@@ -1417,8 +1640,8 @@ extern "C"
         {
             return -1;
         }
-        player->scenarioGateway->updateObjectWheelRotation(object_id, 0, rotation);
-        player->scenarioGateway->updateObjectWheelAngle(object_id, 0, angle);
+        player->scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::WHEEL_ROTATION, object_id, 0.0, {rotation}));
+        player->scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::WHEEL_ANGLE, object_id, 0.0, {angle}));
 
         return 0;
     }
@@ -1433,7 +1656,9 @@ extern "C"
 
         if (object_id >= 0 && object_id < static_cast<int>(player->scenarioEngine->entities_.object_.size()))
         {
-            player->scenarioGateway->updateObjectLaneTypeSnapMask(object_id, 0.0, laneTypes);
+            ObjectStateUpdate update(ObjectStateUpdate::Type::LANE_TYPE_SNAP_MASK, object_id, 0.0, {});
+            update.mode = laneTypes;
+            player->scenarioGateway->ReportUpdate(update);
         }
         else
         {
@@ -1697,6 +1922,42 @@ extern "C"
         return 0;
     }
 
+    SE_DLL_API const char *SE_GetOSIDynamicGroundTruthRaw()
+    {
+#ifdef _USE_OSI
+        if (player != nullptr)
+        {
+            if (player->osiReporter->GetOSIFrequency() == 0)
+            {
+                player->osiReporter->SetOSIFrequency(1);
+            }
+            player->osiReporter->UpdateOSIGroundTruth(player->scenarioGateway->objectState_);
+            return player->osiReporter->GetOSIDynamicGroundTruthRaw();
+        }
+#endif  // _USE_OSI
+
+        return 0;
+    }
+
+    SE_DLL_API const char *SE_GetOSIStaticGroundTruthRaw(int *revision)
+    {
+#ifdef _USE_OSI
+        if (player != nullptr)
+        {
+            if (player->osiReporter->GetOSIFrequency() == 0)
+            {
+                player->osiReporter->SetOSIFrequency(1);
+            }
+            player->osiReporter->UpdateOSIGroundTruth(player->scenarioGateway->objectState_);
+            return player->osiReporter->GetOSIStaticGroundTruthRaw(revision);
+        }
+#else
+        (void)revision;
+#endif  // _USE_OSI
+
+        return 0;
+    }
+
     SE_DLL_API const char *SE_GetOSITrafficCommandRaw()
     {
 #ifdef _USE_OSI
@@ -2520,6 +2781,46 @@ extern "C"
         return -1;
     }
 
+    SE_DLL_API int SE_GetNumberOfRoadFeaturesAhead(int object_id, float lookahead_distance, int type_mask, int max_count)
+    {
+        Object *obj = nullptr;
+        if (getObjectById(object_id, obj) == -1)
+        {
+            return -1;
+        }
+
+        return feature_cursors_[object_id].Update(obj->pos_,
+                                                  static_cast<double>(lookahead_distance),
+                                                  type_mask,
+                                                  static_cast<unsigned int>(MAX(0, max_count)));
+    }
+
+    SE_DLL_API int SE_GetRoadFeatureAhead(int object_id, unsigned int index, SE_RoadFeature *road_feature)
+    {
+        auto it = feature_cursors_.find(object_id);
+        if (it == feature_cursors_.end() || road_feature == nullptr)
+        {
+            return -1;
+        }
+
+        const roadmanager::RoadFeatureCursor::Hit *hit = it->second.GetHit(index);
+        if (hit == nullptr)
+        {
+            return -1;
+        }
+
+        road_feature->type      = hit->type;
+        road_feature->distance  = static_cast<float>(hit->distance);
+        road_feature->roadId    = hit->road_id;
+        road_feature->s         = static_cast<float>(hit->s);
+        road_feature->direction = hit->direction;
+        road_feature->value     = static_cast<float>(hit->value);
+        road_feature->id        = hit->id;
+        road_feature->index     = hit->index == IDX_UNDEFINED ? -1 : static_cast<int>(hit->index);
+
+        return 0;
+    }
+
     SE_DLL_API const char *SE_GetRoadIdString(id_t road_id)
     {
         if (player != nullptr)
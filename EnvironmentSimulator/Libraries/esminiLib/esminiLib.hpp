@@ -27,6 +27,9 @@ typedef uint32_t id_t;
 #define SE_IDX_UNDEFINED   0xffffffff
 #define SE_PARAM_NAME_SIZE 32
 
+#define SE_PROFILE_NAME_SIZE      64
+#define SE_PROFILE_HISTOGRAM_SIZE 16
+
 typedef struct
 {
     int   id;              // Automatically generated unique object id
@@ -231,6 +234,18 @@ typedef struct
     int toLane;
 } SE_RoadObjValidity;
 
+typedef struct
+{
+    int   type;       // feature type, see roadmanager::RoadFeature::Type (1=signal, 2=object, 4=speed limit, 8=lane count)
+    float distance;   // distance along road reference lines from the object to the feature
+    id_t  roadId;     // road id of the feature
+    float s;          // longitudinal position along road
+    int   direction;  // 1=travelling along road s axis, -1=travelling opposite road s axis
+    float value;      // new speed limit or number of driving lanes in travel direction, 0 for signals and objects
+    id_t  id;         // id of the signal or object, ID_UNDEFINED for speed limit and lane count changes
+    int   index;      // index of the signal or object within the road, -1 for speed limit and lane count changes
+} SE_RoadFeature;
+
 typedef struct
 {
     int            width;
@@ -287,6 +302,20 @@ typedef struct
     int   transition_shape;  // 0 = cubic, 1 = linear, 2 = sinusoidal, 3 = step
 } SE_LaneOffsetActionStruct;
 
+typedef struct
+{
+    char  name[SE_PROFILE_NAME_SIZE];  // name of measured phase, e.g. "Storyboard" or controller/condition type
+    int   count;                       // number of measurements
+    float total;                       // accumulated time (ms)
+    float min;                         // shortest measurement (ms)
+    float max;                         // longest measurement (ms)
+    float last;                        // latest measurement (ms)
+    float p50;                         // median (ms), estimated from histogram
+    float p95;                         // 95th percentile (ms), estimated from histogram
+    // number of measurements in log2 buckets of microseconds: [0,2), [2,4), [4,8) ... [32768, inf)
+    int histogram[SE_PROFILE_HISTOGRAM_SIZE];
+} SE_FrameProfileEntry;
+
 // Modes for interpret Z, Head, Pitch, Roll coordinate value as absolute or relative
 // grouped as bitmask: 0000 => skip/use current, 0001=DEFAULT, 0011=ABS, 0111=REL
 // example: Relative Z, Absolute H, Default R, Current P = SE_Z_REL | SE_H_ABS | SE_R_DEF = 4151 = 0001 0000 0011 0111
@@ -560,7 +589,7 @@ extern "C"
        1+2=3=>Off-screen
             @param threads 0=single thread, 1=viewer in a separate thread, parallel to scenario engine
             @param record Create recording for later playback 0=no recording 1=recording
-            @return 0 if successful, -1 if not
+            @return 0 if successful, -1 if not, e.g. while a scenario batch is active, see SE_BatchInit()
 
             \use_viewer bitmask examples:
                             0: No viewer instantiated. Improved performance, use when viewer not needed.
@@ -580,7 +609,7 @@ extern "C"
        1+2=3=>Off-screen
             @param threads 0=single thread, 1=viewer in a separate thread, parallel to scenario engine
             @param record Create recording for later playback 0=no recording 1=recording
-            @return 0 if successful, -1 if not
+            @return 0 if successful, -1 if not, e.g. while a scenario batch is active, see SE_BatchInit()
 
             \use_viewer bitmask examples:
                             0: No viewer instantiated. Improved performance, use when viewer not needed.
@@ -617,6 +646,131 @@ extern "C"
     */
     SE_DLL_API void SE_Close();
 
+    /**
+            Store complete runtime state of the simulation in memory, e.g. entities, storyboard, controllers and random generator
+            Note: Not all controllers support checkpoints, neither does an ongoing SwarmTrafficAction. Recorded files are not rewound on restore.
+            @return Handle (>= 0) to the checkpoint, -1 on failure
+    */
+    SE_DLL_API int SE_CreateCheckpoint();
+
+    /**
+            Restore simulation state from a checkpoint. The set of entities must be the same as when checkpoint was created.
+            The checkpoint is kept and can be restored again.
+            @param handle Handle of the checkpoint, as returned by SE_CreateCheckpoint()
+            @return 0 if successful, -1 if not. The simulation state is kept if entities have been added or deleted, other failures
+            may leave it partly restored, see ScenarioEngine::RestoreState()
+    */
+    SE_DLL_API int SE_RestoreCheckpoint(int handle);
+
+    /**
+            Delete a checkpoint and release its memory. All checkpoints are deleted by SE_Close().
+            @param handle Handle of the checkpoint, as returned by SE_CreateCheckpoint()
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_DeleteCheckpoint(int handle);
+
+    /**
+            Create a batch of independent instances of a scenario, stepped together by a pool of threads. Intended for many parallel
+            episodes, e.g. reinforcement learning. The road network is loaded once and shared by all instances. Each instance has its own
+            random generator, seeded by SE_GetSeed() + instance index. Any previous batch is closed.
+            The batch and the scenario of SE_Init() can't be active at the same time, since they would replace each other's road network.
+            Hence SE_BatchInit() fails until SE_Close() is called, and SE_Init() fails until SE_BatchClose() is called.
+            Note: Scenario parameters and variables, dynamic traffic signals and registered callbacks are global, i.e. shared by instances.
+            Hence scenarios modifying parameters, variables or traffic signals are rejected. Recording, OSI and viewer are not supported.
+            @param oscFilename Path to the OpenSCENARIO file
+            @param n_instances Number of instances
+            @param n_threads Number of threads stepping the instances, 0 = number of hardware threads
+            @param disable_ctrls 1=Any controller will be disabled 0=Controllers applied according to OSC file
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_BatchInit(const char *oscFilename, int n_instances, int n_threads, int disable_ctrls);
+
+    /**
+            Get number of instances of the batch
+            @return Number of instances, 0 if no batch has been created
+    */
+    SE_DLL_API int SE_BatchGetNumberOfInstances();
+
+    /**
+            Step all instances of the batch forward with specified timestep
+            @param dt time step in seconds
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_BatchStepDT(float dt);
+
+    /**
+            Bring one instance of the batch back to its initial state, without reloading the road network
+            @param instance Index of the instance, 0 .. SE_BatchGetNumberOfInstances() - 1
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_BatchResetInstance(int instance);
+
+    /**
+            Get quit flag of all instances, i.e. whether their storyboard is complete
+            @param quit_flags Array of SE_BatchGetNumberOfInstances() values, set to 1 if done else 0
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_BatchGetQuitFlags(int *quit_flags);
+
+    /**
+            Get state of all objects in all instances in one go. The states are stored in instance order, max_objects per instance.
+            Unused slots are left as is.
+            @param max_objects Max number of objects per instance
+            @param states Array of SE_BatchGetNumberOfInstances() * max_objects states
+            @param n_objects Array of SE_BatchGetNumberOfInstances() values, receiving number of objects stored per instance. May be NULL.
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_BatchGetObjectStates(int max_objects, SE_ScenarioObjectState *states, int *n_objects);
+
+    /**
+            Report object position in cartesian coordinates, in given instance of the batch. See SE_ReportObjectPosXYH.
+            @param instance Index of the instance
+            @param object_id Id of the object
+            @param timestamp Timestamp (not really used yet, OK to set 0)
+            @param x X coordinate
+            @param y Y coordinate
+            @param h Heading / yaw
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_BatchReportObjectPosXYH(int instance, int object_id, float timestamp, float x, float y, float h);
+
+    /**
+            Report object longitudinal speed, in given instance of the batch. See SE_ReportObjectSpeed.
+            @param instance Index of the instance
+            @param object_id Id of the object
+            @param speed Speed in forward direction of the entity
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_BatchReportObjectSpeed(int instance, int object_id, float speed);
+
+    /**
+            Delete all instances of the batch and release memory
+    */
+    SE_DLL_API void SE_BatchClose();
+
+    /**
+            Get number of measured phases (scopes) of the frame profiler, see option --profile
+            @return Number of profile entries, 0 if profiling is disabled
+    */
+    SE_DLL_API int SE_GetNumberOfFrameProfileEntries();
+
+    /**
+            Get aggregated time measurements of one phase of the frame, e.g. storyboard evaluation or OSI update
+            Note: Profiling needs to be enabled by option --profile, e.g. SE_SetOptionValue("profile", "all") before SE_Init()
+            @param index Index of the entry, 0 .. SE_GetNumberOfFrameProfileEntries() - 1
+            @param entry Pointer to struct to be filled in
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_GetFrameProfile(int index, SE_FrameProfileEntry *entry);
+
+    /**
+            Save profiled events in Chrome trace JSON format, e.g. for chrome://tracing or Perfetto
+            Note: Events are only collected when option --profile_trace is set
+            @param filename Name of the trace file
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_WriteFrameProfileTrace(const char *filename);
+
     /**
             Enable or disable log to stdout/console
             Deprecated, use SE_SetOption() / SE_UnsetOption() with "disable_stdout" instead
@@ -1453,6 +1607,27 @@ extern "C"
     */
     SE_DLL_API int SE_GetRoadSignValidityRecord(id_t road_id, unsigned int signIndex, unsigned int validityIndex, SE_RoadObjValidity *validity);
 
+    /**
+            Look for road features (signals, objects, speed limit and lane count changes) ahead of the object, in order of distance.
+            Roads are followed through junctions along the object route, if any, else straight ahead.
+            Results are fetched by SE_GetRoadFeatureAhead.
+            @param object_id Id of the object from which to look
+            @param lookahead_distance Max distance to look ahead
+            @param type_mask Bitmask of feature types to include, see SE_RoadFeature type. -1 for all.
+            @param max_count Max number of features to register, 0 for no limit
+            @return Number of features found, -1 on error
+    */
+    SE_DLL_API int SE_GetNumberOfRoadFeaturesAhead(int object_id, float lookahead_distance, int type_mask, int max_count);
+
+    /**
+            Get information on a road feature found by the latest SE_GetNumberOfRoadFeaturesAhead call for the object
+            @param object_id Id of the object
+            @param index Index of the feature, in order of distance
+            @param road_feature Pointer/reference to a SE_RoadFeature struct to be filled in
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_GetRoadFeatureAhead(int object_id, unsigned int index, SE_RoadFeature *road_feature);
+
     /**
             Get original string ID asoociated with specified road
             @param road_id The integer ID road
@@ -1555,6 +1730,21 @@ extern "C"
     */
     SE_DLL_API const char *SE_GetOSIGroundTruthRaw();
 
+    /**
+            The SE_GetOSIDynamicGroundTruthRaw function updates the OSI ground truth and returns a pointer to the internal dynamic part only.
+            Together with SE_GetOSIStaticGroundTruthRaw it avoids copying data into the combined ground truth. Merging static part into
+            dynamic part, e.g. by appending its serialized data, equals the ground truth returned by SE_GetOSIGroundTruthRaw
+            @return osi3::GroundTruth*
+    */
+    SE_DLL_API const char *SE_GetOSIDynamicGroundTruthRaw();
+
+    /**
+            The SE_GetOSIStaticGroundTruthRaw function updates the OSI ground truth and returns a pointer to the internal static part to report
+            @param revision If not null, receives a number changing whenever static data is updated, e.g. to know when a cached serialization is outdated
+            @return osi3::GroundTruth*, or null if no static data is to be reported this frame
+    */
+    SE_DLL_API const char *SE_GetOSIStaticGroundTruthRaw(int *revision);
+
     /**
             Get a pointer to the internal OSI data structure, useful for direct access to OSI data in a C/C++ environment
             @return osi3::TrafficCommand*
@@ -18,9 +18,10 @@
 
 using namespace roadmanager;
 
-static roadmanager::OpenDrive* odrManager = nullptr;
-static std::vector<Position>   position;
-static std::string             returnString;  // use this for returning strings
+static roadmanager::OpenDrive*         odrManager = nullptr;
+static std::vector<Position>          position;
+static std::vector<RoadFeatureCursor> feature_cursor;  // one per position, same index
+static std::string                    returnString;    // use this for returning strings
 
 static int GetRoadInfo(int index, float lookahead_distance, void* data, int lookAheadMode, bool inRoadDrivingDirection, bool probe_extension)
 {
@@ -144,6 +145,7 @@ extern "C"
     {
         odrManager = nullptr;
         position.clear();
+        feature_cursor.clear();
 
         return 0;
     }
@@ -162,6 +164,7 @@ extern "C"
 
         roadmanager::Position newPosition;
         position.push_back(newPosition);
+        feature_cursor.push_back(RoadFeatureCursor());
         return static_cast<int>((position.size() - 1));  // return index of newly created
     }
 
@@ -186,11 +189,13 @@ extern "C"
         {
             // Delete all items
             position.clear();
+            feature_cursor.clear();
         }
         else if (handle >= 0 && handle < static_cast<int>(position.size()))
         {
             // Delete specific item
             position.erase(position.begin() + handle);
+            feature_cursor.erase(feature_cursor.begin() + handle);
         }
         else
         {
@@ -209,6 +214,7 @@ extern "C"
 
         roadmanager::Position newPosition(position[static_cast<unsigned int>(handle)]);
         position.push_back(newPosition);
+        feature_cursor.push_back(RoadFeatureCursor());
         return static_cast<int>((position.size() - 1));  // return index of newly created
     }
 
@@ -994,6 +1000,44 @@ extern "C"
         return -1;
     }
 
+    RM_DLL_API int RM_GetNumberOfRoadFeaturesAhead(int handle, float lookahead_distance, int type_mask, int max_count)
+    {
+        if (odrManager == nullptr || handle < 0 || handle >= static_cast<int>(position.size()))
+        {
+            return -1;
+        }
+
+        return feature_cursor[static_cast<unsigned int>(handle)].Update(position[static_cast<unsigned int>(handle)],
+                                                                         static_cast<double>(lookahead_distance),
+                                                                         type_mask,
+                                                                         static_cast<unsigned int>(MAX(0, max_count)));
+    }
+
+    RM_DLL_API int RM_GetRoadFeatureAhead(int handle, unsigned int index, RM_RoadFeature* road_feature)
+    {
+        if (odrManager == nullptr || handle < 0 || handle >= static_cast<int>(position.size()) || road_feature == nullptr)
+        {
+            return -1;
+        }
+
+        const RoadFeatureCursor::Hit* hit = feature_cursor[static_cast<unsigned int>(handle)].GetHit(index);
+        if (hit == nullptr)
+        {
+            return -1;
+        }
+
+        road_feature->type      = hit->type;
+        road_feature->distance  = static_cast<float>(hit->distance);
+        road_feature->roadId    = hit->road_id;
+        road_feature->s         = static_cast<float>(hit->s);
+        road_feature->direction = hit->direction;
+        road_feature->value     = static_cast<float>(hit->value);
+        road_feature->id        = hit->id;
+        road_feature->index     = hit->index == IDX_UNDEFINED ? -1 : static_cast<int>(hit->index);
+
+        return 0;
+    }
+
     RM_DLL_API int RM_GetNumberOfRoadSignValidityRecords(id_t road_id, unsigned int index)
     {
         if (odrManager == nullptr)
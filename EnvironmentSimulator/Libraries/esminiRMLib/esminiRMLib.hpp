@@ -105,6 +105,18 @@ typedef struct
     int toLane;
 } RM_RoadObjValidity;
 
+typedef struct
+{
+    int   type;       // feature type, see roadmanager::RoadFeature::Type (1=signal, 2=object, 4=speed limit, 8=lane count)
+    float distance;   // distance along road reference lines from the position to the feature
+    id_t  roadId;     // road id of the feature
+    float s;          // longitudinal position along road
+    int   direction;  // 1=travelling along road s axis, -1=travelling opposite road s axis
+    float value;      // new speed limit or number of driving lanes in travel direction, 0 for signals and objects
+    id_t  id;         // id of the signal or object, ID_UNDEFINED for speed limit and lane count changes
+    int   index;      // index of the signal or object within the road, -1 for speed limit and lane count changes
+} RM_RoadFeature;
+
 typedef struct
 {
     float       a_;
@@ -592,6 +604,26 @@ extern "C"
     */
     RM_DLL_API int RM_GetRoadSign(id_t road_id, unsigned int index, RM_RoadSign* road_sign);
 
+    /**
+    Look for road features (signals, objects, speed limit and lane count changes) ahead of the position, in order of distance.
+    Roads are followed through junctions along the route, if any, else straight ahead. Results are fetched by RM_GetRoadFeatureAhead.
+    @param handle Handle to the position object from which to look
+    @param lookahead_distance Max distance to look ahead
+    @param type_mask Bitmask of feature types to include, see RM_RoadFeature type. -1 for all.
+    @param max_count Max number of features to register, 0 for no limit
+    @return Number of features found, -1 on error
+    */
+    RM_DLL_API int RM_GetNumberOfRoadFeaturesAhead(int handle, float lookahead_distance, int type_mask, int max_count);
+
+    /**
+    Get information on a road feature found by the latest RM_GetNumberOfRoadFeaturesAhead call
+    @param handle Handle to the position object
+    @param index Index of the feature, in order of distance
+    @param road_feature Pointer/reference to a RM_RoadFeature struct to be filled in
+    @return 0 if successful, -1 if not
+    */
+    RM_DLL_API int RM_GetRoadFeatureAhead(int handle, unsigned int index, RM_RoadFeature* road_feature);
+
     /**
     Get the number of lane validity records of specified road object/sign
     @param road_id The road of which to look for the sign
@@ -1843,6 +1843,8 @@ std::string SE_Env::GetModelFilenameById(int model_id)
     return name;
 }
 
+thread_local SE_InstanceState* SE_Env::instance_state_ = nullptr;
+
 SE_Env& SE_Env::Inst()
 {
     static SE_Env instance_;
@@ -2158,6 +2160,344 @@ void SE_Mutex::Unlock()
 #endif
 }
 
+SE_ThreadPool::SE_ThreadPool(unsigned int n_threads)
+{
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+    (void)n_threads;
+    n_threads_ = 1;
+#else
+    n_threads_ = n_threads > 0 ? n_threads : MAX(1, std::thread::hardware_concurrency());
+
+    // calling thread will take part of the work, hence one less worker
+    for (unsigned int i = 0; i < n_threads_ - 1; i++)
+    {
+        workers_.emplace_back(&SE_ThreadPool::WorkerLoop, this);
+    }
+#endif
+}
+
+SE_ThreadPool::~SE_ThreadPool()
+{
+#if !(defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        quit_ = true;
+    }
+    cv_start_.notify_all();
+
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+#endif
+}
+
+void SE_ThreadPool::ParallelFor(size_t n, const std::function<void(size_t)>& func)
+{
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+    for (size_t i = 0; i < n; i++)
+    {
+        func(i);
+    }
+#else
+    if (n_threads_ < 2 || n < 2)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            func(i);
+        }
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        func_           = &func;
+        n_items_        = n;
+        next_item_      = 0;
+        n_busy_workers_ = static_cast<unsigned int>(workers_.size());
+        exception_      = nullptr;
+        job_id_++;
+    }
+    cv_start_.notify_all();
+
+    RunJob();
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_done_.wait(lock, [this]() { return n_busy_workers_ == 0; });
+    func_ = nullptr;
+
+    if (exception_)
+    {
+        std::rethrow_exception(exception_);
+    }
+#endif
+}
+
+#if !(defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+void SE_ThreadPool::RunJob()
+{
+    while (true)
+    {
+        size_t i;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            if (next_item_ >= n_items_)
+            {
+                return;
+            }
+            i = next_item_++;
+        }
+
+        try
+        {
+            (*func_)(i);
+        }
+        catch (...)
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            if (!exception_)
+            {
+                exception_ = std::current_exception();
+            }
+            next_item_ = n_items_;  // skip remaining work
+        }
+    }
+}
+
+void SE_ThreadPool::WorkerLoop()
+{
+    unsigned int last_job_id = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            cv_start_.wait(lock, [&]() { return quit_ || job_id_ != last_job_id; });
+            if (quit_)
+            {
+                return;
+            }
+            last_job_id = job_id_;
+        }
+
+        RunJob();
+
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            n_busy_workers_--;
+        }
+        cv_done_.notify_one();
+    }
+}
+#endif
+
+SE_TimeSeries::SE_TimeSeries(unsigned int n_channels, size_t capacity, unsigned int n_levels, unsigned int factor)
+    : n_channels_(n_channels),
+      factor_(MAX(2u, factor))
+{
+    // room for the bucket in progress of next level, see Read()
+    capacity_ = MAX(capacity, 2 * static_cast<size_t>(factor_));
+
+    for (unsigned int i = 0; i < MAX(1u, n_levels); i++)
+    {
+        levels_.push_back(std::make_unique<Level>(capacity_, 1 + (i == 0 ? 1 : 2) * n_channels_));
+        levels_.back()->acc_min.resize(n_channels_);
+        levels_.back()->acc_max.resize(n_channels_);
+    }
+}
+
+void SE_TimeSeries::Write(Level& level, float time, const float* min, const float* max)
+{
+    unsigned long long index = level.count.load(std::memory_order_relaxed);
+
+    // announce overwrite of the oldest entry before touching it, readers check this after copying
+    level.begun.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::atomic<float>* entry = &level.data[(index % capacity_) * level.stride];
+    entry[0].store(time, std::memory_order_relaxed);
+    for (unsigned int i = 0; i < n_channels_; i++)
+    {
+        entry[1 + i].store(min[i], std::memory_order_relaxed);
+    }
+    if (level.stride > 1 + n_channels_)
+    {
+        for (unsigned int i = 0; i < n_channels_; i++)
+        {
+            entry[1 + n_channels_ + i].store(max[i], std::memory_order_relaxed);
+        }
+    }
+
+    level.count.store(index + 1, std::memory_order_release);
+}
+
+void SE_TimeSeries::Add(float time, const float* values)
+{
+    Write(*levels_[0], time, values, values);
+
+    // merge into buckets of coarser levels, as long as buckets are completed
+    const float* min = values;
+    const float* max = values;
+    for (size_t i = 1; i < levels_.size(); i++)
+    {
+        Level& level = *levels_[i];
+        for (unsigned int j = 0; j < n_channels_; j++)
+        {
+            level.acc_min[j] = level.n_acc == 0 ? min[j] : MIN(level.acc_min[j], min[j]);
+            level.acc_max[j] = level.n_acc == 0 ? max[j] : MAX(level.acc_max[j], max[j]);
+        }
+        if (level.n_acc == 0)
+        {
+            level.acc_time = time;
+        }
+
+        if (++level.n_acc < factor_)
+        {
+            break;
+        }
+
+        Write(level, level.acc_time, level.acc_min.data(), level.acc_max.data());
+        level.n_acc = 0;
+        time        = level.acc_time;
+        min         = level.acc_min.data();
+        max         = level.acc_max.data();
+    }
+}
+
+unsigned long long SE_TimeSeries::FirstValid(const Level& level) const
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    unsigned long long begun = level.begun.load(std::memory_order_relaxed);
+    return begun > capacity_ ? begun - capacity_ : 0;
+}
+
+size_t SE_TimeSeries::Read(unsigned int level, unsigned int channel, float t_start, Samples& samples) const
+{
+    samples.time.clear();
+    samples.min.clear();
+    samples.max.clear();
+
+    if (level >= levels_.size() || channel >= n_channels_)
+    {
+        return 0;
+    }
+
+    // Start with requested level. Its last bucket is still in progress, so complete the series with the newer
+    // entries of finer levels, down to the latest raw sample.
+    unsigned long long first = 0;
+    for (int i = static_cast<int>(level); i >= 0; i--)
+    {
+        const Level&       l     = *levels_[static_cast<size_t>(i)];
+        unsigned long long count = l.count.load(std::memory_order_acquire);
+        unsigned int       max_i = l.stride > 1 + n_channels_ ? 1 + n_channels_ + channel : 1 + channel;
+
+        first = MAX(first, count > capacity_ ? count - capacity_ : 0);
+
+        // skip entries older than t_start
+        unsigned long long last = count;
+        while (first < last)
+        {
+            unsigned long long mid = first + (last - first) / 2;
+            if (l.data[(mid % capacity_) * l.stride].load(std::memory_order_relaxed) < t_start)
+            {
+                first = mid + 1;
+            }
+            else
+            {
+                last = mid;
+            }
+        }
+
+        size_t offset = samples.time.size();
+        for (unsigned long long j = first; j < count; j++)
+        {
+            const std::atomic<float>* entry = &l.data[(j % capacity_) * l.stride];
+            samples.time.push_back(entry[0].load(std::memory_order_relaxed));
+            samples.min.push_back(entry[1 + channel].load(std::memory_order_relaxed));
+            samples.max.push_back(entry[max_i].load(std::memory_order_relaxed));
+        }
+
+        // drop entries overwritten while copying
+        unsigned long long valid = FirstValid(l);
+        if (valid > first)
+        {
+            size_t n = static_cast<size_t>(MIN(valid, count) - first);
+            samples.time.erase(samples.time.begin() + static_cast<long>(offset), samples.time.begin() + static_cast<long>(offset + n));
+            samples.min.erase(samples.min.begin() + static_cast<long>(offset), samples.min.begin() + static_cast<long>(offset + n));
+            samples.max.erase(samples.max.begin() + static_cast<long>(offset), samples.max.begin() + static_cast<long>(offset + n));
+        }
+
+        // entries of next finer level not yet merged into this one
+        first = count * factor_;
+    }
+
+    return samples.time.size();
+}
+
+bool SE_TimeSeries::GetLatest(unsigned int channel, float& time, float& value) const
+{
+    const Level& l = *levels_[0];
+
+    if (channel >= n_channels_)
+    {
+        return false;
+    }
+
+    while (true)
+    {
+        unsigned long long count = l.count.load(std::memory_order_acquire);
+        if (count == 0)
+        {
+            return false;
+        }
+
+        const std::atomic<float>* entry = &l.data[((count - 1) % capacity_) * l.stride];
+        time                            = entry[0].load(std::memory_order_relaxed);
+        value                           = entry[1 + channel].load(std::memory_order_relaxed);
+
+        if (count - 1 >= FirstValid(l))
+        {
+            return true;
+        }
+    }
+}
+
+unsigned int SE_TimeSeries::SelectLevel(float t_start, float t_end, size_t max_entries) const
+{
+    for (unsigned int i = 0; i < levels_.size() - 1; i++)
+    {
+        const Level&       l     = *levels_[i];
+        unsigned long long count = l.count.load(std::memory_order_acquire);
+        if (count == 0)
+        {
+            return i;
+        }
+
+        // the oldest entry might be overwritten any moment, look at the next one
+        unsigned long long first    = count > capacity_ ? count - capacity_ + 1 : 0;
+        float              t_oldest = l.data[(first % capacity_) * l.stride].load(std::memory_order_relaxed);
+        float              t_newest = l.data[((count - 1) % capacity_) * l.stride].load(std::memory_order_relaxed);
+
+        if (count > capacity_ && t_oldest > t_start)
+        {
+            continue;  // history dropped, look for it on coarser levels
+        }
+
+        double n_entries = static_cast<double>(count - first);
+        if (t_newest > t_oldest)
+        {
+            n_entries *= MAX(0.0, MIN(t_end, t_newest) - MAX(t_start, t_oldest)) / (t_newest - t_oldest);
+        }
+
+        if (n_entries <= static_cast<double>(max_entries))
+        {
+            return i;
+        }
+    }
+
+    return static_cast<unsigned int>(levels_.size() - 1);
+}
+
 void SE_Option::Usage() const
 {
     std::string showMandatoryStr = isSingleValueOption_ ? "" : "...";
@@ -14,6 +14,7 @@
 
 #include "EnumConfig.hpp"
 
+#include <atomic>
 #include <vector>
 #include <random>
 #include <fstream>
@@ -21,8 +22,12 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <condition_variable>
+#include <exception>
+#include <functional>
 #include <cstring>
 #include <map>
+#include <memory>
+#include <stdexcept>
 #include <unordered_map>
 
 #ifndef _WIN32
@@ -870,6 +875,223 @@ private:
     bool flag;
 };
 
+// Simple pool of worker threads for data parallel work, e.g. independent per road calculations.
+// Workers are created once and then reused for each ParallelFor call. If threads are not supported
+// on the platform, or the pool has only one thread, the work is executed serially in the calling thread.
+class SE_ThreadPool
+{
+public:
+    // n_threads: number of threads including the calling one, 0 = number of hardware threads
+    SE_ThreadPool(unsigned int n_threads = 0);
+    ~SE_ThreadPool();
+
+    // Call func(i) for all i in [0, n) and wait for completion. Any exception thrown by func is rethrown.
+    void ParallelFor(size_t n, const std::function<void(size_t)>& func);
+
+    unsigned int GetNumberOfThreads() const
+    {
+        return n_threads_;
+    }
+
+private:
+    unsigned int n_threads_ = 1;
+#if !(defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+    void RunJob();
+    void WorkerLoop();
+
+    std::vector<std::thread>           workers_;
+    std::mutex                         mtx_;
+    std::condition_variable            cv_start_;
+    std::condition_variable            cv_done_;
+    const std::function<void(size_t)>* func_           = nullptr;
+    size_t                             n_items_        = 0;
+    size_t                             next_item_      = 0;
+    unsigned int                       n_busy_workers_ = 0;
+    unsigned int                       job_id_         = 0;
+    bool                               quit_           = false;
+    std::exception_ptr                 exception_;
+#endif
+};
+
+// Unbounded queue for passing data from any number of threads to one consumer thread, e.g. from network receivers to the
+// simulation thread. Based on D. Vyukov's node based MPSC queue: Push() takes no lock and never waits, it's a single atomic
+// exchange (plus allocation of a node). Pop() must only be called from one thread at a time.
+template <typename T>
+class SE_MPSCQueue
+{
+public:
+    SE_MPSCQueue() : head_(&stub_), tail_(&stub_)
+    {
+    }
+
+    ~SE_MPSCQueue()
+    {
+        T value;
+        while (Pop(value))
+        {
+        }
+        if (tail_ != &stub_)
+        {
+            delete tail_;
+        }
+    }
+
+    SE_MPSCQueue(const SE_MPSCQueue&)            = delete;
+    SE_MPSCQueue& operator=(const SE_MPSCQueue&) = delete;
+
+    void Push(T value)
+    {
+        Node* node = new Node(std::move(value));
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /**
+    Take the oldest element
+    @param value Receives the element
+    @return true if an element was taken, false if empty. An element being pushed concurrently might be left for next call.
+    */
+    bool Pop(T& value)
+    {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+            return false;
+        }
+
+        // next becomes the new stub, its value is no longer needed
+        value = std::move(next->value);
+        tail_ = next;
+        if (tail != &stub_)
+        {
+            delete tail;
+        }
+
+        return true;
+    }
+
+private:
+    struct Node
+    {
+        Node() = default;
+        Node(T v) : value(std::move(v))
+        {
+        }
+        T                  value;
+        std::atomic<Node*> next{nullptr};
+    };
+
+    Node               stub_;
+    std::atomic<Node*> head_;  // last pushed node, producers side
+    Node*              tail_;  // consumed node preceding the oldest element, consumer side
+};
+
+// Bounded store of sampled signals, e.g. object speed over time for plotting or telemetry. Memory is allocated once.
+// Level 0 keeps the latest raw samples in a ring buffer. Each following level keeps min and max of buckets of
+// 'factor' samples of the level below, covering a 'factor' times longer history at lower resolution.
+// One thread may add samples while any number of threads read, no locks involved. Readers copy data and then discard
+// any part overwritten meanwhile, so a reader never blocks the writer.
+class SE_TimeSeries
+{
+public:
+    struct Samples
+    {
+        std::vector<float> time;
+        std::vector<float> min;
+        std::vector<float> max;  // same as min on level 0
+    };
+
+    /**
+    @param n_channels Number of signals per sample
+    @param capacity Max number of entries kept on each level
+    @param n_levels Number of resolution levels, including the raw one
+    @param factor Number of entries merged into one entry of next level
+    */
+    SE_TimeSeries(unsigned int n_channels, size_t capacity = 4096, unsigned int n_levels = 4, unsigned int factor = 8);
+
+    SE_TimeSeries(const SE_TimeSeries&)            = delete;
+    SE_TimeSeries& operator=(const SE_TimeSeries&) = delete;
+
+    /**
+    Add a sample. Writer thread only. Time is expected not to decrease.
+    @param time Timestamp of the sample
+    @param values One value per channel
+    */
+    void Add(float time, const float* values);
+
+    /**
+    Copy entries with timestamp >= t_start from given level
+    @param level Resolution level, 0 is raw samples
+    @param channel Signal index
+    @param t_start Earliest timestamp of interest, older entries are skipped
+    @param samples Receives the entries, oldest first
+    @return Number of entries copied
+    */
+    size_t Read(unsigned int level, unsigned int channel, float t_start, Samples& samples) const;
+
+    /**
+    Get most recent raw value of a channel
+    @return true if any sample has been added, else false
+    */
+    bool GetLatest(unsigned int channel, float& time, float& value) const;
+
+    /**
+    Find the finest level holding the range [t_start, t_end] in at most max_entries entries. If the raw samples
+    don't reach back to t_start, coarser levels are used where history is longer.
+    */
+    unsigned int SelectLevel(float t_start, float t_end, size_t max_entries) const;
+
+    unsigned int GetNumberOfChannels() const
+    {
+        return n_channels_;
+    }
+
+    unsigned int GetNumberOfLevels() const
+    {
+        return static_cast<unsigned int>(levels_.size());
+    }
+
+    size_t GetCapacity() const
+    {
+        return capacity_;
+    }
+
+    // Total number of samples added
+    unsigned long long GetNumberOfSamples() const
+    {
+        return levels_[0]->count.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Level
+    {
+        Level(size_t capacity, unsigned int entry_size) : data(new std::atomic<float>[capacity * entry_size]), stride(entry_size)
+        {
+        }
+        std::unique_ptr<std::atomic<float>[]> data;  // per entry: time, min values, max values (not on level 0)
+        unsigned int                          stride;
+        std::atomic<unsigned long long>       count{0};  // number of completed entries
+        std::atomic<unsigned long long>       begun{0};  // number of entries started, overwriting the oldest one
+
+        // bucket in progress, writer only
+        unsigned int       n_acc = 0;
+        float              acc_time;
+        std::vector<float> acc_min;
+        std::vector<float> acc_max;
+    };
+
+    void Write(Level& level, float time, const float* min, const float* max);
+
+    // Oldest index still valid after having read count entries from level
+    unsigned long long FirstValid(const Level& level) const;
+
+    unsigned int                        n_channels_;
+    size_t                              capacity_;
+    unsigned int                        factor_;
+    std::vector<std::unique_ptr<Level>> levels_;
+};
+
 // Converts string to bool pair, first is set if value is bool and second is value of conversion
 // caller should check first before using second. This function will take:
 // true, True, TRUE as true
@@ -1359,6 +1581,108 @@ private:
     std::mt19937 gen_;
 };
 
+// Sequential in-memory store of runtime state, used for checkpoint and restore of a running simulation.
+// Each module provides a SyncState(SE_StateBuffer&) function which is used for both directions: In store mode
+// every synced value is copied into the buffer, in restore mode the values are copied back in the same order.
+// Hence the traversal must only depend on state that has already been synced at the time of branching.
+class SE_StateBuffer
+{
+public:
+    enum class Mode
+    {
+        STORE,
+        RESTORE
+    };
+
+    void BeginStore()
+    {
+        mode_  = Mode::STORE;
+        index_ = 0;
+        entries_.clear();
+        unsupported_.clear();
+    }
+
+    void BeginRestore()
+    {
+        mode_  = Mode::RESTORE;
+        index_ = 0;
+    }
+
+    bool IsRestoring() const
+    {
+        return mode_ == Mode::RESTORE;
+    }
+
+    // Store a copy of value, or restore value from the buffer. Throws std::runtime_error on traversal mismatch.
+    template <class T>
+    void Sync(T& value)
+    {
+        if (mode_ == Mode::STORE)
+        {
+            entries_.push_back(std::make_unique<Entry<T>>(value));
+            return;
+        }
+
+        Entry<T>* entry = index_ < entries_.size() ? dynamic_cast<Entry<T>*>(entries_[index_].get()) : nullptr;
+        if (entry == nullptr)
+        {
+            throw std::runtime_error("State buffer mismatch at entry " + std::to_string(index_));
+        }
+        value = entry->value_;
+        index_++;
+    }
+
+    // Register an element which runtime state can't be captured, making the stored state unusable for restore
+    void AddUnsupported(const std::string& element)
+    {
+        if (mode_ == Mode::STORE)
+        {
+            unsupported_.push_back(element);
+        }
+    }
+
+    const std::vector<std::string>& GetUnsupported() const
+    {
+        return unsupported_;
+    }
+
+    size_t GetNumberOfEntries() const
+    {
+        return entries_.size();
+    }
+
+private:
+    struct EntryBase
+    {
+        virtual ~EntryBase() = default;
+    };
+
+    template <class T>
+    struct Entry : public EntryBase
+    {
+        explicit Entry(const T& value) : value_(value)
+        {
+        }
+        T value_;
+    };
+
+    Mode                                    mode_  = Mode::STORE;
+    size_t                                  index_ = 0;
+    std::vector<std::unique_ptr<EntryBase>> entries_;
+    std::vector<std::string>                unsupported_;
+};
+
+// State of SE_Env that belongs to one scenario rather than to the process. Normally there is only one scenario and
+// SE_Env holds the state itself. When several scenario engines run side by side, e.g. in ScenarioBatch, each one has
+// its own and selects it for the calling thread by SE_Env::SetInstanceState() while being initialized or stepped.
+struct SE_InstanceState
+{
+    SE_Rand       rand;
+    GhostMode     ghost_mode      = GhostMode::NORMAL;
+    double        ghost_headstart = 0.0;
+    const double* sim_time        = nullptr;  // scenario time of log messages, overriding the one of the logger
+};
+
 class SE_Env
 {
 public:
@@ -1370,8 +1694,6 @@ public:
           oscFilePath_(""),
           collisionDetection_(false),
           saveImagesToRAM_(false),
-          ghost_mode_(GhostMode::NORMAL),
-          ghost_headstart_(0.0),
           osiTimeStamp_(OSI_TIMESTAMP_UNDEFINED)
     {
     }
@@ -1484,27 +1806,51 @@ public:
 
     SE_Rand& GetRand()
     {
-        return rand_;
+        return GetInstanceState().rand;
     }
 
     GhostMode GetGhostMode() const
     {
-        return ghost_mode_;
+        return GetInstanceState().ghost_mode;
     }
 
     void SetGhostMode(GhostMode mode)
     {
-        ghost_mode_ = mode;
+        GetInstanceState().ghost_mode = mode;
     }
 
     double GetGhostHeadstart(void) const
     {
-        return ghost_headstart_;
+        return GetInstanceState().ghost_headstart;
     }
 
     void SetGhostHeadstart(double headstart_time)
     {
-        ghost_headstart_ = headstart_time;
+        GetInstanceState().ghost_headstart = headstart_time;
+    }
+
+    /**
+    Select scenario specific state (random generator, ghost mode) for the calling thread
+    @param state State to use, nullptr to return to the one of SE_Env
+    */
+    void SetInstanceState(SE_InstanceState* state)
+    {
+        instance_state_ = state;
+    }
+
+    bool HasInstanceState() const
+    {
+        return instance_state_ != nullptr;
+    }
+
+    SE_InstanceState& GetInstanceState()
+    {
+        return instance_state_ != nullptr ? *instance_state_ : state_;
+    }
+
+    const SE_InstanceState& GetInstanceState() const
+    {
+        return instance_state_ != nullptr ? *instance_state_ : state_;
     }
 
     SE_Options& GetOptions()
@@ -1519,14 +1865,14 @@ private:
     std::string                exeFilePath_;  // path to executable or library
     std::string                oscFilePath_;  // resolved osc file path
     SE_SystemTime              systemTime_;
-    SE_Rand                    rand_;
+    SE_InstanceState           state_;
     bool                       collisionDetection_;
     bool                       saveImagesToRAM_;
     std::map<int, std::string> entity_model_map_;
-    GhostMode                  ghost_mode_;
-    double                     ghost_headstart_;
     SE_Options                 opt;
     unsigned long long         osiTimeStamp_;
+
+    static thread_local SE_InstanceState* instance_state_;  // see SetInstanceState()
 };
 
 /**
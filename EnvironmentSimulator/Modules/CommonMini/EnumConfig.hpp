@@ -104,6 +104,19 @@ namespace esmini_options
         VEHICLE_DYNAMICS,                // 93
         WIREFRAME,                       // 94
         VIEW_GHOST_RESTART,              // 95
+        OSI_LAZY_ROADMARKS,              // 96
+        OSI_POINT_THREADS,               // 97
+        PROFILE,                         // 98
+        PROFILE_TRACE,                   // 99
+        ROAD_MODEL_CACHE,                // 100
+        RECORD_FORMAT,                   // 101
+        SWARM_LOD_RADIUS,                // 102
+        GHOST_TRAIL_RETENTION,           // 103
+        SHM,                             // 104
+        SHM_OSI,                         // 105
+        OSI_TRAJ_HORIZON,                // 106
+        OSI_TRAJ_DT,                     // 107
+        OSI_TRAJ_THREADS,                // 108
         CONFIGS_COUNT                    // this must be the last enum value
     };
 
@@ -203,7 +216,20 @@ namespace esmini_options
         {"hide_ghost", HIDE_GHOST},
         {"ghost_trail_dt", GHOST_TRAIL_DT},
         {"wireframe", WIREFRAME},
-        {"view_ghost_restart", VIEW_GHOST_RESTART}};
+        {"view_ghost_restart", VIEW_GHOST_RESTART},
+        {"osi_lazy_roadmarks", OSI_LAZY_ROADMARKS},
+        {"osi_point_threads", OSI_POINT_THREADS},
+        {"profile", PROFILE},
+        {"profile_trace", PROFILE_TRACE},
+        {"road_model_cache", ROAD_MODEL_CACHE},
+        {"record_format", RECORD_FORMAT},
+        {"swarm_lod_radius", SWARM_LOD_RADIUS},
+        {"ghost_trail_retention", GHOST_TRAIL_RETENTION},
+        {"shm", SHM},
+        {"shm_osi", SHM_OSI},
+        {"osi_traj_horizon", OSI_TRAJ_HORIZON},
+        {"osi_traj_dt", OSI_TRAJ_DT},
+        {"osi_traj_threads", OSI_TRAJ_THREADS}};
 
     CONFIG_ENUM ConvertStrKeyToEnum(const std::string& key);
 }  // namespace esmini_options
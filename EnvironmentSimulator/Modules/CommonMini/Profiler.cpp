@@ -0,0 +1,236 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include "Profiler.hpp"
+#include "CommonMini.hpp"
+#include "logger.hpp"
+
+#include <fstream>
+#include <thread>
+#include <algorithm>
+
+#define PROFILER_MAX_TRACE_EVENTS 1000000  // limit memory, about 24 MB
+
+SE_Profiler& SE_Profiler::Inst()
+{
+    static SE_Profiler instance;
+    return instance;
+}
+
+SE_Profiler::SE_Profiler() : epoch_(std::chrono::steady_clock::now())
+{
+}
+
+void SE_Profiler::SetLevel(Level level)
+{
+    if (level_ == Level::OFF && level != Level::OFF)
+    {
+        Reset();
+    }
+    level_ = level;
+}
+
+int SE_Profiler::RegisterScope(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = scope_ids_.find(name);
+    if (it != scope_ids_.end())
+    {
+        return it->second;
+    }
+
+    Entry entry{};
+    entry.name = name;
+    entry.min  = LARGE_NUMBER;
+    entries_.push_back(entry);
+    scope_ids_[name] = static_cast<int>(entries_.size()) - 1;
+
+    return static_cast<int>(entries_.size()) - 1;
+}
+
+void SE_Profiler::Record(int id, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    double   duration    = std::chrono::duration<double>(end - start).count();
+    uint64_t duration_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+
+    // bucket i covers [2^i, 2^(i+1)) microseconds, first one also including 0
+    int bucket = 0;
+    while (bucket < PROFILER_HISTOGRAM_SIZE - 1 && duration_us >= (2ULL << bucket))
+    {
+        bucket++;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Entry& entry = entries_[static_cast<size_t>(id)];
+    entry.count++;
+    entry.total += duration;
+    entry.last = duration;
+    entry.min  = MIN(entry.min, duration);
+    entry.max  = MAX(entry.max, duration);
+    entry.histogram[bucket]++;
+
+    if (trace_enabled_)
+    {
+        if (events_.size() < PROFILER_MAX_TRACE_EVENTS)
+        {
+            size_t thread_hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+            auto   thread_it   = std::find(threads_.begin(), threads_.end(), thread_hash);
+            if (thread_it == threads_.end())
+            {
+                thread_it = threads_.insert(threads_.end(), thread_hash);
+            }
+
+            Event event;
+            event.id       = id;
+            event.thread   = static_cast<int>(thread_it - threads_.begin());
+            event.start    = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(start - epoch_).count());
+            event.duration = duration_us;
+            events_.push_back(event);
+        }
+        else if (!trace_full_)
+        {
+            LOG_WARN("Profiler: Max number of trace events ({}) reached, skipping the rest", PROFILER_MAX_TRACE_EVENTS);
+            trace_full_ = true;
+        }
+    }
+}
+
+int SE_Profiler::GetNumberOfEntries()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(entries_.size());
+}
+
+int SE_Profiler::GetEntry(int index, Entry& entry)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (index < 0 || index >= static_cast<int>(entries_.size()))
+    {
+        return -1;
+    }
+
+    entry = entries_[static_cast<size_t>(index)];
+
+    return 0;
+}
+
+double SE_Profiler::GetPercentile(const Entry& entry, double percentile)
+{
+    if (entry.count == 0)
+    {
+        return 0.0;
+    }
+
+    double       threshold = CLAMP(percentile, 0.0, 100.0) * 0.01 * entry.count;
+    unsigned int sum       = 0;
+
+    for (int i = 0; i < PROFILER_HISTOGRAM_SIZE - 1; i++)
+    {
+        sum += entry.histogram[i];
+        if (sum >= threshold)
+        {
+            return MIN(1e-6 * static_cast<double>(2ULL << i), entry.max);
+        }
+    }
+
+    return entry.max;
+}
+
+void SE_Profiler::LogSummary()
+{
+    std::vector<Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries = entries_;
+    }
+
+    LOG_INFO("Frame profile (times in ms, percentiles estimated from log2 histogram):");
+    LOG_INFO("{:<40} {:>8} {:>10} {:>8} {:>8} {:>8} {:>8} {:>8}", "scope", "count", "total", "avg", "min", "p50", "p95", "max");
+    for (auto& entry : entries)
+    {
+        if (entry.count == 0)
+        {
+            continue;
+        }
+        LOG_INFO("{:<40} {:>8} {:>10.2f} {:>8.3f} {:>8.3f} {:>8.3f} {:>8.3f} {:>8.3f}",
+                 entry.name,
+                 entry.count,
+                 1e3 * entry.total,
+                 1e3 * entry.total / entry.count,
+                 1e3 * entry.min,
+                 1e3 * GetPercentile(entry, 50.0),
+                 1e3 * GetPercentile(entry, 95.0),
+                 1e3 * entry.max);
+    }
+}
+
+int SE_Profiler::WriteTrace(const std::string& filename)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        LOG_ERROR("Profiler: Failed to open trace file {}", filename);
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // escape any special characters in scope names once
+    std::vector<std::string> names;
+    for (auto& entry : entries_)
+    {
+        std::string name;
+        for (char c : entry.name)
+        {
+            if (c == '"' || c == '\\')
+            {
+                name += '\\';
+            }
+            name += c;
+        }
+        names.push_back(name);
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (auto& event : events_)
+    {
+        file << (first ? "\n" : ",\n") << "{\"name\":\"" << names[static_cast<size_t>(event.id)] << "\",\"cat\":\"esmini\",\"ph\":\"X\"";
+        file << ",\"ts\":" << event.start << ",\"dur\":" << event.duration << ",\"pid\":0,\"tid\":" << event.thread << "}";
+        first = false;
+    }
+    file << "\n]}\n";
+
+    LOG_INFO("Profiler: Wrote {} trace events to {}", events_.size(), filename);
+
+    return 0;
+}
+
+void SE_Profiler::Reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& entry : entries_)
+    {
+        std::string name = entry.name;
+        entry            = Entry{};
+        entry.name       = name;
+        entry.min        = LARGE_NUMBER;
+    }
+    events_.clear();
+    threads_.clear();
+    trace_full_ = false;
+    epoch_      = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,179 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+#define PROFILER_HISTOGRAM_SIZE 16  // log2 buckets of microseconds: [0,2), [2,4), [4,8) ... [32768, inf)
+
+// Built-in frame profiler, measuring time spent in each phase of the frame by means of scoped timers (see SE_ProfileScope).
+// Measurements are aggregated per scope name into totals and histograms, optionally kept as events for Chrome trace export.
+// When disabled (default) a timer costs one check of the level.
+class SE_Profiler
+{
+public:
+    enum class Level
+    {
+        OFF    = 0,
+        PHASES = 1,  // main phases of the frame, e.g. storyboard, controllers, OSI
+        ALL    = 2   // phases plus individual controller and condition types
+    };
+
+    typedef struct
+    {
+        std::string  name;
+        unsigned int count;  // number of measurements
+        double       total;  // accumulated time (s)
+        double       min;    // shortest measurement (s)
+        double       max;    // longest measurement (s)
+        double       last;   // latest measurement (s)
+        unsigned int histogram[PROFILER_HISTOGRAM_SIZE];
+    } Entry;
+
+    static SE_Profiler& Inst();
+
+    void  SetLevel(Level level);
+    Level GetLevel() const
+    {
+        return level_;
+    }
+    bool IsEnabled(Level level = Level::PHASES) const
+    {
+        return level_ != Level::OFF && level_ >= level;
+    }
+
+    /**
+    Keep each measurement as an event, for later export by WriteTrace()
+    */
+    void SetTraceEnabled(bool enabled)
+    {
+        trace_enabled_ = enabled;
+    }
+
+    /**
+    Look up scope by name, register it if not already existing
+    @return Scope id used for Record()
+    */
+    int  RegisterScope(const std::string& name);
+    void Record(int id, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    int GetNumberOfEntries();
+
+    /**
+    Get a copy of aggregated measurements of specified scope
+    @return 0 on success, -1 if index out of range
+    */
+    int GetEntry(int index, Entry& entry);
+
+    /**
+    Estimate given percentile of measurements based on the histogram
+    @param entry Aggregated measurements
+    @param percentile 0..100
+    @return upper bound of the histogram bucket containing the percentile (s)
+    */
+    static double GetPercentile(const Entry& entry, double percentile);
+
+    void LogSummary();
+
+    /**
+    Write events in Chrome trace JSON format, to be viewed in e.g. chrome://tracing or Perfetto
+    @return 0 on success, -1 on failure
+    */
+    int WriteTrace(const std::string& filename);
+
+    /**
+    Discard all measurements and events, keep registered scopes
+    */
+    void Reset();
+
+private:
+    typedef struct
+    {
+        int      id;
+        int      thread;
+        uint64_t start;     // microseconds since profiler reset
+        uint64_t duration;  // microseconds
+    } Event;
+
+    SE_Profiler();
+
+    Level                                 level_         = Level::OFF;
+    bool                                  trace_enabled_ = false;
+    bool                                  trace_full_    = false;
+    std::chrono::steady_clock::time_point epoch_;
+    std::vector<Entry>                    entries_;
+    std::unordered_map<std::string, int>  scope_ids_;
+    std::vector<Event>                    events_;
+    std::vector<size_t>                   threads_;  // hashed thread ids, index is used as tid in the trace
+    std::mutex                            mutex_;
+};
+
+// Measure time from construction to end of scope. Nothing is measured if profiler level is lower than specified.
+class SE_ProfileScope
+{
+public:
+    // For fixed scopes, id registered once, see SE_PROFILE_SCOPE
+    SE_ProfileScope(int id, SE_Profiler::Level level = SE_Profiler::Level::PHASES)
+    {
+        if (SE_Profiler::Inst().IsEnabled(level))
+        {
+            id_    = id;
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    // For scopes of varying name, e.g. controller type. Name looked up only when enabled.
+    SE_ProfileScope(SE_Profiler::Level level, const char* name)
+    {
+        if (SE_Profiler::Inst().IsEnabled(level))
+        {
+            id_    = SE_Profiler::Inst().RegisterScope(name);
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~SE_ProfileScope()
+    {
+        Stop();
+    }
+
+    // Record measurement before end of scope, e.g. to time only first part of a function
+    void Stop()
+    {
+        if (id_ >= 0)
+        {
+            SE_Profiler::Inst().Record(id_, start_, std::chrono::steady_clock::now());
+            id_ = -1;
+        }
+    }
+
+    SE_ProfileScope(const SE_ProfileScope&)            = delete;
+    SE_ProfileScope& operator=(const SE_ProfileScope&) = delete;
+
+private:
+    int                                   id_ = -1;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#define SE_PROFILE_CONCAT_(a, b) a##b
+#define SE_PROFILE_CONCAT(a, b)  SE_PROFILE_CONCAT_(a, b)
+
+// Time the rest of current scope under given name, e.g. SE_PROFILE_SCOPE("Storyboard")
+#define SE_PROFILE_SCOPE(name)                                                                              \
+    static const int SE_PROFILE_CONCAT(se_profile_id_, __LINE__) = SE_Profiler::Inst().RegisterScope(name); \
+    SE_ProfileScope  SE_PROFILE_CONCAT(se_profile_scope_, __LINE__)(SE_PROFILE_CONCAT(se_profile_id_, __LINE__))
@@ -0,0 +1,514 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// World state published in POSIX shared memory, for clients on the same host, e.g. visualization or co-simulated models.
+// Compared to OSI over UDP there is no serialization, no socket and no fragmentation, a frame is read in place by the client.
+//
+// The shared memory holds a header followed by a ring of slots, one frame per slot: entity states and optional raw OSI ground truth.
+// Each slot is protected by a sequence lock. The writer makes the sequence number odd while writing and even when done, a reader
+// retries if the number was odd or changed during its read. The writer never waits for readers, and a reader has n_slots - 1
+// frames of time before the frame it reads is overwritten.
+//
+// This header does not depend on any other esmini code, clients can include it as is. Not available on Windows.
+
+#define SHARED_STATE_MAGIC                0x4D485345  // "ESHM"
+#define SHARED_STATE_VERSION              1
+#define SHARED_STATE_NAME_SIZE            32
+#define SHARED_STATE_ALIGNMENT            64
+#define SHARED_STATE_DEFAULT_NAME         "/esmini"
+#define SHARED_STATE_DEFAULT_SLOTS        4
+#define SHARED_STATE_DEFAULT_MAX_ENTITIES 1024
+#define SHARED_STATE_DEFAULT_MAX_OSI_KB   4096
+
+#define SHARED_STATE_FLAG_ENTITIES_TRUNCATED 1  // more entities than capacity, the ones exceeding are left out
+#define SHARED_STATE_FLAG_OSI_TRUNCATED      2  // OSI data larger than capacity, left out
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared state requires lock free 64 bit atomics");
+
+// State of one entity, plain data of fixed size types
+struct SE_SharedEntityState
+{
+    int32_t  id;
+    int32_t  obj_type;
+    int32_t  obj_category;
+    int32_t  ctrl_type;
+    int32_t  visibility_mask;
+    int32_t  lane_id;
+    uint32_t road_id;
+    uint32_t junction_id;
+    double   x;
+    double   y;
+    double   z;
+    double   h;
+    double   p;
+    double   r;
+    double   vel_x;
+    double   vel_y;
+    double   vel_z;
+    double   acc_x;
+    double   acc_y;
+    double   acc_z;
+    double   h_rate;
+    double   speed;
+    double   s;
+    double   t;
+    double   lane_offset;
+    double   wheel_angle;
+    double   wheel_rot;
+    float    bb_x;  // bounding box center, relative reference point
+    float    bb_y;
+    float    bb_z;
+    float    bb_length;
+    float    bb_width;
+    float    bb_height;
+    char     name[SHARED_STATE_NAME_SIZE];  // null terminated, truncated if longer
+};
+
+struct SE_SharedStateHeader
+{
+    uint32_t              magic;  // SHARED_STATE_MAGIC when initialized
+    uint32_t              version;
+    uint32_t              n_slots;
+    uint32_t              max_entities;
+    uint64_t              max_osi_size;  // bytes per frame
+    uint64_t              slot_size;     // bytes, including slot header
+    std::atomic<uint64_t> n_frames;      // number of published frames, the latest one in slot (n_frames - 1) % n_slots
+};
+
+struct SE_SharedStateSlot
+{
+    std::atomic<uint64_t> seq;    // sequence lock, odd while being written
+    uint64_t              frame;  // frame number, counting from 0
+    double                time;   // simulation time
+    uint32_t              n_entities;
+    uint32_t              flags;     // SHARED_STATE_FLAG_...
+    uint64_t              osi_size;  // bytes of OSI ground truth, 0 if none
+};
+
+// View of a frame in shared memory, see SE_SharedStateReader::ReadLatest()
+struct SE_SharedFrame
+{
+    uint64_t                    frame;
+    double                      time;
+    uint32_t                    n_entities;
+    uint32_t                    flags;
+    const SE_SharedEntityState* entities;
+    uint64_t                    osi_size;
+    const char*                 osi;
+};
+
+// Frame copied out of shared memory, see SE_SharedStateReader::CopyLatest()
+struct SE_SharedFrameCopy
+{
+    uint64_t                          frame = 0;
+    double                            time  = 0.0;
+    uint32_t                          flags = 0;
+    std::vector<SE_SharedEntityState> entities;
+    std::vector<char>                 osi;
+};
+
+inline size_t SharedStateAlign(size_t size)
+{
+    return (size + SHARED_STATE_ALIGNMENT - 1) / SHARED_STATE_ALIGNMENT * SHARED_STATE_ALIGNMENT;
+}
+
+inline size_t SharedStateSlotSize(uint32_t max_entities, uint64_t max_osi_size)
+{
+    return SharedStateAlign(SharedStateAlign(sizeof(SE_SharedStateSlot)) + max_entities * sizeof(SE_SharedEntityState) + max_osi_size);
+}
+
+inline size_t SharedStateSize(const SE_SharedStateHeader* header)
+{
+    return SharedStateAlign(sizeof(SE_SharedStateHeader)) + header->n_slots * header->slot_size;
+}
+
+inline SE_SharedStateSlot* SharedStateSlot(SE_SharedStateHeader* header, uint64_t idx)
+{
+    return reinterpret_cast<SE_SharedStateSlot*>(reinterpret_cast<char*>(header) + SharedStateAlign(sizeof(SE_SharedStateHeader)) +
+                                                 (idx % header->n_slots) * header->slot_size);
+}
+
+inline SE_SharedEntityState* SharedStateEntities(SE_SharedStateSlot* slot)
+{
+    return reinterpret_cast<SE_SharedEntityState*>(reinterpret_cast<char*>(slot) + SharedStateAlign(sizeof(SE_SharedStateSlot)));
+}
+
+inline char* SharedStateOSI(SE_SharedStateHeader* header, SE_SharedStateSlot* slot)
+{
+    return reinterpret_cast<char*>(SharedStateEntities(slot) + header->max_entities);
+}
+
+// Creates the shared memory object and publishes frames into it. One writer per shared memory object.
+class SE_SharedStateWriter
+{
+public:
+    SE_SharedStateWriter() = default;
+    ~SE_SharedStateWriter()
+    {
+        Close();
+    }
+    SE_SharedStateWriter(const SE_SharedStateWriter&)            = delete;
+    SE_SharedStateWriter& operator=(const SE_SharedStateWriter&) = delete;
+
+    /**
+    Create the shared memory object, replacing any existing one with the same name, and map it
+    @param name Name of the shared memory object, e.g. "/esmini"
+    @param max_entities Max number of entities per frame
+    @param max_osi_size Max size of OSI data per frame in bytes, 0 for no OSI
+    @param n_slots Number of frames in the ring, at least 2
+    @return 0 on success, -1 on failure
+    */
+    int Open(const std::string& name, uint32_t max_entities, uint64_t max_osi_size = 0, uint32_t n_slots = SHARED_STATE_DEFAULT_SLOTS)
+    {
+        Close();
+
+#ifdef _WIN32
+        (void)name;
+        (void)max_entities;
+        (void)max_osi_size;
+        (void)n_slots;
+        return -1;
+#else
+        if (max_entities == 0 || n_slots < 2)
+        {
+            return -1;
+        }
+
+        // Start from a new object, clients still mapping a previous one keep it until they close
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0)
+        {
+            return -1;
+        }
+
+        size_t slot_size = SharedStateSlotSize(max_entities, max_osi_size);
+        size_t size      = SharedStateAlign(sizeof(SE_SharedStateHeader)) + n_slots * slot_size;
+        void*  mem       = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+        {
+            mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+
+        if (mem == MAP_FAILED)
+        {
+            shm_unlink(name.c_str());
+            return -1;
+        }
+
+        // Memory is zero filled by ftruncate, construct the atomics in place
+        header_               = new (mem) SE_SharedStateHeader();
+        header_->version      = SHARED_STATE_VERSION;
+        header_->n_slots      = n_slots;
+        header_->max_entities = max_entities;
+        header_->max_osi_size = max_osi_size;
+        header_->slot_size    = slot_size;
+        for (uint32_t i = 0; i < n_slots; i++)
+        {
+            new (SharedStateSlot(header_, i)) SE_SharedStateSlot();
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        header_->magic = SHARED_STATE_MAGIC;
+
+        name_ = name;
+        size_ = size;
+
+        return 0;
+#endif
+    }
+
+    // Unmap and remove the shared memory object
+    void Close()
+    {
+#ifndef _WIN32
+        if (header_ != nullptr)
+        {
+            munmap(header_, size_);
+            shm_unlink(name_.c_str());
+        }
+#endif
+        header_ = nullptr;
+        slot_   = nullptr;
+        size_   = 0;
+        name_.clear();
+    }
+
+    bool IsOpen() const
+    {
+        return header_ != nullptr;
+    }
+
+    uint32_t GetMaxEntities() const
+    {
+        return header_ != nullptr ? header_->max_entities : 0;
+    }
+
+    uint64_t GetMaxOSISize() const
+    {
+        return header_ != nullptr ? header_->max_osi_size : 0;
+    }
+
+    /**
+    Start writing the next frame. Fill in the entity states directly in shared memory, then publish by EndFrame()
+    @param time Simulation time of the frame
+    @return Entity array of GetMaxEntities() elements, or nullptr if not open
+    */
+    SE_SharedEntityState* BeginFrame(double time)
+    {
+        if (header_ == nullptr)
+        {
+            return nullptr;
+        }
+
+        uint64_t frame = header_->n_frames.load(std::memory_order_relaxed);
+        slot_          = SharedStateSlot(header_, frame);
+        slot_->seq.store(2 * frame + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot_->frame = frame;
+        slot_->time  = time;
+
+        return SharedStateEntities(slot_);
+    }
+
+    /**
+    Publish the frame started by BeginFrame()
+    @param n_entities Number of entity states filled in, capped to GetMaxEntities()
+    @param osi Serialized OSI ground truth, or nullptr
+    @param osi_size Size of OSI data in bytes, left out if larger than GetMaxOSISize()
+    */
+    void EndFrame(uint32_t n_entities, const char* osi = nullptr, uint64_t osi_size = 0)
+    {
+        if (slot_ == nullptr)
+        {
+            return;
+        }
+
+        slot_->flags = 0;
+        if (n_entities > header_->max_entities)
+        {
+            n_entities = header_->max_entities;
+            slot_->flags |= SHARED_STATE_FLAG_ENTITIES_TRUNCATED;
+        }
+        if (osi == nullptr || osi_size > header_->max_osi_size)
+        {
+            slot_->flags |= osi_size > 0 ? SHARED_STATE_FLAG_OSI_TRUNCATED : 0;
+            osi_size = 0;
+        }
+        else
+        {
+            memcpy(SharedStateOSI(header_, slot_), osi, osi_size);
+        }
+        slot_->n_entities = n_entities;
+        slot_->osi_size   = osi_size;
+
+        slot_->seq.store(2 * slot_->frame + 2, std::memory_order_release);
+        header_->n_frames.store(slot_->frame + 1, std::memory_order_release);
+        slot_ = nullptr;
+    }
+
+    uint64_t GetFrameCount() const
+    {
+        return header_ != nullptr ? header_->n_frames.load(std::memory_order_relaxed) : 0;
+    }
+
+private:
+    SE_SharedStateHeader* header_ = nullptr;
+    SE_SharedStateSlot*   slot_   = nullptr;  // slot being written, between BeginFrame() and EndFrame()
+    size_t                size_   = 0;
+    std::string           name_;
+};
+
+// Maps a shared memory object created by SE_SharedStateWriter, read only. Any number of readers per object.
+class SE_SharedStateReader
+{
+public:
+    SE_SharedStateReader() = default;
+    ~SE_SharedStateReader()
+    {
+        Close();
+    }
+    SE_SharedStateReader(const SE_SharedStateReader&)            = delete;
+    SE_SharedStateReader& operator=(const SE_SharedStateReader&) = delete;
+
+    /**
+    Map an existing shared memory object
+    @param name Name of the shared memory object, as given to the writer
+    @return 0 on success, -1 if not found or not compatible
+    */
+    int Open(const std::string& name)
+    {
+        Close();
+
+#ifdef _WIN32
+        (void)name;
+        return -1;
+#else
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+        {
+            return -1;
+        }
+
+        struct stat st;
+        void*       mem  = MAP_FAILED;
+        size_t      size = 0;
+        if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(SE_SharedStateHeader))
+        {
+            size = static_cast<size_t>(st.st_size);
+            mem  = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+
+        if (mem == MAP_FAILED)
+        {
+            return -1;
+        }
+
+        SE_SharedStateHeader* header = static_cast<SE_SharedStateHeader*>(mem);
+        if (header->magic != SHARED_STATE_MAGIC || header->version != SHARED_STATE_VERSION || header->n_slots < 2 ||
+            header->slot_size != SharedStateSlotSize(header->max_entities, header->max_osi_size) || SharedStateSize(header) > size)
+        {
+            munmap(mem, size);
+            return -1;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        header_ = header;
+        size_   = size;
+
+        return 0;
+#endif
+    }
+
+    void Close()
+    {
+#ifndef _WIN32
+        if (header_ != nullptr)
+        {
+            munmap(const_cast<SE_SharedStateHeader*>(header_), size_);
+        }
+#endif
+        header_ = nullptr;
+        size_   = 0;
+    }
+
+    bool IsOpen() const
+    {
+        return header_ != nullptr;
+    }
+
+    const SE_SharedStateHeader* GetHeader() const
+    {
+        return header_;
+    }
+
+    // Number of frames published so far, cheap check for new data
+    uint64_t GetFrameCount() const
+    {
+        return header_ != nullptr ? header_->n_frames.load(std::memory_order_acquire) : 0;
+    }
+
+    /**
+    Read the latest frame in place, without copying. The frame may be overwritten while func is reading it, in which case
+    func is called again with the then latest frame. Hence func should only collect data, and use it once this function returns 0.
+    @param func Called as func(const SE_SharedFrame&)
+    @param max_retries Max number of attempts to get a consistent read
+    @return 0 on success, -1 if not open or no frame published yet, -2 if no consistent read within max_retries
+    */
+    template <typename F>
+    int ReadLatest(F&& func, unsigned int max_retries = 64) const
+    {
+        if (header_ == nullptr)
+        {
+            return -1;
+        }
+
+        SE_SharedStateHeader* header = const_cast<SE_SharedStateHeader*>(header_);  // helpers are shared with the writer, no writes here
+        for (unsigned int i = 0; i < max_retries; i++)
+        {
+            uint64_t n_frames = header->n_frames.load(std::memory_order_acquire);
+            if (n_frames == 0)
+            {
+                return -1;
+            }
+
+            SE_SharedStateSlot* slot = SharedStateSlot(header, n_frames - 1);
+            uint64_t            seq  = slot->seq.load(std::memory_order_acquire);
+            if (seq & 1)
+            {
+                continue;  // being written
+            }
+
+            // Sizes may be torn by a concurrent write, clamp them to stay within the slot
+            SE_SharedFrame frame;
+            frame.frame      = slot->frame;
+            frame.time       = slot->time;
+            frame.n_entities = slot->n_entities < header->max_entities ? slot->n_entities : header->max_entities;
+            frame.flags      = slot->flags;
+            frame.entities   = SharedStateEntities(slot);
+            frame.osi_size   = slot->osi_size < header->max_osi_size ? slot->osi_size : header->max_osi_size;
+            frame.osi        = SharedStateOSI(header, slot);
+
+            func(static_cast<const SE_SharedFrame&>(frame));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->seq.load(std::memory_order_relaxed) == seq)
+            {
+                return 0;
+            }
+        }
+
+        return -2;
+    }
+
+    /**
+    Copy the latest frame, reusing the memory of the given copy
+    @param copy Frame to copy into
+    @param max_retries Max number of attempts to get a consistent read
+    @return 0 on success, -1 if not open or no frame published yet, -2 if no consistent read within max_retries
+    */
+    int CopyLatest(SE_SharedFrameCopy& copy, unsigned int max_retries = 64) const
+    {
+        return ReadLatest(
+            [&copy](const SE_SharedFrame& frame)
+            {
+                copy.frame = frame.frame;
+                copy.time  = frame.time;
+                copy.flags = frame.flags;
+                copy.entities.assign(frame.entities, frame.entities + frame.n_entities);
+                copy.osi.assign(frame.osi, frame.osi + frame.osi_size);
+            },
+            max_retries);
+    }
+
+private:
+    const SE_SharedStateHeader* header_ = nullptr;
+    size_t                      size_   = 0;
+};
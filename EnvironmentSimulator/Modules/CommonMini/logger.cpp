@@ -276,10 +276,17 @@ namespace esmini::common
                                               const std::string& logLevelStr,
                                               const std::string& log)
     {
+        // scenario instances running side by side log their own time, see SE_InstanceState
+        const double* time = SE_Env::Inst().GetInstanceState().sim_time;
+        if (time == nullptr)
+        {
+            time = time_;
+        }
+
         if (metaDataEnabled_)
         {
             return fmt::format("[{}] [{}] [{}::{}::{}] {}\n",
-                               time_ == nullptr ? "" : fmt::format("{:.3f}", *time_),
+                               time == nullptr ? "" : fmt::format("{:.3f}", *time),
                                logLevelStr,
                                fs::path(file).filename().string(),
                                function,
@@ -288,7 +295,7 @@ namespace esmini::common
         }
         else
         {
-            return fmt::format("[{}] [{}] {}\n", time_ == nullptr ? "" : fmt::format("{:.3f}", *time_), logLevelStr, log);
+            return fmt::format("[{}] [{}] {}\n", time == nullptr ? "" : fmt::format("{:.3f}", *time), logLevelStr, log);
         }
     }
 
@@ -327,6 +334,8 @@ namespace esmini::common
 
     void TxtLogger::Log(const std::string& msg)
     {
+        std::lock_guard<std::mutex> lock(mutex_);
+
         try
         {
             if (callbacks_.size() > 0)
@@ -19,6 +19,7 @@
 #include <string>
 #include <iostream>
 #include <deque>
+#include <mutex>
 #include <cstdio>
 
 // Converts enum to its underlying integer type and formats it
@@ -186,6 +187,7 @@ namespace esmini::common
         std::vector<CallbackFuncPtr> callbacks_;
         std::deque<std::string>      buffer_;
         unsigned int                 buffer_capacity_ = 0;
+        std::mutex                   mutex_;  // serialize messages logged from multiple threads
 
     };  // class TxtLogger
 
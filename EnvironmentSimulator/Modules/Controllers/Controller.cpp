@@ -71,6 +71,20 @@ Controller::Controller(InitArgs* args)  // init operatingdomains
     }
 }
 
+void Controller::SyncBaseState(SE_StateBuffer& buf)
+{
+    buf.Sync(operating_domains_);
+    buf.Sync(active_domains_);
+    buf.Sync(mode_);
+    buf.Sync(object_);
+}
+
+void Controller::SyncState(SE_StateBuffer& buf)
+{
+    SyncBaseState(buf);
+    buf.AddUnsupported(std::string("controller ") + GetName() + " of type " + GetTypeName());
+}
+
 void Controller::Step(double timeStep)
 {
     (void)timeStep;
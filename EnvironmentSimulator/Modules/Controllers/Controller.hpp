@@ -108,6 +108,9 @@ namespace scenarioengine
         // Base class Step function should be called from derived classes
         virtual void Step(double timeStep);
 
+        // Store or restore runtime state, see SE_StateBuffer. Controllers not overriding this function are registered as unsupported.
+        virtual void SyncState(SE_StateBuffer& buf);
+
         bool Active() const
         {
             return (active_domains_ != static_cast<unsigned int>(ControlDomainMasks::DOMAIN_MASK_NONE));
@@ -168,6 +171,7 @@ namespace scenarioengine
         bool                 align_to_road_heading_on_activation_   = false;
 
         void AlignToRoadHeading();
+        void SyncBaseState(SE_StateBuffer& buf);
     };
 
     typedef Controller* (*ControllerInstantiateFunction)(void* args);
@@ -81,6 +81,16 @@ void ControllerACC::InitPostPlayer()
     // player_->AddObjectSensor(object_, 4.0, 0.0, 0.5, 0.0, 1.0, 50.0, 1.2, 100);
 }
 
+void ControllerACC::SyncState(SE_StateBuffer& buf)
+{
+    SyncBaseState(buf);
+    buf.Sync(vehicle_);
+    buf.Sync(active_);
+    buf.Sync(setSpeed_);
+    buf.Sync(currentSpeed_);
+    buf.Sync(setSpeedSet_);
+}
+
 void ControllerACC::Step(double timeStep)
 {
     double minGapLength = LARGE_NUMBER;
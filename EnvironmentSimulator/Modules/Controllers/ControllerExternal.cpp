@@ -53,6 +53,11 @@ void ControllerExternal::Init()
     Controller::Init();
 }
 
+void ControllerExternal::SyncState(SE_StateBuffer& buf)
+{
+    SyncBaseState(buf);
+}
+
 void ControllerExternal::Step(double timeStep)
 {
     if (object_ != nullptr && object_->ghost_)
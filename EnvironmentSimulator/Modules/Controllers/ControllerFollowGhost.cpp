@@ -108,6 +108,12 @@ void ControllerFollowGhost::Init()
     Controller::Init();
 }
 
+void ControllerFollowGhost::SyncState(SE_StateBuffer& buf)
+{
+    SyncBaseState(buf);
+    buf.Sync(vehicle_);
+}
+
 void ControllerFollowGhost::Step(double timeStep)
 {
     if (!object_->GetGhost())
@@ -147,6 +147,7 @@ int ControllerFollowRoute::Activate(const ControlActivationMode (&mode)[static_c
     changingLane_          = false;
     waypoints_             = {};
     laneChangeAction_      = nullptr;
+    router_.reset();  // created on demand, for current road network
 
     return Controller::Activate(mode);
 }
@@ -190,7 +191,7 @@ void ControllerFollowRoute::UpdateWaypoints(roadmanager::Position vehiclePos, ro
             if (object_->pos_.GetRoute() != nullptr)
             {
                 pathCalculated_ = false;
-                CalculateWaypoints();
+                CalculateWaypoints(true);
                 currentWaypointIndex_ = 0;
             }
             return;
@@ -199,9 +200,12 @@ void ControllerFollowRoute::UpdateWaypoints(roadmanager::Position vehiclePos, ro
     }
 }
 
-void ControllerFollowRoute::CalculateWaypoints()
+void ControllerFollowRoute::CalculateWaypoints(bool repair)
 {
-    roadmanager::LaneIndependentRouter router(odr_);
+    if (router_ == nullptr)
+    {
+        router_ = std::make_unique<roadmanager::LaneIndependentRouter>(odr_);
+    }
 
     roadmanager::Position startPos(object_->pos_);
     roadmanager::Position targetPos(object_->pos_.GetRoute()->scenario_waypoints_[static_cast<unsigned int>(scenarioWaypointIndex_)]);
@@ -235,7 +239,7 @@ void ControllerFollowRoute::CalculateWaypoints()
         i++;
     }
 
-    std::vector<roadmanager::Node> pathToGoal = router.CalculatePath(startPos, targetPos);
+    std::vector<roadmanager::Node> pathToGoal = repair ? router_->RepairPath(startPos, targetPos) : router_->CalculatePath(startPos, targetPos);
     if (pathToGoal.empty())
     {
         LOG_ERROR("Error: Path not found, deactivating controller");
@@ -243,7 +247,7 @@ void ControllerFollowRoute::CalculateWaypoints()
     }
     else
     {
-        waypoints_ = router.GetWaypoints(pathToGoal, startPos, targetPos);
+        waypoints_ = router_->GetWaypoints(pathToGoal, startPos, targetPos);
 
         object_->pos_.GetRoute()->ReplaceMinimalWaypoints({waypoints_[0], waypoints_[1]});
         object_->SetDirtyBits(Object::DirtyBit::ROUTE);  // Set dirty bit to notify that route has changed
@@ -19,6 +19,8 @@
 #include "Entities.hpp"
 #include "vehicle.hpp"
 #include "OSCPrivateAction.hpp"
+#include "LaneIndependentRouter.hpp"
+#include <memory>
 #include <queue>
 
 // Enable test mode, which stops the vehicle when reaching a target
@@ -85,8 +87,9 @@ namespace scenarioengine
         /**
          * @brief Runs the pathfinder and the waypoint creator for the current scenariowaypoint, and checks if a path has been found.
          *
+         * @param repair If true, reuse the current path when possible, e.g. after missing a waypoint
          */
-        void CalculateWaypoints();
+        void CalculateWaypoints(bool repair = false);
         /**
          * @brief Check if a lane change is allowed or not.
          * Checking: if lanechange is ongoing, if lane exists, or collision risk
@@ -132,19 +135,20 @@ namespace scenarioengine
          */
         WaypointStatus GetWaypointStatus(roadmanager::Position vehiclePos, roadmanager::Position waypoint);
 
-        vehicle::Vehicle                   vehicle_;
-        LatLaneChangeAction               *laneChangeAction_ = nullptr;
-        roadmanager::OpenDrive            *odr_              = nullptr;
-        std::vector<roadmanager::Position> waypoints_;
-        int                                currentWaypointIndex_;
-        int                                scenarioWaypointIndex_;
-        bool                               changingLane_;
-        bool                               pathCalculated_;
-        std::vector<roadmanager::Position> allWaypoints_;
-        double                             laneChangeTime_      = 5;
-        double                             minDistForCollision_ = 10;
-        double                             minLaneWidth_        = 0.5;
-        bool                               testMode_;
+        vehicle::Vehicle                                    vehicle_;
+        LatLaneChangeAction                                *laneChangeAction_ = nullptr;
+        roadmanager::OpenDrive                             *odr_              = nullptr;
+        std::unique_ptr<roadmanager::LaneIndependentRouter> router_;
+        std::vector<roadmanager::Position>                  waypoints_;
+        int                                                 currentWaypointIndex_;
+        int                                                 scenarioWaypointIndex_;
+        bool                                                changingLane_;
+        bool                                                pathCalculated_;
+        std::vector<roadmanager::Position>                  allWaypoints_;
+        double                                              laneChangeTime_      = 5;
+        double                                              minDistForCollision_ = 10;
+        double                                              minLaneWidth_        = 0.5;
+        bool                                                testMode_;
     };
 
     Controller *InstantiateControllerFollowRoute(void *args);
@@ -44,6 +44,21 @@ ControllerLooming::ControllerLooming(InitArgs* args) : Controller(args)
     align_to_road_heading_on_activation_   = true;
 }
 
+void ControllerLooming::SyncState(SE_StateBuffer& buf)
+{
+    SyncBaseState(buf);
+    buf.Sync(vehicle_);
+    buf.Sync(active_);
+    buf.Sync(setSpeed_);
+    buf.Sync(currentSpeed_);
+    buf.Sync(setSpeedSet_);
+    buf.Sync(prevNearAngle);
+    buf.Sync(prevFarAngle);
+    buf.Sync(steering);
+    buf.Sync(acc);
+    buf.Sync(angleDiff);
+}
+
 void ControllerLooming::Step(double timeStep)
 {
     // looming controller properties
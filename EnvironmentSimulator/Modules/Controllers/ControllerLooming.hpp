@@ -56,6 +56,7 @@ namespace scenarioengine
             setSpeed_ = setSpeed;
         }
         void Step(double timeStep);
+        void SyncState(SE_StateBuffer& buf) override;
         bool hasFarTan;
         bool getHasFarTan() const
         {
@@ -69,6 +69,12 @@ void ControllerOffroadFollower::Init()
     Controller::Init();
 }
 
+void ControllerOffroadFollower::SyncState(SE_StateBuffer& buf)
+{
+    SyncBaseState(buf);
+    buf.Sync(vehicle_);
+}
+
 void ControllerOffroadFollower::Step(double timeStep)
 {
     if (follow_entity_ == nullptr)
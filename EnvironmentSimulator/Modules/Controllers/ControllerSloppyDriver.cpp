@@ -57,6 +57,24 @@ void ControllerSloppyDriver::Init()
     Controller::Init();
 }
 
+void ControllerSloppyDriver::SyncState(SE_StateBuffer& buf)
+{
+    SyncBaseState(buf);
+    buf.Sync(time_);
+    buf.Sync(speedTimer_);
+    buf.Sync(speedTimerAverage_);
+    buf.Sync(referenceSpeed_);
+    buf.Sync(initSpeed_);
+    buf.Sync(currentSpeed_);
+    buf.Sync(targetFactor_);
+    buf.Sync(lateralTimer_);
+    buf.Sync(lateralTimerAverage_);
+    buf.Sync(currentT_);
+    buf.Sync(tFuzz0);
+    buf.Sync(tFuzzTarget);
+    buf.Sync(currentH_);
+}
+
 void ControllerSloppyDriver::Step(double timeStep)
 {
     if (object_ == 0)
@@ -78,6 +78,7 @@ namespace scenarioengine
 
         void Init();
         void Step(double timeStep);
+        void SyncState(SE_StateBuffer& buf) override;
         int  Activate(const ControlActivationMode (&mode)[static_cast<unsigned int>(ControlDomains::COUNT)]);
         void ReportKeyEvent(int key, bool down);
 
@@ -231,6 +231,33 @@ namespace scenarioengine
         AddAction(a);
     }
 
+    void PlayerServer::QueueAction(const ActionStruct &action)
+    {
+        queued_actions_.Push(action);
+    }
+
+    void PlayerServer::InjectQueuedActions()
+    {
+        ActionStruct action;
+        while (queued_actions_.Pop(action))
+        {
+            switch (action.action_type)
+            {
+                case static_cast<int>(UDP_ACTION_TYPE::SPEED_ACTION):
+                    InjectSpeedAction(action.message.speed);
+                    break;
+                case static_cast<int>(UDP_ACTION_TYPE::LANE_CHANGE_ACTION):
+                    InjectLaneChangeAction(action.message.laneChange);
+                    break;
+                case static_cast<int>(UDP_ACTION_TYPE::LANE_OFFSET_ACTION):
+                    InjectLaneOffsetAction(action.message.laneOffset);
+                    break;
+                default:
+                    LOG_ERROR("Action of type {} can't be queued", action.action_type);
+            }
+        }
+    }
+
     bool PlayerServer::InjectedActionOngoing(int action_type) const
     {
         if (action_type < 0)
@@ -281,13 +308,10 @@ namespace scenarioengine
                 switch (buf.action_type)
                 {
                     case static_cast<int>(UDP_ACTION_TYPE::SPEED_ACTION):
-                        player->player_server_->InjectSpeedAction(buf.message.speed);
-                        break;
                     case static_cast<int>(UDP_ACTION_TYPE::LANE_CHANGE_ACTION):
-                        player->player_server_->InjectLaneChangeAction(buf.message.laneChange);
-                        break;
                     case static_cast<int>(UDP_ACTION_TYPE::LANE_OFFSET_ACTION):
-                        player->player_server_->InjectLaneOffsetAction(buf.message.laneOffset);
+                        // injected by the simulation thread at start of next frame
+                        player->player_server_->QueueAction(buf);
                         break;
                     case static_cast<int>(UDP_ACTION_TYPE::PLAY):
                         player->SetState(ScenarioPlayer::PlayerState::PLAYER_STATE_PLAYING);
@@ -100,6 +100,13 @@ namespace scenarioengine
         void InjectLaneOffsetAction(LaneOffsetActionStruct& action);
         bool InjectedActionOngoing(int action_type = -1) const;
 
+        /**
+        Queue action received by another thread than the simulation one, e.g. the UDP server. Does not block.
+        The actions are injected by the simulation thread by InjectQueuedActions().
+        */
+        void QueueAction(const ActionStruct& action);
+        void InjectQueuedActions();
+
         int                                      AddAction(OSCAction* action);
         void                                     DeleteAction(unsigned int index);
         int                                      NumberOfActions() const;
@@ -115,9 +122,10 @@ namespace scenarioengine
         void Stop();
 
     private:
-        std::vector<OSCAction*> action_;
-        ScenarioPlayer*         player_;
-        unsigned int            counter_ = 0;
+        std::vector<OSCAction*>    action_;
+        ScenarioPlayer*            player_;
+        unsigned int               counter_ = 0;
+        SE_MPSCQueue<ActionStruct> queued_actions_;
     };
 
 }  // namespace scenarioengine
@@ -27,6 +27,9 @@ Plot::Plot(ScenarioEngine* scenarioengine, bool synchronous)
         (lineplot_information_[cat][2] == "true") ? lineplot_selection_[cat] = true : lineplot_selection_[cat] = false;
     }
 
+    // Ask gateway to publish state snapshots, read in each plot frame
+    scenarioengine_->getScenarioGateway()->GetSnapshot();
+
     // Populate objects we want to plot and default settings for the checkbox selections
     for (size_t i = 0; i < scenarioengine_->entities_.object_.size(); i++)
     {
@@ -103,28 +106,41 @@ void Plot::CleanUp()
     window = nullptr;
 }
 
-void Plot::updateData(const std::vector<Object*>& objects, double time)
+void Plot::updateData(const WorldSnapshot& snapshot)
 {
-    if (plot_objects_.size() < scenarioengine_->entities_.object_.size())
+    for (size_t i = 0; i < snapshot.Size(); i++)
     {
-        for (const auto& object : scenarioengine_->entities_.object_)
+        auto it = plot_object_index_.find(snapshot.name[i]);
+        if (it == plot_object_index_.end())
         {
-            const std::string name = object->GetName();
+            // First time seen in a snapshot, look for a plot object created for it already
+            const std::string& name = snapshot.GetName(i);
             auto val = std::find_if(plot_objects_.begin(), plot_objects_.end(), [&name](const auto& obj) { return obj->getName() == name; });
             if (val == plot_objects_.end())
             {
-                plot_objects_.emplace_back(std::make_unique<PlotObject>(object));
-                selected_object_.push_back(false);  // Checkbox is unchecked
+                // New object, fetch its performance limits from the entity itself
+                scenarioengine_->mutex_.Lock();
+                Object* object = scenarioengine_->entities_.GetObjectByName(name);
+                if (object != nullptr)
+                {
+                    plot_objects_.emplace_back(std::make_unique<PlotObject>(object));
+                    selected_object_.push_back(false);  // Checkbox is unchecked
+                }
+                scenarioengine_->mutex_.Unlock();
+
+                if (object == nullptr)
+                {
+                    continue;
+                }
+                val = plot_objects_.end() - 1;
             }
+            it = plot_object_index_.emplace(snapshot.name[i], static_cast<size_t>(val - plot_objects_.begin())).first;
         }
+        plot_objects_[it->second]->updateData(snapshot, i);
     }
     // TODO:
     // else if (plot_objects_.size() > scen...)
     // should remove the checkbox and data in some smart way
-    for (size_t i = 0; i < objects.size(); i++)
-    {
-        plot_objects_[i]->updateData(objects[i], time);
-    }
 }
 
 void Plot::adjustSelectedObjectsPlotDataAxis(const PlotCategories& y_category)
@@ -134,22 +150,22 @@ void Plot::adjustSelectedObjectsPlotDataAxis(const PlotCategories& y_category)
         if (!selected_object_[item])
             continue;
 
-        const auto& data_map = plot_objects_[item]->plotData;
-
-        if (data_map.count(y_category) == 0 || data_map.at(y_category).empty())
+        float time   = 0.0f;
+        float latest = 0.0f;
+        if (!plot_objects_[item]->plotData.GetLatest(static_cast<unsigned int>(y_category), time, latest))
             continue;
 
-        adjustPlotDataAxis({y_category, data_map.at(y_category)}, item);
+        adjustPlotDataAxis(y_category, latest, item);
     }
 }
 
-void Plot::adjustPlotDataAxis(const std::pair<const PlotCategories, std::vector<float>>& d, const size_t item)
+void Plot::adjustPlotDataAxis(const PlotCategories& category, const float latest, const size_t item)
 {
-    switch (d.first)
+    switch (category)
     {
         case (PlotCategories::Time):
         {
-            if (!d.second.empty() && d.second.back() > plot_objects_[item]->getTimeMax())
+            if (latest > plot_objects_[item]->getTimeMax())
             {
                 x_scaling = ImPlotAxisFlags_AutoFit;
             }
@@ -163,9 +179,9 @@ void Plot::adjustPlotDataAxis(const std::pair<const PlotCategories, std::vector<
         case (PlotCategories::LongVel):
         {
             float min_y_axis = 0.0f;
-            if (d.second.back() < min_y_axis)
+            if (latest < min_y_axis)
             {
-                min_y_axis = d.second.back();
+                min_y_axis = latest;
                 y_scaling  = ImPlotAxisFlags_AutoFit;
             }
             ImPlot::SetNextAxesLimits(time_axis_min_, plot_objects_[item]->getTimeMax(), min_y_axis, plot_objects_[item]->getMaxSpeed() + 5.0f);
@@ -194,7 +210,7 @@ void Plot::adjustPlotDataAxis(const std::pair<const PlotCategories, std::vector<
         }
         case (PlotCategories::LaneID):
         {
-            if (d.second.back() < -5.0f || d.second.back() > 5.0f)
+            if (latest < -5.0f || latest > 5.0f)
             {
                 y_scaling = ImPlotAxisFlags_AutoFit;
             }
@@ -265,23 +281,37 @@ void Plot::renderPlot(const char* name)  //, float window_w, float window_h)
         {
             ImPlot::SetupAxes(get_category_name_[PlotCategories::Time].c_str(), unit.c_str(), x_scaling, y_scaling);
 
+            // Fetch visible part of the series only, at a resolution matching the plot width. Autofit needs all of it.
+            ImPlotRect limits     = ImPlot::GetPlotLimits();
+            float      t_start    = static_cast<float>(limits.X.Min);
+            float      t_end      = static_cast<float>(limits.X.Max);
+            size_t     max_points = static_cast<size_t>(MAX(1.0f, ImPlot::GetPlotSize().x));
+            if (x_scaling & ImPlotAxisFlags_AutoFit)
+            {
+                t_start = -LARGE_NUMBERF;
+                t_end   = LARGE_NUMBERF;
+            }
+
             for (size_t item = 0; item < selected_object_.size(); ++item)
             {
                 if (!selected_object_[item])
                     continue;
 
-                const auto& data_map = plot_objects_[item]->plotData;
+                const SE_TimeSeries& series = plot_objects_[item]->plotData;
+                unsigned int         level  = series.SelectLevel(t_start, t_end, max_points);
 
-                if (data_map.count(PlotCategories::Time) == 0 || data_map.count(y_category) == 0)
+                if (series.Read(level, static_cast<unsigned int>(y_category), t_start, plot_samples_) == 0)
                     continue;
 
-                const auto& x_data = data_map.at(PlotCategories::Time);
-                const auto& y_data = data_map.at(y_category);
-
-                if (x_data.empty() || y_data.empty())
-                    continue;
-
-                ImPlot::PlotLine(std::to_string(item).c_str(), x_data.data(), y_data.data(), static_cast<int>(x_data.size()));
+                std::string label = std::to_string(item);
+                int         n     = static_cast<int>(plot_samples_.time.size());
+                if (level > 0)
+                {
+                    // Decimated, show range of values within each entry. Same label gives same color.
+                    ImPlot::PlotShaded(label.c_str(), plot_samples_.time.data(), plot_samples_.min.data(), plot_samples_.max.data(), n);
+                    ImPlot::PlotLine(label.c_str(), plot_samples_.time.data(), plot_samples_.max.data(), n);
+                }
+                ImPlot::PlotLine(label.c_str(), plot_samples_.time.data(), plot_samples_.min.data(), n);
             }
             ImPlot::EndPlot();
         }
@@ -317,9 +347,13 @@ int Plot::Frame()
     ImGui::NewFrame();
     glfwGetWindowSize(window, &window_w, &window_h);
 
-    scenarioengine_->mutex_.Lock();
-    updateData(scenarioengine_->entities_.object_, scenarioengine_->getSimulationTime());
-    scenarioengine_->mutex_.Unlock();
+    // Read states from the latest snapshot, not blocking the simulation. Only add samples for new simulation frames.
+    std::shared_ptr<const WorldSnapshot> snapshot = scenarioengine_->getScenarioGateway()->GetSnapshot();
+    if (snapshot != nullptr && static_cast<long long>(snapshot->sequence) != snapshot_sequence_)
+    {
+        updateData(*snapshot);
+        snapshot_sequence_ = static_cast<long long>(snapshot->sequence);
+    }
     renderPlot("Line plot");
 
     // Rendering
@@ -404,7 +438,8 @@ void Plot::glfw_error_callback(int error, const char* description)
 
 // PlotObject
 Plot::PlotObject::PlotObject(Object* object)
-    : time_max_(30.0f),
+    : plotData(static_cast<unsigned int>(PlotCategories::Time) + 1),
+      time_max_(30.0f),
       max_acc_(static_cast<float>(object->GetMaxAcceleration())),
       max_decel_(static_cast<float>(-object->GetMaxDeceleration())),
       max_speed_(static_cast<float>(object->GetMaxSpeed())),
@@ -412,28 +447,32 @@ Plot::PlotObject::PlotObject(Object* object)
 {
 }
 
-void Plot::PlotObject::updateData(Object* object, double time)
+void Plot::PlotObject::updateData(const WorldSnapshot& snapshot, size_t index)
 {
+    float values[static_cast<size_t>(PlotCategories::Time) + 1];
+
     // Update Time
-    plotData[PlotCategories::Time].push_back(static_cast<float>(time));
+    values[static_cast<size_t>(PlotCategories::Time)] = static_cast<float>(snapshot.time);
 
     // Update Velocity Lat./Long
     double lat_vel, long_vel;
-    object->pos_.GetVelLatLong(lat_vel, long_vel);
-    plotData[PlotCategories::LatVel].push_back(static_cast<float>(lat_vel));
-    plotData[PlotCategories::LongVel].push_back(static_cast<float>(long_vel));
+    RotateVec2D(snapshot.vel_x[index], snapshot.vel_y[index], -snapshot.h[index], long_vel, lat_vel);
+    values[static_cast<size_t>(PlotCategories::LatVel)]  = static_cast<float>(lat_vel);
+    values[static_cast<size_t>(PlotCategories::LongVel)] = static_cast<float>(long_vel);
 
     // Update Lat./Long. Acceleration
     double lat_acc, long_acc;
-    object->pos_.GetAccLatLong(lat_acc, long_acc);
-    plotData[PlotCategories::LongA].push_back(static_cast<float>(long_acc));
-    plotData[PlotCategories::LatA].push_back(static_cast<float>(lat_acc));
+    RotateVec2D(snapshot.acc_x[index], snapshot.acc_y[index], -snapshot.h[index], long_acc, lat_acc);
+    values[static_cast<size_t>(PlotCategories::LongA)] = static_cast<float>(long_acc);
+    values[static_cast<size_t>(PlotCategories::LatA)]  = static_cast<float>(lat_acc);
 
     // Update Lane offset
-    plotData[PlotCategories::LaneOffset].push_back(static_cast<float>(object->pos_.GetOffset()));
+    values[static_cast<size_t>(PlotCategories::LaneOffset)] = static_cast<float>(snapshot.lane_offset[index]);
 
     // Update Lane ID
-    plotData[PlotCategories::LaneID].push_back(static_cast<float>(object->pos_.GetLaneId()));
+    values[static_cast<size_t>(PlotCategories::LaneID)] = static_cast<float>(snapshot.lane_id[index]);
+
+    plotData.Add(static_cast<float>(snapshot.time), values);
 }
 
 float Plot::PlotObject::getTimeMax() const
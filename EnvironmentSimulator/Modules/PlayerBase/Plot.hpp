@@ -63,9 +63,9 @@ public:
         return !thread_.joinable();
     }
 
-    void        updateData(const std::vector<Object*>& objects, double time);
+    void        updateData(const WorldSnapshot& snapshot);
     void        renderPlot(const char* name);  //, float window_width, float window_height);
-    void        adjustPlotDataAxis(const std::pair<const PlotCategories, std::vector<float>>& d, const size_t item);
+    void        adjustPlotDataAxis(const PlotCategories& category, const float latest, const size_t item);
     void        adjustSelectedObjectsPlotDataAxis(const PlotCategories& y_category);
     void        createImguiWindow();
     static void glfw_error_callback(int error, const char* description);
@@ -78,7 +78,7 @@ private:
     public:
         // PlotObject(float max_acc, float max_decel, float max_speed);
         PlotObject(Object* object);
-        void updateData(Object* object, double time);
+        void updateData(const WorldSnapshot& snapshot, size_t index);
 
         // Getters
         float       getTimeMax() const;
@@ -87,8 +87,8 @@ private:
         float       getMaxSpeed() const;
         std::string getName() const;
 
-        // Data
-        std::unordered_map<PlotCategories, std::vector<float>> plotData{};
+        // Data, one channel per category. Bounded in size and safe to read from any thread while being updated.
+        SE_TimeSeries plotData;
 
     private:
         // Constants
@@ -129,14 +129,17 @@ private:
         {PlotCategories::LaneID, std::vector<std::string>{"LaneID", "id", "false"}},
         {PlotCategories::Time, std::vector<std::string>{"Time", "s", "false"}}};
 
-    size_t            plotcategories_size_ = {};
-    std::vector<char> selected_object_     = {};
-    float             time_axis_min_       = -5.0f;
+    size_t                 plotcategories_size_ = {};
+    std::vector<char>      selected_object_     = {};
+    float                  time_axis_min_       = -5.0f;
+    SE_TimeSeries::Samples plot_samples_        = {};  // buffer for the series currently plotted
 
     // Runtime variables
-    ScenarioEngine* scenarioengine_;
-    bool            initialized_ = false;
-    std::thread     thread_;
+    ScenarioEngine*                 scenarioengine_;
+    bool                            initialized_       = false;
+    long long                       snapshot_sequence_ = -1;  // sequence number of last plotted snapshot
+    std::unordered_map<int, size_t> plot_object_index_ = {};  // interned object name -> plot object index
+    std::thread                     thread_;
 };
 
 #endif  // PLOT_H
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include "logger.hpp"
 #include "Config.hpp"
 #include "ConfigParser.hpp"
+#include "Profiler.hpp"
 
 #ifdef _USE_OSG
 #include "viewer.hpp"
@@ -81,6 +82,17 @@ ScenarioPlayer::ScenarioPlayer(int argc, char* argv[])
 
 ScenarioPlayer::~ScenarioPlayer()
 {
+    if (SE_Profiler::Inst().IsEnabled())
+    {
+        SE_Profiler::Inst().LogSummary();
+        if (SE_Env::Inst().GetOptions().GetOptionSet("profile_trace"))
+        {
+            SE_Profiler::Inst().WriteTrace(SE_Env::Inst().GetOptions().GetOptionValue("profile_trace"));
+        }
+        SE_Profiler::Inst().SetLevel(SE_Profiler::Level::OFF);
+        SE_Profiler::Inst().SetTraceEnabled(false);
+    }
+
     if (launch_server)
     {
         StopServer();
@@ -186,6 +198,8 @@ int ScenarioPlayer::Frame(double timestep_s, bool server_mode)
     int         retval        = 0;
     double      ghost_solo_dt = (GetFixedTimestep() < 0.0) ? 0.05 : GetFixedTimestep();
 
+    SE_PROFILE_SCOPE("Frame");
+
     if (!IsPaused() || server_mode)
     {
 #ifdef _USE_OSI
@@ -268,6 +282,9 @@ int ScenarioPlayer::ScenarioFrame(double timestep_s, bool keyframe)
     int retval = 0;
     mutex.Lock();
 
+    // Inject actions received by the player server since last frame
+    player_server_->InjectQueuedActions();
+
     if ((retval = scenarioEngine->step(timestep_s)) == 0)
     {
         if (keyframe)
@@ -289,11 +306,15 @@ int ScenarioPlayer::ScenarioFrame(double timestep_s, bool keyframe)
 
         scenarioGateway->SetDynamicSignals(roadmanager::Position::GetOpenDrive()->GetDynamicSignals());
         scenarioGateway->UpdateStoryBoardStateChanges(scenarioEngine->storyBoard.GetChanges());
-        scenarioGateway->WriteStatesToFile(scenarioEngine->getSimulationTime(), timestep_s);
+        {
+            SE_PROFILE_SCOPE("WriteStatesToFile");
+            scenarioGateway->WriteStatesToFile(scenarioEngine->getSimulationTime(), timestep_s);
+        }
         scenarioEngine->storyBoard.ClearStateChanges();
 
         if (CSV_Log)
         {
+            SE_PROFILE_SCOPE("CSV_Log");
             UpdateCSV_Log();
         }
 
@@ -318,6 +339,7 @@ void ScenarioPlayer::ScenarioPostFrame()
 
     for (size_t i = 0; i < sensor.size(); i++)
     {
+        SE_PROFILE_SCOPE("Sensors");
         sensor[i]->Update();
     }
 #ifdef _USE_OSI
@@ -326,6 +348,7 @@ void ScenarioPlayer::ScenarioPostFrame()
         // Update OSI info
         if (osiReporter->GetOSIFrequency() > 0)
         {
+            SE_PROFILE_SCOPE("OSI");
             osiReporter->ReportSensors(sensor);
 
             osiReporter->UpdateOSIGroundTruth(scenarioGateway->objectState_);
@@ -335,9 +358,79 @@ void ScenarioPlayer::ScenarioPostFrame()
     }
 #endif  // _USE_OSI
 
+    if (shm_writer_.IsOpen())
+    {
+        SE_PROFILE_SCOPE("SharedState");
+        PublishSharedState();
+    }
+
     mutex.Unlock();
 }
 
+void ScenarioPlayer::PublishSharedState()
+{
+    // Entity states are taken from the gateway snapshot, published once per new snapshot
+    std::shared_ptr<const WorldSnapshot> snapshot = scenarioGateway->GetSnapshot();
+    if (snapshot == nullptr || static_cast<long long>(snapshot->sequence) == shm_snapshot_sequence_)
+    {
+        return;
+    }
+    shm_snapshot_sequence_ = static_cast<long long>(snapshot->sequence);
+
+    SE_SharedEntityState* entities   = shm_writer_.BeginFrame(snapshot->time);
+    uint32_t              n_entities = static_cast<uint32_t>(MIN(snapshot->Size(), shm_writer_.GetMaxEntities()));
+
+    for (uint32_t i = 0; i < n_entities; i++)
+    {
+        SE_SharedEntityState& e = entities[i];
+        e.id                    = snapshot->id[i];
+        e.obj_type              = snapshot->obj_type[i];
+        e.obj_category          = snapshot->obj_category[i];
+        e.ctrl_type             = snapshot->ctrl_type[i];
+        e.visibility_mask       = snapshot->visibility_mask[i];
+        e.lane_id               = snapshot->lane_id[i];
+        e.road_id               = snapshot->road_id[i];
+        e.junction_id           = snapshot->junction_id[i];
+        e.x                     = snapshot->x[i];
+        e.y                     = snapshot->y[i];
+        e.z                     = snapshot->z[i];
+        e.h                     = snapshot->h[i];
+        e.p                     = snapshot->p[i];
+        e.r                     = snapshot->r[i];
+        e.vel_x                 = snapshot->vel_x[i];
+        e.vel_y                 = snapshot->vel_y[i];
+        e.vel_z                 = snapshot->vel_z[i];
+        e.acc_x                 = snapshot->acc_x[i];
+        e.acc_y                 = snapshot->acc_y[i];
+        e.acc_z                 = snapshot->acc_z[i];
+        e.h_rate                = snapshot->h_rate[i];
+        e.speed                 = snapshot->speed[i];
+        e.s                     = snapshot->s[i];
+        e.t                     = snapshot->t[i];
+        e.lane_offset           = snapshot->lane_offset[i];
+        e.wheel_angle           = snapshot->wheel_angle[i];
+        e.wheel_rot             = snapshot->wheel_rot[i];
+        e.bb_x                  = snapshot->boundingbox[i].center_.x_;
+        e.bb_y                  = snapshot->boundingbox[i].center_.y_;
+        e.bb_z                  = snapshot->boundingbox[i].center_.z_;
+        e.bb_length             = snapshot->boundingbox[i].dimensions_.length_;
+        e.bb_width              = snapshot->boundingbox[i].dimensions_.width_;
+        e.bb_height             = snapshot->boundingbox[i].dimensions_.height_;
+        StrCopy(e.name, snapshot->GetName(i).c_str(), SHARED_STATE_NAME_SIZE);
+    }
+
+    const char* osi      = nullptr;
+    int         osi_size = 0;
+#ifdef _USE_OSI
+    if (shm_osi_ && osiReporter->GetUpdated())
+    {
+        osi = osiReporter->GetOSIGroundTruth(&osi_size);
+    }
+#endif  // _USE_OSI
+
+    shm_writer_.EndFrame(static_cast<uint32_t>(snapshot->Size()), osi, static_cast<uint64_t>(MAX(osi_size, 0)));
+}
+
 #ifdef _USE_OSG
 void ScenarioPlayer::ViewerFrame()
 {
@@ -346,6 +439,8 @@ void ScenarioPlayer::ViewerFrame()
         return;
     }
 
+    SE_PROFILE_SCOPE("Viewer");
+
     if (scenarioEngine->environment.IsEnvironment() && !scenarioEngine->environment.IsEnvironmentUpdatedInViewer())
     {
         scenarioEngine->environment.SetEnvironmentUpdatedInViewer(true);
@@ -1440,6 +1535,10 @@ int ScenarioPlayer::Init()
     opt.AddOption("generate_no_road_objects", "Do not generate any OpenDRIVE road objects (e.g. when part of referred 3D model)");
     opt.AddOption("generate_without_textures", "Do not apply textures on any generated road model (set colors instead as for missing textures)");
     opt.AddOption("ghost_trail_dt", "Ghost trail sample delta time", "dt", std::to_string(GHOST_TRAIL_SAMPLE_TIME));
+    opt.AddOption("ghost_trail_retention",
+                  "Discard trail samples older than this, 0 keeps all. Trail still in use by ghost follower is kept",
+                  "duration",
+                  "0");
     opt.AddOption("ground_plane", "Add a large flat ground surface");
     opt.AddOption("headless", "Run without viewer window");
     opt.AddOption("help", "Show this help message (-h works as well)");
@@ -1462,6 +1561,8 @@ int ScenarioPlayer::Init()
                   "modulename(s)");
     opt.AddOption("osc_str", "OpenSCENARIO XML string", "string");
     opt.AddOption("osg_screenshot_event_handler", "Revert to OSG default jpg images ('c'/'C' keys handler)");
+    opt.AddOption("osi_lazy_roadmarks", "Postpone creation of road mark OSI points until first needed, e.g. by OSI or visualization");
+    opt.AddOption("osi_point_threads", "Number of threads creating road OSI points at load, 0=all available", "number", "0");
 #ifdef _USE_OSI
     opt.AddOption("osi_crop_dynamic", "Crop the dynamic osi data around the given object id with given radius", "id,radius", "", false, false);
     opt.AddOption("osi_exclude_ghost", "Excludes ghost from osi dynamic osi ground truth");
@@ -1474,6 +1575,9 @@ int ScenarioPlayer::Init()
                   "Decide how the static data should be reported, 0=Default (first frame), 1=API (expose on API) 2=API_AND_LOG (Always log)",
                   "mode",
                   "0");
+    opt.AddOption("osi_traj_dt", "Time between points of projected future trajectories, e.g. of Ego", "seconds", "0.5");
+    opt.AddOption("osi_traj_horizon", "How far ahead to project future trajectories, e.g. of Ego", "seconds", "10");
+    opt.AddOption("osi_traj_threads", "Number of threads projecting future trajectories, 0=all available", "number", "0");
 #endif
     opt.AddOption("param_dist", "Run variations of the scenario according to specified parameter distribution file", "filename");
     opt.AddOption("param_permutation", "Run specific permutation of parameter distribution, index in range (0 .. NumberOfPermutations-1)", "index");
@@ -1484,8 +1588,21 @@ int ScenarioPlayer::Init()
     opt.AddOption("plot", "Show window with line-plots of interesting data. Modes: asynchronous, synchronous", "mode", "asynchronous");
 #endif
     opt.AddOption("pline_interpolation", "Interpolate orientation (\"segment\", \"corner\", \"off\")", "mode");
+    opt.AddOption("profile",
+                  "Measure time spent in each phase of the frame, summary logged at exit. Modes: phases, all (adds controller and condition types)",
+                  "mode",
+                  "phases");
+    opt.AddOption("profile_trace",
+                  "Save frame profile events in Chrome trace JSON format, e.g. for chrome://tracing. Implies --profile",
+                  "filename",
+                  "profile.json");
     opt.AddOption("record", "Record position data into a file for later replay", "filename", DAT_FILENAME);
+    opt.AddOption("record_format",
+                  "Encoding of recorded object states. Modes: per_field, compact (quantized deltas), compressed (compact in compressed blocks)",
+                  "mode",
+                  "per_field");
     opt.AddOption("road_features", "Show OpenDRIVE road features. Modes: on, off. Toggle key 'o'", "mode", "on");
+    opt.AddOption("road_model_cache", "Cache generated road 3D models in given folder, reused while OpenDRIVE and settings are unchanged", "path");
     opt.AddOption("return_nr_permutations", "Return number of permutations without executing the scenario (-1 = error)");
     opt.AddOption("save_generated_model", "Save generated 3D model (n/a when a scenegraph is loaded)");
     opt.AddOption("save_xosc",
@@ -1496,6 +1613,17 @@ int ScenarioPlayer::Init()
     opt.AddOption("seed", "Specify seed number for random generator", "number");
     opt.AddOption("sensors", "Show sensor frustums. Toggle key 'r'");
     opt.AddOption("server", "Launch server to receive state of external Ego simulator");
+    opt.AddOption("shm", "Publish world state in POSIX shared memory for local clients, see SharedState.hpp", "name", SHARED_STATE_DEFAULT_NAME);
+#ifdef _USE_OSI
+    opt.AddOption("shm_osi",
+                  "Include serialized OSI ground truth in shared memory frames, with given max size per frame. Requires --shm",
+                  "kilobytes",
+                  std::to_string(SHARED_STATE_DEFAULT_MAX_OSI_KB));
+#endif
+    opt.AddOption("swarm_lod_radius",
+                  "Fully simulate swarm traffic only within this distance from central object, others follow lanes by a simple model",
+                  "radius",
+                  "0");
     opt.AddOption("text_scale", "Scale screen overlay text", "size factor", "1.0", true);
     opt.AddOption("threads", "Run viewer in a separate thread, parallel to scenario engine");
     opt.AddOption("trail_mode", "Show trail lines and/or dots. Modes: 0=None 1=lines 2=dots 3=both. Toggle key 'j'", "mode", "0");
@@ -1746,6 +1874,19 @@ int ScenarioPlayer::Init()
         SE_Env::Inst().SetCollisionDetection(true);
     }
 
+    if (opt.GetOptionSet("profile") || opt.GetOptionSet("profile_trace"))
+    {
+        if (opt.GetOptionValue("profile") == "all")
+        {
+            SE_Profiler::Inst().SetLevel(SE_Profiler::Level::ALL);
+        }
+        else
+        {
+            SE_Profiler::Inst().SetLevel(SE_Profiler::Level::PHASES);
+        }
+        SE_Profiler::Inst().SetTraceEnabled(opt.GetOptionSet("profile_trace"));
+    }
+
     if (opt.GetOptionSet("plot"))
     {
         if (opt.GetOptionValue("plot") != "synchronous")
@@ -1893,6 +2034,32 @@ int ScenarioPlayer::Init()
         LOG_INFO("OSI static data reporting mode: {}", arg_str);
     }
 #endif  // _USE_OSI
+
+    if (opt.GetOptionSet("shm"))
+    {
+        uint64_t max_osi_size = 0;
+#ifdef _USE_OSI
+        if (opt.GetOptionSet("shm_osi"))
+        {
+            shm_osi_     = true;
+            max_osi_size = static_cast<uint64_t>(MAX(0, strtoi(opt.GetOptionValue("shm_osi")))) * 1024;
+            if (osiReporter->GetOSIFrequency() == 0)
+            {
+                osiReporter->SetOSIFrequency(1);
+            }
+        }
+#endif  // _USE_OSI
+        uint32_t max_entities = static_cast<uint32_t>(MAX(SHARED_STATE_DEFAULT_MAX_ENTITIES, 2 * scenarioEngine->entities_.object_.size()));
+        if (shm_writer_.Open(opt.GetOptionValue("shm"), max_entities, max_osi_size) != 0)
+        {
+            LOG_ERROR("Failed to create shared memory {}", opt.GetOptionValue("shm"));
+        }
+        else
+        {
+            scenarioGateway->GetSnapshot();  // register interest, the gateway publishes snapshots from now on
+            LOG_INFO("Publishing world state in shared memory {}", opt.GetOptionValue("shm"));
+        }
+    }
     if (opt.GetOptionSet("vehicle_dynamics") == true)
     {
         EnableVehicleDynamics();
@@ -1972,11 +2139,26 @@ int ScenarioPlayer::Init()
             filename = dist.AddInfoToFilepath(filename);
         }
 
+        Dat::Format format = Dat::Format::PER_FIELD;
+        if (opt.GetOptionValue("record_format") == "compact")
+        {
+            format = Dat::Format::COMPACT;
+        }
+        else if (opt.GetOptionValue("record_format") == "compressed")
+        {
+            format = Dat::Format::COMPRESSED;
+        }
+        else if (opt.GetOptionSet("record_format") && opt.GetOptionValue("record_format") != "per_field")
+        {
+            LOG_ERROR("Unknown record format {}, using per_field", opt.GetOptionValue("record_format"));
+        }
+
         LOG_INFO("Recording data to file {}", filename);
         scenarioGateway->RecordToFile(filename,
                                       scenarioEngine->getOdrFilename(),
                                       scenarioEngine->getSceneGraphFilename(),
-                                      std::string(esmini_git_rev()));
+                                      std::string(esmini_git_rev()),
+                                      format);
     }
 
     if (launch_server)
@@ -2085,8 +2267,8 @@ void ScenarioPlayer::UpdateCSV_Log()
         // Create a pointer to the object at position i in the entities vector
         Object* obj = scenarioEngine->entities_.object_[i];
 
-        // Create a Position object for extracting this vehicles XYZ coordinates
-        roadmanager::Position pos = obj->pos_;
+        // Refer to the Position object for extracting this vehicles XYZ coordinates
+        const roadmanager::Position& pos = obj->pos_;
 
         // Extract the String name of the object and store in a compatable const char array
         const char* name_ = &(*obj->name_.c_str());
@@ -2220,6 +2402,43 @@ int ScenarioPlayer::LoadParameterDistribution(std::string filename)
     return 0;
 }
 
+int ScenarioPlayer::StoreState(SE_StateBuffer& buf)
+{
+    mutex.Lock();
+
+    int retval = scenarioEngine->StoreState(buf);
+    buf.Sync(frame_counter_);
+    buf.Sync(quit_request);
+    buf.Sync(osi_updated_);
+#ifdef _USE_OSI
+    osiReporter->SyncState(buf);
+#endif  // _USE_OSI
+
+    mutex.Unlock();
+
+    return retval;
+}
+
+int ScenarioPlayer::RestoreState(SE_StateBuffer& buf)
+{
+    mutex.Lock();
+
+    int retval = scenarioEngine->RestoreState(buf);
+    if (retval == 0)
+    {
+        buf.Sync(frame_counter_);
+        buf.Sync(quit_request);
+        buf.Sync(osi_updated_);
+#ifdef _USE_OSI
+        osiReporter->SyncState(buf);
+#endif  // _USE_OSI
+    }
+
+    mutex.Unlock();
+
+    return retval;
+}
+
 int ScenarioPlayer::GetNumberOfVariables()
 {
     return scenarioEngine->scenarioReader->variables.GetNumberOfParameters();
@@ -20,6 +20,7 @@
 #include "CommonMini.hpp"
 #include "Server.hpp"
 #include "IdealSensor.hpp"
+#include "SharedState.hpp"
 
 #ifdef _USE_OSI
 #include "OSIReporter.hpp"
@@ -229,6 +230,19 @@ namespace scenarioengine
         {
             return frame_counter_;
         }
+
+        /**
+        Store runtime state of scenario and player, see ScenarioEngine::StoreState
+        @return 0 on success, -1 on failure
+        */
+        int StoreState(SE_StateBuffer &buf);
+
+        /**
+        Restore runtime state of scenario and player, see ScenarioEngine::RestoreState
+        Note: Recorded files, e.g. .dat, CSV and OSI, are not rewound
+        @return 0 on success, -1 on failure
+        */
+        int RestoreState(SE_StateBuffer &buf);
         int LoadParameterDistribution(std::string filename);
 
         // TODO
@@ -286,6 +300,8 @@ namespace scenarioengine
         SE_Semaphore                viewer_init_semaphore;
 
     private:
+        void PublishSharedState();
+
         double       trail_dt;
         SE_Thread    thread;
         SE_Mutex     mutex;
@@ -306,6 +322,10 @@ namespace scenarioengine
         DampedSpring roll_spring_template_;
         double       pitch_limit_;
         double       roll_limit_;
+
+        SE_SharedStateWriter shm_writer_;
+        bool                 shm_osi_               = false;
+        long long            shm_snapshot_sequence_ = -1;  // sequence number of last published snapshot, -1 = none yet
     };
 
 }  // namespace scenarioengine
@@ -5,14 +5,82 @@
 
 using namespace roadmanager;
 
+#define PATH_CACHE_MAX_SIZE 4096  // when reached, the cache is cleared
+
+std::unordered_map<LaneIndependentRouter::PathKey, std::vector<Node>, LaneIndependentRouter::PathKeyHash> LaneIndependentRouter::pathCache_;
+std::mutex                                                                                               LaneIndependentRouter::pathCacheMutex_;
+
+static void HashCombine(size_t &seed, size_t value)
+{
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+bool LaneIndependentRouter::PathKey::operator==(const PathKey &rhs) const
+{
+    return odr == rhs.odr && revision == rhs.revision && startRoadId == rhs.startRoadId && startLaneId == rhs.startLaneId &&
+           forward == rhs.forward && targetRoadId == rhs.targetRoadId && targetLaneId == rhs.targetLaneId && targetS == rhs.targetS &&
+           routeStrategy == rhs.routeStrategy;
+}
+
+size_t LaneIndependentRouter::PathKeyHash::operator()(const PathKey &key) const
+{
+    size_t seed = std::hash<const OpenDrive *>()(key.odr);
+    HashCombine(seed, std::hash<unsigned int>()(key.revision));
+    HashCombine(seed, std::hash<id_t>()(key.startRoadId));
+    HashCombine(seed, std::hash<int>()(key.startLaneId));
+    HashCombine(seed, std::hash<bool>()(key.forward));
+    HashCombine(seed, std::hash<id_t>()(key.targetRoadId));
+    HashCombine(seed, std::hash<int>()(key.targetLaneId));
+    HashCombine(seed, std::hash<double>()(key.targetS));
+    HashCombine(seed, std::hash<int>()(static_cast<int>(key.routeStrategy)));
+    return seed;
+}
+
+size_t LaneIndependentRouter::NodeKeyHash::operator()(const NodeKey &key) const
+{
+    size_t seed = std::hash<const Road *>()(key.road);
+    HashCombine(seed, std::hash<int>()(key.currentLaneId));
+    HashCombine(seed, std::hash<int>()(key.fromLaneId));
+    HashCombine(seed, std::hash<const RoadLink *>()(key.link));
+    return seed;
+}
+
+// Set previous of each node to the preceding one in the list
+static void LinkPath(std::vector<Node> &path)
+{
+    for (size_t i = 0; i < path.size(); i++)
+    {
+        path[i].previous = i > 0 ? &path[i - 1] : nullptr;
+    }
+}
+
 LaneIndependentRouter::LaneIndependentRouter(OpenDrive *odr) : odr_(odr), roadCalculations_(RoadCalculations())
 {
 }
 
 LaneIndependentRouter::~LaneIndependentRouter()
 {
-    clearQueue(unvisited_);
-    clearVector(visited_);
+}
+
+void LaneIndependentRouter::ClearPathCache()
+{
+    std::lock_guard<std::mutex> lock(pathCacheMutex_);
+    pathCache_.clear();
+}
+
+size_t LaneIndependentRouter::GetPathCacheSize()
+{
+    std::lock_guard<std::mutex> lock(pathCacheMutex_);
+    return pathCache_.size();
+}
+
+Node *LaneIndependentRouter::AllocateNode()
+{
+    if (nodesUsed_ == nodePool_.size())
+    {
+        nodePool_.emplace_back();
+    }
+    return &nodePool_[nodesUsed_++];
 }
 
 // Gets the next pathnode for the nextroad based on current srcnode
@@ -44,7 +112,7 @@ std::vector<Node *> LaneIndependentRouter::GetNextNodes(Road *nextRoad, Road *ta
                 continue;
             }
             // create next non target node
-            pNode                = new Node;
+            pNode                = AllocateNode();
             pNode->link          = nextLink;
             pNode->road          = nextRoad;
             pNode->currentLaneId = lanePair.second;
@@ -166,7 +234,7 @@ std::vector<std::pair<int, int>> LaneIndependentRouter::GetConnectingLanes(Node
 Node *LaneIndependentRouter::CreateTargetNode(Node *currentNode, Road *nextRoad, std::pair<int, int> laneIds)
 {
     // Create last node (targetnode)
-    Node *targetNode          = new Node;
+    Node *targetNode          = AllocateNode();
     targetNode->previous      = currentNode;
     targetNode->road          = nextRoad;
     targetNode->currentLaneId = laneIds.second;
@@ -177,25 +245,55 @@ Node *LaneIndependentRouter::CreateTargetNode(Node *currentNode, Road *nextRoad,
     return targetNode;
 }
 
-bool LaneIndependentRouter::FindGoal()
+Node *LaneIndependentRouter::FindGoal(const std::unordered_map<NodeKey, int, NodeKeyHash> *rejoin, int *rejoinIdx)
 {
+    int    targetLaneId = targetWaypoint_.GetLaneId();
+    Node  *bestNode     = nullptr;
+    double bestWeight   = LARGE_NUMBER;
+
     while (!unvisited_.empty())
     {
         Node *currentNode = unvisited_.top();
+        if (bestNode != nullptr && currentNode->weight >= bestWeight)
+        {
+            // all remaining ways are longer than best found
+            break;
+        }
         unvisited_.pop();
-        bool nodeIsVisited =
-            std::find_if(visited_.begin(), visited_.end(), [currentNode](const Node *n) { return *n == *currentNode; }) != visited_.end();
-        if (nodeIsVisited)
+
+        if (!visited_.insert({currentNode->road, currentNode->currentLaneId, currentNode->fromLaneId, currentNode->link}).second)
         {
-            delete currentNode;
             continue;
         }
-        visited_.push_back(currentNode);
-        Road *targetRoad   = odr_->GetRoadById(targetWaypoint_.GetTrackId());
-        int   targetLaneId = targetWaypoint_.GetLaneId();
-        if (currentNode->road == targetRoad && currentNode->currentLaneId == targetLaneId)
+        if (currentNode->road == targetRoad_ && currentNode->currentLaneId == targetLaneId)
         {
-            return true;
+            if (rejoin == nullptr)
+            {
+                return currentNode;
+            }
+            if (currentNode->weight < bestWeight)
+            {
+                bestNode   = currentNode;
+                bestWeight = currentNode->weight;
+                *rejoinIdx = -1;
+            }
+            continue;
+        }
+        if (rejoin != nullptr)
+        {
+            auto it = rejoin->find({currentNode->road, currentNode->currentLaneId, 0, currentNode->link});
+            if (it != rejoin->end())
+            {
+                // back on known path, which is the best way on from here
+                double weight = currentNode->weight + lastPath_.back().weight - lastPath_[static_cast<unsigned int>(it->second)].weight;
+                if (weight < bestWeight)
+                {
+                    bestNode   = currentNode;
+                    bestWeight = weight;
+                    *rejoinIdx = it->second;
+                }
+                continue;
+            }
         }
         if (!currentNode->link)
         {
@@ -204,17 +302,17 @@ bool LaneIndependentRouter::FindGoal()
         std::vector<Road *> nextRoads = GetNextRoads(currentNode->link, currentNode->road);
         for (Road *nextRoad : nextRoads)
         {
-            std::vector<Node *> nextNodes = GetNextNodes(nextRoad, targetRoad, currentNode);
+            std::vector<Node *> nextNodes = GetNextNodes(nextRoad, targetRoad_, currentNode);
             for (Node *n : nextNodes)
             {
                 unvisited_.push(n);
             }
         }
     }
-    return false;
+    return bestNode;
 }
 
-bool LaneIndependentRouter::IsPositionValid(Position pos) const
+bool LaneIndependentRouter::IsPositionValid(const Position &pos) const
 {
     Road *road = odr_->GetRoadById(pos.GetTrackId());
     if (!road)
@@ -234,9 +332,9 @@ bool LaneIndependentRouter::IsPositionValid(Position pos) const
     return lane->IsDriving();  // true if lane is defined as drivable
 }
 
-Node *LaneIndependentRouter::CreateStartNode(RoadLink *link, Road *road, int laneId, ContactPointType contactPoint, Position pos)
+Node *LaneIndependentRouter::CreateStartNode(RoadLink *link, Road *road, int laneId, ContactPointType contactPoint, const Position &pos)
 {
-    Node *startNode          = new Node;
+    Node *startNode          = AllocateNode();
     startNode->link          = link;
     startNode->road          = road;
     startNode->currentLaneId = laneId;
@@ -272,28 +370,29 @@ Node *LaneIndependentRouter::CreateStartNode(RoadLink *link, Road *road, int lan
     return startNode;
 }
 
-std::vector<Node> LaneIndependentRouter::CalculatePath(Position start, Position target)
+Node *LaneIndependentRouter::InitSearch(Position &start, Position &target, PathKey &key)
 {
-    clearQueue(unvisited_);
-    clearVector(visited_);
+    unvisited_.GetUnderlyingContainer().clear();
+    visited_.clear();
+    nodesUsed_ = 0;
 
     if (!IsPositionValid(start))
     {
         LOG_ERROR("(LaneIndependentRouter::CalculatePath) Error: Start position is invalid");
-        return {};
+        return nullptr;
     }
     if (!IsPositionValid(target))
     {
         LOG_ERROR("(LaneIndependentRouter::CalculatePath) Error: Target position is invalid");
-        return {};
+        return nullptr;
     }
 
     Road *startRoad   = odr_->GetRoadById(start.GetTrackId());
     int   startLaneId = start.GetLaneId();
 
-    targetWaypoint_    = target;
-    Road *targetRoad   = odr_->GetRoadById(targetWaypoint_.GetTrackId());
-    int   targetLaneId = targetWaypoint_.GetLaneId();
+    targetWaypoint_  = target;
+    targetRoad_      = odr_->GetRoadById(targetWaypoint_.GetTrackId());
+    int targetLaneId = targetWaypoint_.GetLaneId();
 
     // Get routestrategy from traget position
     routeStrategy_ = target.GetRouteStrategy();
@@ -316,38 +415,163 @@ std::vector<Node> LaneIndependentRouter::CalculatePath(Position start, Position
 
     // If start and end waypoint are on the same road and same lane,
     // no pathToGoal is needed
-    if (startRoad == targetRoad && startLaneId == targetLaneId)
+    if (startRoad == targetRoad_ && startLaneId == targetLaneId)
     {
         LOG_ERROR("(LaneIndependentRouter::CalculatePath) Error: start pos and target pos on same road and lane");
-        return {};
+        return nullptr;
     }
 
     if (!nextElement)
     {
         // No link (next road element) found
         LOG_ERROR("(LaneIndependentRouter::CalculatePath) Error: No link from start pos");
-        return {};
+        return nullptr;
     }
 
-    Node *startNode = CreateStartNode(nextElement, startRoad, startLaneId, contactPoint, start);
-    unvisited_.push(startNode);
+    key = {odr_,
+           odr_->GetRevision(),
+           startRoad->GetId(),
+           startLaneId,
+           isInForwardDirection,
+           targetRoad_->GetId(),
+           targetLaneId,
+           target.GetS(),
+           routeStrategy_};
+
+    return CreateStartNode(nextElement, startRoad, startLaneId, contactPoint, start);
+}
+
+std::vector<Node> LaneIndependentRouter::BacktrackPath(Node *node)
+{
+    std::vector<Node> path;
+    for (Node *nodeIterator = node; nodeIterator != nullptr; nodeIterator = nodeIterator->previous)
+    {
+        path.push_back(*nodeIterator);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::vector<Node> LaneIndependentRouter::CalculatePath(Position start, Position target)
+{
+    PathKey key;
+    Node   *startNode = InitSearch(start, target, key);
+    if (startNode == nullptr)
+    {
+        return {};
+    }
 
-    bool              found = FindGoal();
     std::vector<Node> pathToGoal;
-    if (found)
+    bool              cached = false;
+    {
+        std::lock_guard<std::mutex> lock(pathCacheMutex_);
+        auto                        it = pathCache_.find(key);
+        if (it != pathCache_.end())
+        {
+            pathToGoal = it->second;
+            cached     = true;
+        }
+    }
+
+    if (cached)
     {
-        Node *nodeIterator = visited_.back();
-        while (nodeIterator != 0)
+        if (pathToGoal.empty())
+        {
+            // known to be unreachable
+            LOG_WARN("(LaneIndependentRouter::CalculatePath) Warning: Path to target not found");
+            return {};
+        }
+
+        // cached path, from another start s along the same road. Only the weights differ.
+        double offset = startNode->weight - pathToGoal[0].weight;
+        for (Node &node : pathToGoal)
         {
-            pathToGoal.push_back(*nodeIterator);
-            nodeIterator = nodeIterator->previous;
+            node.weight += offset;
         }
     }
     else
     {
-        LOG_WARN("(LaneIndependentRouter::CalculatePath) Warning: Path to target not found");
+        unvisited_.push(startNode);
+        Node *goal = FindGoal();
+        if (goal != nullptr)
+        {
+            pathToGoal = BacktrackPath(goal);
+        }
+
+        {
+            // also remember unreachable targets, the most expensive searches
+            std::lock_guard<std::mutex> lock(pathCacheMutex_);
+            if (pathCache_.size() >= PATH_CACHE_MAX_SIZE)
+            {
+                pathCache_.clear();
+            }
+            pathCache_[key] = pathToGoal;
+        }
+
+        if (goal == nullptr)
+        {
+            LOG_WARN("(LaneIndependentRouter::CalculatePath) Warning: Path to target not found");
+            return {};
+        }
     }
-    std::reverse(pathToGoal.begin(), pathToGoal.end());
+
+    LinkPath(pathToGoal);
+    lastPath_    = pathToGoal;
+    lastPathKey_ = key;
+    LinkPath(lastPath_);
+
+    return pathToGoal;
+}
+
+std::vector<Node> LaneIndependentRouter::RepairPath(Position start, Position target)
+{
+    PathKey key;
+    Node   *startNode = InitSearch(start, target, key);
+    if (startNode == nullptr)
+    {
+        return {};
+    }
+
+    bool sameTarget = !lastPath_.empty() && lastPathKey_.odr == key.odr && lastPathKey_.revision == key.revision &&
+                      lastPathKey_.targetRoadId == key.targetRoadId && lastPathKey_.targetLaneId == key.targetLaneId &&
+                      lastPathKey_.targetS == key.targetS && lastPathKey_.routeStrategy == key.routeStrategy;
+    if (!sameTarget)
+    {
+        return CalculatePath(start, target);
+    }
+
+    std::unordered_map<NodeKey, int, NodeKeyHash> rejoin;
+    for (size_t i = 0; i < lastPath_.size() - 1; i++)
+    {
+        rejoin[{lastPath_[i].road, lastPath_[i].currentLaneId, 0, lastPath_[i].link}] = static_cast<int>(i);
+    }
+
+    unvisited_.push(startNode);
+    int   rejoinIdx = -1;
+    Node *goal      = FindGoal(&rejoin, &rejoinIdx);
+    if (goal == nullptr)
+    {
+        LOG_WARN("(LaneIndependentRouter::RepairPath) Warning: Path to target not found");
+        return {};
+    }
+
+    std::vector<Node> pathToGoal = BacktrackPath(goal);
+    if (rejoinIdx >= 0)
+    {
+        // continue along the remaining part of the latest path
+        double offset = goal->weight - lastPath_[static_cast<unsigned int>(rejoinIdx)].weight;
+        for (size_t i = static_cast<size_t>(rejoinIdx) + 1; i < lastPath_.size(); i++)
+        {
+            pathToGoal.push_back(lastPath_[i]);
+            pathToGoal.back().weight += offset;
+        }
+    }
+
+    LinkPath(pathToGoal);
+    lastPath_    = pathToGoal;
+    lastPathKey_ = key;
+    LinkPath(lastPath_);
+
     return pathToGoal;
 }
 
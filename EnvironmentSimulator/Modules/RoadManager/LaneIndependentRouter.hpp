@@ -2,10 +2,13 @@
 
 #include <string>
 #include <queue>
+#include <deque>
+#include <mutex>
 #include "pugixml.hpp"
 #include "CommonMini.hpp"
 #include "RoadManager.hpp"
 #include <unordered_map>
+#include <unordered_set>
 #include "logger.hpp"
 
 namespace roadmanager
@@ -114,13 +117,25 @@ namespace roadmanager
         ~LaneIndependentRouter();
 
         /**
-         * @brief Calculates the path between two positions.
+         * @brief Calculates the path between two positions. Paths found are cached and shared by all routers, so
+         *        repeated requests from same road, lane and direction to same target are served without searching.
+         *        Node::previous of returned nodes refers to the preceding node in the returned list.
          *
          * @param start
          * @param target
          * @return std::vector<Node *>, empty list if path not found
          */
         std::vector<Node> CalculatePath(Position start, Position target);
+        /**
+         * @brief Calculates the path between two positions, reusing the latest path of this router if the target is the same.
+         *        The search stops as soon as no way back onto the latest path, or to the target, can be shorter than
+         *        the best one found. Typically used when the vehicle has deviated from the path.
+         *
+         * @param start
+         * @param target
+         * @return std::vector<Node *>, empty list if path not found
+         */
+        std::vector<Node> RepairPath(Position start, Position target);
         /**
          * @brief Translate a list of nodes (path) in to waypoints
          *
@@ -131,7 +146,87 @@ namespace roadmanager
          */
         std::vector<Position> GetWaypoints(std::vector<Node> path, Position start, Position target);
 
+        /**
+         * @brief Forget all cached paths
+         *
+         */
+        static void ClearPathCache();
+
+        /**
+         * @brief Get number of cached paths
+         *
+         */
+        static size_t GetPathCacheSize();
+
     private:
+        /**
+         * @brief Identifies a path request, see CalculatePath. Start s only offsets the weights, hence not part of the key.
+         *
+         */
+        struct PathKey
+        {
+            const OpenDrive        *odr;
+            unsigned int            revision;
+            id_t                    startRoadId;
+            int                     startLaneId;
+            bool                    forward;
+            id_t                    targetRoadId;
+            int                     targetLaneId;
+            double                  targetS;
+            Position::RouteStrategy routeStrategy;
+
+            bool operator==(const PathKey &rhs) const;
+        };
+
+        struct PathKeyHash
+        {
+            size_t operator()(const PathKey &key) const;
+        };
+
+        /**
+         * @brief Identifies a node state, road and lane and direction of travel, optionally also the lane coming from
+         *
+         */
+        struct NodeKey
+        {
+            const Road     *road;
+            int             currentLaneId;
+            int             fromLaneId;
+            const RoadLink *link;
+
+            bool operator==(const NodeKey &rhs) const
+            {
+                return road == rhs.road && currentLaneId == rhs.currentLaneId && fromLaneId == rhs.fromLaneId && link == rhs.link;
+            }
+        };
+
+        struct NodeKeyHash
+        {
+            size_t operator()(const NodeKey &key) const;
+        };
+
+        /**
+         * @brief Validate positions and prepare a new search, see CalculatePath
+         *
+         * @param start
+         * @param target
+         * @param key identification of the path request
+         * @return Node*, the start node or nullptr on error
+         */
+        Node *InitSearch(Position &start, Position &target, PathKey &key);
+        /**
+         * @brief Get a node from the pool, valid until next search
+         *
+         * @return Node*
+         */
+        Node *AllocateNode();
+        /**
+         * @brief Collect the path leading to a node, from the start node
+         *
+         * @param node last node of the path
+         * @return std::vector<Node>
+         */
+        std::vector<Node> BacktrackPath(Node *node);
         /**
          * @brief Get the Next Link between two roads
          *
@@ -167,7 +262,7 @@ namespace roadmanager
          * @param pos
          * @return Node*
          */
-        Node *CreateStartNode(RoadLink *link, Road *road, int laneId, ContactPointType contactPoint, Position pos);
+        Node *CreateStartNode(RoadLink *link, Road *road, int laneId, ContactPointType contactPoint, const Position &pos);
         /**
          * @brief Get the next nodes (one for each lane) for the next road
          *
@@ -188,9 +283,12 @@ namespace roadmanager
         /**
          * @brief The main loop of the lane independent pathfinder
          *
-         * @return true if path is found
+         * @param rejoin Nodes (excluding from lane) of a known path to the target, with their index. Nodes found here are not
+         *               expanded further, instead the remaining part of the known path is considered. Optional.
+         * @param rejoinIdx Index in known path of the node where found path joins, or -1 if it reaches the target directly
+         * @return Node*, the last node of the best path or nullptr if no path is found
          */
-        bool FindGoal();
+        Node *FindGoal(const std::unordered_map<NodeKey, int, NodeKeyHash> *rejoin = nullptr, int *rejoinIdx = nullptr);
         /**
          * @brief Checks if a position is valid on the OpenDRIVE network.
          *
@@ -198,28 +296,7 @@ namespace roadmanager
          * @return true
          * @return false
          */
-        bool IsPositionValid(Position pos) const;
-        template <class Q>
-        void clearQueue(Q &q)
-        {
-            while (!q.empty())
-            {
-                auto p = q.top();
-                q.pop();
-                delete p;
-            }
-            q = Q();
-        }
-        template <class V>
-        void clearVector(V &v)
-        {
-            for (auto p : v)
-            {
-                delete p;
-            }
-            v.clear();
-        }
-
+        bool IsPositionValid(const Position &pos) const;
         struct InspectionPriorityQueue : public std::priority_queue<Node *, std::vector<Node *>, WeightCompare>
         {
             using BaseClass = std::priority_queue<Node *, std::vector<Node *>, WeightCompare>;
@@ -232,12 +309,20 @@ namespace roadmanager
             }
         };
 
-        InspectionPriorityQueue unvisited_;
-        std::vector<Node *>     visited_;
-        Position                targetWaypoint_;
-        OpenDrive              *odr_;
-        RoadCalculations        roadCalculations_;
-        Position::RouteStrategy routeStrategy_;
+        InspectionPriorityQueue                  unvisited_;
+        std::unordered_set<NodeKey, NodeKeyHash> visited_;
+        std::deque<Node>                         nodePool_;       // nodes of current search, reused by next one
+        size_t                                   nodesUsed_ = 0;  // number of nodes in pool taken by current search
+        Position                                 targetWaypoint_;
+        Road                                    *targetRoad_ = nullptr;
+        OpenDrive                               *odr_;
+        RoadCalculations                         roadCalculations_;
+        Position::RouteStrategy                  routeStrategy_;
+        std::vector<Node>                        lastPath_;  // latest path found, see RepairPath()
+        PathKey                                  lastPathKey_ = {};
+
+        static std::unordered_map<PathKey, std::vector<Node>, PathKeyHash> pathCache_;
+        static std::mutex                                                   pathCacheMutex_;
     };
 
 }  // namespace roadmanager
\ No newline at end of file
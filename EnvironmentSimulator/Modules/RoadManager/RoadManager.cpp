@@ -50,6 +50,8 @@
 #include <time.h>
 #include <limits>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <map>
 #include <sstream>
 #include <string>
@@ -74,6 +76,7 @@ using namespace roadmanager;
 #define TUNNEL_ROOF_THICKNESS      2.0
 #define TUNNEL_HEIGHT              4.5
 #define MAX_ROAD_LEN_ERROR         0.1
+#define SEGMENT_INDEX_LEAF_SIZE    16  // number of polyline segments per box on lowest level of the segment index
 
 const char* object_type_str[] = {"barrier",   "bike",     "building",     "bus",          "car",           "crosswalk",  "gantry",
                                  "motorbike", "none",     "obstacle",     "parkingSpace", "patch",         "pedestrian", "pole",
@@ -484,6 +487,13 @@ void TrafficLight::UpdateState(const std::string state)
     }
 }
 
+void TrafficLight::SyncState(SE_StateBuffer& buf)
+{
+    buf.Sync(lamps_);
+    buf.Sync(state_);
+    buf.Sync(state_vector_);
+}
+
 void TrafficLight::CheckValidLampModes(const std::string& input) const
 {
     std::istringstream ss(input);
@@ -1239,15 +1249,13 @@ LaneWidth* Lane::GetWidthByIndex(idx_t index) const
 
 LaneWidth* Lane::GetWidthByS(double s) const
 {
-    if (lane_width_.empty())
+    idx_t idx = GetPieceIdxByS(lane_width_, s, [](const LaneWidth* w) { return w->GetSOffset(); });
+    if (idx == IDX_UNDEFINED)
     {
         return 0;  // No lanewidth defined
     }
 
-    auto iter = std::upper_bound(lane_width_.begin() + 1, lane_width_.end(), s, [](double stmp, LaneWidth* w) { return stmp < w->GetSOffset(); });
-    if (iter != lane_width_.end())
-        return *(iter - 1);
-    return lane_width_.back();
+    return lane_width_[idx];
 }
 
 void Lane::AddLaneWidth(LaneWidth* lane_width)
@@ -1662,67 +1670,15 @@ idx_t Road::GetLaneSectionIdxByS(double s, idx_t start_at) const
         return IDX_UNDEFINED;
     }
 
-    LaneSection* lane_section = lane_section_[start_at];
-    if (lane_section == nullptr)
+    if (s > lane_section_.back()->GetS() + lane_section_.back()->GetLength() + SMALL_NUMBER)
     {
-        LOG_ERROR("GetLaneSectionIdxByS: lane_section is null (case 1)");
+        // s is beyond the last lane section
+        LOG_ERROR("GetLaneSectionIdxByS: s {} is beyond the last lane section", s);
         return IDX_UNDEFINED;
     }
 
-    idx_t i;
-    if (s < lane_section->GetS() && start_at > 0 && start_at != IDX_UNDEFINED)
-    {
-        // Look backwards
-        for (i = start_at - 1; i > 0; i--)  // No need to check the first one
-        {
-            lane_section = GetLaneSectionByIdx(i);
-            if (lane_section == nullptr)
-            {
-                LOG_ERROR("GetLaneSectionIdxByS: lane_section is null (case 2)");
-                return IDX_UNDEFINED;
-            }
-
-            if (s > lane_section->GetS())
-            {
-                break;
-            }
-        }
-    }
-    else
-    {
-        // look forward
-        for (i = start_at; i < GetNumberOfLaneSections(); i++)
-        {
-            lane_section = GetLaneSectionByIdx(i);
-            if (lane_section == nullptr)
-            {
-                LOG_ERROR("GetLaneSectionIdxByS: lane_section is null (case 3)");
-                return IDX_UNDEFINED;
-            }
-
-            if (s < lane_section->GetS() + lane_section->GetLength())
-            {
-                break;
-            }
-        }
-
-        if (i == GetNumberOfLaneSections())
-        {
-            if (s > lane_section_.back()->GetS() + lane_section_.back()->GetLength() + SMALL_NUMBER)
-            {
-                // s is beyond the last lane section
-                LOG_ERROR("GetLaneSectionIdxByS: s {} is beyond the last lane section", s);
-                return IDX_UNDEFINED;
-            }
-            else
-            {
-                // s is just slightly beyond the last lane section, accept
-                i = GetNumberOfLaneSections() - 1;
-            }
-        }
-    }
-
-    return i;
+    // Start looking at given index, typically the current lane section of a moving position
+    return GetPieceIdxByS(lane_section_, s, [](const LaneSection* ls) { return ls->GetS(); }, start_at);
 }
 
 int Road::GetLaneInfoByS(double s, idx_t start_lane_section_idx, int start_lane_id, LaneInfo& lane_info, int laneTypeMask) const
@@ -2465,6 +2421,18 @@ RoadMarkInfo Lane::GetRoadMarkInfoByS(id_t track_id, int lane_id, double s) cons
     return rm_info;
 }
 
+static std::atomic<idx_t> road_link_idx_counter(0);
+
+idx_t RoadLink::NewIdx()
+{
+    return road_link_idx_counter++;
+}
+
+void RoadLink::ResetIdxCounter()
+{
+    road_link_idx_counter = 0;
+}
+
 RoadLink::RoadLink(LinkType type, pugi::xml_node node)
 {
     string element_type        = node.attribute("elementType").value();
@@ -2720,6 +2688,76 @@ void Road::AddObject(RMObject* object)
     object_.push_back(object);
 }
 
+static int GetFeatureOrientation(RoadObject::Orientation orientation)
+{
+    return orientation == RoadObject::Orientation::POSITIVE ? 1 : (orientation == RoadObject::Orientation::NEGATIVE ? -1 : 0);
+}
+
+void Road::UpdateFeatureIndex()
+{
+    feature_.clear();
+
+    for (idx_t i = 0; i < signal_.size(); i++)
+    {
+        RoadFeature feature;
+        feature.type        = RoadFeature::SIGNAL;
+        feature.s           = signal_[i]->GetS();
+        feature.orientation = GetFeatureOrientation(signal_[i]->GetOrientation());
+        feature.id          = static_cast<id_t>(signal_[i]->GetId());
+        feature.index       = i;
+        feature.object      = signal_[i];
+        feature_.push_back(feature);
+    }
+
+    for (idx_t i = 0; i < object_.size(); i++)
+    {
+        RoadFeature feature;
+        feature.type        = RoadFeature::OBJECT;
+        feature.s           = object_[i]->GetS();
+        feature.orientation = GetFeatureOrientation(object_[i]->GetOrientation());
+        feature.id          = object_[i]->GetId();
+        feature.index       = i;
+        feature.object      = object_[i];
+        feature_.push_back(feature);
+    }
+
+    // speed limit changes, valid for both directions
+    for (auto it = type_.begin(); it != type_.end(); it++)
+    {
+        if (it != type_.begin() && fabs(it->second->speed_ - std::prev(it)->second->speed_) > SMALL_NUMBER)
+        {
+            RoadFeature feature;
+            feature.type         = RoadFeature::SPEED_LIMIT;
+            feature.s            = it->first;
+            feature.value_behind = std::prev(it)->second->speed_;
+            feature.value_ahead  = it->second->speed_;
+            feature_.push_back(feature);
+        }
+    }
+
+    // lane count changes, per side. Right hand traffic drives on right side (negative lane ids) along s axis.
+    for (idx_t i = 1; i < lane_section_.size(); i++)
+    {
+        for (int side : {-1, 1})
+        {
+            unsigned int n_behind = lane_section_[i - 1]->GetNumberOfDrivingLanesSide(side);
+            unsigned int n_ahead  = lane_section_[i]->GetNumberOfDrivingLanesSide(side);
+            if (n_behind != n_ahead)
+            {
+                RoadFeature feature;
+                feature.type         = RoadFeature::LANE_COUNT;
+                feature.s            = lane_section_[i]->GetS();
+                feature.orientation  = (side == -1) == (rule_ == RoadRule::RIGHT_HAND_TRAFFIC) ? 1 : -1;
+                feature.value_behind = n_behind;
+                feature.value_ahead  = n_ahead;
+                feature_.push_back(feature);
+            }
+        }
+    }
+
+    std::stable_sort(feature_.begin(), feature_.end(), [](const RoadFeature& a, const RoadFeature& b) { return a.s < b.s; });
+}
+
 void Road::AddTunnel(Tunnel* tunnel)
 {
     tunnel_.push_back(tunnel);
@@ -2920,41 +2958,37 @@ RMObject::ObjectType RMObject::Str2Type(std::string type)
     return RMObject::ObjectType::NONE;
 }
 
-double Road::GetLaneOffset(double s) const
+double Road::GetLaneOffset(double s, idx_t* index) const
 {
-    unsigned int i = 0;
+    idx_t i = GetPieceIdxByS(lane_offset_, s, [](const LaneOffset* lo) { return lo->GetS(); }, index ? *index : IDX_UNDEFINED);
 
-    if (lane_offset_.size() == 0)
+    if (i == IDX_UNDEFINED)
     {
         return 0;
     }
 
-    for (; i + 1 < lane_offset_.size(); i++)
+    if (index)
     {
-        if (s < lane_offset_[i + 1]->GetS())
-        {
-            break;
-        }
+        *index = i;
     }
+
     return (lane_offset_[i]->GetLaneOffset(s));
 }
 
-double Road::GetLaneOffsetPrim(double s) const
+double Road::GetLaneOffsetPrim(double s, idx_t* index) const
 {
-    unsigned int i = 0;
+    idx_t i = GetPieceIdxByS(lane_offset_, s, [](const LaneOffset* lo) { return lo->GetS(); }, index ? *index : IDX_UNDEFINED);
 
-    if (lane_offset_.size() == 0)
+    if (i == IDX_UNDEFINED)
     {
         return 0;
     }
 
-    for (; i + 1 < lane_offset_.size(); i++)
+    if (index)
     {
-        if (s < lane_offset_[i + 1]->GetS())
-        {
-            break;
-        }
+        *index = i;
     }
+
     return (lane_offset_[i]->GetLaneOffsetPrim(s));
 }
 
@@ -3346,10 +3380,9 @@ bool Road::GetZAndPitchByS(double s, double* z, double* z_prim, double* z_primPr
 {
     if (GetNumberOfElevations() > 0)
     {
-        if (*index >= GetNumberOfElevations())
-        {
-            *index = 0;
-        }
+        // Move to next elevation section slightly ahead of the boundary
+        *index = GetPieceIdxByS(elevation_profile_, s + SMALL_NUMBER, [](const Elevation* e) { return e->GetS(); }, *index);
+
         Elevation* elevation = GetElevation(*index);
         if (elevation == NULL)
         {
@@ -3357,23 +3390,6 @@ bool Road::GetZAndPitchByS(double s, double* z, double* z_prim, double* z_primPr
             return false;
         }
 
-        if (s > elevation->GetS() + elevation->GetLength() - SMALL_NUMBER)
-        {
-            while (s > elevation->GetS() + elevation->GetLength() - SMALL_NUMBER && *index < GetNumberOfElevations() - 1)
-            {
-                // Move to next elevation section
-                elevation = GetElevation(++*index);
-            }
-        }
-        else if (s < elevation->GetS())
-        {
-            while (s < elevation->GetS() && *index > 0)
-            {
-                // Move to previous elevation section
-                elevation = GetElevation(--*index);
-            }
-        }
-
         if (elevation)
         {
             double p    = s - elevation->GetS();
@@ -3395,10 +3411,8 @@ bool Road::UpdateZAndRollBySAndT(double s, double t, double* z, double* roadSupe
 {
     if (GetNumberOfSuperElevations() > 0)
     {
-        if (*index >= GetNumberOfSuperElevations())
-        {
-            *index = 0;
-        }
+        *index = GetPieceIdxByS(super_elevation_profile_, s, [](const Elevation* e) { return e->GetS(); }, *index);
+
         Elevation* super_elevation = GetSuperElevation(*index);
         if (super_elevation == NULL)
         {
@@ -3406,23 +3420,6 @@ bool Road::UpdateZAndRollBySAndT(double s, double t, double* z, double* roadSupe
             return false;
         }
 
-        if (s > super_elevation->GetS() + super_elevation->GetLength())
-        {
-            while (s > super_elevation->GetS() + super_elevation->GetLength() && *index < GetNumberOfSuperElevations() - 1)
-            {
-                // Move to next elevation section
-                super_elevation = GetSuperElevation(++*index);
-            }
-        }
-        else if (s < super_elevation->GetS())
-        {
-            while (s < super_elevation->GetS() && *index > 0)
-            {
-                // Move to previous elevation section
-                super_elevation = GetSuperElevation(--*index);
-            }
-        }
-
         if (super_elevation)
         {
             double ds = s - super_elevation->GetS();
@@ -3517,6 +3514,9 @@ Junction* OpenDrive::GetJunctionByIdx(idx_t idx) const
     }
 }
 
+// shared by all OpenDrive instances, so that a revision is never reused. See OpenDrive::GetRevision().
+static std::atomic<unsigned int> odr_revision_counter{0};
+
 OpenDrive::OpenDrive(const char* filename) : speed_unit_(SpeedUnit::UNDEFINED)
 {
     if (!LoadOpenDriveFile(filename))
@@ -3580,10 +3580,13 @@ std::string ReadAttribute(pugi::xml_node node, std::string attribute_name, bool
 void OpenDrive::Clear()
 {
     ResetGlobalIdCounter();
+    RoadLink::ResetIdxCounter();
+    revision_ = ++odr_revision_counter;
 
     road_ids_.clear();
     junction_ids_.clear();
     dynamic_signals_.clear();
+    roadmark_osi_pending_.clear();
 
     for (size_t i = 0; i < road_.size(); i++)
     {
@@ -5290,6 +5293,14 @@ bool OpenDrive::ParseOpenDriveXML(const pugi::xml_document& doc)
         LOG_ERROR("Failed to create OSI points for OpenDrive road!");
     }
 
+    // index after OSI setup, which adds tunnel objects
+    for (auto road : road_)
+    {
+        road->UpdateFeatureIndex();
+    }
+
+    revision_ = ++odr_revision_counter;
+
     return true;
 }
 
@@ -5679,46 +5690,61 @@ bool RoadPath::CheckRoad(Road* checkRoad, RoadPath::PathNode* srcNode, Road* fro
         nextLaneId = checkRoad->GetConnectedLaneIdAtS(nextLaneId, 0.0, -1.0);
     }
 
+    workspace_->ReserveLink(nextLink);
+
     // Check if next node is already visited
-    for (size_t i = 0; i < visited_.size(); i++)
+    if (workspace_->visited_stamp[nextLink->GetIdx()] == workspace_->generation)
     {
-        if (visited_[i]->link == nextLink)
-        {
-            // Already visited, ignore and return
-            return false;
-        }
+        // Already visited, ignore and return
+        return false;
     }
 
     // Check if next node is already among unvisited
-    size_t i;
-    for (i = 0; i < unvisited_.size(); i++)
+    if (workspace_->unvisited_stamp[nextLink->GetIdx()] == workspace_->generation)
     {
-        if (unvisited_[i]->link == nextLink)
+        for (size_t i = 0; i < unvisited_.size(); i++)
         {
-            // Consider it, i.e. calc distance and potentially store it (if less than old)
-            if (srcNode->dist + checkRoad->GetLength() < unvisited_[i]->dist)
+            if (unvisited_[i]->link == nextLink)
             {
-                unvisited_[i]->dist = srcNode->dist + checkRoad->GetLength();
+                // Consider it, i.e. calc distance and potentially store it (if less than old)
+                if (srcNode->dist + checkRoad->GetLength() < unvisited_[i]->dist)
+                {
+                    unvisited_[i]->dist = srcNode->dist + checkRoad->GetLength();
+                }
             }
         }
     }
 
-    if (i == unvisited_.size())
-    {
-        // link not visited before, add it
-        PathNode* pNode     = new PathNode;
-        pNode->dist         = srcNode->dist + checkRoad->GetLength();
-        pNode->link         = nextLink;
-        pNode->fromRoad     = checkRoad;
-        pNode->fromLaneId   = nextLaneId;
-        pNode->previous     = srcNode;
-        pNode->contactPoint = contact_point;
-        unvisited_.push_back(pNode);
-    }
+    // add link, including new path to it
+    PathNode* pNode     = workspace_->NewNode();
+    pNode->dist         = srcNode->dist + checkRoad->GetLength();
+    pNode->link         = nextLink;
+    pNode->fromRoad     = checkRoad;
+    pNode->fromLaneId   = nextLaneId;
+    pNode->previous     = srcNode;
+    pNode->contactPoint = contact_point;
+    AddUnvisited(pNode);
 
     return true;
 }
 
+void RoadPath::AddUnvisited(PathNode* node)
+{
+    workspace_->ReserveLink(node->link);
+    workspace_->unvisited_stamp[node->link->GetIdx()] = workspace_->generation;
+    unvisited_.push_back(node);
+}
+
+void RoadPath::MarkVisited(idx_t unvisited_idx)
+{
+    PathNode* node = unvisited_[unvisited_idx];
+
+    // Mark pivot link as visited (move it from unvisited to visited)
+    workspace_->visited_stamp[node->link->GetIdx()] = workspace_->generation;
+    visited_.push_back(node);
+    unvisited_.erase(unvisited_.begin() + unvisited_idx);
+}
+
 int RoadPath::Calculate(double& dist, bool bothDirections, double maxDist)
 {
     OpenDrive* odr = startPos_->GetOpenDrive();
@@ -5783,7 +5809,7 @@ int RoadPath::Calculate(double& dist, bool bothDirections, double maxDist)
 
         if (link)
         {
-            PathNode* pNode = new PathNode;
+            PathNode* pNode = workspace_->NewNode();
             pNode->link     = link;
             pNode->fromRoad = pivotRoad;
 
@@ -5812,7 +5838,7 @@ int RoadPath::Calculate(double& dist, bool bothDirections, double maxDist)
                 pNode->dist = pivotRoad->GetLength() - startPos_->GetS();  // distance to end of road
             }
 
-            unvisited_.push_back(pNode);
+            AddUnvisited(pNode);
         }
     }
 
@@ -5950,9 +5976,7 @@ int RoadPath::Calculate(double& dist, bool bothDirections, double maxDist)
             }
         }
 
-        // Mark pivot link as visited (move it from unvisited to visited)
-        visited_.push_back(unvisited_[minIndex]);
-        unvisited_.erase(unvisited_.begin() + minIndex);
+        MarkVisited(minIndex);
     }
 
     if (found)
@@ -6001,19 +6025,331 @@ int RoadPath::Calculate(double& dist, bool bothDirections, double maxDist)
     return found ? 0 : -1;
 }
 
+RoadPath::RoadPath(const Position* startPos, const Position* targetPos)
+    : workspace_(AcquireWorkspace()),
+      visited_(workspace_->visited),
+      unvisited_(workspace_->unvisited),
+      startPos_(startPos),
+      targetPos_(targetPos),
+      direction_(0),
+      firstNode_(nullptr)
+{
+}
+
 RoadPath::~RoadPath()
 {
-    for (size_t i = 0; i < visited_.size(); i++)
+    ReleaseWorkspace(workspace_);
+}
+
+void RoadPath::Workspace::Reset()
+{
+    n_nodes_used = 0;
+    visited.clear();
+    unvisited.clear();
+
+    if (++generation == 0)
+    {
+        // stamps wrapped around, clear to avoid false matches
+        std::fill(visited_stamp.begin(), visited_stamp.end(), 0);
+        std::fill(unvisited_stamp.begin(), unvisited_stamp.end(), 0);
+        generation = 1;
+    }
+}
+
+RoadPath::PathNode* RoadPath::Workspace::NewNode()
+{
+    if (n_nodes_used == node_pool.size())
     {
-        delete (visited_[i]);
+        node_pool.push_back(std::make_unique<PathNode>());
     }
-    visited_.clear();
 
-    for (size_t i = 0; i < unvisited_.size(); i++)
+    PathNode* node = node_pool[n_nodes_used++].get();
+    *node          = PathNode();
+
+    return node;
+}
+
+void RoadPath::Workspace::ReserveLink(const RoadLink* link)
+{
+    if (link->GetIdx() >= visited_stamp.size())
+    {
+        visited_stamp.resize(link->GetIdx() + 1, 0);
+        unvisited_stamp.resize(link->GetIdx() + 1, 0);
+    }
+}
+
+// Free workspaces of current thread. Nested path searches, e.g. distance calculations while
+// another path is alive, will get a workspace of their own.
+static thread_local std::vector<std::unique_ptr<RoadPath::Workspace>> free_path_workspaces_;
+
+RoadPath::Workspace* RoadPath::AcquireWorkspace()
+{
+    Workspace* workspace = nullptr;
+
+    if (free_path_workspaces_.empty())
+    {
+        workspace = new Workspace;
+    }
+    else
+    {
+        workspace = free_path_workspaces_.back().release();
+        free_path_workspaces_.pop_back();
+    }
+
+    workspace->Reset();
+
+    return workspace;
+}
+
+void RoadPath::ReleaseWorkspace(Workspace* workspace)
+{
+    free_path_workspaces_.push_back(std::unique_ptr<Workspace>(workspace));
+}
+
+static unsigned int GetNumberOfDrivingLanesInDirection(const Road* road, double s, int direction)
+{
+    if (road->GetNumberOfLaneSections() == 0)
+    {
+        return 0;
+    }
+
+    // right hand traffic drives on right side (negative lane ids) along s axis
+    return road->GetNumberOfDrivingLanesSide(s, road->GetRule() == Road::RoadRule::RIGHT_HAND_TRAFFIC ? -direction : direction);
+}
+
+void RoadFeatureCursor::Reset()
+{
+    segment_.clear();
+    hit_.clear();
+    route_        = nullptr;
+    route_size_   = 0;
+    odr_revision_ = 0;
+}
+
+bool RoadFeatureCursor::AddNextSegment(const Route* route)
+{
+    OpenDrive*       odr           = Position::GetOpenDrive();
+    Segment&         last          = segment_.back();
+    RoadLink*        link          = last.road->GetLink(last.direction > 0 ? LinkType::SUCCESSOR : LinkType::PREDECESSOR);
+    Road*            next_road     = nullptr;
+    ContactPointType contact_point = ContactPointType::CONTACT_POINT_UNDEFINED;
+
+    if (link != nullptr && link->GetElementType() == RoadLink::ELEMENT_TYPE_ROAD)
+    {
+        next_road     = odr->GetRoadById(link->GetElementId());
+        contact_point = link->GetContactPointType();
+    }
+    else if (link != nullptr && link->GetElementType() == RoadLink::ELEMENT_TYPE_JUNCTION)
+    {
+        Junction* junction = odr->GetJunctionById(link->GetElementId());
+        if (junction != nullptr)
+        {
+            // pick connection leading to next road of the route, else the one most straight ahead
+            Road*    target = route != nullptr ? route->GetRoadAtOtherEndOfIncomingRoad(junction, last.road) : nullptr;
+            Position pos;
+            pos.SetTrackPos(last.road->GetId(), last.s_end, 0.0);
+            double h_out    = last.direction > 0 ? pos.GetHRoad() : GetAngleSum(pos.GetHRoad(), M_PI);
+            double min_diff = LARGE_NUMBER;
+
+            for (Connection* connection : junction->GetConnections())
+            {
+                Road* connecting_road = connection->GetConnectingRoad();
+                if (connection->GetIncomingRoad() != last.road || connecting_road == nullptr)
+                {
+                    continue;
+                }
+
+                if (target != nullptr)
+                {
+                    Road* outgoing_road = junction->GetType() == Junction::JunctionType::DIRECT
+                                              ? connecting_road
+                                              : junction->GetRoadAtOtherEndOfConnectingRoad(connecting_road, last.road);
+                    if (outgoing_road == target)
+                    {
+                        next_road     = connecting_road;
+                        contact_point = connection->GetContactPoint();
+                        break;
+                    }
+                }
+
+                // compare heading at the far end of the connecting road
+                bool forward = connection->GetContactPoint() == ContactPointType::CONTACT_POINT_START;
+                pos.SetTrackPos(connecting_road->GetId(), forward ? connecting_road->GetLength() : 0.0, 0.0);
+                double diff = GetAbsAngleDifference(forward ? pos.GetHRoad() : GetAngleSum(pos.GetHRoad(), M_PI), h_out);
+                if (diff < min_diff - SMALL_NUMBER)
+                {
+                    min_diff      = diff;
+                    next_road     = connecting_road;
+                    contact_point = connection->GetContactPoint();
+                }
+            }
+        }
+    }
+
+    if (next_road == nullptr ||
+        (contact_point != ContactPointType::CONTACT_POINT_START && contact_point != ContactPointType::CONTACT_POINT_END))
+    {
+        last.dead_end = true;
+        return false;
+    }
+
+    Segment segment;
+    segment.road       = next_road;
+    segment.direction  = contact_point == ContactPointType::CONTACT_POINT_START ? 1 : -1;
+    segment.s_start    = segment.direction > 0 ? 0.0 : next_road->GetLength();
+    segment.s_end      = segment.direction > 0 ? next_road->GetLength() : 0.0;
+    segment.dist_start = last.dist_start + fabs(last.s_end - last.s_start);
+    segment.dead_end   = false;
+    segment_.push_back(segment);
+
+    return true;
+}
+
+int RoadFeatureCursor::Update(const Position& pos, double distance, int type_mask, unsigned int max_hits)
+{
+    hit_.clear();
+
+    // roads ahead refer to any previously loaded road network
+    if (Position::GetOpenDrive()->GetRevision() != odr_revision_)
+    {
+        Reset();
+        odr_revision_ = Position::GetOpenDrive()->GetRevision();
+    }
+
+    Road* road = Position::GetOpenDrive()->GetRoadById(pos.GetTrackId());
+    if (road == nullptr)
+    {
+        Reset();
+        return -1;
+    }
+
+    int          direction  = IsAngleForward(pos.GetHRelative()) ? 1 : -1;
+    double       s          = pos.GetS();
+    const Route* route      = (pos.GetRoute() != nullptr && pos.GetRoute()->IsValid()) ? pos.GetRoute() : nullptr;
+    size_t       route_size = route != nullptr ? route->minimal_waypoints_.size() : 0;
+
+    if (route != route_ || route_size != route_size_)
+    {
+        segment_.clear();
+    }
+    route_      = route;
+    route_size_ = route_size;
+
+    // find current road among the ones ahead and skip the ones passed, else start over
+    size_t idx = 0;
+    while (idx < segment_.size() &&
+           !(segment_[idx].road == road && segment_[idx].direction == direction && (s - segment_[idx].s_start) * direction > -SMALL_NUMBER))
+    {
+        idx++;
+    }
+
+    if (idx == segment_.size())
+    {
+        segment_.clear();
+        segment_.push_back({road, direction, s, direction > 0 ? road->GetLength() : 0.0, 0.0, false});
+    }
+    else if (idx > 0)
+    {
+        segment_.erase(segment_.begin(), segment_.begin() + static_cast<long>(idx));
+        double offset = segment_[0].dist_start;
+        for (Segment& segment : segment_)
+        {
+            segment.dist_start -= offset;
+        }
+    }
+
+    // distance already travelled along first segment
+    double dist_now = (s - segment_[0].s_start) * direction;
+
+    // add roads until look-ahead distance is covered. Only a loop of zero length roads could go on forever, bail out.
+    for (unsigned int n_zero_length = 0; n_zero_length <= Position::GetOpenDrive()->GetNumOfRoads();)
+    {
+        const Segment& last = segment_.back();
+        if (last.dead_end || last.dist_start + fabs(last.s_end - last.s_start) - dist_now > distance || !AddNextSegment(route))
+        {
+            break;
+        }
+        n_zero_length = segment_.back().road->GetLength() < SMALL_NUMBER ? n_zero_length + 1 : 0;
+    }
+
+    bool done    = false;
+    auto add_hit = [&](RoadFeature::Type type, double dist, const Segment& segment, double feature_s, double value, const RoadFeature* feature)
+    {
+        if (dist > distance || (max_hits > 0 && hit_.size() >= max_hits))
+        {
+            done = true;
+        }
+        else if (type & type_mask)
+        {
+            hit_.push_back({type,
+                            dist,
+                            segment.road->GetId(),
+                            feature_s,
+                            segment.direction,
+                            value,
+                            feature != nullptr ? feature->id : ID_UNDEFINED,
+                            feature != nullptr ? feature->index : IDX_UNDEFINED,
+                            feature != nullptr ? feature->object : nullptr});
+        }
+    };
+
+    for (size_t i = 0; i < segment_.size() && !done; i++)
     {
-        delete (unvisited_[i]);
+        const Segment& segment = segment_[i];
+
+        if (i > 0)
+        {
+            // changes where roads connect
+            const Segment& prev  = segment_[i - 1];
+            double         dist  = segment.dist_start - dist_now;
+            double         speed = segment.road->GetSpeedByS(segment.s_start);
+            if (fabs(speed - prev.road->GetSpeedByS(prev.s_end)) > SMALL_NUMBER)
+            {
+                add_hit(RoadFeature::SPEED_LIMIT, dist, segment, segment.s_start, speed, nullptr);
+            }
+
+            unsigned int n_lanes = GetNumberOfDrivingLanesInDirection(segment.road, segment.s_start, segment.direction);
+            if (n_lanes != GetNumberOfDrivingLanesInDirection(prev.road, prev.s_end, prev.direction))
+            {
+                add_hit(RoadFeature::LANE_COUNT, dist, segment, segment.s_start, n_lanes, nullptr);
+            }
+        }
+
+        // features are sorted by s, walk them in direction of travel
+        const std::vector<RoadFeature>& features        = segment.road->GetFeatures();
+        double                          s_from          = i == 0 ? s : segment.s_start;
+        auto                            add_feature_hit = [&](const RoadFeature& feature)
+        {
+            if (feature.orientation == 0 || feature.orientation == segment.direction)
+            {
+                add_hit(feature.type,
+                        segment.dist_start + (feature.s - segment.s_start) * segment.direction - dist_now,
+                        segment,
+                        feature.s,
+                        segment.direction > 0 ? feature.value_ahead : feature.value_behind,
+                        &feature);
+            }
+        };
+
+        if (segment.direction > 0)
+        {
+            auto it = std::lower_bound(features.begin(), features.end(), s_from, [](const RoadFeature& f, double value) { return f.s < value; });
+            for (; it != features.end() && !done && it->s < segment.s_end + SMALL_NUMBER; it++)
+            {
+                add_feature_hit(*it);
+            }
+        }
+        else
+        {
+            auto it = std::upper_bound(features.begin(), features.end(), s_from, [](double value, const RoadFeature& f) { return value < f.s; });
+            while (it != features.begin() && !done && std::prev(it)->s > segment.s_end - SMALL_NUMBER)
+            {
+                add_feature_hit(*(--it));
+            }
+        }
     }
-    unvisited_.clear();
+
+    return static_cast<int>(hit_.size());
 }
 
 OpenDrive::~OpenDrive()
@@ -6985,6 +7321,7 @@ void Position::Init()
     lane_idx_            = IDX_UNDEFINED;
     elevation_idx_       = IDX_UNDEFINED;
     super_elevation_idx_ = IDX_UNDEFINED;
+    lane_offset_idx_     = IDX_UNDEFINED;
     osi_point_idx_       = IDX_UNDEFINED;
     route_               = 0;
     trajectory_          = 0;
@@ -7101,6 +7438,8 @@ void Position::CopyLocation(const Position& from)
     offset_                 = from.offset_;
     curvature_              = from.curvature_;
     elevation_idx_          = from.elevation_idx_;
+    super_elevation_idx_    = from.super_elevation_idx_;
+    lane_offset_idx_        = from.lane_offset_idx_;
     track_idx_              = from.track_idx_;
     lane_idx_               = from.lane_idx_;
     geometry_idx_           = from.geometry_idx_;
@@ -7154,6 +7493,24 @@ void Position::Duplicate(const Position& from)
     t_trajectory_    = from.t_trajectory_;
 }
 
+void Position::SyncState(SE_StateBuffer& buf)
+{
+    // Duplicate() covers location and motion, remaining fields are synced explicitly
+    Position state(*this);
+    buf.Sync(state);
+    if (buf.IsRestoring())
+    {
+        Duplicate(state);
+    }
+
+    buf.Sync(route_);
+    buf.Sync(trajectory_);
+    buf.Sync(osi_x_);
+    buf.Sync(osi_y_);
+    buf.Sync(osi_z_);
+    buf.Sync(overlapping_roads);
+}
+
 void Position::Clean()
 {
     if (route_ != nullptr)
@@ -7368,11 +7725,15 @@ bool OpenDrive::CheckLaneOSIRequirement(std::vector<double> x0, std::vector<doub
     }
 }
 
-void OpenDrive::SetLaneOSIPoints()
+void OpenDrive::SetLaneOSIPoints(SE_ThreadPool& pool)
+{
+    pool.ParallelFor(road_.size(), [this](size_t i) { SetLaneOSIPoints(road_[i]); });
+}
+
+void OpenDrive::SetLaneOSIPoints(Road* road)
 {
     // Initialization
     Position                 pos_pivot, pos_tmp, pos_candidate, pos_last_ok;
-    Road*                    road;
     LaneSection*             lsec;
     Lane*                    lane;
     unsigned int             number_of_lanes;
@@ -7385,100 +7746,285 @@ void OpenDrive::SetLaneOSIPoints()
     pos_tmp.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
     pos_candidate.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
 
-    // Looping through each road
-    for (unsigned int i = 0; i < road_.size(); i++)
+    if (road->GetJunction() == ID_UNDEFINED)
     {
-        road = road_[i];
-
-        if (road->GetJunction() == ID_UNDEFINED)
+        osiintersection = ID_UNDEFINED;
+    }
+    else
+    {
+        Junction* junction = GetJunctionById(road->GetJunction());
+        if (junction && junction->IsOsiIntersection())
+        {
+            osiintersection = GetJunctionById(road->GetJunction())->GetGlobalId();
+        }
+        else
         {
             osiintersection = ID_UNDEFINED;
         }
+    }
+
+    // Looping through each lane section
+    unsigned int number_of_lane_sections = road->GetNumberOfLaneSections();
+    for (unsigned int j = 0; j < number_of_lane_sections; j++)
+    {
+        // Get the ending position of the current lane section
+        lsec = road->GetLaneSectionByIdx(j);
+        if (j == number_of_lane_sections - 1)
+        {
+            lsec_end = road->GetLength();
+        }
         else
         {
-            Junction* junction = GetJunctionById(road->GetJunction());
-            if (junction && junction->IsOsiIntersection())
+            lsec_end = road->GetLaneSectionByIdx(j + 1)->GetS();
+        }
+
+        // Looping through each lane
+        number_of_lanes        = lsec->GetNumberOfLanes();
+        double lane_offset_max = 0.0;
+        for (unsigned int k = 0; k < number_of_lanes + 1; k++)  // +1 for center lane
+        {
+            std::vector<double> x0, y0, x1, y1;
+
+            if (k < number_of_lanes)
             {
-                osiintersection = GetJunctionById(road->GetJunction())->GetGlobalId();
+                lane = lsec->GetLaneByIdx(k);
             }
             else
             {
-                osiintersection = ID_UNDEFINED;
+                lane = lsec->GetLaneById(0);
+                if (lane_offset_max < SMALL_NUMBER)
+                {
+                    // no lane offset, reference line identical to center lane
+                    lsec->GetRefLineOSIPoints().Set(lane->GetOSIPoints()->GetPoints());
+                    continue;
+                }
+                else
+                {
+                    // create unique points for reference line
+                }
             }
-        }
+            int counter = 0;
 
-        // Looping through each lane section
-        unsigned int number_of_lane_sections = road_[i]->GetNumberOfLaneSections();
-        for (unsigned int j = 0; j < number_of_lane_sections; j++)
-        {
-            // Get the ending position of the current lane section
-            lsec = road->GetLaneSectionByIdx(j);
-            if (j == number_of_lane_sections - 1)
+            // [XO, YO] = Real position with no tolerance
+            if (k < number_of_lanes)
             {
-                lsec_end = road->GetLength();
+                if (pos_pivot.SetLanePos(road->GetId(), lane->GetId(), lsec->GetS(), 0, j) != Position::ReturnCode::OK)
+                {
+                    break;
+                }
             }
             else
             {
-                lsec_end = road->GetLaneSectionByIdx(j + 1)->GetS();
+                if (pos_pivot.SetTrackPos(road->GetId(), lsec->GetS(), 0.0) != Position::ReturnCode::OK)
+                {
+                    break;
+                }
             }
 
-            // Looping through each lane
-            number_of_lanes        = lsec->GetNumberOfLanes();
-            double lane_offset_max = 0.0;
-            for (unsigned int k = 0; k < number_of_lanes + 1; k++)  // +1 for center lane
+            // Add the starting point of each lane as osi point
+            PointStruct p = {lsec->GetS(), pos_pivot.GetX(), pos_pivot.GetY(), pos_pivot.GetZ(), pos_pivot.GetHRoad(), false};
+            osi_point.push_back(p);
+            pos_last_ok = pos_pivot;
+
+            // [XO, YO] = closest position with given (-) tolerance
+            if (k < number_of_lanes)
             {
-                std::vector<double> x0, y0, x1, y1;
+                pos_tmp.SetLanePos(road->GetId(), lane->GetId(), MAX(0, lsec->GetS() - OSI_TANGENT_LINE_TOLERANCE), 0, j);
+            }
+            else
+            {
+                pos_tmp.SetTrackPos(road->GetId(), MAX(0, lsec->GetS() - OSI_TANGENT_LINE_TOLERANCE), 0.0);
+            }
+            x0.push_back(pos_tmp.GetX());
+            y0.push_back(pos_tmp.GetY());
+
+            // Push real position between the +/- tolerance points
+            x0.push_back(pos_pivot.GetX());
+            y0.push_back(pos_pivot.GetY());
+
+            // [XO, YO] = closest position with given (+) tolerance
+            if (k < number_of_lanes)
+            {
+                pos_tmp.SetLanePos(road->GetId(), lane->GetId(), MIN(lsec->GetS() + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0, j);
+            }
+            else
+            {
+                pos_tmp.SetTrackPos(road->GetId(), MIN(lsec->GetS() + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0.0);
+            }
+            x0.push_back(pos_tmp.GetX());
+            y0.push_back(pos_tmp.GetY());
+
+            bool   insert = false;
+            double step   = MIN(OSI_POINT_CALC_STEPSIZE, lsec->GetLength());
 
+            pos_candidate = pos_pivot;
+
+            // Looping through sequential points along the track determined by "OSI_POINT_CALC_STEPSIZE"
+            while (++counter)
+            {
+                // Make sure we stay within lane section length
+                double s = MIN(pos_candidate.GetS() + step, lsec_end - SMALL_NUMBER / 2);
+
+                if (lane->GetId() == 0)  // center lane
+                {
+                    lane_offset_max = MAX(lane_offset_max, fabs(road->GetLaneOffset(s)));
+                }
+
+                // [X1, Y1] = Real position with no tolerance
                 if (k < number_of_lanes)
                 {
-                    lane = lsec->GetLaneByIdx(k);
+                    pos_candidate.SetLanePos(road->GetId(), lane->GetId(), s, 0, j);
                 }
                 else
                 {
-                    lane = lsec->GetLaneById(0);
-                    if (lane_offset_max < SMALL_NUMBER)
-                    {
-                        // no lane offset, reference line identical to center lane
-                        lsec->GetRefLineOSIPoints().Set(lane->GetOSIPoints()->GetPoints());
-                        continue;
-                    }
-                    else
-                    {
-                        // create unique points for reference line
-                    }
+                    pos_candidate.SetTrackPos(road->GetId(), s, 0.0);
                 }
-                int counter = 0;
 
-                // [XO, YO] = Real position with no tolerance
+                // [X1, Y1] = closest position with given (-) tolerance
                 if (k < number_of_lanes)
                 {
-                    if (pos_pivot.SetLanePos(road->GetId(), lane->GetId(), lsec->GetS(), 0, j) != Position::ReturnCode::OK)
-                    {
-                        break;
-                    }
+                    pos_tmp.SetLanePos(road->GetId(), lane->GetId(), MAX(s - OSI_TANGENT_LINE_TOLERANCE, 0), 0, j);
                 }
                 else
                 {
-                    if (pos_pivot.SetTrackPos(road->GetId(), lsec->GetS(), 0.0) != Position::ReturnCode::OK)
-                    {
-                        break;
-                    }
+                    pos_tmp.SetTrackPos(road->GetId(), MAX(s - OSI_TANGENT_LINE_TOLERANCE, 0), 0.0);
                 }
+                x1.push_back(pos_tmp.GetX());
+                y1.push_back(pos_tmp.GetY());
 
-                // Add the starting point of each lane as osi point
-                PointStruct p = {lsec->GetS(), pos_pivot.GetX(), pos_pivot.GetY(), pos_pivot.GetZ(), pos_pivot.GetHRoad(), false};
-                osi_point.push_back(p);
-                pos_last_ok = pos_pivot;
+                x1.push_back(pos_candidate.GetX());
+                y1.push_back(pos_candidate.GetY());
 
-                // [XO, YO] = closest position with given (-) tolerance
+                // [X1, Y1] = closest position with given (+) tolerance
                 if (k < number_of_lanes)
                 {
-                    pos_tmp.SetLanePos(road->GetId(), lane->GetId(), MAX(0, lsec->GetS() - OSI_TANGENT_LINE_TOLERANCE), 0, j);
+                    pos_tmp.SetLanePos(road->GetId(), lane->GetId(), MIN(s + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0, j);
                 }
                 else
                 {
-                    pos_tmp.SetTrackPos(road->GetId(), MAX(0, lsec->GetS() - OSI_TANGENT_LINE_TOLERANCE), 0.0);
+                    pos_tmp.SetTrackPos(road->GetId(), MIN(s + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0.0);
+                }
+
+                x1.push_back(pos_tmp.GetX());
+                y1.push_back(pos_tmp.GetY());
+
+                int add_point_status = CheckAndAddOSIPoint(pos_pivot,
+                                                           pos_candidate,
+                                                           pos_last_ok,
+                                                           x0,
+                                                           y0,
+                                                           x1,
+                                                           y1,
+                                                           step,
+                                                           osi_requirement,
+                                                           osi_point,
+                                                           insert,
+                                                           lsec_end);
+                if (add_point_status == 2)
+                {
+                    break;
+                }
+                else if (add_point_status == 1)
+                {
+                    pos_candidate = pos_pivot;
                 }
+            }
+
+            if (k < number_of_lanes)
+            {
+                // Set all collected osi points for the current lane
+                lane->osi_points_.Set(osi_point);
+                lane->SetOSIIntersection(osiintersection);
+            }
+            else
+            {
+                // Set collected osi points for the reference line
+                lsec->GetRefLineOSIPoints().Set(osi_point);
+            }
+
+            // Clear osi collectors for next iteration
+            osi_point.clear();
+        }
+    }
+}
+
+void OpenDrive::SetLaneBoundaryPoints(SE_ThreadPool& pool)
+{
+    std::vector<std::vector<std::pair<Lane*, std::vector<PointStruct>>>> boundaries(road_.size());
+
+    pool.ParallelFor(road_.size(), [this, &boundaries](size_t i) { SetLaneBoundaryPoints(road_[i], boundaries[i]); });
+
+    // Create lane boundaries sequentially, since global ids are assigned on creation
+    for (auto& road_boundaries : boundaries)
+    {
+        for (auto& boundary : road_boundaries)
+        {
+            // Initialization of LaneBoundary class
+            LaneBoundaryOSI* lb = new LaneBoundaryOSI(0);
+            // add the lane boundary class to the lane class and generating the global id
+            boundary.first->SetLaneBoundary(lb);
+            // Fills up the osi points in the lane boundary class
+            lb->osi_points_.Set(boundary.second);
+        }
+    }
+}
+
+void OpenDrive::SetLaneBoundaryPoints(Road* road, std::vector<std::pair<Lane*, std::vector<PointStruct>>>& boundaries)
+{
+    // Initialization
+    Position                 pos_pivot, pos_tmp, pos_candidate, pos_last_ok;
+    LaneSection*             lsec;
+    Lane*                    lane;
+    unsigned int             number_of_lanes;
+    double                   lsec_end;
+    std::vector<PointStruct> osi_point;
+    bool                     osi_requirement;
+
+    pos_pivot.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
+    pos_tmp.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
+    pos_candidate.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
+
+    // Looping through each lane section
+    unsigned int number_of_lane_sections = road->GetNumberOfLaneSections();
+    for (unsigned int j = 0; j < number_of_lane_sections; j++)
+    {
+        // Get the ending position of the current lane section
+        lsec = road->GetLaneSectionByIdx(j);
+        if (j == number_of_lane_sections - 1)
+        {
+            lsec_end = road->GetLength();
+        }
+        else
+        {
+            lsec_end = road->GetLaneSectionByIdx(j + 1)->GetS();
+        }
+        // Looping through each lane
+        number_of_lanes = lsec->GetNumberOfLanes();
+        for (unsigned int k = 0; k < number_of_lanes; k++)
+        {
+            lane                     = lsec->GetLaneByIdx(k);
+            unsigned int n_roadmarks = lane->GetNumberOfRoadMarks();
+
+            if (n_roadmarks == 0)
+            {
+                std::vector<double> x0, y0, x1, y1;
+
+                lane                 = lsec->GetLaneByIdx(k);
+                unsigned int counter = 0;
+
+                // [XO, YO] = Real position with no tolerance
+                if (pos_pivot.SetLaneBoundaryPos(road->GetId(), lane->GetId(), lsec->GetS(), 0, j) != Position::ReturnCode::OK)
+                {
+                    break;
+                }
+
+                // Add the starting point of each lane as osi point
+                PointStruct p = {lsec->GetS(), pos_pivot.GetX(), pos_pivot.GetY(), pos_pivot.GetZ(), pos_pivot.GetHRoad(), false};
+                osi_point.push_back(p);
+                pos_last_ok = pos_pivot;
+
+                // [XO, YO] = closest position with given (-) tolerance
+                pos_tmp.SetLaneBoundaryPos(road->GetId(), lane->GetId(), MAX(0, lsec->GetS() - OSI_TANGENT_LINE_TOLERANCE), 0, j);
                 x0.push_back(pos_tmp.GetX());
                 y0.push_back(pos_tmp.GetY());
 
@@ -7487,14 +8033,7 @@ void OpenDrive::SetLaneOSIPoints()
                 y0.push_back(pos_pivot.GetY());
 
                 // [XO, YO] = closest position with given (+) tolerance
-                if (k < number_of_lanes)
-                {
-                    pos_tmp.SetLanePos(road->GetId(), lane->GetId(), MIN(lsec->GetS() + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0, j);
-                }
-                else
-                {
-                    pos_tmp.SetTrackPos(road->GetId(), MIN(lsec->GetS() + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0.0);
-                }
+                pos_tmp.SetLaneBoundaryPos(road->GetId(), lane->GetId(), MIN(lsec->GetS() + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0, j);
                 x0.push_back(pos_tmp.GetX());
                 y0.push_back(pos_tmp.GetY());
 
@@ -7509,30 +8048,11 @@ void OpenDrive::SetLaneOSIPoints()
                     // Make sure we stay within lane section length
                     double s = MIN(pos_candidate.GetS() + step, lsec_end - SMALL_NUMBER / 2);
 
-                    if (lane->GetId() == 0)  // center lane
-                    {
-                        lane_offset_max = MAX(lane_offset_max, fabs(road->GetLaneOffset(s)));
-                    }
-
                     // [X1, Y1] = Real position with no tolerance
-                    if (k < number_of_lanes)
-                    {
-                        pos_candidate.SetLanePos(road->GetId(), lane->GetId(), s, 0, j);
-                    }
-                    else
-                    {
-                        pos_candidate.SetTrackPos(road->GetId(), s, 0.0);
-                    }
+                    pos_candidate.SetLaneBoundaryPos(road->GetId(), lane->GetId(), s, 0, j);
 
                     // [X1, Y1] = closest position with given (-) tolerance
-                    if (k < number_of_lanes)
-                    {
-                        pos_tmp.SetLanePos(road->GetId(), lane->GetId(), MAX(s - OSI_TANGENT_LINE_TOLERANCE, 0), 0, j);
-                    }
-                    else
-                    {
-                        pos_tmp.SetTrackPos(road->GetId(), MAX(s - OSI_TANGENT_LINE_TOLERANCE, 0), 0.0);
-                    }
+                    pos_tmp.SetLaneBoundaryPos(road->GetId(), lane->GetId(), MAX(s - OSI_TANGENT_LINE_TOLERANCE, 0), 0, j);
                     x1.push_back(pos_tmp.GetX());
                     y1.push_back(pos_tmp.GetY());
 
@@ -7540,15 +8060,7 @@ void OpenDrive::SetLaneOSIPoints()
                     y1.push_back(pos_candidate.GetY());
 
                     // [X1, Y1] = closest position with given (+) tolerance
-                    if (k < number_of_lanes)
-                    {
-                        pos_tmp.SetLanePos(road->GetId(), lane->GetId(), MIN(s + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0, j);
-                    }
-                    else
-                    {
-                        pos_tmp.SetTrackPos(road->GetId(), MIN(s + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0.0);
-                    }
-
+                    pos_tmp.SetLaneBoundaryPos(road->GetId(), lane->GetId(), MIN(s + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0, j);
                     x1.push_back(pos_tmp.GetX());
                     y1.push_back(pos_tmp.GetY());
 
@@ -7564,177 +8076,34 @@ void OpenDrive::SetLaneOSIPoints()
                                                                osi_point,
                                                                insert,
                                                                lsec_end);
-                    if (add_point_status == 2)
-                    {
-                        break;
-                    }
-                    else if (add_point_status == 1)
-                    {
-                        pos_candidate = pos_pivot;
-                    }
-                }
-
-                if (k < number_of_lanes)
-                {
-                    // Set all collected osi points for the current lane
-                    lane->osi_points_.Set(osi_point);
-                    lane->SetOSIIntersection(osiintersection);
-                }
-                else
-                {
-                    // Set collected osi points for the reference line
-                    lsec->GetRefLineOSIPoints().Set(osi_point);
-                }
-
-                // Clear osi collectors for next iteration
-                osi_point.clear();
-            }
-        }
-    }
-}
-
-void OpenDrive::SetLaneBoundaryPoints()
-{
-    // Initialization
-    Position                 pos_pivot, pos_tmp, pos_candidate, pos_last_ok;
-    Road*                    road;
-    LaneSection*             lsec;
-    Lane*                    lane;
-    unsigned int             number_of_lanes;
-    double                   lsec_end;
-    std::vector<PointStruct> osi_point;
-    bool                     osi_requirement;
-
-    pos_pivot.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
-    pos_tmp.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
-    pos_candidate.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
-
-    // Looping through each road
-    for (unsigned int i = 0; i < road_.size(); i++)
-    {
-        road = road_[i];
-
-        // Looping through each lane section
-        unsigned int number_of_lane_sections = road_[i]->GetNumberOfLaneSections();
-        for (unsigned int j = 0; j < number_of_lane_sections; j++)
-        {
-            // Get the ending position of the current lane section
-            lsec = road->GetLaneSectionByIdx(j);
-            if (j == number_of_lane_sections - 1)
-            {
-                lsec_end = road->GetLength();
-            }
-            else
-            {
-                lsec_end = road->GetLaneSectionByIdx(j + 1)->GetS();
-            }
-            // Looping through each lane
-            number_of_lanes = lsec->GetNumberOfLanes();
-            for (unsigned int k = 0; k < number_of_lanes; k++)
-            {
-                lane                     = lsec->GetLaneByIdx(k);
-                unsigned int n_roadmarks = lane->GetNumberOfRoadMarks();
-
-                if (n_roadmarks == 0)
-                {
-                    std::vector<double> x0, y0, x1, y1;
-
-                    lane                 = lsec->GetLaneByIdx(k);
-                    unsigned int counter = 0;
-
-                    // [XO, YO] = Real position with no tolerance
-                    if (pos_pivot.SetLaneBoundaryPos(road->GetId(), lane->GetId(), lsec->GetS(), 0, j) != Position::ReturnCode::OK)
+                    if (add_point_status == 2)
                     {
                         break;
                     }
-
-                    // Add the starting point of each lane as osi point
-                    PointStruct p = {lsec->GetS(), pos_pivot.GetX(), pos_pivot.GetY(), pos_pivot.GetZ(), pos_pivot.GetHRoad(), false};
-                    osi_point.push_back(p);
-                    pos_last_ok = pos_pivot;
-
-                    // [XO, YO] = closest position with given (-) tolerance
-                    pos_tmp.SetLaneBoundaryPos(road->GetId(), lane->GetId(), MAX(0, lsec->GetS() - OSI_TANGENT_LINE_TOLERANCE), 0, j);
-                    x0.push_back(pos_tmp.GetX());
-                    y0.push_back(pos_tmp.GetY());
-
-                    // Push real position between the +/- tolerance points
-                    x0.push_back(pos_pivot.GetX());
-                    y0.push_back(pos_pivot.GetY());
-
-                    // [XO, YO] = closest position with given (+) tolerance
-                    pos_tmp.SetLaneBoundaryPos(road->GetId(), lane->GetId(), MIN(lsec->GetS() + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0, j);
-                    x0.push_back(pos_tmp.GetX());
-                    y0.push_back(pos_tmp.GetY());
-
-                    bool   insert = false;
-                    double step   = MIN(OSI_POINT_CALC_STEPSIZE, lsec->GetLength());
-
-                    pos_candidate = pos_pivot;
-
-                    // Looping through sequential points along the track determined by "OSI_POINT_CALC_STEPSIZE"
-                    while (++counter)
+                    else if (add_point_status == 1)
                     {
-                        // Make sure we stay within lane section length
-                        double s = MIN(pos_candidate.GetS() + step, lsec_end - SMALL_NUMBER / 2);
-
-                        // [X1, Y1] = Real position with no tolerance
-                        pos_candidate.SetLaneBoundaryPos(road->GetId(), lane->GetId(), s, 0, j);
-
-                        // [X1, Y1] = closest position with given (-) tolerance
-                        pos_tmp.SetLaneBoundaryPos(road->GetId(), lane->GetId(), MAX(s - OSI_TANGENT_LINE_TOLERANCE, 0), 0, j);
-                        x1.push_back(pos_tmp.GetX());
-                        y1.push_back(pos_tmp.GetY());
-
-                        x1.push_back(pos_candidate.GetX());
-                        y1.push_back(pos_candidate.GetY());
-
-                        // [X1, Y1] = closest position with given (+) tolerance
-                        pos_tmp.SetLaneBoundaryPos(road->GetId(), lane->GetId(), MIN(s + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0, j);
-                        x1.push_back(pos_tmp.GetX());
-                        y1.push_back(pos_tmp.GetY());
-
-                        int add_point_status = CheckAndAddOSIPoint(pos_pivot,
-                                                                   pos_candidate,
-                                                                   pos_last_ok,
-                                                                   x0,
-                                                                   y0,
-                                                                   x1,
-                                                                   y1,
-                                                                   step,
-                                                                   osi_requirement,
-                                                                   osi_point,
-                                                                   insert,
-                                                                   lsec_end);
-                        if (add_point_status == 2)
-                        {
-                            break;
-                        }
-                        else if (add_point_status == 1)
-                        {
-                            pos_candidate = pos_pivot;
-                        }
+                        pos_candidate = pos_pivot;
                     }
-
-                    // Initialization of LaneBoundary class
-                    LaneBoundaryOSI* lb = new LaneBoundaryOSI(0);
-                    // add the lane boundary class to the lane class and generating the global id
-                    lane->SetLaneBoundary(lb);
-                    // Fills up the osi points in the lane boundary class
-                    lb->osi_points_.Set(osi_point);
-                    // Clear osi collectors for next iteration
-                    osi_point.clear();
                 }
+
+                // Store the points, lane boundary objects are created afterwards in road order to get deterministic global ids
+                boundaries.emplace_back(lane, std::move(osi_point));
+                // Clear osi collectors for next iteration
+                osi_point.clear();
             }
         }
     }
 }
 
-void OpenDrive::SetRoadMarkOSIPoints()
+void OpenDrive::SetRoadMarkOSIPoints(SE_ThreadPool& pool)
+{
+    pool.ParallelFor(road_.size(), [this](size_t i) { SetRoadMarkOSIPoints(road_[i]); });
+}
+
+void OpenDrive::SetRoadMarkOSIPoints(Road* road)
 {
     // Initialization
     Position              pos_pivot, pos_tmp, pos_candidate, pos_last_ok;
-    Road*                 road;
     LaneSection*          lsec;
     Lane*                 lane;
     LaneRoadMark*         lane_roadMark;
@@ -7751,249 +8120,243 @@ void OpenDrive::SetRoadMarkOSIPoints()
     pos_tmp.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
     pos_candidate.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
 
-    // Looping through each road
-    for (unsigned int i = 0; i < road_.size(); i++)
+    // Looping through each lane section
+    unsigned int number_of_lane_sections = road->GetNumberOfLaneSections();
+    for (unsigned int j = 0; j < number_of_lane_sections; j++)
     {
-        road = road_[i];
+        // Get the ending position of the current lane section
+        lsec = road->GetLaneSectionByIdx(j);
+        if (j == number_of_lane_sections - 1)
+        {
+            lsec_end = road->GetLength();
+        }
+        else
+        {
+            lsec_end = road->GetLaneSectionByIdx(j + 1)->GetS();
+        }
 
-        // Looping through each lane section
-        unsigned int number_of_lane_sections = road_[i]->GetNumberOfLaneSections();
-        for (unsigned int j = 0; j < number_of_lane_sections; j++)
+        // Looping through each lane
+        number_of_lanes = lsec->GetNumberOfLanes();
+        for (unsigned int k = 0; k < number_of_lanes; k++)
         {
-            // Get the ending position of the current lane section
-            lsec = road->GetLaneSectionByIdx(j);
-            if (j == number_of_lane_sections - 1)
-            {
-                lsec_end = road->GetLength();
-            }
-            else
-            {
-                lsec_end = road->GetLaneSectionByIdx(j + 1)->GetS();
-            }
+            lane = lsec->GetLaneByIdx(k);
 
-            // Looping through each lane
-            number_of_lanes = lsec->GetNumberOfLanes();
-            for (unsigned int k = 0; k < number_of_lanes; k++)
+            // Looping through each roadMark within the lane
+            number_of_roadmarks = lane->GetNumberOfRoadMarks();
+            if (number_of_roadmarks != 0)
             {
-                lane = lsec->GetLaneByIdx(k);
-
-                // Looping through each roadMark within the lane
-                number_of_roadmarks = lane->GetNumberOfRoadMarks();
-                if (number_of_roadmarks != 0)
+                for (unsigned int m = 0; m < number_of_roadmarks; m++)
                 {
-                    for (unsigned int m = 0; m < number_of_roadmarks; m++)
+                    lane_roadMark = lane->GetLaneRoadMarkByIdx(m);
+                    s_roadmark    = lsec->GetS() + lane_roadMark->GetSOffset();
+                    if (m == number_of_roadmarks - 1)
                     {
-                        lane_roadMark = lane->GetLaneRoadMarkByIdx(m);
-                        s_roadmark    = lsec->GetS() + lane_roadMark->GetSOffset();
-                        if (m == number_of_roadmarks - 1)
-                        {
-                            s_end_roadmark = MAX(0, lsec_end - SMALL_NUMBER);
-                        }
-                        else
-                        {
-                            s_end_roadmark = MAX(0, lsec->GetS() + lane->GetLaneRoadMarkByIdx(m + 1)->GetSOffset() - SMALL_NUMBER);
-                        }
+                        s_end_roadmark = MAX(0, lsec_end - SMALL_NUMBER);
+                    }
+                    else
+                    {
+                        s_end_roadmark = MAX(0, lsec->GetS() + lane->GetLaneRoadMarkByIdx(m + 1)->GetSOffset() - SMALL_NUMBER);
+                    }
 
-                        // create point and lines for the road marks
-                        number_of_roadmarktypes = lane_roadMark->GetNumberOfRoadMarkTypes();
-                        if (number_of_roadmarktypes != 0)
-                        {
-                            lane_roadMarkType       = lane_roadMark->GetLaneRoadMarkTypeByIdx(0);
-                            number_of_roadmarklines = lane_roadMarkType->GetNumberOfRoadMarkTypeLines();
+                    // create point and lines for the road marks
+                    number_of_roadmarktypes = lane_roadMark->GetNumberOfRoadMarkTypes();
+                    if (number_of_roadmarktypes != 0)
+                    {
+                        lane_roadMarkType       = lane_roadMark->GetLaneRoadMarkTypeByIdx(0);
+                        number_of_roadmarklines = lane_roadMarkType->GetNumberOfRoadMarkTypeLines();
 
-                            // Looping through each roadmark line under roadmark
-                            for (unsigned int n = 0; n < number_of_roadmarklines; n++)
+                        // Looping through each roadmark line under roadmark
+                        for (unsigned int n = 0; n < number_of_roadmarklines; n++)
+                        {
+                            lane_roadMarkTypeLine = lane_roadMarkType->GetLaneRoadMarkTypeLineByIdx(n);
+                            if (lane_roadMarkTypeLine != nullptr)
                             {
-                                lane_roadMarkTypeLine = lane_roadMarkType->GetLaneRoadMarkTypeLineByIdx(n);
-                                if (lane_roadMarkTypeLine != nullptr)
-                                {
-                                    double s_roadmark_point = s_roadmark + lane_roadMarkTypeLine->GetSOffset();
+                                double s_roadmark_point = s_roadmark + lane_roadMarkTypeLine->GetSOffset();
 
-                                    if (lane_roadMark->GetType() == LaneRoadMark::RoadMarkType::BOTTS_DOTS)
+                                if (lane_roadMark->GetType() == LaneRoadMark::RoadMarkType::BOTTS_DOTS)
+                                {
+                                    // Setting OSI points for each dot
+                                    while (true)
                                     {
-                                        // Setting OSI points for each dot
-                                        while (true)
+                                        pos_candidate.SetRoadMarkPos(road->GetId(), lane->GetId(), m, 0, n, s_roadmark_point, 0, j);
+                                        PointStruct p = {s_roadmark_point,
+                                                         pos_candidate.GetX(),
+                                                         pos_candidate.GetY(),
+                                                         pos_candidate.GetZ(),
+                                                         pos_candidate.GetHRoad(),
+                                                         true};
+                                        osi_point.push_back(p);
+
+                                        s_roadmark_point += lane_roadMarkTypeLine->GetSpace();
+                                        if (s_roadmark_point < SMALL_NUMBER || s_roadmark_point > s_end_roadmark - SMALL_NUMBER)
                                         {
-                                            pos_candidate.SetRoadMarkPos(road->GetId(), lane->GetId(), m, 0, n, s_roadmark_point, 0, j);
-                                            PointStruct p = {s_roadmark_point,
-                                                             pos_candidate.GetX(),
-                                                             pos_candidate.GetY(),
-                                                             pos_candidate.GetZ(),
-                                                             pos_candidate.GetHRoad(),
-                                                             true};
-                                            osi_point.push_back(p);
-
-                                            s_roadmark_point += lane_roadMarkTypeLine->GetSpace();
-                                            if (s_roadmark_point < SMALL_NUMBER || s_roadmark_point > s_end_roadmark - SMALL_NUMBER)
+                                            if (s_roadmark_point < SMALL_NUMBER)
                                             {
-                                                if (s_roadmark_point < SMALL_NUMBER)
-                                                {
-                                                    LOG_WARN("Roadmark length + space = 0 - ignoring");
-                                                }
-                                                break;
+                                                LOG_WARN("Roadmark length + space = 0 - ignoring");
                                             }
+                                            break;
                                         }
                                     }
-                                    else
-                                    {
-                                        int counter = 0;
+                                }
+                                else
+                                {
+                                    int counter = 0;
 
-                                        // create one line at a time for dashed markings, or complete line segment for solid marking
-                                        while (s_roadmark_point < s_end_roadmark - SMALL_NUMBER)
+                                    // create one line at a time for dashed markings, or complete line segment for solid marking
+                                    while (s_roadmark_point < s_end_roadmark - SMALL_NUMBER)
+                                    {
+                                        // [XO, YO] = Real position with no tolerance
+                                        x0.clear();
+                                        y0.clear();
+                                        x1.clear();
+                                        y1.clear();
+
+                                        pos_pivot.SetRoadMarkPos(road->GetId(), lane->GetId(), m, 0, n, s_roadmark_point, 0, j);
+                                        pos_last_ok = pos_pivot;
+
+                                        // Add the starting point of each lane as osi point
+                                        PointStruct p =
+                                            {s_roadmark_point, pos_pivot.GetX(), pos_pivot.GetY(), pos_pivot.GetZ(), pos_pivot.GetHRoad(), false};
+                                        osi_point.push_back(p);
+
+                                        // [XO, YO] = closest position with given (-) tolerance
+                                        pos_tmp.SetRoadMarkPos(road->GetId(),
+                                                               lane->GetId(),
+                                                               m,
+                                                               0,
+                                                               n,
+                                                               MAX(0, s_roadmark_point - OSI_TANGENT_LINE_TOLERANCE),
+                                                               0,
+                                                               j);
+                                        x0.push_back(pos_tmp.GetX());
+                                        y0.push_back(pos_tmp.GetY());
+
+                                        // Push real position between the +/- tolerance points
+                                        x0.push_back(pos_pivot.GetX());
+                                        y0.push_back(pos_pivot.GetY());
+
+                                        // [XO, YO] = closest position with given (+) tolerance
+                                        pos_tmp.SetRoadMarkPos(road->GetId(),
+                                                               lane->GetId(),
+                                                               m,
+                                                               0,
+                                                               n,
+                                                               MIN(s_roadmark_point + OSI_TANGENT_LINE_TOLERANCE, s_end_roadmark),
+                                                               0,
+                                                               j);
+                                        x0.push_back(pos_tmp.GetX());
+                                        y0.push_back(pos_tmp.GetY());
+
+                                        bool   insert = false;
+                                        double step   = MIN(OSI_POINT_CALC_STEPSIZE, lsec->GetLength());
+
+                                        pos_candidate = pos_pivot;
+
+                                        // Make sure we stay within lane section length
+                                        if (lane_roadMarkTypeLine->GetSpace() > SMALL_NUMBER || lane_roadMarkTypeLine->GetRepeat() == false)
+                                        {
+                                            s_end_roadmarkline =
+                                                MIN(s_end_roadmark - SMALL_NUMBER / 2.0, s_roadmark_point + lane_roadMarkTypeLine->GetLength());
+                                        }
+                                        else
                                         {
-                                            // [XO, YO] = Real position with no tolerance
-                                            x0.clear();
-                                            y0.clear();
-                                            x1.clear();
-                                            y1.clear();
+                                            s_end_roadmarkline = s_end_roadmark - SMALL_NUMBER / 2.0;
+                                        }
 
-                                            pos_pivot.SetRoadMarkPos(road->GetId(), lane->GetId(), m, 0, n, s_roadmark_point, 0, j);
-                                            pos_last_ok = pos_pivot;
+                                        double s = s_roadmark_point;
+                                        while (++counter)
+                                        {
+                                            // [X1, Y1] = Real position with no tolerance
+                                            if (pos_candidate.GetS() + step > s_end_roadmarkline - SMALL_NUMBER / 2)
+                                            {
+                                                step = s_end_roadmarkline - SMALL_NUMBER / 2 - pos_candidate.GetS();
+                                            }
+                                            s = pos_candidate.GetS() + step;
 
-                                            // Add the starting point of each lane as osi point
-                                            PointStruct p =
-                                                {s_roadmark_point, pos_pivot.GetX(), pos_pivot.GetY(), pos_pivot.GetZ(), pos_pivot.GetHRoad(), false};
-                                            osi_point.push_back(p);
+                                            pos_candidate.SetRoadMarkPos(road->GetId(), lane->GetId(), m, 0, n, s, 0, j);
 
-                                            // [XO, YO] = closest position with given (-) tolerance
+                                            // [X1, Y1] = closest position with given (-) tolerance
                                             pos_tmp.SetRoadMarkPos(road->GetId(),
                                                                    lane->GetId(),
                                                                    m,
                                                                    0,
                                                                    n,
-                                                                   MAX(0, s_roadmark_point - OSI_TANGENT_LINE_TOLERANCE),
+                                                                   MAX(0, s - OSI_TANGENT_LINE_TOLERANCE),
                                                                    0,
                                                                    j);
-                                            x0.push_back(pos_tmp.GetX());
-                                            y0.push_back(pos_tmp.GetY());
+                                            x1.push_back(pos_tmp.GetX());
+                                            y1.push_back(pos_tmp.GetY());
 
-                                            // Push real position between the +/- tolerance points
-                                            x0.push_back(pos_pivot.GetX());
-                                            y0.push_back(pos_pivot.GetY());
+                                            x1.push_back(pos_candidate.GetX());
+                                            y1.push_back(pos_candidate.GetY());
 
-                                            // [XO, YO] = closest position with given (+) tolerance
+                                            // [X1, Y1] = closest position with given (+) tolerance
                                             pos_tmp.SetRoadMarkPos(road->GetId(),
                                                                    lane->GetId(),
                                                                    m,
                                                                    0,
                                                                    n,
-                                                                   MIN(s_roadmark_point + OSI_TANGENT_LINE_TOLERANCE, s_end_roadmark),
+                                                                   MIN(s + OSI_TANGENT_LINE_TOLERANCE, road->GetLength()),
                                                                    0,
                                                                    j);
-                                            x0.push_back(pos_tmp.GetX());
-                                            y0.push_back(pos_tmp.GetY());
-
-                                            bool   insert = false;
-                                            double step   = MIN(OSI_POINT_CALC_STEPSIZE, lsec->GetLength());
-
-                                            pos_candidate = pos_pivot;
+                                            x1.push_back(pos_tmp.GetX());
+                                            y1.push_back(pos_tmp.GetY());
 
                                             // Make sure we stay within lane section length
-                                            if (lane_roadMarkTypeLine->GetSpace() > SMALL_NUMBER || lane_roadMarkTypeLine->GetRepeat() == false)
+                                            int add_point_status = CheckAndAddOSIPoint(pos_pivot,
+                                                                                       pos_candidate,
+                                                                                       pos_last_ok,
+                                                                                       x0,
+                                                                                       y0,
+                                                                                       x1,
+                                                                                       y1,
+                                                                                       step,
+                                                                                       osi_requirement,
+                                                                                       osi_point,
+                                                                                       insert,
+                                                                                       s_end_roadmarkline);
+                                            if (add_point_status == 2)
                                             {
-                                                s_end_roadmarkline =
-                                                    MIN(s_end_roadmark - SMALL_NUMBER / 2.0, s_roadmark_point + lane_roadMarkTypeLine->GetLength());
+                                                break;
                                             }
-                                            else
+                                            else if (add_point_status == 1)
                                             {
-                                                s_end_roadmarkline = s_end_roadmark - SMALL_NUMBER / 2.0;
+                                                pos_candidate = pos_pivot;
                                             }
+                                        }
 
-                                            double s = s_roadmark_point;
-                                            while (++counter)
-                                            {
-                                                // [X1, Y1] = Real position with no tolerance
-                                                if (pos_candidate.GetS() + step > s_end_roadmarkline - SMALL_NUMBER / 2)
-                                                {
-                                                    step = s_end_roadmarkline - SMALL_NUMBER / 2 - pos_candidate.GetS();
-                                                }
-                                                s = pos_candidate.GetS() + step;
-
-                                                pos_candidate.SetRoadMarkPos(road->GetId(), lane->GetId(), m, 0, n, s, 0, j);
-
-                                                // [X1, Y1] = closest position with given (-) tolerance
-                                                pos_tmp.SetRoadMarkPos(road->GetId(),
-                                                                       lane->GetId(),
-                                                                       m,
-                                                                       0,
-                                                                       n,
-                                                                       MAX(0, s - OSI_TANGENT_LINE_TOLERANCE),
-                                                                       0,
-                                                                       j);
-                                                x1.push_back(pos_tmp.GetX());
-                                                y1.push_back(pos_tmp.GetY());
-
-                                                x1.push_back(pos_candidate.GetX());
-                                                y1.push_back(pos_candidate.GetY());
-
-                                                // [X1, Y1] = closest position with given (+) tolerance
-                                                pos_tmp.SetRoadMarkPos(road->GetId(),
-                                                                       lane->GetId(),
-                                                                       m,
-                                                                       0,
-                                                                       n,
-                                                                       MIN(s + OSI_TANGENT_LINE_TOLERANCE, road->GetLength()),
-                                                                       0,
-                                                                       j);
-                                                x1.push_back(pos_tmp.GetX());
-                                                y1.push_back(pos_tmp.GetY());
-
-                                                // Make sure we stay within lane section length
-                                                int add_point_status = CheckAndAddOSIPoint(pos_pivot,
-                                                                                           pos_candidate,
-                                                                                           pos_last_ok,
-                                                                                           x0,
-                                                                                           y0,
-                                                                                           x1,
-                                                                                           y1,
-                                                                                           step,
-                                                                                           osi_requirement,
-                                                                                           osi_point,
-                                                                                           insert,
-                                                                                           s_end_roadmarkline);
-                                                if (add_point_status == 2)
-                                                {
-                                                    break;
-                                                }
-                                                else if (add_point_status == 1)
-                                                {
-                                                    pos_candidate = pos_pivot;
-                                                }
-                                            }
+                                        if (s > s_end_roadmarkline - SMALL_NUMBER || lane_roadMarkTypeLine->GetRepeat() == false)
+                                        {
+                                            osi_point.back().endpoint = true;
 
-                                            if (s > s_end_roadmarkline - SMALL_NUMBER || lane_roadMarkTypeLine->GetRepeat() == false)
+                                            if (lane_roadMarkTypeLine->GetRepeat() == false)
                                             {
-                                                osi_point.back().endpoint = true;
-
-                                                if (lane_roadMarkTypeLine->GetRepeat() == false)
-                                                {
-                                                    break;
-                                                }
+                                                break;
                                             }
-
-                                            s_roadmark_point = MIN(s_end_roadmark, s_end_roadmarkline + lane_roadMarkTypeLine->GetSpace());
                                         }
+
+                                        s_roadmark_point = MIN(s_end_roadmark, s_end_roadmarkline + lane_roadMarkTypeLine->GetSpace());
                                     }
+                                }
 
-                                    // Set all collected osi points for the current lane roadmarkline
-                                    lane_roadMarkTypeLine->osi_points_.Set(osi_point);
+                                // Set all collected osi points for the current lane roadmarkline
+                                lane_roadMarkTypeLine->osi_points_.Set(osi_point);
 
-                                    // Clear osi collectors for roadmarks for next iteration
-                                    osi_point.clear();
-                                }
-                                else
-                                {
-                                    LOG_ERROR("LaneRoadMarkTypeLine {} for LaneRoadMarkType for LaneRoadMark {} for lane {} is not defined",
-                                              n,
-                                              m,
-                                              lane->GetId());
-                                }
+                                // Clear osi collectors for roadmarks for next iteration
+                                osi_point.clear();
+                            }
+                            else
+                            {
+                                LOG_ERROR("LaneRoadMarkTypeLine {} for LaneRoadMarkType for LaneRoadMark {} for lane {} is not defined",
+                                          n,
+                                          m,
+                                          lane->GetId());
                             }
                         }
-                        else
-                        {
-                            LOG_ERROR("Unexpected missing roadmark type or explicit element!");
-                        }
+                    }
+                    else
+                    {
+                        LOG_ERROR("Unexpected missing roadmark type or explicit element!");
                     }
                 }
             }
@@ -8207,13 +8570,38 @@ void OpenDrive::CreateTunnelOSIPointsAndObjects()
     }
 }
 
+// Guards deferred road mark OSI points, created on first request which may be from any thread
+static std::mutex roadmark_osi_mutex_;
+
+static unsigned int GetOSIPointThreads()
+{
+    // 0 = use all available hardware threads
+    std::string value = SE_Env::Inst().GetOptions().GetOptionValue("osi_point_threads");
+    return value.empty() ? 0 : static_cast<unsigned int>(MAX(0, strtoi(value)));
+}
+
 bool OpenDrive::SetRoadOSI()
 {
     if (this == Position::GetOpenDrive())
     {
-        SetLaneOSIPoints();
-        SetRoadMarkOSIPoints();
-        SetLaneBoundaryPoints();
+        // Roads are processed independently. Center lane points are needed for XYZ to road coordinate mapping, so lanes
+        // are always processed up front. Road marks are not referred to by anything but OSI and visualization, optionally
+        // deferring them until first requested, see EnsureRoadMarkOSIPoints()
+        SE_ThreadPool pool(GetOSIPointThreads());
+
+        SetLaneOSIPoints(pool);
+
+        bool lazy = SE_Env::Inst().GetOptions().GetOptionSet("osi_lazy_roadmarks");
+        {
+            std::lock_guard<std::mutex> lock(roadmark_osi_mutex_);
+            roadmark_osi_pending_.assign(road_.size(), lazy);
+        }
+        if (!lazy)
+        {
+            SetRoadMarkOSIPoints(pool);
+        }
+
+        SetLaneBoundaryPoints(pool);
         CreateTunnelOSIPointsAndObjects();
         return true;
     }
@@ -8221,6 +8609,42 @@ bool OpenDrive::SetRoadOSI()
     return false;
 }
 
+void OpenDrive::EnsureRoadMarkOSIPoints(Road* road)
+{
+    std::lock_guard<std::mutex> lock(roadmark_osi_mutex_);
+
+    if (road == nullptr)
+    {
+        if (std::find(roadmark_osi_pending_.begin(), roadmark_osi_pending_.end(), true) != roadmark_osi_pending_.end())
+        {
+            SE_ThreadPool pool(GetOSIPointThreads());
+            pool.ParallelFor(road_.size(),
+                             [this](size_t i)
+                             {
+                                 if (roadmark_osi_pending_[i])
+                                 {
+                                     SetRoadMarkOSIPoints(road_[i]);
+                                 }
+                             });
+            roadmark_osi_pending_.assign(road_.size(), false);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < road_.size() && i < roadmark_osi_pending_.size(); i++)
+    {
+        if (road_[i] == road)
+        {
+            if (roadmark_osi_pending_[i])
+            {
+                SetRoadMarkOSIPoints(road);
+                roadmark_osi_pending_[i] = false;
+            }
+            return;
+        }
+    }
+}
+
 idx_t LaneSection::GetClosestLaneIdx(double s, double t, double laneOffset, int side, double& offset, bool noZeroWidth, int laneTypeMask) const
 {
     double min_offset         = t - laneOffset;  // Initial offset relates to center lane
@@ -8282,7 +8706,7 @@ int Position::GotoClosestDrivingLaneAtCurrentPosition()
     }
 
     double offset;
-    double lane_offset = road->GetLaneOffset(s_);
+    double lane_offset = road->GetLaneOffset(s_, &lane_offset_idx_);
     idx_t  lane_idx    = lane_section->GetClosestLaneIdx(s_, t_, lane_offset, 0, offset, true, snapToLaneTypes_);
 
     if (lane_idx == IDX_UNDEFINED)
@@ -8325,7 +8749,7 @@ void Position::Track2Lane()
 
     // Find the closest driving lane within the lane section
     double offset;
-    double lane_offset = road->GetLaneOffset(s_);
+    double lane_offset = road->GetLaneOffset(s_, &lane_offset_idx_);
     idx_t  lane_idx    = lane_section->GetClosestLaneIdx(s_, t_, lane_offset, 0, offset, true, snapToLaneTypes_);
 
     if (lane_idx == IDX_UNDEFINED)
@@ -9096,7 +9520,7 @@ bool Position::EvaluateRoadZHPR(int mode)
         h_road_   = GetRoadH();
         ret_value = road->GetZAndPitchByS(s_, &z_road_, &z_roadPrim_, &z_roadPrimPrim_, &p_road_, &elevation_idx_);
         ret_value &= road->UpdateZAndRollBySAndT(s_, t_, &z_road_, &roadSuperElevationPrim_, &r_road_, &super_elevation_idx_);
-        h_road_ += atan(road->GetLaneOffsetPrim(s_)) + h_offset_;
+        h_road_ += atan(road->GetLaneOffsetPrim(s_, &lane_offset_idx_)) + h_offset_;
         h_road_ = GetAngleInInterval2PI(h_road_);
     }
     else
@@ -9155,7 +9579,7 @@ void Position::LaneBoundary2Track()
 
         if (lane_section != nullptr)
         {
-            t_        = road->GetLaneOffset(s_) + offset_ + lane_section->GetOuterOffset(s_, lane_id_) * (lane_id_ < 0 ? -1 : 1);
+            t_        = road->GetLaneOffset(s_, &lane_offset_idx_) + offset_ + lane_section->GetOuterOffset(s_, lane_id_) * (lane_id_ < 0 ? -1 : 1);
             h_offset_ = lane_section->GetOuterOffsetHeading(s_, lane_id_) * (lane_id_ < 0 ? -1 : 1);
         }
     }
@@ -9172,7 +9596,7 @@ void Position::Lane2Track()
 
         if (lane_section != nullptr)
         {
-            t_        = offset_ + road->GetLaneOffset(s_) + lane_section->GetCenterOffset(s_, lane_id_) * (lane_id_ < 0 ? -1 : 1);
+            t_        = offset_ + road->GetLaneOffset(s_, &lane_offset_idx_) + lane_section->GetCenterOffset(s_, lane_id_) * (lane_id_ < 0 ? -1 : 1);
             h_offset_ = lane_section->GetCenterOffsetHeading(s_, lane_id_) * (lane_id_ < 0 ? -1 : 1);
         }
     }
@@ -9189,7 +9613,7 @@ void Position::RoadMark2Track()
 
         if (lane_section != nullptr)
         {
-            t_        = offset_ + road->GetLaneOffset(s_) + lane_section->GetOuterOffset(s_, lane_id_) * (lane_id_ < 0 ? -1 : 1);
+            t_        = offset_ + road->GetLaneOffset(s_, &lane_offset_idx_) + lane_section->GetOuterOffset(s_, lane_id_) * (lane_id_ < 0 ? -1 : 1);
             h_offset_ = lane_section->GetOuterOffsetHeading(s_, lane_id_) * (lane_id_ < 0 ? -1 : 1);
 
             Lane* lane = lane_section->GetLaneByIdx(lane_idx_);
@@ -9250,6 +9674,7 @@ Position::ReturnCode Position::SetLongitudinalTrackPos(id_t track_id, double s)
         geometry_idx_        = 0;
         elevation_idx_       = 0;
         super_elevation_idx_ = 0;
+        lane_offset_idx_     = 0;
         lane_section_idx_    = 0;
         lane_id_             = 0;
         lane_idx_            = 0;
@@ -11128,15 +11553,15 @@ bool Position::Delta(Position* pos_b, PositionDiff& diff, bool bothDirections, d
     bool   found;
     diff.dOppLane = false;
 
-    RoadPath* path = new RoadPath(this, pos_b);
-    found          = (path->Calculate(dist, bothDirections, maxDist) == 0 && abs(dist) < maxDist);
+    RoadPath path(this, pos_b);
+    found = (path.Calculate(dist, bothDirections, maxDist) == 0 && abs(dist) < maxDist);
     if (found)
     {
         int                              laneIdB         = pos_b->GetLaneId();
         Road*                            road_B          = Position::GetRoadById(pos_b->GetTrackId());
         double                           tB              = pos_b->GetT();
         int                              adjustedLaneIdA = GetLaneId();
-        roadmanager::RoadPath::PathNode* last_node       = path->visited_.size() > 0 ? path->visited_.back() : nullptr;
+        roadmanager::RoadPath::PathNode* last_node       = path.visited_.size() > 0 ? path.visited_.back() : nullptr;
 
         // Check the angles of the two positions relative to the road direction
         bool pos_a_forward = (IsAngleForward(GetHRelative()));
@@ -11173,7 +11598,7 @@ bool Position::Delta(Position* pos_b, PositionDiff& diff, bool bothDirections, d
         // If the relative direction of the two positions is the same, we are driving in the same direction unless the detected path is reversed, then
         // we have to invert the dDirection
         diff.dDirection = (pos_a_forward == pos_b_forward);
-        if (bothDirections == true && path->direction_ == -1)
+        if (bothDirections == true && path.direction_ == -1)
         {
             diff.dDirection = !diff.dDirection;
         }
@@ -11202,10 +11627,10 @@ bool Position::Delta(Position* pos_b, PositionDiff& diff, bool bothDirections, d
 
 #if 0  // Change to 1 to print some info on stdout - e.g. for debugging
         std::string roadIds = "";
-        if (path->visited_.size() > 0)
+        if (path.visited_.size() > 0)
         {
             std::ostringstream  oss;
-            RoadPath::PathNode* node = path->visited_.back();
+            RoadPath::PathNode* node = path.visited_.back();
             while (node)
             {
                 if (node->fromRoad != nullptr)
@@ -11228,8 +11653,6 @@ bool Position::Delta(Position* pos_b, PositionDiff& diff, bool bothDirections, d
 
     getRelativeDistance(pos_b->GetX(), pos_b->GetY(), diff.dx, diff.dy);
 
-    delete path;
-
     return found;
 }
 
@@ -12003,7 +12426,7 @@ void PolyLineBase::AddVertex(TrajVertex v)
 idx_t PolyLineBase::Evaluate(double s, TrajVertex& pos, idx_t startAtIndex)
 {
     double       s_local = 0;
-    unsigned int i       = CLAMP(startAtIndex, 0, GetNumberOfVertices() - 1);
+    unsigned int i       = CLAMP(ToStorageIndex(startAtIndex), 0, GetNumberOfVertices() - 1);
 
     if (GetNumberOfVertices() < 1)
     {
@@ -12019,13 +12442,21 @@ idx_t PolyLineBase::Evaluate(double s, TrajVertex& pos, idx_t startAtIndex)
     }
     else if (s > vertex_[i].s + SMALL_NUMBER)
     {
-        for (; i < GetNumberOfVertices() - 1 && s > vertex_[i + 1].s + SMALL_NUMBER; i++)
-            ;  // move to the firstmost segment matching the provided s value
+        // move to the firstmost segment matching the provided s value, search forward from start index
+        auto iter = std::lower_bound(vertex_.begin() + i + 1,
+                                     vertex_.end(),
+                                     s - SMALL_NUMBER,
+                                     [](const TrajVertex& v, double value) { return v.s < value; });
+        i         = static_cast<unsigned int>(iter - vertex_.begin()) - 1;
     }
     else if (s < vertex_[i].s + SMALL_NUMBER)
     {
-        for (; i > 0 && s < vertex_[i].s + SMALL_NUMBER; i--)
-            ;  // move to the firstmost segment matching the provided s value
+        // move to the firstmost segment matching the provided s value, search backward from start index
+        auto iter = std::upper_bound(vertex_.begin(),
+                                     vertex_.begin() + i + 1,
+                                     s - SMALL_NUMBER,
+                                     [](double value, const TrajVertex& v) { return value < v.s; });
+        i         = iter == vertex_.begin() ? 0 : static_cast<unsigned int>(iter - vertex_.begin()) - 1;
     }
 
     double s0 = vertex_[i].s;
@@ -12033,12 +12464,12 @@ idx_t PolyLineBase::Evaluate(double s, TrajVertex& pos, idx_t startAtIndex)
 
     if (EvaluateSegmentByLocalS(i, s_local, pos) == 0)
     {
-        current_index_ = i;  // update cached index position
+        current_index_ = i + index_offset_;  // update cached index position
     }
 
     pos.s = s;
 
-    return i;
+    return i + index_offset_;
 }
 
 idx_t PolyLineBase::Evaluate(double s, TrajVertex& pos)
@@ -12063,15 +12494,15 @@ PolyLineBase::GhostTrailReturnCode PolyLineBase::Time2S(double time, double& s,
     }
     else if (GetNumberOfVertices() == 1)
     {
-        s     = 0;
-        index = 0;
+        s     = vertex_[0].s;
+        index = index_offset_;
         return GhostTrailReturnCode::GHOST_TRAIL_OK;
     }
     else if (time < vertex_[0].time + SMALL_NUMBER)
     {
         // snap to first vertex
-        s     = 0.0;
-        index = 0;
+        s     = vertex_[0].s;
+        index = index_offset_;
 
         if (time > vertex_[0].time - SMALL_NUMBER)
         {
@@ -12088,7 +12519,7 @@ PolyLineBase::GhostTrailReturnCode PolyLineBase::Time2S(double time, double& s,
     {
         // snap to last vertex
         s     = vertex_.back().s;
-        index = static_cast<unsigned int>(vertex_.size()) - 1;
+        index = index_offset_ + static_cast<unsigned int>(vertex_.size()) - 1;
 
         if (time < vertex_.back().time + SMALL_NUMBER)
         {
@@ -12103,12 +12534,12 @@ PolyLineBase::GhostTrailReturnCode PolyLineBase::Time2S(double time, double& s,
     }
 
     // start looking from current index by default
-    idx_t i = current_index_;
+    idx_t i = MIN(ToStorageIndex(current_index_), GetNumberOfVertices() - 1);
 
     // override with any specified start index
-    if (index != IDX_UNDEFINED && index < GetNumberOfVertices())
+    if (index != IDX_UNDEFINED && ToStorageIndex(index) < GetNumberOfVertices())
     {
-        i = index;
+        i = ToStorageIndex(index);
     }
 
     // If given time is less than time at current index, its probably more efficient to search backwards
@@ -12118,30 +12549,27 @@ PolyLineBase::GhostTrailReturnCode PolyLineBase::Time2S(double time, double& s,
         i--;             // since we always interpolate forward, we start on previous vertex (first potential candidate)
     }
 
+    // timestamps are increasing, so binary search the part of the trail in search direction
     if (direction == 1)
     {
-        for (; i < GetNumberOfVertices() - 1; i++)
-        {
-            if (time < vertex_[i + 1].time - SMALL_NUMBER)
-            {
-                break;
-            }
-        }
+        auto iter = std::upper_bound(vertex_.begin() + i + 1,
+                                     vertex_.end(),
+                                     time + SMALL_NUMBER,
+                                     [](double value, const TrajVertex& v) { return value < v.time; });
+        i         = static_cast<unsigned int>(iter - vertex_.begin()) - 1;
     }
     else
     {
-        for (; i > 0; i--)
-        {
-            if (time > vertex_[i].time - SMALL_NUMBER)
-            {
-                break;
-            }
-        }
+        auto iter = std::lower_bound(vertex_.begin(),
+                                     vertex_.begin() + i + 1,
+                                     time + SMALL_NUMBER,
+                                     [](const TrajVertex& v, double value) { return v.time < value; });
+        i         = iter == vertex_.begin() ? 0 : static_cast<unsigned int>(iter - vertex_.begin()) - 1;
     }
 
     double w = (time - vertex_[i].time) / (vertex_[i + 1].time - vertex_[i].time);
     s        = MAX(0.0, vertex_[i].s + w * (vertex_[i + 1].s - vertex_[i].s));
-    index    = i;
+    index    = i + index_offset_;
 
     return GhostTrailReturnCode::GHOST_TRAIL_OK;
 }
@@ -12151,105 +12579,260 @@ void PolyLineBase::SetInterpolationMode(InterpolationMode mode)
     interpolation_mode_ = mode;
 }
 
-int PolyLineBase::FindClosestPoint(double xin, double yin, TrajVertex& pos, idx_t& index, idx_t startAtIndex)
+double PolyLineBase::SegmentDistance(idx_t i, double x, double y, double& s_local) const
 {
-    if (startAtIndex == IDX_UNDEFINED)
+    double px = 0.0;
+    double py = 0.0;
+
+    ProjectPointOnLine2D(x, y, vertex_[i].x, vertex_[i].y, vertex_[i + 1].x, vertex_[i + 1].y, px, py);
+    double dist = PointDistance2D(x, y, px, py);
+
+    bool inside = PointInBetweenVectorEndpoints(px, py, vertex_[i].x, vertex_[i].y, vertex_[i + 1].x, vertex_[i + 1].y, s_local);
+    if (!inside)
+    {
+        // Find combined longitudinal and lateral distance to line endpoint
+        // s_local represent now (outside line segment) distance to closest line segment end point
+        dist = sqrt(dist * dist + s_local * s_local);
+        if (s_local < 0)
+        {
+            s_local = 0;
+        }
+        else
+        {
+            s_local = vertex_[i + 1].s - vertex_[i].s;
+        }
+    }
+    else
     {
-        // treat as 0, look globally
-        startAtIndex = 0;
+        // rescale normalized s
+        s_local *= (vertex_[i + 1].s - vertex_[i].s);
     }
 
-    // look along the line segments
-    TrajVertex   tmpPos;
-    double       sLocal    = 0.0;
-    double       sLocalMin = 0.0;
-    idx_t        iMin      = startAtIndex;
-    double       distMin   = LARGE_NUMBER;
-    unsigned int i         = 0;
-    int          direction = 1;
+    return dist;
+}
+
+void PolyLineBase::UpdateSegmentIndex()
+{
+    unsigned int n = GetNumberOfVertices();
 
-    // If a teleportation is made by the Ghost, a reset of trajectory has been made. Hence, we can't look from the usual point. Set startAtIndex =
-    // 0
-    if (startAtIndex + 1 > GetNumberOfVertices())
+    if (n < segment_index_n_vertices_)
     {
-        startAtIndex = 0;
-        i            = 0;
+        // vertices removed, rebuild from scratch
+        segment_index_.clear();
+        segment_index_n_vertices_ = 0;
     }
-    else
+
+    if (n == segment_index_n_vertices_)
     {
-        i = startAtIndex;
+        return;
     }
 
-    // Find closest line segment
+    if (segment_index_.empty())
+    {
+        segment_index_.resize(1);
+    }
 
-    while (i + 1 < GetNumberOfVertices())
+    // add segments ending at new vertices, expanding the boxes covering them on each level
+    for (unsigned int i = segment_index_n_vertices_ > 0 ? segment_index_n_vertices_ - 1 : 0; i + 1 < n; i++)
     {
-        ProjectPointOnLine2D(xin, yin, vertex_[i].x, vertex_[i].y, vertex_[i + 1].x, vertex_[i + 1].y, tmpPos.x, tmpPos.y);
-        double distTmp = PointDistance2D(xin, yin, tmpPos.x, tmpPos.y);
+        SegmentBox   box  = {MIN(vertex_[i].x, vertex_[i + 1].x),
+                             MIN(vertex_[i].y, vertex_[i + 1].y),
+                             MAX(vertex_[i].x, vertex_[i + 1].x),
+                             MAX(vertex_[i].y, vertex_[i + 1].y)};
+        unsigned int node = i / SEGMENT_INDEX_LEAF_SIZE;
 
-        bool inside = PointInBetweenVectorEndpoints(tmpPos.x, tmpPos.y, vertex_[i].x, vertex_[i].y, vertex_[i + 1].x, vertex_[i + 1].y, sLocal);
-        if (!inside)
+        for (auto& level : segment_index_)
         {
-            // Find combined longitudinal and lateral distance to line endpoint
-            // sLocal represent now (outside line segment) distance to closest line segment end point
-            distTmp = sqrt(distTmp * distTmp + sLocal * sLocal);
-            if (sLocal < 0)
+            if (node == level.size())
             {
-                sLocal = 0;
+                level.push_back(box);
             }
             else
             {
-                sLocal = vertex_[i + 1].s - vertex_[i].s;
+                SegmentBox& b = level[node];
+                b.x_min       = MIN(b.x_min, box.x_min);
+                b.y_min       = MIN(b.y_min, box.y_min);
+                b.x_max       = MAX(b.x_max, box.x_max);
+                b.y_max       = MAX(b.y_max, box.y_max);
             }
+            node /= 2;
         }
-        else
+    }
+
+    // add levels on top until a single box covers all segments
+    while (segment_index_.back().size() > 1)
+    {
+        const std::vector<SegmentBox>& lower = segment_index_.back();
+        std::vector<SegmentBox>        upper((lower.size() + 1) / 2);
+
+        for (size_t j = 0; j < upper.size(); j++)
         {
-            // rescale normalized s
-            sLocal *= (vertex_[i + 1].s - vertex_[i].s);
+            upper[j] = lower[2 * j];
+            if (2 * j + 1 < lower.size())
+            {
+                upper[j].x_min = MIN(upper[j].x_min, lower[2 * j + 1].x_min);
+                upper[j].y_min = MIN(upper[j].y_min, lower[2 * j + 1].y_min);
+                upper[j].x_max = MAX(upper[j].x_max, lower[2 * j + 1].x_max);
+                upper[j].y_max = MAX(upper[j].y_max, lower[2 * j + 1].y_max);
+            }
         }
+        segment_index_.push_back(std::move(upper));
+    }
+
+    segment_index_n_vertices_ = n;
+}
+
+bool PolyLineBase::FindClosestSegment(double x, double y, idx_t& index, double& s_local, double& dist)
+{
+    UpdateSegmentIndex();
+
+    if (segment_index_.empty() || segment_index_[0].empty())
+    {
+        return false;
+    }
+
+    // squared distance from point to box, 0 if inside
+    auto box_dist2 = [x, y](const SegmentBox& b)
+    {
+        double dx = MAX(0.0, MAX(b.x_min - x, x - b.x_max));
+        double dy = MAX(0.0, MAX(b.y_min - y, y - b.y_max));
+        return dx * dx + dy * dy;
+    };
+
+    // Depth first search, nearest child first, skipping boxes further away than closest segment found so far.
+    // Stack holds at most one pending sibling per level, and there are at most 32 levels for 32 bit indices.
+    struct Node
+    {
+        unsigned int level;
+        unsigned int node;
+    };
+    Node         stack[64];
+    unsigned int n_stack = 0;
+
+    stack[n_stack++] = {static_cast<unsigned int>(segment_index_.size()) - 1, 0};
+    dist             = LARGE_NUMBER;
+    index            = IDX_UNDEFINED;
+
+    while (n_stack > 0)
+    {
+        Node current = stack[--n_stack];
 
-        if (distTmp < distMin)
+        if (box_dist2(segment_index_[current.level][current.node]) > dist * dist)
         {
-            iMin      = i;
-            sLocalMin = sLocal;
-            distMin   = distTmp;
+            continue;
         }
-        else if (startAtIndex > 0)
+
+        if (current.level == 0)
         {
-            // Look for a local minimum distance
-            // Distance is increasing
-            // After looking in forward direction, go backwards from the start index
-            if (direction == 1)
+            unsigned int i_end = MIN((current.node + 1) * SEGMENT_INDEX_LEAF_SIZE, GetNumberOfVertices() - 1);
+            for (unsigned int i = current.node * SEGMENT_INDEX_LEAF_SIZE; i < i_end; i++)
             {
-                i         = startAtIndex;  // go back to start index
-                direction = -1;            // and continue search in other direction
+                double s_tmp    = 0.0;
+                double dist_tmp = SegmentDistance(i, x, y, s_tmp);
+
+                if (dist_tmp < dist || (dist_tmp <= dist && i < index))
+                {
+                    index   = i;
+                    s_local = s_tmp;
+                    dist    = dist_tmp;
+                }
             }
-            else
+        }
+        else
+        {
+            const std::vector<SegmentBox>& children = segment_index_[current.level - 1];
+            unsigned int                   first    = 2 * current.node;
+            unsigned int                   second   = first + 1;
+
+            if (second < children.size())
             {
-                break;  // Now give up
+                // push the farthest child first, so that the nearest one is processed first
+                if (box_dist2(children[second]) < box_dist2(children[first]))
+                {
+                    std::swap(first, second);
+                }
+                stack[n_stack++] = {current.level - 1, second};
             }
+            stack[n_stack++] = {current.level - 1, first};
         }
+    }
+
+    return index != IDX_UNDEFINED;
+}
+
+int PolyLineBase::FindClosestPoint(double xin, double yin, TrajVertex& pos, idx_t& index, idx_t startAtIndex)
+{
+    // If a teleportation is made by the Ghost, a reset of trajectory has been made. Hence, we can't look from the usual point.
+    // Then, as well as when no start index is given, look globally
+    bool global = startAtIndex == 0 || startAtIndex == IDX_UNDEFINED || ToStorageIndex(startAtIndex) + 1 > GetNumberOfVertices();
+
+    // Any start index referring to a discarded vertex is moved to the oldest remaining one
+    startAtIndex = global ? 0 : ToStorageIndex(startAtIndex);
+
+    double       sLocal    = 0.0;
+    double       sLocalMin = 0.0;
+    idx_t        iMin      = startAtIndex;
+    double       distMin   = LARGE_NUMBER;
+    unsigned int i         = startAtIndex;
+    int          direction = 1;
 
-        if (direction < 0)
+    if (global)
+    {
+        // Global minimum, make use of segment index instead of checking every segment
+        if (!FindClosestSegment(xin, yin, iMin, sLocalMin, distMin))
         {
-            if (i > 0)
+            return -1;
+        }
+    }
+    else
+    {
+        // Look for a local minimum distance around the start index
+        while (i + 1 < GetNumberOfVertices())
+        {
+            double distTmp = SegmentDistance(i, xin, yin, sLocal);
+
+            if (distTmp < distMin)
             {
-                i--;
+                iMin      = i;
+                sLocalMin = sLocal;
+                distMin   = distTmp;
             }
             else
             {
-                break;
+                // Distance is increasing
+                // After looking in forward direction, go backwards from the start index
+                if (direction == 1)
+                {
+                    i         = startAtIndex;  // go back to start index
+                    direction = -1;            // and continue search in other direction
+                }
+                else
+                {
+                    break;  // Now give up
+                }
             }
-        }
-        else
-        {
-            if (i < GetNumberOfVertices() - 1)
+
+            if (direction < 0)
             {
-                i++;
+                if (i > 0)
+                {
+                    i--;
+                }
+                else
+                {
+                    break;
+                }
             }
             else
             {
-                break;
+                if (i < GetNumberOfVertices() - 1)
+                {
+                    i++;
+                }
+                else
+                {
+                    break;
+                }
             }
         }
     }
@@ -12257,7 +12840,7 @@ int PolyLineBase::FindClosestPoint(double xin, double yin, TrajVertex& pos, idx_
     if (distMin < LARGE_NUMBER)
     {
         EvaluateSegmentByLocalS(iMin, sLocalMin, pos);
-        index = iMin;
+        index = iMin + index_offset_;
         return 0;
     }
     else
@@ -12312,12 +12895,40 @@ std::vector<TrajVertex>& PolyLineBase::GetVertices()
 
 TrajVertex* PolyLineBase::GetCurrentVertex()
 {
-    if (GetNumberOfVertices() < 1 || current_index_ == IDX_UNDEFINED || current_index_ >= vertex_.size())
+    if (GetNumberOfVertices() < 1 || current_index_ == IDX_UNDEFINED || current_index_ < index_offset_ ||
+        ToStorageIndex(current_index_) >= vertex_.size())
     {
         return nullptr;
     }
 
-    return &vertex_[current_index_];
+    return &vertex_[ToStorageIndex(current_index_)];
+}
+
+void PolyLineBase::DiscardVertices(double time, idx_t keep_index)
+{
+    // count vertices prior to given time, except the last one which starts the segment covering the time
+    auto         iter = std::lower_bound(vertex_.begin(), vertex_.end(), time, [](const TrajVertex& v, double value) { return v.time < value; });
+    unsigned int n    = iter == vertex_.begin() ? 0 : static_cast<unsigned int>(iter - vertex_.begin()) - 1;
+
+    if (keep_index != IDX_UNDEFINED)
+    {
+        n = MIN(n, ToStorageIndex(keep_index));
+    }
+
+    // Compact only when the outdated vertices are at least as many as the remaining ones. This way each vertex is moved at
+    // most once on average, and storage never exceeds twice the retained part.
+    if (n == 0 || n < GetNumberOfVertices() - n)
+    {
+        return;
+    }
+
+    vertex_.erase(vertex_.begin(), vertex_.begin() + n);
+    index_offset_ += n;
+    current_index_ = MAX(current_index_, index_offset_);
+
+    // vertices have moved, rebuild segment index on next use
+    segment_index_.clear();
+    segment_index_n_vertices_ = 0;
 }
 
 void PolyLineBase::Reset(bool clear_vertices)
@@ -12327,8 +12938,13 @@ void PolyLineBase::Reset(bool clear_vertices)
         vertex_.clear();
     }
     current_index_    = 0;
+    index_offset_     = 0;
     length_           = 0.0;
     current_val_.time = 0.0;
+
+    // vertices might be modified after reset, drop the segment index
+    segment_index_.clear();
+    segment_index_n_vertices_ = 0;
 }
 
 PolyLineShape::~PolyLineShape()
@@ -12674,10 +13290,13 @@ int PolyLineShape::Evaluate(double p, TrajectoryParamType ptype, TrajVertex& pos
     }
     else
     {
-        for (; i < vertex_.size() - 1 && ((ptype == TrajectoryParamType::TRAJ_PARAM_TYPE_S && pline_.vertex_[i + 1].s < p) ||
-                                          (ptype == TrajectoryParamType::TRAJ_PARAM_TYPE_TIME && pline_.vertex_[i + 1].time < p));
-             i++)
-            ;
+        // find first segment ending at or after p
+        auto iter = std::lower_bound(pline_.vertex_.begin() + 1,
+                                     pline_.vertex_.end(),
+                                     p,
+                                     [ptype](const TrajVertex& v, double value)
+                                     { return (ptype == TrajectoryParamType::TRAJ_PARAM_TYPE_S ? v.s : v.time) < value; });
+        i         = static_cast<unsigned int>(iter - pline_.vertex_.begin()) - 1;
 
         if (ptype == TrajectoryParamType::TRAJ_PARAM_TYPE_TIME)
         {
@@ -14731,6 +15350,15 @@ RMTrajectory* RMTrajectory::Copy()
     return traj;
 }
 
+void RMTrajectory::SyncState(SE_StateBuffer& buf)
+{
+    // shape definition is static, Freeze() only updates the polyline approximation and following properties
+    buf.Sync(shape_->pline_);
+    buf.Sync(shape_->current_val_);
+    buf.Sync(shape_->following_mode_);
+    buf.Sync(shape_->initial_speed_);
+}
+
 int Shape::FindClosestPoint(double xin, double yin, TrajVertex& pos, idx_t& index, idx_t startAtIndex)
 {
     if (pline_.vertex_.size() > 0)
@@ -13,11 +13,13 @@
 #ifndef OPENDRIVE_HH_
 #define OPENDRIVE_HH_
 
+#include <algorithm>
 #include <cmath>
 #include <string>
 #include <map>
 #include <vector>
 #include <list>
+#include <memory>
 #include <sstream>
 #include "pugixml.hpp"
 #include "CommonMini.hpp"
@@ -47,6 +49,52 @@ namespace roadmanager
     */
     int GetLaneIdDelta(int from_lane, int to_lane);
 
+    /**
+            Find the piece covering given s value in a sequence of piecewise defined road attributes,
+            e.g. lane offset, lane width or elevation records. The piece covering s is the last one
+            starting at or before s. Since objects move coherently along s, the hint (typically the
+            index found by previous lookup) and its neighbors are checked first, giving constant time
+            for incremental updates. Otherwise binary search is applied.
+            @param pieces Sequence of pieces, sorted by start s
+            @param s Distance along the road (or along the lane section for lane widths)
+            @param get_s Function returning start s of a piece
+            @param hint Index to check first, IDX_UNDEFINED to skip
+            @return index of the piece, 0 if s is before first piece, IDX_UNDEFINED if no pieces
+    */
+    template <typename T, typename GetS>
+    idx_t GetPieceIdxByS(const std::vector<T> &pieces, double s, GetS get_s, idx_t hint = IDX_UNDEFINED)
+    {
+        if (pieces.empty())
+        {
+            return IDX_UNDEFINED;
+        }
+
+        idx_t n = static_cast<idx_t>(pieces.size());
+
+        if (hint < n)
+        {
+            auto covers = [&](idx_t i) { return (i == 0 || get_s(pieces[i]) <= s) && (i + 1 >= n || s < get_s(pieces[i + 1])); };
+
+            if (covers(hint))
+            {
+                return hint;
+            }
+            else if (hint + 1 < n && covers(hint + 1))
+            {
+                return hint + 1;
+            }
+            else if (hint > 0 && covers(hint - 1))
+            {
+                return hint - 1;
+            }
+        }
+
+        auto iter =
+            std::upper_bound(pieces.begin() + 1, pieces.end(), s, [&get_s](double s_value, const T &piece) { return s_value < get_s(piece); });
+
+        return static_cast<idx_t>(iter - pieces.begin()) - 1;
+    }
+
     class Polynomial
     {
     public:
@@ -1190,13 +1238,27 @@ namespace roadmanager
             element_id_ = id;
         }
 
+        /**
+        Unique and dense index of the link instance within the road network, e.g. for indexing per link data in path searches
+        */
+        idx_t GetIdx() const
+        {
+            return idx_;
+        }
+
+        // Restart indexing from 0. Call when all links are deleted, i.e. the road network is cleared, see OpenDrive::Clear().
+        static void ResetIdxCounter();
+
         void Print() const;
 
     private:
+        static idx_t NewIdx();
+
         LinkType         type_               = NONE;
         id_t             element_id_         = ID_UNDEFINED;
         ElementType      element_type_       = ELEMENT_TYPE_UNKNOWN;
         ContactPointType contact_point_type_ = CONTACT_POINT_UNDEFINED;
+        idx_t            idx_                = NewIdx();
     };
 
     struct LaneInfo
@@ -2097,6 +2159,7 @@ namespace roadmanager
         void SetTrafficLightInfo();
         void UpdateState(const std::string state);
         void CheckValidLampModes(const std::string &input) const;
+        void SyncState(SE_StateBuffer &buf);  // store or restore lamp states, see SE_StateBuffer
 
         size_t GetNrLamps() const
         {
@@ -2667,6 +2730,32 @@ namespace roadmanager
         MPH
     };
 
+    /**
+    Item along a road of interest when looking ahead, e.g. for driver or ADAS models. Each road keeps its features
+    sorted by s, see Road::GetFeatures(). Changes of speed limit and lane count are registered where they occur within
+    the road, while changes at road connections are resolved by RoadFeatureCursor.
+    */
+    struct RoadFeature
+    {
+        enum Type
+        {
+            SIGNAL      = (1 << 0),  // road sign or traffic light
+            OBJECT      = (1 << 1),  // road object, e.g. barrier or parking space
+            SPEED_LIMIT = (1 << 2),  // change of speed limit, given by road type entries
+            LANE_COUNT  = (1 << 3),  // change of number of driving lanes in one direction
+            ANY         = 0xf
+        };
+
+        Type        type;
+        double      s;                             // position along the road
+        int         orientation  = 0;              // 1 = valid for traffic along road s axis, -1 = opposite, 0 = both
+        double      value_behind = 0.0;            // SPEED_LIMIT (m/s), LANE_COUNT: value at lower s
+        double      value_ahead  = 0.0;            // SPEED_LIMIT (m/s), LANE_COUNT: value at higher s
+        id_t        id           = ID_UNDEFINED;   // SIGNAL, OBJECT: id of signal or object
+        idx_t       index        = IDX_UNDEFINED;  // SIGNAL, OBJECT: see Road::GetSignal() and Road::GetRoadObject()
+        RoadObject *object       = nullptr;        // SIGNAL, OBJECT
+    };
+
     class Road
     {
     public:
@@ -2882,8 +2971,8 @@ namespace roadmanager
         {
             return tunnel_;
         }
-        double       GetLaneOffset(double s) const;
-        double       GetLaneOffsetPrim(double s) const;
+        double       GetLaneOffset(double s, idx_t *index = nullptr) const;
+        double       GetLaneOffsetPrim(double s, idx_t *index = nullptr) const;
         unsigned int GetNumberOfLanes(double s) const;
         unsigned int GetNumberOfDrivingLanes(double s) const;
         Lane        *GetDrivingLaneByIdx(double s, idx_t idx) const;
@@ -2948,6 +3037,16 @@ namespace roadmanager
 
         int GetIntIdByStringId(std::string string_id);
 
+        /**
+        Collect signals, objects and changes of speed limit and lane count, sorted by s. Call once road is complete.
+        */
+        void UpdateFeatureIndex();
+
+        const std::vector<RoadFeature> &GetFeatures() const
+        {
+            return feature_;
+        }
+
     protected:
         id_t        id_;
         std::string id_str_;
@@ -2966,6 +3065,7 @@ namespace roadmanager
         std::vector<Signal *>                   signal_;
         std::vector<RMObject *>                 object_;
         std::vector<Tunnel *>                   tunnel_;
+        std::vector<RoadFeature>                feature_;
     };
 
     class LaneRoadLaneConnection
@@ -3296,6 +3396,15 @@ namespace roadmanager
             return odr_filename_;
         }
 
+        /**
+                Get revision of the road network, a new value each time roads are loaded or cleared.
+                Used to detect when data cached from the road network, e.g. pointers to roads, is outdated.
+        */
+        unsigned int GetRevision() const
+        {
+            return revision_;
+        }
+
         /**
                 Setting information based on the OSI standards for OpenDrive elements
         */
@@ -3313,14 +3422,33 @@ namespace roadmanager
                                  bool                     &insert,
                                  const double              s_max) const;
         bool CheckLaneOSIRequirement(std::vector<double> x0, std::vector<double> y0, std::vector<double> x1, std::vector<double> y1) const;
-        void SetLaneOSIPoints();
-        void SetRoadMarkOSIPoints();
+
+        /**
+                Create OSI points for all lanes, roads distributed over given thread pool
+        */
+        void SetLaneOSIPoints(SE_ThreadPool &pool);
+        void SetLaneOSIPoints(Road *road);
+
+        /**
+                Create OSI points for all road marks, roads distributed over given thread pool
+        */
+        void SetRoadMarkOSIPoints(SE_ThreadPool &pool);
+        void SetRoadMarkOSIPoints(Road *road);
+
+        /**
+                Make sure road mark OSI points have been created. Needed before accessing them when the
+                osi_lazy_roadmarks option is set, otherwise they are already created at load and this call returns immediately.
+                @param road Road of interest, or nullptr for all roads
+        */
+        void EnsureRoadMarkOSIPoints(Road *road = nullptr);
 
         /**
                 Checks all lanes - if a lane has RoadMarks it does nothing. If a lane does not have roadmarks
                 then it creates a LaneBoundary following the lane border (left border for left lanes, right border for right lanes)
+                Points are calculated in parallel, while the LaneBoundary objects are created in road order for deterministic global ids
         */
-        void SetLaneBoundaryPoints();
+        void SetLaneBoundaryPoints(SE_ThreadPool &pool);
+        void SetLaneBoundaryPoints(Road *road, std::vector<std::pair<Lane *, std::vector<PointStruct>>> &boundaries);
 
         /**
                 Create tunnel road objects from lane boundary OSI points
@@ -3495,6 +3623,8 @@ namespace roadmanager
         std::vector<std::pair<id_t, std::string>> road_ids_;
         std::vector<std::pair<id_t, std::string>> junction_ids_;
         std::vector<Signal *>                     dynamic_signals_;
+        std::vector<bool>                         roadmark_osi_pending_;  // per road, set when road mark OSI points are deferred
+        unsigned int                              revision_ = 0;          // see GetRevision()
         id_t                                      LookupIdFromStr(std::vector<std::pair<id_t, std::string>> &ids, std::string id_str);
         bool                                      ParseOpenDriveXML(const pugi::xml_document &doc);
     };
@@ -3720,6 +3850,12 @@ namespace roadmanager
         // Copy only location data from other position object
         void CopyLocation(const Position &from);
 
+        /**
+        Store or restore complete runtime state, see SE_StateBuffer
+        Route and trajectory objects are not owned by the position, hence only the references are synced
+        */
+        void SyncState(SE_StateBuffer &buf);
+
         void Clean();
 
         void              Init();
@@ -4754,6 +4890,7 @@ namespace roadmanager
         idx_t geometry_idx_;         // index of the segment within the track given by track_idx
         idx_t elevation_idx_;        // index of the current elevation entry
         idx_t super_elevation_idx_;  // index of the current super elevation entry
+        idx_t lane_offset_idx_;      // index of the current lane offset entry
         idx_t osi_point_idx_;        // index of the current closest OSI road point
 
         // RouteStrategy for a position, used for waypoints
@@ -4917,19 +5054,39 @@ namespace roadmanager
             int              direction = 0;
         };
 
-        std::vector<PathNode *> visited_;
-        std::vector<PathNode *> unvisited_;
-        const Position         *startPos_;
-        const Position         *targetPos_;
-        int                     direction_;  // direction of path from starting pos. 0==not set, 1==forward, -1==backward
-        PathNode               *firstNode_;
-
-        RoadPath(const Position *startPos, const Position *targetPos)
-            : startPos_(startPos),
-              targetPos_(targetPos),
-              direction_(0),
-              firstNode_(nullptr){};
+        /**
+        Search state reused between path calculations to avoid heap allocations in steady state.
+        Nodes are pooled and the visited/unvisited status per link is tracked by generation stamps,
+        indexed by RoadLink::GetIdx(), so nothing needs to be cleared between searches.
+        Each thread keeps a stack of free workspaces, handing out one per RoadPath instance.
+        */
+        struct Workspace
+        {
+            std::vector<std::unique_ptr<PathNode>> node_pool;
+            size_t                                 n_nodes_used = 0;
+            std::vector<PathNode *>                visited;
+            std::vector<PathNode *>                unvisited;
+            std::vector<unsigned int>              visited_stamp;    // per link: generation when visited
+            std::vector<unsigned int>              unvisited_stamp;  // per link: generation when added to unvisited
+            unsigned int                           generation = 0;
+
+            void      Reset();
+            PathNode *NewNode();
+            void      ReserveLink(const RoadLink *link);
+        };
+
+        Workspace              *workspace_;
+        std::vector<PathNode *> &visited_;
+        std::vector<PathNode *> &unvisited_;
+        const Position          *startPos_;
+        const Position          *targetPos_;
+        int                      direction_;  // direction of path from starting pos. 0==not set, 1==forward, -1==backward
+        PathNode                *firstNode_;
+
+        RoadPath(const Position *startPos, const Position *targetPos);
         ~RoadPath();
+        RoadPath(const RoadPath &)            = delete;
+        RoadPath &operator=(const RoadPath &) = delete;
 
         /**
         Calculate shortest path between starting position and target position,
@@ -4946,6 +5103,76 @@ namespace roadmanager
 
     private:
         bool CheckRoad(Road *checkRoad, RoadPath::PathNode *srcNode, Road *fromRoad, int fromLaneId);
+        void AddUnvisited(PathNode *node);
+        void MarkVisited(idx_t unvisited_idx);
+
+        static Workspace *AcquireWorkspace();
+        static void       ReleaseWorkspace(Workspace *workspace);
+    };
+
+    /**
+    Finds road features, see RoadFeature, ahead of a position in order of distance. Follows the route of the position,
+    if any, else the most straight way through junctions. The roads ahead are kept between updates, so as long as the
+    position advances along them only the newly covered part of the road network is looked up. Distances are measured
+    along road reference lines.
+    */
+    class RoadFeatureCursor
+    {
+    public:
+        struct Hit
+        {
+            RoadFeature::Type type;
+            double            distance;   // from the position, along the roads
+            id_t              road_id;    // road of the feature
+            double            s;          // position of the feature along its road
+            int               direction;  // direction of travel relative road s axis, 1 or -1
+            double            value;      // SPEED_LIMIT (m/s), LANE_COUNT: value once passed
+            id_t              id;         // SIGNAL, OBJECT: id of signal or object
+            idx_t             index;      // SIGNAL, OBJECT: index on the road
+            RoadObject       *object;     // SIGNAL, OBJECT
+        };
+
+        /**
+        Look for features ahead of given position, in the direction of its heading
+        @param pos Current position
+        @param distance Max distance to look ahead
+        @param type_mask Bitmask of the feature types to include, see RoadFeature::Type
+        @param max_hits Stop after this number of features, 0 means no limit
+        @return Number of features found, -1 if position is not on a road
+        */
+        int Update(const Position &pos, double distance, int type_mask = RoadFeature::ANY, unsigned int max_hits = 0);
+
+        unsigned int GetNumberOfHits() const
+        {
+            return static_cast<unsigned int>(hit_.size());
+        }
+
+        const Hit *GetHit(unsigned int idx) const
+        {
+            return idx < hit_.size() ? &hit_[idx] : nullptr;
+        }
+
+        // Forget roads ahead, next update will look them up from scratch. Done automatically when another road network is loaded.
+        void Reset();
+
+    private:
+        struct Segment
+        {
+            Road  *road;
+            int    direction;   // direction of travel relative road s axis, 1 or -1
+            double s_start;     // where segment is entered
+            double s_end;       // where road is left
+            double dist_start;  // distance from start of first segment
+            bool   dead_end;    // no way further from this segment
+        };
+
+        bool AddNextSegment(const Route *route);
+
+        std::vector<Segment> segment_;
+        std::vector<Hit>     hit_;
+        const Route         *route_        = nullptr;  // route followed when segments were added, only compared
+        size_t               route_size_   = 0;
+        unsigned int         odr_revision_ = 0;  // road network the segments refer to, see OpenDrive::GetRevision()
     };
 
     class PolyLineBase
@@ -5006,6 +5233,15 @@ namespace roadmanager
          */
         idx_t Evaluate(double s);
 
+        /**
+         * Find point on polyline closest to provided point
+         * @param xin X coordinate of input position
+         * @param yin Y coordinate of input position
+         * @param pos Returns closest trajectory position
+         * @param index Returns index of closest segment
+         * @param startAtIndex If > 0 look for local minimum around this index, else global minimum using the segment index
+         * @return 0 if successful, -1 if polyline has no segments
+         */
         int FindClosestPoint(double xin, double yin, TrajVertex &pos, idx_t &index, idx_t startAtIndex = 0);
 
         int FindPointAhead(double s_start, double distance, TrajVertex &pos, idx_t &index, idx_t startAtIndex = 0);
@@ -5035,6 +5271,25 @@ namespace roadmanager
         void                     Reset(bool clear_vertices);
         void                     SetInterpolationMode(InterpolationMode mode);
 
+        /**
+         * Discard vertices older than given time, keeping the last one before it so that the time is still covered.
+         * Indices given and returned by other functions are not affected, e.g. index 100 refers to the same vertex
+         * before and after. vertex_ holds remaining vertices only, index i at position i - GetIndexOffset().
+         * Storage is compacted only when discarded vertices are at least as many as remaining ones, so the cost is
+         * constant per added vertex.
+         * @param time Timestamp of the oldest vertex to keep
+         * @param keep_index Don't discard this vertex or any later one, e.g. segment in use by a follower. IDX_UNDEFINED to skip.
+         */
+        void DiscardVertices(double time, idx_t keep_index = IDX_UNDEFINED);
+
+        /**
+         * Get number of discarded vertices, i.e. index of first vertex in vertex_
+         */
+        idx_t GetIndexOffset() const
+        {
+            return index_offset_;
+        }
+
         /**
          * Get s value for given time value
          * @param time Time offset from first timestamp
@@ -5045,13 +5300,56 @@ namespace roadmanager
         GhostTrailReturnCode Time2S(double time, double &s, idx_t &index) const;
 
         std::vector<TrajVertex> vertex_;
-        idx_t                   current_index_ = 0;
+        idx_t                   current_index_ = 0;  // including index offset, see DiscardVertices()
         TrajVertex              current_val_;
         double                  length_             = 0.0;
         InterpolationMode       interpolation_mode_ = InterpolationMode::INTERPOLATE_NONE;
 
     protected:
         int EvaluateSegmentByLocalS(idx_t i, double local_s, TrajVertex &pos);
+
+        // Convert index into position in vertex_, discarded vertices mapped to first remaining one
+        idx_t ToStorageIndex(idx_t index) const
+        {
+            return index > index_offset_ ? index - index_offset_ : 0;
+        }
+
+        idx_t index_offset_ = 0;  // number of discarded vertices, see DiscardVertices()
+
+        /**
+         * Calculate distance from a point to a segment
+         * @param i Index of the segment, i.e. first vertex
+         * @param x X coordinate of the point
+         * @param y Y coordinate of the point
+         * @param s_local Returns distance along the segment to the closest point
+         * @return Distance from point to the closest point on the segment
+         */
+        double SegmentDistance(idx_t i, double x, double y, double &s_local) const;
+
+        /**
+         * Bring the segment index up to date. Vertices are assumed to be appended only, any other
+         * change must be followed by Reset() which drops the index.
+         */
+        void UpdateSegmentIndex();
+
+        /**
+         * Find segment globally closest to a point, using the segment index. Among equally close segments the first one is picked.
+         * @return true if found, false if polyline has no segments
+         */
+        bool FindClosestSegment(double x, double y, idx_t &index, double &s_local, double &dist);
+
+        struct SegmentBox
+        {
+            double x_min;
+            double y_min;
+            double x_max;
+            double y_max;
+        };
+
+        // Bounding box hierarchy over segments. Level 0 holds one box per SEGMENT_INDEX_LEAF_SIZE consecutive segments,
+        // each following level one box per pair of boxes in the level below. Last level holds a single box.
+        std::vector<std::vector<SegmentBox>> segment_index_;
+        unsigned int                         segment_index_n_vertices_ = 0;  // number of vertices covered by the segment index
     };
 
     // Trajectory stuff
@@ -5385,6 +5683,7 @@ namespace roadmanager
         double        GetH() const;
         void          Evaluate();  // evaluate for current s-value
         RMTrajectory *Copy();
+        void          SyncState(SE_StateBuffer &buf);  // store or restore frozen polyline and evaluation state
 
         Shape      *shape_;
         std::string name_;
@@ -14,6 +14,7 @@
 #include "OSCCondition.hpp"
 #include "Storyboard.hpp"
 #include "logger.hpp"
+#include "Profiler.hpp"
 
 using namespace scenarioengine;
 using namespace roadmanager;
@@ -279,8 +280,32 @@ void OSCCondition::Reset()
     cond_value_ = false;
 }
 
+void OSCCondition::SyncState(SE_StateBuffer& buf)
+{
+    buf.Sync(last_result_);
+    buf.Sync(state_);
+    buf.Sync(history_);
+    buf.Sync(cond_value_);
+}
+
+const char* OSCCondition::GetTypeName() const
+{
+    switch (base_type_)
+    {
+        case ConditionType::BY_ENTITY:
+            return "ByEntityCondition";
+        case ConditionType::BY_STATE:
+            return "StoryboardElementStateCondition";
+        case ConditionType::BY_VALUE:
+            return "ByValueCondition";
+    }
+    return "Condition";
+}
+
 bool OSCCondition::Evaluate(double sim_time)
 {
+    SE_ProfileScope profile_scope(SE_Profiler::Level::ALL, GetTypeName());
+
     bool result        = CheckCondition(sim_time);
     bool current_value = CheckEdge(result, last_result_, edge_);
     last_result_       = result;
@@ -337,6 +362,14 @@ bool ConditionGroup::Evaluate(double sim_time)
     return result;
 }
 
+void ConditionGroup::SyncState(SE_StateBuffer& buf)
+{
+    for (auto c : condition_)
+    {
+        c->SyncState(buf);
+    }
+}
+
 bool Trigger::Evaluate(double sim_time)
 {
     bool result = false;
@@ -394,6 +427,76 @@ void Trigger::Reset()
     }
 }
 
+void Trigger::SyncState(SE_StateBuffer& buf)
+{
+    for (auto cg : conditionGroup_)
+    {
+        cg->SyncState(buf);
+    }
+}
+
+void TrigByEntity::SyncState(SE_StateBuffer& buf)
+{
+    OSCCondition::SyncState(buf);
+    buf.Sync(triggered_by_entities_);
+}
+
+const char* TrigByEntity::GetTypeName() const
+{
+    switch (type_)
+    {
+        case EntityConditionType::TIME_HEADWAY:
+            return "TimeHeadwayCondition";
+        case EntityConditionType::DISTANCE:
+            return "DistanceCondition";
+        case EntityConditionType::RELATIVE_DISTANCE:
+            return "RelativeDistanceCondition";
+        case EntityConditionType::REACH_POSITION:
+            return "ReachPositionCondition";
+        case EntityConditionType::TRAVELED_DISTANCE:
+            return "TraveledDistanceCondition";
+        case EntityConditionType::END_OF_ROAD:
+            return "EndOfRoadCondition";
+        case EntityConditionType::TIME_TO_COLLISION:
+            return "TimeToCollisionCondition";
+        case EntityConditionType::COLLISION:
+            return "CollisionCondition";
+        case EntityConditionType::OFF_ROAD:
+            return "OffroadCondition";
+        case EntityConditionType::ACCELERATION:
+            return "AccelerationCondition";
+        case EntityConditionType::STAND_STILL:
+            return "StandStillCondition";
+        case EntityConditionType::SPEED:
+            return "SpeedCondition";
+        case EntityConditionType::RELATIVE_SPEED:
+            return "RelativeSpeedCondition";
+        case EntityConditionType::RELATIVE_CLEARANCE:
+            return "RelativeClearanceCondition";
+    }
+    return OSCCondition::GetTypeName();
+}
+
+const char* TrigByValue::GetTypeName() const
+{
+    switch (type_)
+    {
+        case Type::PARAMETER:
+            return "ParameterCondition";
+        case Type::VARIABLE:
+            return "VariableCondition";
+        case Type::TIME_OF_DAY:
+            return "TimeOfDayCondition";
+        case Type::SIMULATION_TIME:
+            return "SimulationTimeCondition";
+        case Type::TRAFFIC_SIGNAL:
+            return "TrafficSignalCondition";
+        case Type::UNDEFINED:
+            break;
+    }
+    return OSCCondition::GetTypeName();
+}
+
 bool TrigByState::CheckCondition(double sim_time)
 {
     (void)sim_time;
@@ -587,6 +690,13 @@ void TrigByState::Reset()
     OSCCondition::Reset();
 }
 
+void TrigByState::SyncState(SE_StateBuffer& buf)
+{
+    OSCCondition::SyncState(buf);
+    buf.Sync(state_change_);
+    buf.Sync(latest_state_change_);
+}
+
 bool TrigBySimulationTime::CheckCondition(double sim_time)
 {
     sim_time_   = sim_time;
@@ -600,6 +710,12 @@ std::string TrigBySimulationTime::GetAdditionalLogInfo()
     return fmt::format("{:.4f} {} {:.4f}, edge: {}", sim_time_, Rule2Str(rule_), value_, Edge2Str());
 }
 
+void TrigBySimulationTime::SyncState(SE_StateBuffer& buf)
+{
+    OSCCondition::SyncState(buf);
+    buf.Sync(value_);
+}
+
 bool TrigByParameter::CheckCondition(double sim_time)
 {
     (void)sim_time;
@@ -1186,6 +1302,12 @@ std::string TrigByCollision::GetAdditionalLogInfo()
     return str;
 }
 
+void TrigByCollision::SyncState(SE_StateBuffer& buf)
+{
+    TrigByEntity::SyncState(buf);
+    buf.Sync(collision_pair_);
+}
+
 bool TrigByTraveledDistance::CheckCondition(double sim_time)
 {
     (void)sim_time;
@@ -114,6 +114,8 @@ namespace scenarioengine
         bool                CheckEdge(bool new_value, bool old_value, OSCCondition::ConditionEdge edge) const;
         std::string         Edge2Str() const;
         virtual void        Reset();
+        virtual void        SyncState(SE_StateBuffer& buf);
+        virtual const char* GetTypeName() const;  // OpenSCENARIO element name, e.g. "SpeedCondition"
     };
 
     class ConditionGroup
@@ -130,6 +132,7 @@ namespace scenarioengine
         }
 
         bool Evaluate(double sim_time);
+        void SyncState(SE_StateBuffer& buf);
     };
 
     class Trigger
@@ -150,6 +153,7 @@ namespace scenarioengine
 
         bool         Evaluate(double sim_time);
         virtual void Reset();
+        void         SyncState(SE_StateBuffer& buf);
 
     private:
         bool defaultValue_;  // applied on empty conditions
@@ -205,6 +209,9 @@ namespace scenarioengine
         void print()
         {
         }
+
+        void        SyncState(SE_StateBuffer& buf) override;
+        const char* GetTypeName() const override;
     };
 
     class TrigByTimeHeadway : public TrigByEntity
@@ -350,6 +357,7 @@ namespace scenarioengine
         {
         }
         std::string GetAdditionalLogInfo() override;
+        void        SyncState(SE_StateBuffer& buf) override;
     };
 
     class TrigByEndOfRoad : public TrigByEntity
@@ -536,6 +544,7 @@ namespace scenarioengine
         std::string StateChangeToStr(StateChange state_change);
         std::string GetAdditionalLogInfo() override;
         void        Reset();
+        void        SyncState(SE_StateBuffer& buf) override;
     };
 
     class TrigByValue : public OSCCondition
@@ -557,6 +566,8 @@ namespace scenarioengine
         TrigByValue(Type type) : OSCCondition(BY_VALUE), type_(type)
         {
         }
+
+        const char* GetTypeName() const override;
     };
 
     class TrigBySimulationTime : public TrigByValue
@@ -570,6 +581,7 @@ namespace scenarioengine
         {
         }
         std::string GetAdditionalLogInfo() override;
+        void        SyncState(SE_StateBuffer& buf) override;  // value_ is shifted on ghost restart
     };
 
     class TrigByParameter : public TrigByValue
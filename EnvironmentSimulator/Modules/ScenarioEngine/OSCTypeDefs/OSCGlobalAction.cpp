@@ -40,11 +40,21 @@ using std::vector;
 #define VEHICLE_DISTANCE      12   // Min distance between two spawned vehicles
 #define SWARM_TIME_INTERVAL   0.1  // Sleep time between update steps
 #define SWARM_SPAWN_FREQUENCY 1.1  // Sleep time between spawns
-#define MAX_CARS              1000
+#define SWARM_LOD_MARGIN      10   // Distance beyond LOD radius before vehicles are demoted to far field
+#define FAR_FIELD_MIN_GAP     3.0  // Min distance to vehicle ahead for far field vehicles
+#define FAR_FIELD_TIME_GAP    1.5  // Time gap to vehicle ahead for far field vehicles
 #define MAX_LANES             32
 
 int SwarmTrafficAction::counter_ = 0;
 
+namespace
+{
+    inline uint64_t LaneKey(id_t roadId, int laneId)
+    {
+        return (static_cast<uint64_t>(roadId) << 32) | static_cast<uint32_t>(laneId);
+    }
+}  // namespace
+
 void EnvironmentAction::Start(double simTime)
 {
     environment_->UpdateEnvironment(new_environment_);
@@ -363,6 +373,16 @@ SwarmTrafficAction::SwarmTrafficAction(StoryBoardElement* parent) : OSCGlobalAct
     counter_ = 0;
 }
 
+void SwarmTrafficAction::SyncState(SE_StateBuffer& buf)
+{
+    // spawned vehicles and spatial index are not captured, hence state is only valid before the swarm is started
+    if (num_executions_ > 0)
+    {
+        buf.AddUnsupported("SwarmTrafficAction " + GetName());
+    }
+    OSCGlobalAction::SyncState(buf);
+}
+
 void SwarmTrafficAction::Start(double simTime)
 {
     LOG_INFO("Swarm IR: {:.2f}, SMjA: {:.2f}, SMnA: {:.2f}, maxV: {} vel: {:.2f}",
@@ -373,6 +393,16 @@ void SwarmTrafficAction::Start(double simTime)
              velocity_);
     double x0, y0, x1, y1;
 
+    lodRadius_ = SE_Env::Inst().GetOptions().GetOptionSet("swarm_lod_radius")
+                     ? strtod(SE_Env::Inst().GetOptions().GetOptionValue("swarm_lod_radius"))
+                     : 0.0;
+    if (lodRadius_ > SMALL_NUMBER)
+    {
+        LOG_INFO("Swarm LOD radius: {:.2f}, vehicles further away from central object moved by simple lane following model", lodRadius_);
+    }
+    farV.clear();
+    laneSlots_.clear();
+
     midSMjA  = (semiMajorAxis_ + innerRadius_) / 2.0;
     midSMnA  = (semiMinorAxis_ + innerRadius_) / 2.0;
     lastTime = -1;
@@ -427,8 +457,10 @@ void SwarmTrafficAction::Start(double simTime)
 
 void SwarmTrafficAction::Step(double simTime, double dt)
 {
-    (void)simTime;
-    (void)dt;
+    if (lodRadius_ > SMALL_NUMBER)
+    {
+        stepFarField(dt);
+    }
 
     // Executes the step at each TIME_INTERVAL
     if (lastTime < 0 || abs(simTime - lastTime) > SWARM_TIME_INTERVAL)
@@ -454,7 +486,12 @@ void SwarmTrafficAction::Step(double simTime, double dt)
         aabbTree::processCandidates(candidates, triangle);
         aabbTree::findPoints(triangle, info, sols);
 
-        spawn(sols, despawn(simTime), simTime);
+        int nRemoved = despawn(simTime);
+        if (lodRadius_ > SMALL_NUMBER)
+        {
+            updateLOD(simTime);
+        }
+        spawn(sols, nRemoved, simTime);
         lastTime = simTime;
     }
 }
@@ -574,10 +611,9 @@ inline void SwarmTrafficAction::sampleRoads(int minN, int maxN, Solutions& sols,
     if (nCarsToSpawn <= sols.size() && nCarsToSpawn > 0)
     {
         // Shuffle and randomly select the points
-        // Solutions selected(nCarsToSpawn);
-        static Point selected[MAX_CARS];  // Remove macro when/if found a solution for dynamic array
+        Solutions selected(nCarsToSpawn);
         std::shuffle(sols.begin(), sols.end(), SE_Env::Inst().GetRand().GetGenerator());
-        sample(sols.begin(), sols.end(), selected, nCarsToSpawn, SE_Env::Inst().GetRand().GetGenerator());
+        sample(sols.begin(), sols.end(), selected.begin(), nCarsToSpawn, SE_Env::Inst().GetRand().GetGenerator());
 
         for (unsigned int i = 0; i < nCarsToSpawn; i++)
         {
@@ -639,8 +675,7 @@ inline void SwarmTrafficAction::sampleRoads(int minN, int maxN, Solutions& sols,
 
 void SwarmTrafficAction::spawn(Solutions sols, int replace, double simTime)
 {
-    int maxCars = static_cast<int>(
-        MIN(MAX_CARS, static_cast<unsigned int>(numberOfVehicles) - spawnedV.size()));  // Remove MIN check when/if found a solution for dynamic array
+    int maxCars = static_cast<int>(numberOfVehicles) - static_cast<int>(spawnedV.size() + farV.size());
     if (maxCars <= 0)
     {
         return;
@@ -649,17 +684,19 @@ void SwarmTrafficAction::spawn(Solutions sols, int replace, double simTime)
     vector<SelectInfo> info;
     sampleRoads(replace, maxCars, sols, info);
 
+    vector<unsigned int> elements;
+    vector<idx_t>        lanes;
     for (SelectInfo inf : info)
     {
-        unsigned int        lanesNo = MIN(MAX_LANES, inf.road->GetNumberOfDrivingLanes(inf.pos.GetS()));
-        static unsigned int elements[MAX_LANES];
-        std::iota(elements, elements + lanesNo, 0);
-
-        static idx_t lanes[MAX_LANES];
+        unsigned int lanesNo = MIN(MAX_LANES, inf.road->GetNumberOfDrivingLanes(inf.pos.GetS()));
+        unsigned int nLanes  = MIN(lanesNo, inf.nLanes);
+        elements.resize(lanesNo);
+        lanes.resize(nLanes);
+        std::iota(elements.begin(), elements.end(), 0);
 
-        sample(elements, elements + lanesNo, lanes, MIN(MAX_LANES, inf.nLanes), SE_Env::Inst().GetRand().GetGenerator());
+        sample(elements.begin(), elements.end(), lanes.begin(), nLanes, SE_Env::Inst().GetRand().GetGenerator());
 
-        for (unsigned int i = 0; i < MIN(MAX_LANES, inf.nLanes); i++)
+        for (unsigned int i = 0; i < nLanes; i++)
         {
             auto Lane = inf.road->GetDrivingLaneByIdx(inf.pos.GetS(), lanes[i]);
             int  laneID;
@@ -677,88 +714,296 @@ void SwarmTrafficAction::spawn(Solutions sols, int replace, double simTime)
             if (!ensureDistance(inf.pos, laneID, MIN(MAX(40.0, velocity_ * 2.0), 0.7 * semiMajorAxis_)))
                 continue;  // distance = speed * 2 seconds
 
-            Controller::InitArgs args;
-            args.name            = "Swarm ACC controller";
-            args.type            = CONTROLLER_ACC_TYPE_NAME;
-            args.scenario_engine = scenario_engine_;
-            args.gateway         = gateway_;
-            args.parameters      = 0;
-            args.properties      = 0;
-
-#if 0  // This is one way of setting the ACC setSpeed property
-            args.properties = new OSCProperties();
-            OSCProperties::Property property;
-            property.name_ = "setSpeed";
-            property.value_ = std::to_string(velocity_);
-            args.properties->property_.push_back(property);
-#endif
-            Controller* acc = InstantiateControllerACC(&args);
-
-#if 1  // This is another way of setting the ACC setSpeed property
-            (static_cast<ControllerACC*>(acc))->SetSetSpeed(velocity_);
-#endif
-            reader_->AddController(acc);
-
             // Pick random model from vehicle catalog
-            Vehicle* vehicle_tmp = vehicle_pool_.GetRandomVehicle();
-            if (vehicle_tmp == nullptr)
+            Vehicle* model = vehicle_pool_.GetRandomVehicle();
+            if (model == nullptr)
             {
                 LOG_ERROR("No vehicle");
                 continue;
             }
-            Vehicle* vehicle = new Vehicle(*vehicle_tmp);
-            vehicle->pos_.SetLanePos(inf.pos.GetTrackId(), laneID, inf.pos.GetS(), 0.0);
 
             // Set swarm traffic direction based on RHT or LHT
+            double hRelative;
             if (inf.road->GetRule() == roadmanager::Road::RoadRule::RIGHT_HAND_TRAFFIC)
             {
-                vehicle->pos_.SetHeadingRelativeRoadDirection(laneID < 0 ? 0.0 : M_PI);
+                hRelative = laneID < 0 ? 0.0 : M_PI;
             }
             else if (inf.road->GetRule() == roadmanager::Road::RoadRule::LEFT_HAND_TRAFFIC)
             {
-                vehicle->pos_.SetHeadingRelativeRoadDirection(laneID > 0 ? 0.0 : M_PI);
+                hRelative = laneID > 0 ? 0.0 : M_PI;
             }
             else
             {
                 // do something if undefined... maybe default to RHT?
-                vehicle->pos_.SetHeadingRelativeRoadDirection(laneID < 0 ? 0.0 : M_PI);
+                hRelative = laneID < 0 ? 0.0 : M_PI;
+            }
+
+            if (lodRadius_ > SMALL_NUMBER &&
+                PointDistance2D(inf.pos.GetX(), inf.pos.GetY(), centralObject_->pos_.GetX(), centralObject_->pos_.GetY()) > lodRadius_)
+            {
+                // Far from central object, add as a lightweight vehicle
+                FarVehicle far = {roadmanager::Position(), model, velocity_, 0.0, 0, false};
+                far.pos.SetLanePos(inf.pos.GetTrackId(), laneID, inf.pos.GetS(), 0.0);
+                far.pos.SetHeadingRelative(hRelative);
+                for (Object* obj = model; obj != nullptr; obj = obj->TrailerVehicle())
+                {
+                    far.length += static_cast<double>(obj->boundingbox_.dimensions_.length_);
+                }
+
+                // register in lane, for distance checks of following spawns
+                std::vector<LaneSlot>& slots = laneSlots_[LaneKey(far.pos.GetTrackId(), laneID)];
+                LaneSlot               slot  = {far.pos.GetS(), far.length, static_cast<int>(farV.size())};
+                slots.insert(std::upper_bound(slots.begin(), slots.end(), slot, [](const LaneSlot& a, const LaneSlot& b) { return a.s < b.s; }),
+                             slot);
+
+                farV.push_back(far);
+            }
+            else
+            {
+                spawnVehicle(model, inf.pos.GetTrackId(), laneID, inf.pos.GetS(), hRelative, velocity_, simTime);
+            }
+        }
+    }
+}
+
+int SwarmTrafficAction::spawnVehicle(Vehicle* model,
+                                     id_t     roadId,
+                                     int      laneId,
+                                     double   s,
+                                     double   hRelative,
+                                     double   speed,
+                                     double   simTime,
+                                     bool     exact_model)
+{
+    // Primarily reuse a despawned vehicle, including its controller
+    Controller* acc     = nullptr;
+    Vehicle*    vehicle = reuseVehicle(model, simTime, acc, exact_model);
+    bool        reused  = vehicle != nullptr;
+
+    if (!reused)
+    {
+        if (spawnedV.size() + recycled_.size() >= numberOfVehicles)
+        {
+            return -1;  // all vehicles allocated, wait for one to be released
+        }
+
+        Controller::InitArgs args;
+        args.name            = "Swarm ACC controller";
+        args.type            = CONTROLLER_ACC_TYPE_NAME;
+        args.scenario_engine = scenario_engine_;
+        args.gateway         = gateway_;
+        args.parameters      = 0;
+        args.properties      = 0;
+
+#if 0  // This is one way of setting the ACC setSpeed property
+        args.properties = new OSCProperties();
+        OSCProperties::Property property;
+        property.name_ = "setSpeed";
+        property.value_ = std::to_string(velocity_);
+        args.properties->property_.push_back(property);
+#endif
+        acc = InstantiateControllerACC(&args);
+        reader_->AddController(acc);
+
+        vehicle        = new Vehicle(*model);
+        vehicle->name_ = "swarm_" + std::to_string(counter_++);
+    }
+
+    vehicle->pos_.SetLanePos(roadId, laneId, s, 0.0);
+    vehicle->pos_.SetHeadingRelative(hRelative);
+    vehicle->SetSpeed(speed);
+    // vehicle->scaleMode_ = EntityScaleMode::BB_TO_MODEL;
+
+    if (reused)
+    {
+        entities_->activateObject(vehicle);
+    }
+    else
+    {
+        entities_->addObject(vehicle, true);
+        vehicle->AssignController(acc);
+        acc->LinkObject(vehicle);
+    }
+
+    // align trailers
+    Vehicle* v = vehicle;
+    if (!v->TowVehicle() && v->TrailerVehicle())
+    {
+        v->AlignTrailers();
+    }
+
+    v->AlignRearAxlePosition();
+
+    // (re)set ACC setSpeed property, since it might have been adapted during any previous life
+    (static_cast<ControllerACC*>(acc))->SetSetSpeed(velocity_);
+    acc->Activate({ControlActivationMode::ON, ControlActivationMode::OFF, ControlActivationMode::OFF, ControlActivationMode::OFF});
+
+    SpawnInfo sInfo = {
+        vehicle->GetId(),  // Vehicle ID
+        0,                 // Useless detection counter
+        roadId,            // Road ID
+        laneId,            // Lane
+        simTime,           // Simulation time
+        model,             // Catalog vehicle
+        vehicle            // Vehicle
+    };
+    spawnedV.push_back(sInfo);
+
+    return 0;
+}
+
+void SwarmTrafficAction::releaseVehicle(Vehicle* vehicle, Vehicle* model, double simTime)
+{
+    // Keep vehicle and its controller for reuse. Deactivate, and remove vehicle and any trailers from gateway.
+    Controller* acc = nullptr;
+    for (auto ctrl : vehicle->controllers_)
+    {
+        ctrl->Deactivate();
+        if (ctrl->GetType() == Controller::Type::CONTROLLER_TYPE_ACC)
+        {
+            acc = ctrl;
+        }
+    }
+
+    for (Object* obj = vehicle; obj != nullptr; obj = obj->TrailerVehicle())
+    {
+        gateway_->removeObject(obj->GetId());
+    }
+    entities_->deactivateObject(vehicle);
+
+    recycled_.push_back({vehicle, model, acc, simTime});
+}
+
+void SwarmTrafficAction::stepFarField(double dt)
+{
+    // Sort all swarm vehicles into lanes. Fully simulated vehicles are included as leaders to far field ones.
+    for (auto& lane : laneSlots_)
+    {
+        lane.second.clear();
+    }
+
+    for (const SpawnInfo& info : spawnedV)
+    {
+        roadmanager::Position& pos = info.vehicle->pos_;
+        laneSlots_[LaneKey(pos.GetTrackId(), pos.GetLaneId())].push_back(
+            {pos.GetS(), static_cast<double>(info.vehicle->boundingbox_.dimensions_.length_), -1});
+    }
+
+    for (size_t i = 0; i < farV.size(); i++)
+    {
+        laneSlots_[LaneKey(farV[i].pos.GetTrackId(), farV[i].pos.GetLaneId())].push_back(
+            {farV[i].pos.GetS(), farV[i].length, static_cast<int>(i)});
+    }
+
+    // Adapt speed to vehicle ahead in same lane: Keep time gap, but accelerate towards swarm speed when there is space
+    for (auto& lane : laneSlots_)
+    {
+        std::vector<LaneSlot>& slots = lane.second;
+        std::sort(slots.begin(), slots.end(), [](const LaneSlot& a, const LaneSlot& b) { return a.s < b.s; });
+
+        for (size_t j = 0; j < slots.size(); j++)
+        {
+            if (slots[j].farIndex < 0)
+            {
+                continue;
             }
 
-            vehicle->SetSpeed(velocity_);
-            // vehicle->scaleMode_ = EntityScaleMode::BB_TO_MODEL;
-            vehicle->name_ = "swarm_" + std::to_string(counter_++);
-            int id         = entities_->addObject(vehicle, true);
+            FarVehicle& far         = farV[static_cast<unsigned int>(slots[j].farIndex)];
+            int         dir         = cos(far.pos.GetHRelative()) > 0.0 ? 1 : -1;
+            int         leader      = static_cast<int>(j) + dir;
+            double      targetSpeed = velocity_;
 
-            // align trailers
-            Vehicle* v = vehicle;
-            if (!v->TowVehicle() && v->TrailerVehicle())
+            if (leader >= 0 && leader < static_cast<int>(slots.size()))
             {
-                v->AlignTrailers();
+                const LaneSlot& lead = slots[static_cast<unsigned int>(leader)];
+                double          gap  = fabs(lead.s - slots[j].s) - 0.5 * (lead.length + slots[j].length);
+                targetSpeed          = MIN(targetSpeed, MAX(0.0, (gap - FAR_FIELD_MIN_GAP) / FAR_FIELD_TIME_GAP));
             }
 
-            v->AlignRearAxlePosition();
+            far.speed += CLAMP(targetSpeed - far.speed, -far.model->GetMaxDeceleration() * dt, far.model->GetMaxAcceleration() * dt);
+        }
+    }
+
+    for (FarVehicle& far : farV)
+    {
+        if (!far.endOfRoad && far.pos.MoveAlongS(far.speed * dt) < roadmanager::Position::ReturnCode::OK)
+        {
+            far.endOfRoad = true;  // will be removed by despawn
+        }
+    }
+}
+
+void SwarmTrafficAction::updateLOD(double simTime)
+{
+    double x = centralObject_->pos_.GetX();
+    double y = centralObject_->pos_.GetY();
 
-            vehicle->AssignController(acc);
-            acc->LinkObject(vehicle);
-            acc->Activate({ControlActivationMode::ON, ControlActivationMode::OFF, ControlActivationMode::OFF, ControlActivationMode::OFF});
+    // Demote fully simulated vehicles leaving the LOD radius. Some margin to avoid toggling back and forth at the border.
+    for (size_t i = 0; i < spawnedV.size();)
+    {
+        Vehicle* vehicle = spawnedV[i].vehicle;
+        if (PointDistance2D(vehicle->pos_.GetX(), vehicle->pos_.GetY(), x, y) > lodRadius_ + SWARM_LOD_MARGIN)
+        {
+            FarVehicle far = {vehicle->pos_, spawnedV[i].model, vehicle->GetSpeed(), 0.0, spawnedV[i].outMidAreaCount, false};
+            for (Object* obj = spawnedV[i].model; obj != nullptr; obj = obj->TrailerVehicle())
+            {
+                far.length += static_cast<double>(obj->boundingbox_.dimensions_.length_);
+            }
+            farV.push_back(far);
 
-            SpawnInfo sInfo = {
-                id,                    // Vehicle ID
-                0,                     // Useless detection counter
-                inf.pos.GetTrackId(),  // Road ID
-                laneID,                // Lane
-                simTime                // Simulation time
-            };
-            spawnedV.push_back(sInfo);
+            releaseVehicle(vehicle, spawnedV[i].model, simTime);
+            spawnedV.erase(spawnedV.begin() + static_cast<int>(i));
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    // Promote far field vehicles entering the LOD radius, unless no vehicle of same model is available for the moment
+    for (size_t i = 0; i < farV.size();)
+    {
+        FarVehicle& far = farV[i];
+        if (!far.endOfRoad && PointDistance2D(far.pos.GetX(), far.pos.GetY(), x, y) < lodRadius_ &&
+            spawnVehicle(far.model,
+                         far.pos.GetTrackId(),
+                         far.pos.GetLaneId(),
+                         far.pos.GetS(),
+                         far.pos.GetHRelative(),
+                         far.speed,
+                         simTime,
+                         true) == 0)
+        {
+            spawnedV.back().outMidAreaCount = far.outMidAreaCount;
+            farV[i]                         = farV.back();
+            farV.pop_back();
+        }
+        else
+        {
+            i++;
         }
     }
 }
 
 inline bool SwarmTrafficAction::ensureDistance(roadmanager::Position pos, int lane, double dist)
 {
-    for (SpawnInfo info : spawnedV)
+    // Far field vehicles, only check same lane
+    auto slots = laneSlots_.find(LaneKey(pos.GetTrackId(), lane));
+    if (slots != laneSlots_.end())
     {
-        Object* vehicle = entities_->GetObjectById(info.vehicleID);
+        auto it = std::lower_bound(slots->second.begin(),
+                                   slots->second.end(),
+                                   pos.GetS() - dist,
+                                   [](const LaneSlot& slot, double s) { return slot.s < s; });
+        if (it != slots->second.end() && it->s < pos.GetS() + dist)
+        {
+            return false;
+        }
+    }
+
+    for (const SpawnInfo& info : spawnedV)
+    {
+        Object* vehicle = info.vehicle;
 
         // First apply minimal radius filter to avoid vehicles appear too close, e.g. next to each other in neighbor lanes
         if (PointDistance2D(pos.GetX(), pos.GetY(), vehicle->pos_.GetX(), vehicle->pos_.GetY()) < 20)
@@ -781,106 +1026,113 @@ inline bool SwarmTrafficAction::ensureDistance(roadmanager::Position pos, int la
     return true;
 }
 
-int SwarmTrafficAction::despawn(double simTime)
+Vehicle* SwarmTrafficAction::reuseVehicle(Vehicle*& model, double simTime, Controller*& controller, bool exact_model)
 {
-    (void)simTime;
-    auto infoPtr       = spawnedV.begin();
-    bool increase      = true;
-    bool deleteVehicle = false;
-    int  count         = 0;
-
-    roadmanager::Position cPos = centralObject_->pos_;
-
-    while (infoPtr != spawnedV.end())
+    // Look for a vehicle of requested model. If all vehicles are allocated, pick the one released first instead, unless
+    // the model must be kept, e.g. when a far field vehicle is promoted.
+    // Skip vehicles released in current step, so that they don't just jump to new position in recordings.
+    int index = -1;
+    for (size_t i = 0; i < recycled_.size(); i++)
     {
-        Object* vehicle = entities_->GetObjectById(infoPtr->vehicleID);
+        if (recycled_[i].release_time > simTime - SMALL_NUMBER)
+        {
+            continue;
+        }
 
-        if (vehicle->IsOffRoad() || vehicle->IsEndOfRoad())
+        if (recycled_[i].model == model)
         {
-            deleteVehicle = true;
+            index = static_cast<int>(i);
+            break;
         }
-        else
+        else if (!exact_model && index == -1 && spawnedV.size() + recycled_.size() >= numberOfVehicles)
         {
-            roadmanager::Position vPos = vehicle->pos_;
-            auto                  e0   = ellipse(cPos.GetX(), cPos.GetY(), cPos.GetH(), semiMajorAxis_, semiMinorAxis_, vPos.GetX(), vPos.GetY());
-            auto                  e1   = ellipse(cPos.GetX(), cPos.GetY(), cPos.GetH(), midSMjA, midSMnA, vPos.GetX(), vPos.GetY());
-
-            if (e0 > 0.001)  // outside major ellipse
-            {
-                deleteVehicle = true;
-            }
-            else if (e1 > 0.001 || (0 <= e1 && e1 <= 0.001))  // outside middle ellipse or on the border
-            {
-                infoPtr->outMidAreaCount++;
-                if (infoPtr->outMidAreaCount > USELESS_THRESHOLD)
-                {
-                    deleteVehicle = true;
-                }
-            }
-            else
-            {
-                infoPtr->outMidAreaCount = 0;
-            }
+            index = static_cast<int>(i);
         }
+    }
 
-        if (deleteVehicle)
-        {
-            for (auto ctrl : vehicle->controllers_)
-            {
-                vehicle->UnassignController(ctrl);
-                ctrl->UnlinkObject();
-                reader_->RemoveController(ctrl);
-            }
+    if (index == -1)
+    {
+        return nullptr;
+    }
 
-            if (vehicle->type_ == Object::Type::VEHICLE)
-            {
-                Vehicle* v       = static_cast<Vehicle*>(vehicle);
-                Vehicle* trailer = nullptr;
-                while (v)  // remove all linked trailers
-                {
-                    trailer = static_cast<Vehicle*>(v->TrailerVehicle());
+    Vehicle* vehicle = recycled_[static_cast<unsigned int>(index)].vehicle;
+    model            = recycled_[static_cast<unsigned int>(index)].model;
+    controller       = recycled_[static_cast<unsigned int>(index)].controller;
+    recycled_.erase(recycled_.begin() + index);
 
-                    gateway_->removeObject(v->name_);
+    // reset states from previous life, for the vehicle and any trailers
+    for (Vehicle* v = vehicle; v != nullptr; v = static_cast<Vehicle*>(v->TrailerVehicle()))
+    {
+        v->SetOffRoad(false);
+        v->SetEndOfRoad(false);
+        v->SetStandStill(false);
+        v->collisions_.clear();
+        v->reset_ = true;
+    }
 
-                    if (v->objectEvents_.size() > 0 || v->initActions_.size() > 0)
-                    {
-                        entities_->deactivateObject(v);
-                    }
-                    else
-                    {
-                        entities_->removeObject(v, false);
-                    }
-                    v = trailer;
+    return vehicle;
+}
 
-                    vehicle = nullptr;  // indicate vehicle removed
-                }
-            }
+bool SwarmTrafficAction::outsideSwarm(const roadmanager::Position& pos, int& outMidAreaCount)
+{
+    const roadmanager::Position& cPos = centralObject_->pos_;
 
-            if (vehicle)
-            {
-                gateway_->removeObject(vehicle->name_);
-                if (vehicle->objectEvents_.size() > 0 || vehicle->initActions_.size() > 0)
-                {
-                    entities_->deactivateObject(vehicle);
-                }
-                else
-                {
-                    entities_->removeObject(vehicle, false);
-                }
-            }
+    auto e0 = ellipse(cPos.GetX(), cPos.GetY(), cPos.GetH(), semiMajorAxis_, semiMinorAxis_, pos.GetX(), pos.GetY());
+    auto e1 = ellipse(cPos.GetX(), cPos.GetY(), cPos.GetH(), midSMjA, midSMnA, pos.GetX(), pos.GetY());
 
-            infoPtr  = spawnedV.erase(infoPtr);
-            increase = deleteVehicle = false;
-            count++;
+    if (e0 > 0.001)  // outside major ellipse
+    {
+        return true;
+    }
+    else if (e1 > 0.001 || (0 <= e1 && e1 <= 0.001))  // outside middle ellipse or on the border
+    {
+        outMidAreaCount++;
+        if (outMidAreaCount > USELESS_THRESHOLD)
+        {
+            return true;
         }
+    }
+    else
+    {
+        outMidAreaCount = 0;
+    }
+
+    return false;
+}
 
-        if (increase)
+int SwarmTrafficAction::despawn(double simTime)
+{
+    int count = 0;
+
+    for (size_t i = 0; i < spawnedV.size();)
+    {
+        Vehicle* vehicle = spawnedV[i].vehicle;
+
+        if (vehicle->IsOffRoad() || vehicle->IsEndOfRoad() || outsideSwarm(vehicle->pos_, spawnedV[i].outMidAreaCount))
+        {
+            releaseVehicle(vehicle, spawnedV[i].model, simTime);
+            spawnedV.erase(spawnedV.begin() + static_cast<int>(i));
+            count++;
+        }
+        else
         {
-            ++infoPtr;
+            i++;
         }
+    }
 
-        increase = true;
+    for (size_t i = 0; i < farV.size();)
+    {
+        if (farV[i].endOfRoad || outsideSwarm(farV[i].pos, farV[i].outMidAreaCount))
+        {
+            farV[i] = farV.back();
+            farV.pop_back();
+            count++;
+        }
+        else
+        {
+            i++;
+        }
     }
 
     return count;
-}
\ No newline at end of file
+}
@@ -20,6 +20,7 @@
 #include "OSCEnvironment.hpp"
 #include "OSCAABBTree.hpp"
 #include <vector>
+#include <unordered_map>
 #include "OSCUtils.hpp"
 #include "OSCPosition.hpp"
 #include "logger.hpp"
@@ -386,13 +387,44 @@ namespace scenarioengine
     public:
         struct SpawnInfo
         {
-            int    vehicleID;
-            int    outMidAreaCount;
-            id_t   roadID;
-            int    lane;
-            double simTime;
+            int      vehicleID;
+            int      outMidAreaCount;
+            id_t     roadID;
+            int      lane;
+            double   simTime;
+            Vehicle* model;  // catalog vehicle the spawned one is a copy of
+            Vehicle* vehicle;
         };
 
+        // Vehicle outside the level of detail (LOD) radius. Instead of being a full entity with a controller, it's moved
+        // along its lane by a simple car following model.
+        typedef struct
+        {
+            roadmanager::Position pos;
+            Vehicle*              model;
+            double                speed;
+            double                length;  // including any trailers
+            int                   outMidAreaCount;
+            bool                  endOfRoad;
+        } FarVehicle;
+
+        // Vehicle position in a lane, for far field car following and spawn distance checks
+        typedef struct
+        {
+            double s;
+            double length;
+            int    farIndex;  // index in farV, -1 for fully simulated vehicles
+        } LaneSlot;
+
+        // Despawned vehicle, kept inactive together with its controller for reuse
+        typedef struct
+        {
+            Vehicle*    vehicle;
+            Vehicle*    model;
+            Controller* controller;
+            double      release_time;
+        } RecycledVehicle;
+
         typedef struct
         {
             roadmanager::Position pos;
@@ -418,6 +450,8 @@ namespace scenarioengine
 
         void Step(double simTime, double dt);
 
+        void SyncState(SE_StateBuffer& buf) override;
+
         void print()
         {
         }
@@ -472,7 +506,28 @@ namespace scenarioengine
         VehiclePool             vehicle_pool_;
         static int              counter_;
 
+        // Swarm vehicles are allocated once and then recycled, hence spawnedV.size() + recycled_.size() <= numberOfVehicles
+        std::vector<RecycledVehicle> recycled_;
+
+        // Level of detail. Only vehicles within lodRadius_ from central object are fully simulated, 0 = all
+        double                                              lodRadius_ = 0.0;
+        std::vector<FarVehicle>                             farV;
+        std::unordered_map<uint64_t, std::vector<LaneSlot>> laneSlots_;  // swarm vehicles per road and lane, sorted by s
+
         int         despawn(double simTime);
+        bool        outsideSwarm(const roadmanager::Position& pos, int& outMidAreaCount);
+        Vehicle*    reuseVehicle(Vehicle*& model, double simTime, Controller*& controller, bool exact_model);
+        int         spawnVehicle(Vehicle* model,
+                                 id_t     roadId,
+                                 int      laneId,
+                                 double   s,
+                                 double   hRelative,
+                                 double   speed,
+                                 double   simTime,
+                                 bool     exact_model = false);
+        void        releaseVehicle(Vehicle* vehicle, Vehicle* model, double simTime);
+        void        stepFarField(double dt);
+        void        updateLOD(double simTime);
         void        createRoadSegments(aabbTree::BBoxVec& vec);
         void        spawn(Solutions sols, int replace, double simTime);
         inline bool ensureDistance(roadmanager::Position pos, int lane, double dist);
@@ -332,6 +332,20 @@ void AssignRouteAction::ReplaceObjectRefs(Object* obj1, Object* obj2)
     }
 }
 
+void FollowTrajectoryAction::SyncState(SE_StateBuffer& buf)
+{
+    OSCPrivateAction::SyncState(buf);
+    buf.Sync(time_);
+    buf.Sync(initialDistanceOffset_);
+    buf.Sync(initialHeadingSign_);
+    buf.Sync(movingDirection_);
+    buf.Sync(explicit_h_active_);
+    if (traj_ != nullptr)
+    {
+        traj_->SyncState(buf);
+    }
+}
+
 void FollowTrajectoryAction::Start(double simTime)
 {
     OSCAction::Start(simTime);
@@ -661,13 +675,15 @@ AcquirePositionAction::~AcquirePositionAction()
 
 void AcquirePositionAction::Start(double simTime)
 {
-    // Resolve route
-    if (route_ != nullptr)
+    // Resolve route, reuse any previous instance to keep references valid, e.g. in stored checkpoints
+    if (route_ == nullptr)
     {
-        delete route_;
-        route_ = nullptr;
+        route_ = new roadmanager::Route;
+    }
+    else
+    {
+        *route_ = roadmanager::Route();
     }
-    route_ = new roadmanager::Route;
     route_->setName("AcquirePositionRoute");
     route_->setObjName(object_->GetName());
 
@@ -840,6 +856,16 @@ void ActivateControllerAction::End()
     OSCAction::End();
 }
 
+void LatLaneChangeAction::SyncState(SE_StateBuffer& buf)
+{
+    OSCPrivateAction::SyncState(buf);
+    buf.Sync(transition_);
+    buf.Sync(target_lane_offset_);
+    buf.Sync(start_offset_);
+    internal_pos_.SyncState(buf);
+    buf.Sync(heading_agnostic_);
+}
+
 void LatLaneChangeAction::Start(double simTime)
 {
     OSCAction::Start(simTime);
@@ -1033,6 +1059,13 @@ void LatLaneChangeAction::ReplaceObjectRefs(Object* obj1, Object* obj2)
     }
 }
 
+void LatLaneOffsetAction::SyncState(SE_StateBuffer& buf)
+{
+    OSCPrivateAction::SyncState(buf);
+    buf.Sync(transition_);
+    buf.Sync(max_lateral_acc_);
+}
+
 void LatLaneOffsetAction::Start(double simTime)
 {
     OSCAction::Start(simTime);
@@ -1149,6 +1182,13 @@ double LongSpeedAction::TargetRelative::GetValue()
     return 0;
 }
 
+void LongSpeedAction::SyncState(SE_StateBuffer& buf)
+{
+    OSCPrivateAction::SyncState(buf);
+    buf.Sync(transition_);
+    buf.Sync(target_speed_reached_);
+}
+
 void LongSpeedAction::Start(double simTime)
 {
     OSCAction::Start(simTime);
@@ -1296,6 +1336,18 @@ void LongSpeedAction::Step(double simTime, double dt)
     }
 }
 
+void LongSpeedProfileAction::SyncState(SE_StateBuffer& buf)
+{
+    OSCPrivateAction::SyncState(buf);
+    buf.Sync(segment_);
+    buf.Sync(cur_index_);
+    buf.Sync(start_time_);
+    buf.Sync(elapsed_);
+    buf.Sync(speed_);
+    buf.Sync(acc_);
+    buf.Sync(init_acc_);
+}
+
 void LongSpeedProfileAction::Start(double simTime)
 {
     OSCAction::Start(simTime);
@@ -1773,6 +1825,12 @@ void LongSpeedAction::ReplaceObjectRefs(Object* obj1, Object* obj2)
     }
 }
 
+void LongDistanceAction::SyncState(SE_StateBuffer& buf)
+{
+    OSCPrivateAction::SyncState(buf);
+    buf.Sync(acceleration_);
+}
+
 void LongDistanceAction::Start(double simTime)
 {
     if (target_object_ == 0)
@@ -1939,6 +1997,18 @@ void LongDistanceAction::ReplaceObjectRefs(Object* obj1, Object* obj2)
     }
 }
 
+void LatDistanceAction::SyncState(SE_StateBuffer& buf)
+{
+    OSCPrivateAction::SyncState(buf);
+    buf.Sync(move_state_);
+    buf.Sync(lat_vel_);
+    buf.Sync(acceleration_);
+    buf.Sync(spring_);
+    buf.Sync(old_x_);
+    buf.Sync(old_y_);
+    buf.Sync(sign_);
+}
+
 void LatDistanceAction::Start(double simTime)
 {
     if (target_object_ == 0)
@@ -2338,6 +2408,13 @@ void LatDistanceAction::ReplaceObjectRefs(Object* obj1, Object* obj2)
     }
 }
 
+void TeleportAction::SyncState(SE_StateBuffer& buf)
+{
+    OSCPrivateAction::SyncState(buf);
+    position_.SyncState(buf);
+    buf.Sync(ghost_restart_);
+}
+
 void TeleportAction::Start(double simTime)
 {
     OSCAction::Start(simTime);
@@ -2603,6 +2680,20 @@ void SynchronizeAction::SetSubMode(SynchSubmode submode, std::string msg)
     }
 }
 
+void SynchronizeAction::SyncState(SE_StateBuffer& buf)
+{
+    OSCPrivateAction::SyncState(buf);
+    buf.Sync(steadyState_);
+    buf.Sync(mode_);
+    buf.Sync(submode_);
+    target_position_master_.SyncState(buf);
+    target_position_.SyncState(buf);
+    buf.Sync(tolerance_);
+    buf.Sync(tolerance_master_);
+    buf.Sync(lastDist_);
+    buf.Sync(lastMasterDist_);
+}
+
 void SynchronizeAction::Start(double simTime)
 {
     target_position_master_.EvaluateRelation();
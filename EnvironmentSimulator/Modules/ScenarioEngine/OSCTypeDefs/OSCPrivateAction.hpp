@@ -290,6 +290,8 @@ namespace scenarioengine
             return "SpeedAction";
         };
 
+        void SyncState(SE_StateBuffer& buf) override;
+
         void Start(double simTime);
         void Step(double simTime, double dt);
 
@@ -402,6 +404,8 @@ namespace scenarioengine
             return "SpeedProfileAction";
         };
 
+        void SyncState(SE_StateBuffer& buf) override;
+
         void Start(double simTime);
         void Step(double simTime, double dt = 0.0);
 
@@ -507,6 +511,8 @@ namespace scenarioengine
             return "LongitudinalDistanceAction";
         };
 
+        void SyncState(SE_StateBuffer& buf) override;
+
         void Start(double simTime);
         void Step(double simTime, double dt);
 
@@ -600,6 +606,8 @@ namespace scenarioengine
             return "LateralDistanceAction";
         };
 
+        void SyncState(SE_StateBuffer& buf) override;
+
         void Start(double simTime);
         void Step(double simTime, double dt);
 
@@ -731,6 +739,8 @@ namespace scenarioengine
             return "LaneChangeAction";
         };
 
+        void SyncState(SE_StateBuffer& buf) override;
+
         void Step(double simTime, double dt);
         void Start(double simTime);
 
@@ -814,6 +824,8 @@ namespace scenarioengine
             return "LaneOffsetAction";
         };
 
+        void SyncState(SE_StateBuffer& buf) override;
+
         void Start(double simTime);
         void Step(double simTime, double dt);
 
@@ -931,6 +943,8 @@ namespace scenarioengine
             return "SynchronizeAction";
         };
 
+        void SyncState(SE_StateBuffer& buf) override;
+
         void Step(double simTime, double dt);
         void Start(double simTime);
 
@@ -1000,6 +1014,8 @@ namespace scenarioengine
             return "TeleportAction";
         };
 
+        void SyncState(SE_StateBuffer& buf) override;
+
         void Step(double simTime, double dt);
         void Start(double simTime);
 
@@ -1215,6 +1231,8 @@ namespace scenarioengine
             return "FollowTrajectoryAction";
         };
 
+        void SyncState(SE_StateBuffer& buf) override;
+
         void Step(double simTime, double dt);
         void Start(double simTime);
         void End();
@@ -81,6 +81,50 @@ Object::Object(Type type)
     model3d_x_offset_ = 0.0;
 }
 
+void Object::SyncState(SE_StateBuffer& buf)
+{
+    buf.Sync(speed_);
+    buf.Sync(wheel_angle_);
+    buf.Sync(wheel_rot_);
+    buf.Sync(ghost_trail_s_);
+    buf.Sync(trail_follow_index_);
+    buf.Sync(odometer_);
+    buf.Sync(end_of_road_timestamp_);
+    buf.Sync(off_road_timestamp_);
+    buf.Sync(stand_still_timestamp_);
+    buf.Sync(reset_);
+    buf.Sync(controllers_);
+    buf.Sync(headstart_time_);
+    buf.Sync(visibilityMask_);
+    buf.Sync(junctionSelectorStrategy_);
+    buf.Sync(nextJunctionSelectorAngle_);
+    buf.Sync(trail_closest_pos_);
+    for (int i = 0; i < 3; i++)
+    {
+        buf.Sync(sensor_pos_[i]);
+    }
+    buf.Sync(trail_);
+    buf.Sync(boundingbox_);
+    buf.Sync(objectEvents_);
+    buf.Sync(pitch_spring_);
+    buf.Sync(roll_spring_);
+    buf.Sync(state_old);
+    buf.Sync(collisions_);
+    for (int i = 0; i < OVERRIDE_NR_TYPES; i++)
+    {
+        buf.Sync(overrideActionList[i]);
+    }
+    buf.Sync(dirty_);
+    buf.Sync(is_active_);
+
+    pos_.SyncState(buf);
+    if (pos_.route_ != nullptr)
+    {
+        // route is owned by the action assigning it, but its current state depends on the object
+        buf.Sync(*pos_.route_);
+    }
+}
+
 void Object::SetEndOfRoad(bool state, double time)
 {
     if (state == true)
@@ -1702,6 +1746,24 @@ Vehicle::~Vehicle()
 {
 }
 
+void Vehicle::SyncState(SE_StateBuffer& buf)
+{
+    Object::SyncState(buf);
+
+    if (trailer_coupler_ != nullptr)
+    {
+        buf.Sync(trailer_coupler_->tow_vehicle_);
+    }
+    if (trailer_hitch_ != nullptr)
+    {
+        buf.Sync(trailer_hitch_->trailer_vehicle_);
+    }
+    buf.Sync(wheel_data);
+    buf.Sync(rear_axle_pos_);
+    buf.Sync(rear_axle_vel_);
+    buf.Sync(rear_axle_speed_);
+}
+
 void Vehicle::SetAllowedPitch()
 {
     // Cap pitching to 35% (tuned for esmini models) of front wheel diameter to avoid hitting the ground
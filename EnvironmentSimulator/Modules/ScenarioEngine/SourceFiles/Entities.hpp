@@ -260,6 +260,9 @@ namespace scenarioengine
         virtual ~Object()
         {
         }
+
+        // Store or restore runtime state, including any assigned route, see SE_StateBuffer
+        virtual void SyncState(SE_StateBuffer& buf);
         void SetEndOfRoad(bool state, double time = 0.0);
         bool IsEndOfRoad() const
         {
@@ -754,6 +757,8 @@ namespace scenarioengine
         Vehicle& operator=(const Vehicle&) = default;
         ~Vehicle();
 
+        void SyncState(SE_StateBuffer& buf) override;
+
         void SetCategory(std::string category)
         {
             if (category == "car")
@@ -17,6 +17,7 @@
 #include <string>
 #include <utility>
 #include <array>
+#include <unordered_map>
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -83,9 +84,11 @@ static struct
 
 static struct
 {
-    osi3::GroundTruth    *gt;
-    osi3::SensorView     *sv;
-    osi3::TrafficCommand *tc;
+    osi3::GroundTruth       *gt;
+    osi3::SensorView        *sv;
+    osi3::TrafficCommand    *tc;
+    const osi3::GroundTruth *gt_static_part;  // static data to merge into dynamic data for the combined ground truth, or nullptr
+    bool                     gt_merged;       // whether gt reflects latest update
 } obj_osi_external;
 
 using namespace scenarioengine;
@@ -312,9 +315,9 @@ int OSIReporter::UpdateOSIGroundTruth(const std::vector<std::unique_ptr<ObjectSt
         {
             SerializeDynamicAndStaticData();
         }
-        // Merge for API
-        obj_osi_external.gt->CopyFrom(*obj_osi_internal.dynamic_gt);
-        obj_osi_external.gt->MergeFrom(*obj_osi_internal.static_gt);
+        // Static data for API
+        obj_osi_external.gt_static_part = obj_osi_internal.static_gt;
+        static_gt_revision_++;
 
         counter_offset_  = GetCounter();
         osi_initialized_ = true;
@@ -323,10 +326,14 @@ int OSIReporter::UpdateOSIGroundTruth(const std::vector<std::unique_ptr<ObjectSt
     {
         // We always want to update the dynamic ground truth
         UpdateOSIDynamicGroundTruth(objectState);
-        obj_osi_external.gt->CopyFrom(*obj_osi_internal.dynamic_gt);
-
         UpdateOSIStaticGroundTruth(objectState);
 
+        if (obj_osi_internal.static_updated_gt->stationary_object_size() > 0)
+        {
+            // added misc objects have been merged into the static ground truth
+            static_gt_revision_++;
+        }
+
         switch (static_update_mode_)
         {
             case OSIStaticReportMode::DEFAULT:  // Only log and transmit dynamic ground truth
@@ -337,7 +344,11 @@ int OSIReporter::UpdateOSIGroundTruth(const std::vector<std::unique_ptr<ObjectSt
                 // include any added misc objects
                 if (obj_osi_internal.static_updated_gt->stationary_object_size() > 0)
                 {
-                    obj_osi_external.gt->MergeFrom(*obj_osi_internal.static_updated_gt);
+                    obj_osi_external.gt_static_part = obj_osi_internal.static_updated_gt;
+                }
+                else
+                {
+                    obj_osi_external.gt_static_part = nullptr;
                 }
                 break;
             case OSIStaticReportMode::API:  // Log dynamic ground truth, serialize and transmit combined ground truth
@@ -346,7 +357,7 @@ int OSIReporter::UpdateOSIGroundTruth(const std::vector<std::unique_ptr<ObjectSt
                     SerializeDynamicData();
                 }
 
-                obj_osi_external.gt->MergeFrom(*obj_osi_internal.static_gt);  // Merge for API
+                obj_osi_external.gt_static_part = obj_osi_internal.static_gt;  // Merge for API
                 break;
             case OSIStaticReportMode::API_AND_LOG:  // Log combined ground truth, serialze and transmit combined ground truth
                 if (IsFileOpen() || GetUDPClientStatus() == 0)
@@ -354,11 +365,18 @@ int OSIReporter::UpdateOSIGroundTruth(const std::vector<std::unique_ptr<ObjectSt
                     SerializeDynamicAndStaticData();
                 }
 
-                obj_osi_external.gt->MergeFrom(*obj_osi_internal.static_gt);  // Merge for API
+                obj_osi_external.gt_static_part = obj_osi_internal.static_gt;  // Merge for API
                 break;
         }
     }
 
+    // Combined ground truth for API. Skipped if user fetches static and dynamic parts separately, then merged only on request.
+    obj_osi_external.gt_merged = false;
+    if (!lazy_gt_merge_)
+    {
+        MergeOSIGroundTruth();
+    }
+
     if (IsFileOpen())
     {
         WriteOSIFile();
@@ -445,6 +463,7 @@ int OSIReporter::CreateOSIStaticGroundTruthFromODR()
         }
     }
 
+    opendrive->EnsureRoadMarkOSIPoints();
     UpdateOSIRoadLane();
     UpdateOSILaneBoundary();
     UpdateOSIIntersection();
@@ -1223,43 +1242,40 @@ int OSIReporter::UpdateOSIIntersection()
                     idx_t                          to_global_id   = lane_section_out->GetLaneGlobalIdById(to_lane_id);
 
                     // locate outgoing lane and register incoming lane
-                    for (unsigned int jj = 0; jj < obj_osi_internal.ln.size(); jj++)
+                    osi3::Lane *to_lane = GetOSILaneFromGlobalId(to_global_id);
+                    if (to_lane != nullptr)
                     {
-                        if (obj_osi_internal.ln[jj]->mutable_id()->value() == to_global_id)
-                        {
-                            osi_lane                                            = obj_osi_internal.ln[jj];
-                            osi3::Lane_Classification_LanePairing *lane_pairing = nullptr;
+                        osi_lane                                            = to_lane;
+                        osi3::Lane_Classification_LanePairing *lane_pairing = nullptr;
 
-                            if (osi_lane->mutable_classification()->mutable_lane_pairing()->size() == 0)
-                            {
-                                // create lane pairing element to add first connection to one of the ends
-                                lane_pairing = osi_lane->mutable_classification()->add_lane_pairing();
-                            }
-                            else
+                        if (osi_lane->mutable_classification()->mutable_lane_pairing()->size() == 0)
+                        {
+                            // create lane pairing element to add first connection to one of the ends
+                            lane_pairing = osi_lane->mutable_classification()->add_lane_pairing();
+                        }
+                        else
+                        {
+                            if (osi_lane->mutable_classification()->mutable_lane_pairing()->size() > 1)
                             {
-                                if (osi_lane->mutable_classification()->mutable_lane_pairing()->size() > 1)
-                                {
-                                    LOG_ERROR("Unexpected lane pairing size for osi lane {}", to_global_id);
-                                }
-                                // reuse existing lane pairing element to add connection for the other end
-                                lane_pairing = osi_lane->mutable_classification()->mutable_lane_pairing(0);
+                                LOG_ERROR("Unexpected lane pairing size for osi lane {}", to_global_id);
                             }
+                            // reuse existing lane pairing element to add connection for the other end
+                            lane_pairing = osi_lane->mutable_classification()->mutable_lane_pairing(0);
+                        }
 
-                            // all connections are mutual, i.e. any incoming->outgoing pair exists twice, one for each direction.
-                            // Hence, register only one way here. Register if for the to-lane, since that direction is known.
-                            if (c->GetContactPoint() == roadmanager::ContactPointType::CONTACT_POINT_END)
-                            {
-                                lane_pairing->mutable_successor_lane_id()->set_value(from_global_id);
-                            }
-                            else if (c->GetContactPoint() == roadmanager::ContactPointType::CONTACT_POINT_START)
-                            {
-                                lane_pairing->mutable_antecessor_lane_id()->set_value(from_global_id);
-                            }
-                            else
-                            {
-                                LOG_ERROR("Unexpected direct junction lane link contact point (junction {})", junction->GetId());
-                            }
-                            break;
+                        // all connections are mutual, i.e. any incoming->outgoing pair exists twice, one for each direction.
+                        // Hence, register only one way here. Register if for the to-lane, since that direction is known.
+                        if (c->GetContactPoint() == roadmanager::ContactPointType::CONTACT_POINT_END)
+                        {
+                            lane_pairing->mutable_successor_lane_id()->set_value(from_global_id);
+                        }
+                        else if (c->GetContactPoint() == roadmanager::ContactPointType::CONTACT_POINT_START)
+                        {
+                            lane_pairing->mutable_antecessor_lane_id()->set_value(from_global_id);
+                        }
+                        else
+                        {
+                            LOG_ERROR("Unexpected direct junction lane link contact point (junction {})", junction->GetId());
                         }
                     }
                 }
@@ -1637,59 +1653,46 @@ int OSIReporter::UpdateOSIIntersection()
 
     // Lets Update the antecessor and successor lanes of the lanes that are not intersections
     // Get all the intersection lanes, this lanes have the predecessor and successor lanes information
-    std::vector<osi3::Lane *> IntersectionLanes;
+    // Also index all lanes by global id, to look up the connected lanes directly instead of scanning all lanes per connection
+    std::vector<osi3::Lane *>                  IntersectionLanes;
+    std::unordered_map<uint64_t, osi3::Lane *> lane_by_id;
+    lane_by_id.reserve(static_cast<size_t>(obj_osi_internal.static_gt->lane_size()));
     for (int i = 0; i < obj_osi_internal.static_gt->lane_size(); ++i)
     {
+        lane_by_id.emplace(obj_osi_internal.static_gt->lane(i).id().value(), obj_osi_internal.static_gt->mutable_lane(i));
         if (obj_osi_internal.static_gt->lane(i).classification().type() == osi3::Lane_Classification_Type::Lane_Classification_Type_TYPE_INTERSECTION)
         {
             IntersectionLanes.push_back(obj_osi_internal.static_gt->mutable_lane(i));
         }
     }
 
-    // For each lane in OSI groundTruth
-    for (int i = 0; i < obj_osi_internal.static_gt->lane_size(); ++i)
+    // For each connection of the intersections, register the intersection as successor or predecessor of the connected lane
+    // Only the first connection found is registered, to lanes not having any connections yet
+    for (unsigned int j = 0; j < IntersectionLanes.size(); ++j)
     {
-        // Check if the lane is in the intersection
-        for (unsigned int j = 0; j < IntersectionLanes.size(); ++j)
+        for (int k = 0; k < IntersectionLanes[j]->classification().lane_pairing_size(); ++k)
         {
-            for (int k = 0; k < IntersectionLanes[j]->classification().lane_pairing_size(); ++k)
+            // Check predecessors
+            if (IntersectionLanes[j]->classification().lane_pairing()[k].has_antecessor_lane_id())
             {
-                // Check predecessors
-                if (IntersectionLanes[j]->classification().lane_pairing()[k].has_antecessor_lane_id())
+                // then we add the intersection ID to the successor of the lane
+                auto it = lane_by_id.find(IntersectionLanes[j]->classification().lane_pairing()[k].antecessor_lane_id().value());
+                if (it != lane_by_id.end() && it->second->classification().lane_pairing_size() == 0)
                 {
-                    // It lane is in predecesor of the intersection
-                    if (obj_osi_internal.static_gt->lane(i).id().value() ==
-                        IntersectionLanes[j]->classification().lane_pairing()[k].antecessor_lane_id().value())
-                    {
-                        // then we add the intersection ID to the successor of the lane
-                        if (obj_osi_internal.static_gt->mutable_lane(i)->mutable_classification()->lane_pairing_size() == 0)
-                        {
-                            obj_osi_internal.static_gt->mutable_lane(i)
-                                ->mutable_classification()
-                                ->add_lane_pairing()
-                                ->mutable_successor_lane_id()
-                                ->set_value(IntersectionLanes[j]->id().value());
-                        }
-                    }
+                    it->second->mutable_classification()->add_lane_pairing()->mutable_successor_lane_id()->set_value(
+                        IntersectionLanes[j]->id().value());
                 }
+            }
 
-                // Check successors
-                if (IntersectionLanes[j]->classification().lane_pairing()[k].has_successor_lane_id())
+            // Check successors
+            if (IntersectionLanes[j]->classification().lane_pairing()[k].has_successor_lane_id())
+            {
+                // then we add the intersection ID to the predecessor of the lane
+                auto it = lane_by_id.find(IntersectionLanes[j]->classification().lane_pairing()[k].successor_lane_id().value());
+                if (it != lane_by_id.end() && it->second->classification().lane_pairing_size() == 0)
                 {
-                    // It lane is in successor of the intersection
-                    if (obj_osi_internal.static_gt->lane(i).id().value() ==
-                        IntersectionLanes[j]->classification().lane_pairing()[k].successor_lane_id().value())
-                    {
-                        // then we add the intersection ID to the predecessor of the lane
-                        if (obj_osi_internal.static_gt->mutable_lane(i)->mutable_classification()->lane_pairing_size() == 0)
-                        {
-                            obj_osi_internal.static_gt->mutable_lane(i)
-                                ->mutable_classification()
-                                ->add_lane_pairing()
-                                ->mutable_antecessor_lane_id()
-                                ->set_value(IntersectionLanes[j]->id().value());
-                        }
-                    }
+                    it->second->mutable_classification()->add_lane_pairing()->mutable_antecessor_lane_id()->set_value(
+                        IntersectionLanes[j]->id().value());
                 }
             }
         }
@@ -2580,58 +2583,71 @@ int OSIReporter::UpdateOSIRoadLane()
                             }
                         }
 
-                        for (int l = 0; l < obj_osi_internal.static_gt->lane_size(); ++l)
+                        // look up the connected lanes directly by global id, both links might refer to the same lane
+                        osi3::Lane *osi_lane_predecessor = nullptr;
+                        osi3::Lane *osi_lane_successor   = nullptr;
+
+                        if (predecessorRoad && predecessor_lane_section && link_predecessor && driving_lane_predecessor)
                         {
-                            lane_pairing = nullptr;
+                            osi_lane_predecessor = GetOSILaneFromGlobalId(driving_lane_predecessor->GetGlobalId());
+                        }
 
-                            if (predecessorRoad && predecessor_lane_section && link_predecessor && driving_lane_predecessor &&
-                                driving_lane_predecessor->GetGlobalId() == obj_osi_internal.static_gt->lane(l).id().value())
+                        if (successorRoad && successor_lane_section && link_successor && driving_lane_successor)
+                        {
+                            osi_lane_successor = GetOSILaneFromGlobalId(driving_lane_successor->GetGlobalId());
+                        }
+
+                        if (osi_lane_predecessor != nullptr)
+                        {
+                            // find first empty pairing slot for successor lane
+                            lane_pairing = nullptr;
+                            for (int m = 0; m < osi_lane_predecessor->classification().lane_pairing_size(); ++m)
                             {
-                                // find first empty pairing slot for successor lane
-                                for (int m = 0; m < obj_osi_internal.static_gt->lane(l).classification().lane_pairing_size(); ++m)
+                                if (!osi_lane_predecessor->classification().lane_pairing(m).has_successor_lane_id())
                                 {
-                                    if (!obj_osi_internal.static_gt->lane(l).classification().lane_pairing(m).has_successor_lane_id())
-                                    {
-                                        lane_pairing = obj_osi_internal.static_gt->mutable_lane(l)->mutable_classification()->mutable_lane_pairing(m);
-                                        break;
-                                    }
+                                    lane_pairing = osi_lane_predecessor->mutable_classification()->mutable_lane_pairing(m);
+                                    break;
                                 }
+                            }
 
-                                if (lane_pairing == nullptr)
-                                {
-                                    // create a new lane pairing entry
-                                    lane_pairing = obj_osi_internal.static_gt->mutable_lane(l)->mutable_classification()->add_lane_pairing();
-                                }
+                            if (lane_pairing == nullptr)
+                            {
+                                // create a new lane pairing entry
+                                lane_pairing = osi_lane_predecessor->mutable_classification()->add_lane_pairing();
+                            }
 
-                                if ((road->GetLink(roadmanager::LinkType::PREDECESSOR) != 0))
-                                {
-                                    lane_pairing->mutable_successor_lane_id()->set_value(lane_global_id);
-                                }
+                            if ((road->GetLink(roadmanager::LinkType::PREDECESSOR) != 0))
+                            {
+                                lane_pairing->mutable_successor_lane_id()->set_value(lane_global_id);
                             }
+                        }
 
-                            if (successorRoad && successor_lane_section && link_successor && driving_lane_successor &&
-                                driving_lane_successor->GetGlobalId() == obj_osi_internal.static_gt->lane(l).id().value())
+                        if (osi_lane_successor != nullptr)
+                        {
+                            if (osi_lane_successor != osi_lane_predecessor)
                             {
-                                // find first empty pairing slot for successor lane
-                                for (int m = 0; m < obj_osi_internal.static_gt->lane(l).classification().lane_pairing_size(); ++m)
-                                {
-                                    if (!obj_osi_internal.static_gt->lane(l).classification().lane_pairing(m).has_antecessor_lane_id())
-                                    {
-                                        lane_pairing = obj_osi_internal.static_gt->mutable_lane(l)->mutable_classification()->mutable_lane_pairing(m);
-                                        break;
-                                    }
-                                }
+                                lane_pairing = nullptr;
+                            }
 
-                                if (lane_pairing == nullptr)
+                            // find first empty pairing slot for successor lane
+                            for (int m = 0; m < osi_lane_successor->classification().lane_pairing_size(); ++m)
+                            {
+                                if (!osi_lane_successor->classification().lane_pairing(m).has_antecessor_lane_id())
                                 {
-                                    // create a new lane pairing entry
-                                    lane_pairing = obj_osi_internal.static_gt->mutable_lane(l)->mutable_classification()->add_lane_pairing();
+                                    lane_pairing = osi_lane_successor->mutable_classification()->mutable_lane_pairing(m);
+                                    break;
                                 }
+                            }
 
-                                if ((road->GetLink(roadmanager::LinkType::SUCCESSOR) != 0))
-                                {
-                                    lane_pairing->mutable_antecessor_lane_id()->set_value(lane_global_id);
-                                }
+                            if (lane_pairing == nullptr)
+                            {
+                                // create a new lane pairing entry
+                                lane_pairing = osi_lane_successor->mutable_classification()->add_lane_pairing();
+                            }
+
+                            if ((road->GetLink(roadmanager::LinkType::SUCCESSOR) != 0))
+                            {
+                                lane_pairing->mutable_antecessor_lane_id()->set_value(lane_global_id);
                             }
                         }
                     }
@@ -2948,6 +2964,7 @@ const char *OSIReporter::GetOSIGroundTruth(int *size)
     if (!(GetUDPClientStatus() == 0 || IsFileOpen()))
     {
         // Data has not been serialized
+        MergeOSIGroundTruth();
         obj_osi_external.gt->SerializeToString(&osiGroundTruth.ground_truth);
         osiGroundTruth.size = static_cast<unsigned int>(obj_osi_external.gt->ByteSizeLong());
     }
@@ -2955,11 +2972,61 @@ const char *OSIReporter::GetOSIGroundTruth(int *size)
     return osiGroundTruth.ground_truth.data();
 }
 
+void OSIReporter::MergeOSIGroundTruth()
+{
+    if (!obj_osi_external.gt_merged)
+    {
+        obj_osi_external.gt->CopyFrom(*obj_osi_internal.dynamic_gt);
+        if (obj_osi_external.gt_static_part != nullptr)
+        {
+            obj_osi_external.gt->MergeFrom(*obj_osi_external.gt_static_part);
+        }
+        obj_osi_external.gt_merged = true;
+    }
+}
+
 const char *OSIReporter::GetOSIGroundTruthRaw()
 {
+    MergeOSIGroundTruth();
     return reinterpret_cast<char *>(obj_osi_external.gt);
 }
 
+void OSIReporter::SyncState(SE_StateBuffer &buf)
+{
+    buf.Sync(counter_offset_);
+    buf.Sync(osi_updated_);
+    buf.Sync(*obj_osi_internal.dynamic_gt);
+    buf.Sync(obj_osi_external.gt_static_part);
+    buf.Sync(osiGroundTruth.ground_truth);
+    buf.Sync(osiGroundTruth.size);
+
+    if (buf.IsRestoring())
+    {
+        // combined ground truth refers to the replaced dynamic part
+        obj_osi_external.gt_merged = false;
+        if (!lazy_gt_merge_)
+        {
+            MergeOSIGroundTruth();
+        }
+    }
+}
+
+const char *OSIReporter::GetOSIDynamicGroundTruthRaw()
+{
+    lazy_gt_merge_ = true;
+    return reinterpret_cast<const char *>(obj_osi_internal.dynamic_gt);
+}
+
+const char *OSIReporter::GetOSIStaticGroundTruthRaw(int *revision)
+{
+    lazy_gt_merge_ = true;
+    if (revision != nullptr)
+    {
+        *revision = static_gt_revision_;
+    }
+    return reinterpret_cast<const char *>(obj_osi_external.gt_static_part);
+}
+
 const char *OSIReporter::GetOSITrafficCommandRaw()
 {
     return reinterpret_cast<char *>(obj_osi_external.tc);
@@ -2988,17 +3055,7 @@ const char *OSIReporter::GetOSIRoadLane(const std::vector<std::unique_ptr<Object
 
     // find the lane in the sensor view and save its index in the sensor view
     id_t  lane_id_of_vehicle = pos.GetLaneGlobalId();
-    idx_t idx                = IDX_UNDEFINED;
-    for (unsigned int i = 0; i < obj_osi_internal.ln.size(); i++)
-    {
-        osi3::Identifier identifier = obj_osi_internal.ln[i]->id();
-        id_t             found_id   = static_cast<unsigned int>(identifier.value());
-        if (found_id == lane_id_of_vehicle)
-        {
-            idx = i;
-            break;
-        }
-    }
+    idx_t idx                = GetLaneIdxfromIdOSI(lane_id_of_vehicle);
     if (idx == IDX_UNDEFINED)
     {
         LOG_ERROR("Failed to locate vehicle lane id!");
@@ -3059,18 +3116,18 @@ bool OSIReporter::IsCentralOSILane(int lane_idx)
 
 idx_t OSIReporter::GetLaneIdxfromIdOSI(id_t lane_id)
 {
-    id_t idx = ID_UNDEFINED;
-    for (unsigned int i = 0; i < obj_osi_internal.ln.size(); i++)
+    // lanes are sorted by global id, see UpdateOSIRoadLane()
+    auto it = std::lower_bound(obj_osi_internal.ln.begin(),
+                               obj_osi_internal.ln.end(),
+                               lane_id,
+                               [](osi3::Lane *lane, id_t gid) { return lane->id().value() < gid; });
+
+    if (it != obj_osi_internal.ln.end() && (*it)->id().value() == lane_id)
     {
-        osi3::Identifier identifier = obj_osi_internal.ln[i]->id();
-        id_t             found_id   = static_cast<unsigned int>(identifier.value());
-        if (found_id == lane_id)
-        {
-            idx = i;
-            break;
-        }
+        return static_cast<idx_t>(it - obj_osi_internal.ln.begin());
     }
-    return idx;
+
+    return ID_UNDEFINED;
 }
 
 osi3::Lane *OSIReporter::GetOSILaneFromGlobalId(id_t g_id)
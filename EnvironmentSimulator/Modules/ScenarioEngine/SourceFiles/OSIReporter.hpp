@@ -36,6 +36,8 @@
 
 using namespace scenarioengine;
 
+class TrajectoryPredictor;
+
 class OSIReporter
 {
 public:
@@ -205,6 +207,16 @@ public:
 
     const char*       GetOSIGroundTruth(int* size);
     const char*       GetOSIGroundTruthRaw();
+
+    /**
+     Get dynamic and static ground truth separately. Once used, the combined ground truth is no longer created
+     on every update, but only when requested by GetOSIGroundTruthRaw() or GetOSIGroundTruth().
+     Merging the static part into the dynamic part, e.g. by concatenating their serialized data, equals the combined ground truth.
+     @param revision Changed whenever the static data changes, e.g. to know when a cached serialization is outdated
+     @return Pointer to osi3::GroundTruth, static part might be nullptr when no static data is to be reported
+    */
+    const char*       GetOSIDynamicGroundTruthRaw();
+    const char*       GetOSIStaticGroundTruthRaw(int* revision);
     const char*       GetOSITrafficCommandRaw();
     const char*       GetOSIRoadLane(const std::vector<std::unique_ptr<ObjectState>>& objectState, int* size, int object_id);
     const char*       GetOSIRoadLaneBoundary(int* size, int g_id);
@@ -218,6 +230,7 @@ public:
     SE_SOCKET         OpenSocket(std::string ipaddr);
     void              SerializeDynamicData();
     void              SerializeDynamicAndStaticData();
+    void              MergeOSIGroundTruth();
     void              AddTrafficLightToGt(osi3::GroundTruth* gt, roadmanager::Signal* signal);
     int               GetUDPClientStatus()
     {
@@ -254,6 +267,12 @@ public:
         counter_offset_ = GetCounter() + 1;  // Add 1, since counter is incremented before next OSI update
     }
 
+    /**
+    Store or restore runtime state of the reporter, i.e. update phase and latest dynamic ground truth
+    Part of simulation checkpoints, see ScenarioPlayer::StoreState()
+    */
+    void SyncState(SE_StateBuffer& buf);
+
     void SetOSIFrequency(int freq)
     {
         osi_freq_ = freq;
@@ -284,8 +303,14 @@ private:
     void                                CreateLaneBoundaryFromSensordata(const osi3::SensorData& sd, int lane_boundary_nr);
     bool                                osi_updated_        = false;
     bool                                osi_initialized_    = false;
+    int                                 static_gt_revision_ = 0;
+    bool                                lazy_gt_merge_      = false;
     bool                                report_ghost_       = true;
     OSIStaticReportMode                 static_update_mode_ = OSIStaticReportMode::DEFAULT;
     std::vector<std::pair<int, double>> osi_crop_           = {};       // id, radius
     std::optional<int64_t>              environment_timestamp_offset_;  // Offset to apply to environment timestamp, in seconds
+
+    // projected future trajectories, see UpdateOSIDynamicGroundTruth(). Type is private to GT_OSIReporter.cpp, hence the deleter.
+    std::unique_ptr<TrajectoryPredictor, void (*)(TrajectoryPredictor*)> trajectory_predictor_ = {nullptr, nullptr};
+    std::vector<const std::unique_ptr<ObjectState>*>                     reported_objects_;  // objects reported in current update, reused
 };
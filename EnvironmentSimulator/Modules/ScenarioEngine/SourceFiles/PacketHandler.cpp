@@ -1,18 +1,219 @@
 #include "ScenarioGateway.hpp"
 #include "PacketHandler.hpp"
 
+#define LZ_MIN_MATCH  4      // shortest match, shorter sequences are written as literals
+#define LZ_MAX_OFFSET 65535  // max distance back to a match, fits in 2 bytes
+#define LZ_HASH_BITS  14     // size of match finder hash table
+
+namespace
+{
+    uint32_t Read32(const char* ptr)
+    {
+        uint32_t value;
+        memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    uint32_t HashLZ(uint32_t value)
+    {
+        return (value * 2654435761u) >> (32 - LZ_HASH_BITS);
+    }
+
+    // Lengths of 15 or more are written as 15 in the token, followed by remaining length in bytes of max 255
+    void WriteLZLength(std::vector<char>& dst, size_t length)
+    {
+        for (; length >= 255; length -= 255)
+        {
+            dst.push_back(static_cast<char>(255));
+        }
+        dst.push_back(static_cast<char>(length));
+    }
+
+    bool ReadLZLength(const unsigned char*& read_ptr, const unsigned char* end_ptr, size_t& length)
+    {
+        unsigned char byte = 255;
+        while (byte == 255)
+        {
+            if (read_ptr >= end_ptr)
+            {
+                return false;
+            }
+            byte = *read_ptr++;
+            length += byte;
+        }
+        return true;
+    }
+
+    // Sequence: token (literal length << 4 | match length - LZ_MIN_MATCH), literals, offset (2 bytes), no match in last sequence
+    void WriteLZSequence(std::vector<char>& dst, const char* literals, size_t n_literals, size_t offset, size_t match_length)
+    {
+        size_t match_code = match_length > 0 ? match_length - LZ_MIN_MATCH : 0;
+
+        dst.push_back(static_cast<char>((MIN(n_literals, 15) << 4) | MIN(match_code, 15)));
+        if (n_literals >= 15)
+        {
+            WriteLZLength(dst, n_literals - 15);
+        }
+        dst.insert(dst.end(), literals, literals + n_literals);
+
+        if (match_length > 0)
+        {
+            dst.push_back(static_cast<char>(offset & 0xff));
+            dst.push_back(static_cast<char>(offset >> 8));
+            if (match_code >= 15)
+            {
+                WriteLZLength(dst, match_code - 15);
+            }
+        }
+    }
+}  // namespace
+
+void Dat::WriteVarint(std::string& buf, uint64_t value)
+{
+    for (; value >= 0x80; value >>= 7)
+    {
+        buf.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    }
+    buf.push_back(static_cast<char>(value));
+}
+
+int Dat::ReadVarint(const char*& read_ptr, const char* end_ptr, uint64_t& value)
+{
+    value = 0;
+    for (unsigned int shift = 0; shift < 64 && read_ptr < end_ptr; shift += 7)
+    {
+        unsigned char byte = static_cast<unsigned char>(*read_ptr++);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int Dat::CompressBlock(const char* src, size_t size, std::vector<char>& dst)
+{
+    std::vector<size_t> table(1 << LZ_HASH_BITS, SIZE_MAX);  // latest position of each hashed 4 byte sequence
+    size_t              anchor = 0;                         // start of pending literals
+    size_t              pos    = 0;
+
+    dst.clear();
+    dst.reserve(size / 2);
+
+    while (pos + LZ_MIN_MATCH <= size)
+    {
+        uint32_t sequence  = Read32(src + pos);
+        uint32_t hash      = HashLZ(sequence);
+        size_t   candidate = table[hash];
+        table[hash]        = pos;
+
+        if (candidate != SIZE_MAX && pos - candidate <= LZ_MAX_OFFSET && Read32(src + candidate) == sequence)
+        {
+            size_t length = LZ_MIN_MATCH;
+            while (pos + length < size && src[candidate + length] == src[pos + length])
+            {
+                length++;
+            }
+
+            WriteLZSequence(dst, src + anchor, pos - anchor, pos - candidate, length);
+            pos += length;
+            anchor = pos;
+        }
+        else
+        {
+            pos++;
+        }
+    }
+
+    if (anchor < size)
+    {
+        WriteLZSequence(dst, src + anchor, size - anchor, 0, 0);
+    }
+
+    return 0;
+}
+
+int Dat::DecompressBlock(const char* src, size_t size, std::vector<char>& dst, size_t uncompressed_size)
+{
+    const unsigned char* read_ptr = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* end_ptr  = read_ptr + size;
+    size_t               n        = 0;  // number of decompressed bytes
+
+    // size is read from file, check it before allocating
+    if (uncompressed_size > DAT_COMPRESSED_BLOCK_SIZE)
+    {
+        return -1;
+    }
+    dst.resize(uncompressed_size);
+
+    while (read_ptr < end_ptr)
+    {
+        unsigned char token      = *read_ptr++;
+        size_t        n_literals = token >> 4;
+
+        if ((n_literals == 15 && !ReadLZLength(read_ptr, end_ptr, n_literals)) || n_literals > static_cast<size_t>(end_ptr - read_ptr) ||
+            n_literals > uncompressed_size - n)
+        {
+            return -1;
+        }
+        memcpy(dst.data() + n, read_ptr, n_literals);
+        read_ptr += n_literals;
+        n += n_literals;
+
+        if (read_ptr == end_ptr)
+        {
+            break;  // last sequence, literals only
+        }
+
+        if (end_ptr - read_ptr < 2)
+        {
+            return -1;
+        }
+        size_t offset = static_cast<size_t>(read_ptr[0]) | (static_cast<size_t>(read_ptr[1]) << 8);
+        size_t length = token & 0x0f;
+        read_ptr += 2;
+
+        if (length == 15 && !ReadLZLength(read_ptr, end_ptr, length))
+        {
+            return -1;
+        }
+        length += LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > n || length > uncompressed_size - n)
+        {
+            return -1;
+        }
+
+        // byte by byte, since match may overlap the bytes being written
+        for (size_t i = 0; i < length; i++)
+        {
+            dst[n + i] = dst[n - offset + i];
+        }
+        n += length;
+    }
+
+    return n == uncompressed_size ? 0 : -1;
+}
+
 Dat::DatWriter::~DatWriter()
 {
     // Seems GateWay which owns DatWriter is destroyed before the scenario ends...
     if (IsWriteFileOpen())
     {
         Write(PacketId::END_OF_SCENARIO, simulation_time_);
+        FlushBlock();
         write_file_.flush();
         write_file_.close();
     }
 }
 
-int Dat::DatWriter::Init(const std::string& file_name, const std::string& odr_name, const std::string& model_name, const std::string& git_rev)
+int Dat::DatWriter::Init(const std::string& file_name,
+                         const std::string& odr_name,
+                         const std::string& model_name,
+                         const std::string& git_rev,
+                         Format             format)
 {
     write_file_.open(file_name, std::ios::binary);
     if (write_file_.fail())
@@ -21,6 +222,8 @@ int Dat::DatWriter::Init(const std::string& file_name, const std::string& odr_na
         return -1;
     }
 
+    format_ = format;
+
     // Always write versions first
     unsigned int version_major = DAT_FILE_FORMAT_VERSION_MAJOR;
     unsigned int version_minor = DAT_FILE_FORMAT_VERSION_MINOR;
@@ -114,6 +317,11 @@ int Dat::DatWriter::WriteStoryBoardStateChangesToDat(const std::vector<std::stri
 
 int Dat::DatWriter::WriteObjectStatesToDat(const std::vector<std::unique_ptr<scenarioengine::ObjectState>>& object_states)
 {
+    if (format_ != Format::PER_FIELD)
+    {
+        return WriteCompactObjectStatesToDat(object_states);
+    }
+
     // Write objects
     this->ResetCurrentIds();
     for (const auto& object_state : object_states)
@@ -311,6 +519,121 @@ int Dat::DatWriter::WriteObjectStatesToDat(const std::vector<std::unique_ptr<sce
     return 0;
 }
 
+int Dat::DatWriter::WriteCompactObjectStatesToDat(const std::vector<std::unique_ptr<scenarioengine::ObjectState>>& object_states)
+{
+    constexpr unsigned int n_scalar = static_cast<unsigned int>(CompactField::N_SCALAR);
+    static_assert(static_cast<unsigned int>(CompactField::N_FIELDS) <= 32, "CompactField mask must fit in 32 bits");
+    static_assert(sizeof(BoundingBox) == 6 * sizeof(float), "BoundingBox is written as 6 floats");
+
+    this->ResetCurrentIds();
+    for (const auto& object_state : object_states)
+    {
+        const auto state   = &object_state->state_;
+        current_object_id_ = state->info.id;
+        current_ids_.insert(current_object_id_);
+
+        auto [cache_it, new_object] = compact_state_.try_emplace(current_object_id_);
+        CompactObjState& cache      = cache_it->second;
+
+        // same order as CompactField
+        double scalar[n_scalar] = {state->info.speed,
+                                   state->pos.GetX(),
+                                   state->pos.GetY(),
+                                   state->pos.GetZ(),
+                                   state->pos.GetH(),
+                                   state->pos.GetP(),
+                                   state->pos.GetR(),
+                                   state->info.wheel_data.empty() ? 0.0 : state->info.wheel_data[0].h,
+                                   state->info.wheel_data.empty() ? 0.0 : state->info.wheel_data[0].p,
+                                   state->pos.GetS(),
+                                   state->pos.GetT(),
+                                   state->pos.GetOffset(),
+                                   state->info.refpoint_x_offset,
+                                   state->info.model_x_offset,
+                                   static_cast<double>(state->info.model_id),
+                                   static_cast<double>(state->info.obj_type),
+                                   static_cast<double>(state->info.obj_category),
+                                   static_cast<double>(state->info.ctrl_type),
+                                   static_cast<double>(state->info.scaleMode),
+                                   static_cast<double>(state->info.visibilityMask),
+                                   static_cast<double>(state->pos.GetTrackId()),
+                                   static_cast<double>(state->pos.GetLaneId())};
+
+        int64_t      values[n_scalar];
+        unsigned int mask = 0;
+        for (unsigned int i = 0; i < n_scalar; i++)
+        {
+            values[i] = static_cast<int64_t>(std::llround(scalar[i] / compact_resolution[i]));
+            if (new_object || values[i] != cache.values[i])
+            {
+                mask |= 1u << i;
+            }
+        }
+
+        if (new_object || !IsBoundingBoxEqual(cache.bounding_box, state->info.boundingbox))
+        {
+            mask |= CompactFieldBit(CompactField::BOUNDING_BOX);
+        }
+        if (new_object || cache.name != state->info.name)
+        {
+            mask |= CompactFieldBit(CompactField::NAME);
+        }
+        if (new_object || cache.model3d != state->info.model3d)
+        {
+            mask |= CompactFieldBit(CompactField::MODEL3D);
+        }
+
+        if (mask == 0)
+        {
+            continue;  // nothing changed
+        }
+
+        compact_buffer_.clear();
+        WriteVarint(compact_buffer_, ZigZagEncode(current_object_id_));
+        WriteVarint(compact_buffer_, mask);
+
+        for (unsigned int i = 0; i < n_scalar; i++)
+        {
+            if (mask & (1u << i))
+            {
+                WriteVarint(compact_buffer_, ZigZagEncode(values[i] - cache.values[i]));
+                cache.values[i] = values[i];
+            }
+        }
+
+        if (mask & CompactFieldBit(CompactField::BOUNDING_BOX))
+        {
+            cache.bounding_box = {state->info.boundingbox.center_.x_,
+                                  state->info.boundingbox.center_.y_,
+                                  state->info.boundingbox.center_.z_,
+                                  state->info.boundingbox.dimensions_.length_,
+                                  state->info.boundingbox.dimensions_.width_,
+                                  state->info.boundingbox.dimensions_.height_};
+            compact_buffer_.append(reinterpret_cast<const char*>(&cache.bounding_box), sizeof(cache.bounding_box));
+        }
+
+        if (mask & CompactFieldBit(CompactField::NAME))
+        {
+            cache.name = state->info.name;
+            WriteVarint(compact_buffer_, cache.name.size());
+            compact_buffer_.append(cache.name);
+        }
+
+        if (mask & CompactFieldBit(CompactField::MODEL3D))
+        {
+            cache.model3d = state->info.model3d;
+            WriteVarint(compact_buffer_, cache.model3d.size());
+            compact_buffer_.append(cache.model3d);
+        }
+
+        Write(PacketId::OBJ_STATE, compact_buffer_);
+    }
+
+    this->CheckDeletedObjects();
+
+    return 0;
+}
+
 void Dat::DatWriter::CheckDeletedObjects()
 {
     // Will be empty before first iteration, so we ignore that case
@@ -325,6 +648,7 @@ void Dat::DatWriter::CheckDeletedObjects()
                 current_object_id_ = previous_id;
                 Write(PacketId::OBJ_DELETED);
                 object_state_cache_.state_.erase(previous_id);
+                compact_state_.erase(previous_id);
                 this->SetObjectIdWritten(false);  // Need to reset this flag so write function will write the object ID
             }
         }
@@ -335,10 +659,46 @@ void Dat::DatWriter::CheckDeletedObjects()
 
 void Dat::DatWriter::WritePacket(PacketGeneric& packet)
 {
+    if (format_ == Format::COMPRESSED)
+    {
+        // collect packets, compress when block is full
+        if (!block_.empty() && block_.size() + sizeof(PacketHeader) + packet.data.size() > DAT_COMPRESSED_BLOCK_SIZE)
+        {
+            FlushBlock();
+        }
+
+        // blocks never exceed the max size, a packet not fitting on its own is stored as is
+        if (sizeof(PacketHeader) + packet.data.size() <= DAT_COMPRESSED_BLOCK_SIZE)
+        {
+            block_.insert(block_.end(), reinterpret_cast<char*>(&packet.header), reinterpret_cast<char*>(&packet.header) + sizeof(PacketHeader));
+            block_.insert(block_.end(), packet.data.begin(), packet.data.end());
+            return;
+        }
+    }
+
     write_file_.write(reinterpret_cast<char*>(&packet.header), sizeof(PacketHeader));
     write_file_.write(packet.data.data(), static_cast<std::streamsize>(packet.data.size()));
 }
 
+void Dat::DatWriter::FlushBlock()
+{
+    if (block_.empty())
+    {
+        return;
+    }
+
+    CompressBlock(block_.data(), block_.size(), compressed_);
+
+    unsigned int uncompressed_size = static_cast<unsigned int>(block_.size());
+    PacketHeader header            = {static_cast<id_t>(PacketId::COMPRESSED_BLOCK), static_cast<unsigned int>(sizeof(uncompressed_size) + compressed_.size())};
+
+    write_file_.write(reinterpret_cast<char*>(&header), sizeof(header));
+    write_file_.write(reinterpret_cast<char*>(&uncompressed_size), sizeof(uncompressed_size));
+    write_file_.write(compressed_.data(), static_cast<std::streamsize>(compressed_.size()));
+
+    block_.clear();
+}
+
 bool Dat::DatWriter::IsWriteFileOpen() const
 {
     return write_file_.is_open();
@@ -390,12 +750,13 @@ void Dat::DatWriter::WriteToBuffer(char*& write_ptr, const std::string& str)
 
 constexpr bool Dat::DatWriter::ShouldWriteObjId(PacketId p_id) const noexcept
 {
-    static_assert(static_cast<int>(PacketId::END_OF_SCENARIO) < 64, "PacketId values must be < 64");
+    static_assert(static_cast<int>(PacketId::PACKET_ID_SIZE) <= 64, "PacketId values must be < 64");
 
+    // OBJ_STATE contains the object id
     constexpr uint64_t skip_mask =
         (uint64_t{1} << static_cast<unsigned int>(PacketId::END_OF_SCENARIO)) | (uint64_t{1} << static_cast<unsigned int>(PacketId::DT)) |
         (uint64_t{1} << static_cast<unsigned int>(PacketId::TIMESTAMP)) | (uint64_t{1} << static_cast<unsigned int>(PacketId::TRAFFIC_LIGHT)) |
-        uint64_t{1} << static_cast<unsigned int>(PacketId::ELEM_STATE_CHANGE);
+        (uint64_t{1} << static_cast<unsigned int>(PacketId::ELEM_STATE_CHANGE)) | (uint64_t{1} << static_cast<unsigned int>(PacketId::OBJ_STATE));
 
     // If the bit for p_id is set, we skip writing
     return ((skip_mask >> static_cast<unsigned int>(p_id)) & uint64_t{1}) == 0;
@@ -426,14 +787,63 @@ void Dat::DatReader::SetFileSize()
     file_.seekg(0, std::ios::beg);  // jump back to start
 }
 
+bool Dat::DatReader::Read(char* data, size_t size)
+{
+    if (block_pos_ < block_.size())
+    {
+        if (size > block_.size() - block_pos_)
+        {
+            return false;  // packets never span blocks
+        }
+        memcpy(data, block_.data() + block_pos_, size);
+        block_pos_ += size;
+        return true;
+    }
+
+    return static_cast<bool>(file_.read(data, static_cast<std::streamsize>(size)));
+}
+
 bool Dat::DatReader::ReadFile(Dat::PacketHeader& header)
 {
-    if (file_.tellg() >= file_size_)
+    while (block_pos_ >= block_.size())
     {
-        return false;
+        if (file_.tellg() >= file_size_)
+        {
+            return false;
+        }
+
+        if (!file_.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        {
+            LOG_ERROR("Failed to read packet header.");
+            return false;
+        }
+
+        if (header.id != static_cast<id_t>(PacketId::COMPRESSED_BLOCK))
+        {
+            return true;
+        }
+
+        // Decompress the block, then serve packets from it
+        unsigned int uncompressed_size = 0;
+        if (header.data_size < sizeof(uncompressed_size) || header.data_size > 2 * DAT_COMPRESSED_BLOCK_SIZE ||
+            !file_.read(reinterpret_cast<char*>(&uncompressed_size), sizeof(uncompressed_size)))
+        {
+            LOG_ERROR("Failed to read compressed block.");
+            return false;
+        }
+
+        compressed_.resize(header.data_size - sizeof(uncompressed_size));
+        if (!file_.read(compressed_.data(), static_cast<std::streamsize>(compressed_.size())) ||
+            DecompressBlock(compressed_.data(), compressed_.size(), block_, uncompressed_size) != 0)
+        {
+            LOG_ERROR("Failed to decompress block of packets.");
+            block_.clear();
+            return false;
+        }
+        block_pos_ = 0;
     }
 
-    if (!file_.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    if (!Read(reinterpret_cast<char*>(&header), sizeof(header)))
     {
         LOG_ERROR("Failed to read packet header.");
         return false;
@@ -444,9 +854,125 @@ bool Dat::DatReader::ReadFile(Dat::PacketHeader& header)
 
 void Dat::DatReader::UnknownPacket(const Dat::PacketHeader& header)
 {
+    if (block_pos_ < block_.size())
+    {
+        block_pos_ = MIN(block_.size(), block_pos_ + header.data_size);
+        return;
+    }
+
     file_.seekg(header.data_size, std::ios::cur);  // Skips the packet by moving cursor ahead
 }
 
+int Dat::DatReader::ReadObjectState(const Dat::PacketHeader& header, Dat::ObjState& state, unsigned int& mask)
+{
+    constexpr unsigned int n_scalar = static_cast<unsigned int>(CompactField::N_SCALAR);
+
+    packet_buffer_.resize(header.data_size);
+    if (!Read(packet_buffer_.data(), header.data_size))
+    {
+        return -1;
+    }
+
+    const char* read_ptr = packet_buffer_.data();
+    const char* end_ptr  = read_ptr + packet_buffer_.size();
+    uint64_t    value    = 0;
+
+    if (ReadVarint(read_ptr, end_ptr, value) != 0)
+    {
+        return -1;
+    }
+    int obj_id = static_cast<int>(ZigZagDecode(value));
+
+    if (ReadVarint(read_ptr, end_ptr, value) != 0)
+    {
+        return -1;
+    }
+    mask = static_cast<unsigned int>(value);
+
+    CompactObjState& cache = compact_state_[obj_id];
+
+    for (unsigned int i = 0; i < n_scalar; i++)
+    {
+        if (mask & (1u << i))
+        {
+            if (ReadVarint(read_ptr, end_ptr, value) != 0)
+            {
+                return -1;
+            }
+            cache.values[i] += ZigZagDecode(value);
+        }
+    }
+
+    if (mask & CompactFieldBit(CompactField::BOUNDING_BOX))
+    {
+        if (static_cast<size_t>(end_ptr - read_ptr) < sizeof(cache.bounding_box))
+        {
+            return -1;
+        }
+        memcpy(&cache.bounding_box, read_ptr, sizeof(cache.bounding_box));
+        read_ptr += sizeof(cache.bounding_box);
+    }
+
+    auto read_string = [&](std::string& str)
+    {
+        if (ReadVarint(read_ptr, end_ptr, value) != 0 || value > static_cast<uint64_t>(end_ptr - read_ptr))
+        {
+            return -1;
+        }
+        str.assign(read_ptr, read_ptr + value);
+        read_ptr += value;
+        return 0;
+    };
+
+    if ((mask & CompactFieldBit(CompactField::NAME) && read_string(cache.name) != 0) ||
+        (mask & CompactFieldBit(CompactField::MODEL3D) && read_string(cache.model3d) != 0))
+    {
+        return -1;
+    }
+
+    auto scalar = [&cache](CompactField field)
+    {
+        unsigned int i = static_cast<unsigned int>(field);
+        return static_cast<float>(static_cast<double>(cache.values[i]) * compact_resolution[i]);
+    };
+    auto integer = [&cache](CompactField field) { return static_cast<int>(cache.values[static_cast<unsigned int>(field)]); };
+
+    state.obj_id_            = obj_id;
+    state.active_            = true;
+    state.speed_             = scalar(CompactField::SPEED);
+    state.pose_              = {scalar(CompactField::POSE_X),
+                                scalar(CompactField::POSE_Y),
+                                scalar(CompactField::POSE_Z),
+                                scalar(CompactField::POSE_H),
+                                scalar(CompactField::POSE_P),
+                                scalar(CompactField::POSE_R)};
+    state.wheel_angle_       = scalar(CompactField::WHEEL_ANGLE);
+    state.wheel_rot_         = scalar(CompactField::WHEEL_ROT);
+    state.pos_s_             = scalar(CompactField::POS_S);
+    state.pos_t_             = scalar(CompactField::POS_T);
+    state.pos_offset_        = scalar(CompactField::POS_OFFSET);
+    state.refpoint_x_offset_ = scalar(CompactField::REFPOINT_X_OFFSET);
+    state.model_x_offset_    = scalar(CompactField::MODEL_X_OFFSET);
+    state.model_id_          = integer(CompactField::MODEL_ID);
+    state.obj_type_          = integer(CompactField::OBJ_TYPE);
+    state.obj_category_      = integer(CompactField::OBJ_CATEGORY);
+    state.ctrl_type_         = integer(CompactField::CTRL_TYPE);
+    state.scale_mode_        = integer(CompactField::SCALE_MODE);
+    state.visibility_mask_   = integer(CompactField::VISIBILITY_MASK);
+    state.road_id_           = static_cast<id_t>(cache.values[static_cast<unsigned int>(CompactField::ROAD_ID)]);
+    state.lane_id_           = integer(CompactField::LANE_ID);
+    state.bounding_box_      = cache.bounding_box;
+    state.name_              = cache.name;
+    state.model3d_           = cache.model3d;
+
+    return 0;
+}
+
+void Dat::DatReader::DeleteObjectState(int obj_id)
+{
+    compact_state_.erase(obj_id);
+}
+
 void Dat::DatReader::CloseFile()
 {
     if (file_.is_open())
@@ -458,12 +984,12 @@ void Dat::DatReader::CloseFile()
 int Dat::DatReader::ReadStringPacket(std::string& str)
 {
     unsigned int size;
-    if (!file_.read(reinterpret_cast<char*>(&size), sizeof(size)))
+    if (!Read(reinterpret_cast<char*>(&size), sizeof(size)))
     {
         return -1;
     }
     str.resize(size);
-    if (!file_.read(str.data(), size))
+    if (!Read(str.data(), size))
     {
         return -1;
     }
@@ -516,7 +1042,7 @@ int Dat::DatReader::FillDatHeader()
              header_.model_filename.string,
              header_.git_rev.string);
 
-    if (header_.version_minor != DAT_FILE_FORMAT_VERSION_MINOR)
+    if (header_.version_minor > DAT_FILE_FORMAT_VERSION_MINOR)
     {
         LOG_WARN("replayer compiled for version {}.{}. Some inconsistencies are expected.",
                  DAT_FILE_FORMAT_VERSION_MAJOR,
@@ -5,7 +5,8 @@
 #include "RoadManager.hpp"
 
 #define DAT_FILE_FORMAT_VERSION_MAJOR 4
-#define DAT_FILE_FORMAT_VERSION_MINOR 3
+#define DAT_FILE_FORMAT_VERSION_MINOR 4
+#define DAT_COMPRESSED_BLOCK_SIZE     65536  // max uncompressed size of a compressed block of packets (bytes)
 
 namespace scenarioengine
 {
@@ -44,9 +45,86 @@ namespace Dat
         MODEL_X_OFFSET    = 25,
         OBJ_MODEL3D       = 26,
         ELEM_STATE_CHANGE = 27,
-        PACKET_ID_SIZE    = 28  // Keep this last
+        OBJ_STATE         = 28,  // All changed fields of one object, see CompactField
+        COMPRESSED_BLOCK  = 29,  // Sequence of packets, compressed. Data: uncompressed size (unsigned int) + compressed data
+        PACKET_ID_SIZE    = 30   // Keep this last
     };
 
+    // How object states are written to the dat file
+    enum class Format
+    {
+        PER_FIELD  = 0,  // one packet per changed field, readable by all 4.x tools
+        COMPACT    = 1,  // one OBJ_STATE packet per changed object
+        COMPRESSED = 2   // compact, packets grouped in compressed blocks
+    };
+
+    /*
+        Fields of the OBJ_STATE packet. Data: object id, field mask (bit per field) and the changed fields in order.
+        Scalar fields are integers or fixed point (see compact_resolution), written as the difference to the previous
+        value of the object, which is 0 for a new object. Integers are zigzag varint encoded.
+    */
+    enum class CompactField : unsigned int
+    {
+        SPEED = 0,
+        POSE_X,
+        POSE_Y,
+        POSE_Z,
+        POSE_H,
+        POSE_P,
+        POSE_R,
+        WHEEL_ANGLE,
+        WHEEL_ROT,
+        POS_S,
+        POS_T,
+        POS_OFFSET,
+        REFPOINT_X_OFFSET,
+        MODEL_X_OFFSET,
+        MODEL_ID,
+        OBJ_TYPE,
+        OBJ_CATEGORY,
+        CTRL_TYPE,
+        SCALE_MODE,
+        VISIBILITY_MASK,
+        ROAD_ID,
+        LANE_ID,
+        N_SCALAR,                // number of scalar fields, keep after the last one
+        BOUNDING_BOX = N_SCALAR,  // 6 floats
+        NAME,                    // varint size + characters
+        MODEL3D,                 // varint size + characters
+        N_FIELDS                 // Keep this last
+    };
+
+    // Resolution of scalar fields in the OBJ_STATE packet, 1 for integer fields
+    inline constexpr double compact_resolution[static_cast<unsigned int>(CompactField::N_SCALAR)] = {
+        1e-4,  // speed (m/s)
+        1e-4,  // x (m)
+        1e-4,  // y (m)
+        1e-4,  // z (m)
+        1e-5,  // h (rad)
+        1e-5,  // p (rad)
+        1e-5,  // r (rad)
+        1e-5,  // wheel angle (rad)
+        1e-4,  // wheel rotation (rad)
+        1e-4,  // s (m)
+        1e-4,  // t (m)
+        1e-4,  // lane offset (m)
+        1e-4,  // refpoint x offset (m)
+        1e-4,  // model x offset (m)
+        1.0,   // model id
+        1.0,   // object type
+        1.0,   // object category
+        1.0,   // controller type
+        1.0,   // scale mode
+        1.0,   // visibility mask
+        1.0,   // road id
+        1.0    // lane id
+    };
+
+    inline unsigned int CompactFieldBit(CompactField field)
+    {
+        return 1u << static_cast<unsigned int>(field);
+    }
+
     struct PacketString
     {
         unsigned int size;
@@ -128,6 +206,37 @@ namespace Dat
         std::string model3d_           = {};
     };
 
+    // Latest values of an object in OBJ_STATE packets, on both writer and reader side
+    struct CompactObjState
+    {
+        int64_t     values[static_cast<unsigned int>(CompactField::N_SCALAR)] = {};  // in units of compact_resolution
+        BoundingBox bounding_box                                               = {};
+        std::string name                                                       = {};
+        std::string model3d                                                    = {};
+    };
+
+    // Varint and zigzag encoding of integers, as used in OBJ_STATE packets
+    void WriteVarint(std::string& buf, uint64_t value);
+    int  ReadVarint(const char*& read_ptr, const char* end_ptr, uint64_t& value);
+
+    inline uint64_t ZigZagEncode(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    inline int64_t ZigZagDecode(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    /*
+        LZ77 style block compression of packets, format similar to LZ4 block format
+        Blocks are at most DAT_COMPRESSED_BLOCK_SIZE bytes uncompressed, larger sizes are rejected on decompression
+        @return 0 on success, -1 on failure (e.g. corrupt data)
+    */
+    int CompressBlock(const char* src, size_t size, std::vector<char>& dst);
+    int DecompressBlock(const char* src, size_t size, std::vector<char>& dst, size_t uncompressed_size);
+
     struct ObjectStateCache  // Maybe rename to e.g. SimulationStateCache?
     {
         double                                     dt_ = LARGE_NUMBER;
@@ -144,6 +253,8 @@ namespace Dat
         int            WriteTrafficLightsToDat(const std::vector<roadmanager::Signal*>& dynamic_signals);
         int            WriteStoryBoardStateChangesToDat(const std::vector<std::string>& state_changes);
         int            WriteObjectStatesToDat(const std::vector<std::unique_ptr<scenarioengine::ObjectState>>& object_states);
+        int            WriteCompactObjectStatesToDat(const std::vector<std::unique_ptr<scenarioengine::ObjectState>>& object_states);
+        void           FlushBlock();
         constexpr bool ShouldWriteObjId(PacketId p_id) const noexcept;
 
         size_t SerializedSize(const std::string& str);
@@ -153,7 +264,11 @@ namespace Dat
         DatWriter() = default;
         ~DatWriter();
 
-        int Init(const std::string& file_name, const std::string& odr_name, const std::string& model_name, const std::string& git_rev);
+        int Init(const std::string& file_name,
+                 const std::string& odr_name,
+                 const std::string& model_name,
+                 const std::string& git_rev,
+                 Format             format = Format::PER_FIELD);
 
         bool IsWriteFileOpen() const;
         void SetTimestampWritten(bool state);
@@ -237,15 +352,20 @@ namespace Dat
         }
 
     private:
-        std::ofstream           write_file_;
-        ObjectStateCache        object_state_cache_;
-        int                     current_object_id_ = -1;  // Current object ID being processed
-        bool                    timestamp_written_ = false;
-        bool                    object_id_written_ = false;
-        double                  simulation_time_   = 0.0;
-        std::unordered_set<int> previous_ids_;  // Keep track of object IDs
-        std::unordered_set<int> current_ids_;   // Keep track of object IDs for the current state
-        double                  dt_ = -1.0;
+        std::ofstream                            write_file_;
+        ObjectStateCache                         object_state_cache_;
+        int                                      current_object_id_ = -1;  // Current object ID being processed
+        bool                                     timestamp_written_ = false;
+        bool                                     object_id_written_ = false;
+        double                                   simulation_time_   = 0.0;
+        std::unordered_set<int>                  previous_ids_;  // Keep track of object IDs
+        std::unordered_set<int>                  current_ids_;   // Keep track of object IDs for the current state
+        double                                   dt_     = -1.0;
+        Format                                   format_ = Format::PER_FIELD;
+        std::unordered_map<int, CompactObjState> compact_state_;   // latest written values per object, for delta encoding
+        std::string                              compact_buffer_;  // reused OBJ_STATE packet data
+        std::vector<char>                        block_;           // packets waiting for compression
+        std::vector<char>                        compressed_;      // reused compression output
     };
 
     class DatReader
@@ -267,6 +387,19 @@ namespace Dat
         void UnknownPacket(const Dat::PacketHeader& header);
         void CloseFile();
 
+        /**
+            Read an OBJ_STATE packet and update the object values
+            @param state All current values of the object
+            @param mask Bits of changed fields, see CompactField
+            @return 0 on success, -1 on failure
+        */
+        int ReadObjectState(const Dat::PacketHeader& header, Dat::ObjState& state, unsigned int& mask);
+
+        /**
+            Forget latest values of a deleted object, a new object with same id starts from scratch
+        */
+        void DeleteObjectState(int obj_id);
+
         /* Template definition kept in the header, otherwise symbols might not be resolved properly.
         Maybe it can be resolved during the build process somehow, but for now they are here. */
         template <typename... Data>
@@ -276,7 +409,7 @@ namespace Dat
             packet.header = header;
             packet.data.resize(packet.header.data_size);
 
-            if (!file_.read(packet.data.data(), packet.header.data_size))
+            if (!Read(packet.data.data(), packet.header.data_size))
             {
                 return -1;
             }
@@ -321,10 +454,18 @@ namespace Dat
         }
 
     private:
-        std::string    file_name_;
-        std::ifstream  file_;
-        std::streampos file_size_;
-        Dat::DatHeader header_;
+        // Read from current decompressed block, if any, else from file
+        bool Read(char* data, size_t size);
+
+        std::string                              file_name_;
+        std::ifstream                            file_;
+        std::streampos                           file_size_;
+        Dat::DatHeader                           header_;
+        std::vector<char>                        block_;           // decompressed packets of current compressed block
+        size_t                                   block_pos_ = 0;   // read position in block_
+        std::vector<char>                        compressed_;      // reused compressed block data
+        std::string                              packet_buffer_;   // reused OBJ_STATE packet data
+        std::unordered_map<int, CompactObjState> compact_state_;   // latest read values per object
     };
 
 }  // namespace Dat
@@ -0,0 +1,250 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <atomic>
+#include "ScenarioBatch.hpp"
+#include "logger.hpp"
+
+using namespace scenarioengine;
+
+namespace
+{
+    // Select the state of an instance for the calling thread, for the lifetime of the guard
+    class InstanceStateGuard
+    {
+    public:
+        explicit InstanceStateGuard(SE_InstanceState *state)
+        {
+            SE_Env::Inst().SetInstanceState(state);
+        }
+        ~InstanceStateGuard()
+        {
+            SE_Env::Inst().SetInstanceState(nullptr);
+        }
+    };
+
+    // Return true if element, or any child of it, modifies state shared by all instances
+    bool ModifiesGlobalState(StoryBoardElement *element)
+    {
+        if (element->element_type_ == StoryBoardElement::ElementType::ACTION)
+        {
+            switch (static_cast<OSCAction *>(element)->action_type_)
+            {
+                case OSCAction::ActionType::PARAMETER_SET:
+                case OSCAction::ActionType::VARIABLE_SET:
+                case OSCAction::ActionType::VARIABLE_ADD:
+                case OSCAction::ActionType::VARIABLE_MULTIPLY_BY:
+                case OSCAction::ActionType::INFRASTRUCTURE:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        for (auto child : *element->GetChildren())
+        {
+            if (ModifiesGlobalState(child))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool ModifiesGlobalState(StoryBoard &story_board)
+    {
+        for (auto action : story_board.init_.global_action_)
+        {
+            if (ModifiesGlobalState(action))
+            {
+                return true;
+            }
+        }
+
+        return ModifiesGlobalState(static_cast<StoryBoardElement *>(&story_board));
+    }
+}  // namespace
+
+ScenarioBatch::~ScenarioBatch()
+{
+    Close();
+}
+
+int ScenarioBatch::Init(const std::string &osc_filename, unsigned int n_instances, unsigned int n_threads, bool disable_controllers)
+{
+    Close();
+
+    if (n_instances == 0)
+    {
+        LOG_ERROR("ScenarioBatch: No instances requested");
+        return -1;
+    }
+
+    osc_filename_        = osc_filename;
+    disable_controllers_ = disable_controllers;
+
+    unsigned int seed = SE_Env::Inst().GetRand().GetSeed();
+    for (unsigned int i = 0; i < n_instances; i++)
+    {
+        instances_.push_back(std::make_unique<Instance>());
+        instances_.back()->env.rand.SetSeed(seed + i);
+        if (CreateEngine(*instances_.back()) != 0)
+        {
+            LOG_ERROR("ScenarioBatch: Failed to create instance {}", i);
+            Close();
+            return -1;
+        }
+    }
+
+    pool_ = std::make_unique<SE_ThreadPool>(n_threads);
+    LOG_INFO("ScenarioBatch: {} instances of {} using {} threads", n_instances, osc_filename_, pool_->GetNumberOfThreads());
+
+    return 0;
+}
+
+int ScenarioBatch::CreateEngine(Instance &instance)
+{
+    InstanceStateGuard guard(&instance.env);
+
+    instance.engine.reset();
+    instance.initial_state_valid = false;
+
+    // the first instance loads the road network, if not already loaded, the others refer to it
+    ScenarioEngine::SetShareRoadNetwork(true);
+    try
+    {
+        instance.engine = std::make_unique<ScenarioEngine>(osc_filename_, disable_controllers_);
+    }
+    catch (const std::exception &e)
+    {
+        LOG_ERROR("ScenarioBatch: {}", e.what());
+    }
+    ScenarioEngine::SetShareRoadNetwork(false);
+
+    if (instance.engine == nullptr || instance.engine->GetInitStatus() != 0)
+    {
+        instance.engine.reset();
+        return -1;
+    }
+
+    // parameters, variables and dynamic traffic signals are global, changing them in one instance would affect all
+    if (ModifiesGlobalState(instance.engine->storyBoard))
+    {
+        LOG_ERROR("ScenarioBatch: Scenario modifies parameters, variables or traffic signals, not supported in batch mode");
+        instance.engine.reset();
+        return -1;
+    }
+
+    // initial frame, corresponding to the one of ScenarioPlayer::Init()
+    instance.engine->step(0.0);
+    instance.engine->prepareGroundTruth(0.0);
+    instance.engine->getScenarioGateway()->clearDirtyBits();
+
+    // keep initial state for quick reset, if the scenario supports it. Global state is left out, it's constant anyway.
+    instance.initial_state_valid = instance.engine->StoreState(instance.initial_state, false) == 0;
+
+    return 0;
+}
+
+int ScenarioBatch::Step(double dt)
+{
+    if (instances_.empty())
+    {
+        return -1;
+    }
+
+    std::atomic<int> n_failed{0};
+
+    pool_->ParallelFor(instances_.size(),
+                       [this, dt, &n_failed](size_t i)
+                       {
+                           Instance          &instance = *instances_[i];
+                           InstanceStateGuard guard(&instance.env);
+
+                           if (instance.engine == nullptr)
+                           {
+                               n_failed++;  // failed reset
+                               return;
+                           }
+
+                           try
+                           {
+                               if (instance.engine->step(dt) == 0)
+                               {
+                                   instance.engine->prepareGroundTruth(dt);
+                               }
+                               instance.engine->UpdateGhostMode();
+                               instance.engine->getScenarioGateway()->clearDirtyBits();
+                           }
+                           catch (const std::exception &e)
+                           {
+                               LOG_ERROR("ScenarioBatch: Instance {} failed: {}", i, e.what());
+                               n_failed++;
+                           }
+                       });
+
+    return n_failed > 0 ? -1 : 0;
+}
+
+int ScenarioBatch::Reset(unsigned int index)
+{
+    if (index >= instances_.size())
+    {
+        return -1;
+    }
+
+    Instance &instance = *instances_[index];
+
+    if (instance.engine != nullptr && instance.initial_state_valid)
+    {
+        // random generator is part of the stored state
+        InstanceStateGuard guard(&instance.env);
+        return instance.engine->RestoreState(instance.initial_state);
+    }
+
+    instance.env.rand.SetSeed(instance.env.rand.GetSeed());
+    instance.env.ghost_mode      = GhostMode::NORMAL;
+    instance.env.ghost_headstart = 0.0;
+
+    // parsing the scenario again rebuilds the global parameter and variable tables, keep them as seen by the other instances
+    std::vector<OSCParameterDeclarations::ParameterStruct> parameters = ScenarioReader::parameters.parameterDeclarations_.Parameter;
+    std::vector<OSCParameterDeclarations::ParameterStruct> variables  = ScenarioReader::variables.parameterDeclarations_.Parameter;
+
+    int retval = CreateEngine(instance);
+
+    ScenarioReader::parameters.parameterDeclarations_.Parameter = parameters;
+    ScenarioReader::variables.parameterDeclarations_.Parameter  = variables;
+
+    return retval;
+}
+
+void ScenarioBatch::Close()
+{
+    for (auto &instance : instances_)
+    {
+        InstanceStateGuard guard(&instance->env);
+        instance->engine.reset();
+    }
+    instances_.clear();
+    pool_.reset();
+}
+
+ScenarioEngine *ScenarioBatch::GetEngine(unsigned int index)
+{
+    return index < instances_.size() ? instances_[index]->engine.get() : nullptr;
+}
+
+bool ScenarioBatch::GetQuitFlag(unsigned int index) const
+{
+    return index < instances_.size() && instances_[index]->engine != nullptr && instances_[index]->engine->GetQuitFlag();
+}
@@ -0,0 +1,100 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "CommonMini.hpp"
+#include "ScenarioEngine.hpp"
+
+namespace scenarioengine
+{
+    /**
+    A set of independent instances of the same scenario, stepped in lockstep by a pool of threads. Typical use is
+    many short episodes, e.g. reinforcement learning, where each instance is reset individually when done.
+
+    The road network is loaded once and shared by all instances. Each instance has its own entities, storyboard,
+    gateway and random generator, seeded by the global seed plus instance index.
+
+    Limitations: Scenario parameters and variables, as well as dynamic traffic signals, are global and hence shared.
+    Scenarios modifying them, by ParameterAction, VariableAction or TrafficSignalAction, are rejected. Recording and OSI
+    are not supported. Calls must not overlap, i.e. the batch is to be used by one application thread at a time.
+    */
+    class ScenarioBatch
+    {
+    public:
+        ScenarioBatch() = default;
+        ~ScenarioBatch();
+
+        /**
+        Create and initialize the instances, replacing any previous ones
+        @param osc_filename OpenSCENARIO file
+        @param n_instances Number of instances
+        @param n_threads Number of threads stepping the instances, 0 = number of hardware threads
+        @param disable_controllers Ignore controllers assigned in the scenario, i.e. use default controller
+        @return 0 on success, -1 on failure, e.g. scenario modifying global state (see limitations above)
+        */
+        int Init(const std::string &osc_filename, unsigned int n_instances, unsigned int n_threads = 0, bool disable_controllers = false);
+
+        /**
+        Step all instances one timestep, in parallel
+        @param dt Timestep in seconds
+        @return 0 on success, -1 if stepping any instance failed
+        */
+        int Step(double dt);
+
+        /**
+        Bring an instance back to its initial state. Restores the state captured after init if supported by the scenario,
+        else the scenario is parsed again. The road network is not reloaded in either case.
+        @param index Index of the instance
+        @return 0 on success, -1 on failure
+        */
+        int Reset(unsigned int index);
+
+        void Close();
+
+        unsigned int GetNumberOfInstances() const
+        {
+            return static_cast<unsigned int>(instances_.size());
+        }
+
+        unsigned int GetNumberOfThreads() const
+        {
+            return pool_ != nullptr ? pool_->GetNumberOfThreads() : 0;
+        }
+
+        // Return engine of given instance, nullptr if index is out of range
+        ScenarioEngine *GetEngine(unsigned int index);
+
+        // Return true if storyboard of given instance is complete
+        bool GetQuitFlag(unsigned int index) const;
+
+    private:
+        struct Instance
+        {
+            std::unique_ptr<ScenarioEngine> engine;
+            SE_InstanceState                env;
+            SE_StateBuffer                  initial_state;
+            bool                            initial_state_valid = false;
+        };
+
+        int CreateEngine(Instance &instance);
+
+        std::vector<std::unique_ptr<Instance>> instances_;
+        std::unique_ptr<SE_ThreadPool>         pool_;
+        std::string                            osc_filename_;
+        bool                                   disable_controllers_ = false;
+    };
+
+}  // namespace scenarioengine
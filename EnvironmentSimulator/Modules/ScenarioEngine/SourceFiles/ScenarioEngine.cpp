@@ -19,6 +19,7 @@
 #include "ControllerFollowReference.hpp"
 #include "Entities.hpp"
 #include "OSCParameterDistribution.hpp"
+#include "Profiler.hpp"
 
 #define WHEEL_RADIUS          0.35
 #define STAND_STILL_THRESHOLD 1e-3  // meter per second
@@ -27,6 +28,22 @@ using namespace scenarioengine;
 
 static CallBack paramDeclCallback = {0, 0};
 
+// Scenario time of log messages. An engine of a set running side by side, e.g. ScenarioBatch, registers it for its own
+// instance only, leaving the time of the logger to the application.
+static void SetLogTime(double* time)
+{
+    if (SE_Env::Inst().HasInstanceState())
+    {
+        SE_Env::Inst().GetInstanceState().sim_time = time;
+    }
+    else
+    {
+        txtLogger.SetLoggerTime(time);
+    }
+}
+
+bool ScenarioEngine::share_road_network_ = false;
+
 namespace scenarioengine
 {
     void RegisterParameterDeclarationCallback(ParamDeclCallbackFunc func, void* data)
@@ -39,28 +56,31 @@ namespace scenarioengine
 ScenarioEngine::ScenarioEngine(std::string oscFilename, bool disable_controllers)
 {
     init_status_ = InitScenario(oscFilename, disable_controllers);
-    txtLogger.SetLoggerTime(GetSimulationTimePtr());
+    SetLogTime(GetSimulationTimePtr());
 }
 
 ScenarioEngine::ScenarioEngine(const pugi::xml_document& xml_doc, bool disable_controllers)
 {
     init_status_ = InitScenario(xml_doc, disable_controllers);
-    txtLogger.SetLoggerTime(GetSimulationTimePtr());
+    SetLogTime(GetSimulationTimePtr());
 }
 
 void ScenarioEngine::InitScenarioCommon(bool disable_controllers)
 {
-    init_status_         = 0;
-    disable_controllers_ = disable_controllers;
-    simulationTime_      = 0;
-    trueTime_            = 0;
-    frame_nr_            = 0;
-    scenarioReader       = new ScenarioReader(&entities_, &catalogs, &environment, disable_controllers);
-    injected_actions_    = nullptr;
-    ghost_               = nullptr;
-    ghost_trail_dt_      = SE_Env::Inst().GetOptions().GetOptionSet("ghost_trail_dt")
-                               ? strtod(SE_Env::Inst().GetOptions().GetOptionValue("ghost_trail_dt"))
-                               : GHOST_TRAIL_SAMPLE_TIME;
+    init_status_           = 0;
+    disable_controllers_   = disable_controllers;
+    simulationTime_        = 0;
+    trueTime_              = 0;
+    frame_nr_              = 0;
+    scenarioReader         = new ScenarioReader(&entities_, &catalogs, &environment, disable_controllers);
+    injected_actions_      = nullptr;
+    ghost_                 = nullptr;
+    ghost_trail_dt_        = SE_Env::Inst().GetOptions().GetOptionSet("ghost_trail_dt")
+                                 ? strtod(SE_Env::Inst().GetOptions().GetOptionValue("ghost_trail_dt"))
+                                 : GHOST_TRAIL_SAMPLE_TIME;
+    ghost_trail_retention_ = SE_Env::Inst().GetOptions().GetOptionSet("ghost_trail_retention")
+                                 ? strtod(SE_Env::Inst().GetOptions().GetOptionValue("ghost_trail_retention"))
+                                 : 0.0;
     SE_Env::Inst().SetGhostMode(GhostMode::NORMAL);
     SE_Env::Inst().SetGhostHeadstart(0.0);
 }
@@ -114,7 +134,7 @@ ScenarioEngine::~ScenarioEngine()
     scenarioReader = 0;
     SE_Env::Inst().SetOSCFilePath("");
     LOG_INFO("Closing");
-    txtLogger.SetLoggerTime(nullptr);
+    SetLogTime(nullptr);
 }
 
 void ScenarioEngine::UpdateGhostMode()
@@ -133,8 +153,135 @@ void ScenarioEngine::UpdateGhostMode()
     }
 }
 
+int ScenarioEngine::StoreState(SE_StateBuffer& buf, bool include_global)
+{
+    buf.BeginStore();
+    SyncState(buf, include_global);
+
+    for (const auto& element : buf.GetUnsupported())
+    {
+        LOG_ERROR("StoreState: State of {} can't be captured", element);
+    }
+
+    return buf.GetUnsupported().empty() ? 0 : -1;
+}
+
+int ScenarioEngine::RestoreState(SE_StateBuffer& buf)
+{
+    if (buf.GetNumberOfEntries() == 0 || !buf.GetUnsupported().empty())
+    {
+        LOG_ERROR("RestoreState: No valid state to restore");
+        return -1;
+    }
+
+    buf.BeginRestore();
+
+    try
+    {
+        SyncState(buf, true);  // actual scope is read from the buffer
+    }
+    catch (const std::runtime_error& e)
+    {
+        LOG_ERROR("RestoreState: {}", e.what());
+        return -1;
+    }
+
+    return 0;
+}
+
+void ScenarioEngine::SyncState(SE_StateBuffer& buf, bool include_global)
+{
+    // Objects and controllers are referred by pointers all over the place. Hence they can't be re-created,
+    // make sure the same set exists before touching any state.
+    std::vector<Object*> objects = entities_.object_;
+    objects.insert(objects.end(), entities_.object_pool_.begin(), entities_.object_pool_.end());
+    std::vector<id_t> g_ids;
+    for (auto obj : objects)
+    {
+        g_ids.push_back(obj->g_id_);
+    }
+    std::vector<Object*>     stored_objects     = objects;
+    std::vector<id_t>        stored_g_ids       = g_ids;
+    std::vector<Controller*> stored_controllers = scenarioReader->controller_;
+    buf.Sync(stored_objects);
+    buf.Sync(stored_g_ids);
+    buf.Sync(stored_controllers);
+
+    if (buf.IsRestoring())
+    {
+        bool match = stored_objects.size() == objects.size() && stored_controllers == scenarioReader->controller_;
+        for (size_t i = 0; match && i < stored_objects.size(); i++)
+        {
+            auto it = std::find(objects.begin(), objects.end(), stored_objects[i]);
+            match   = it != objects.end() && g_ids[static_cast<size_t>(it - objects.begin())] == stored_g_ids[i];
+        }
+
+        if (!match)
+        {
+            throw std::runtime_error("Entities or controllers have been added or deleted since state was stored");
+        }
+    }
+
+    buf.Sync(entities_.object_);
+    buf.Sync(entities_.object_pool_);
+
+    for (auto obj : entities_.object_)
+    {
+        obj->SyncState(buf);
+    }
+
+    for (auto obj : entities_.object_pool_)
+    {
+        obj->SyncState(buf);
+    }
+
+    for (auto ctrl : scenarioReader->controller_)
+    {
+        ctrl->SyncState(buf);
+    }
+
+    storyBoard.SyncState(buf);
+    scenarioGateway.SyncState(buf);
+
+    // State shared by all engines of the process, included or not as decided when storing
+    buf.Sync(include_global);
+    if (include_global)
+    {
+        for (auto signal : odrManager->GetDynamicSignals())
+        {
+            roadmanager::TrafficLight* tl = dynamic_cast<roadmanager::TrafficLight*>(signal);
+            if (tl != nullptr)
+            {
+                tl->SyncState(buf);
+            }
+        }
+
+        buf.Sync(ScenarioReader::parameters.parameterDeclarations_.Parameter);
+        buf.Sync(ScenarioReader::variables.parameterDeclarations_.Parameter);
+    }
+
+    buf.Sync(environment);
+    buf.Sync(collision_pair_);
+    buf.Sync(object_distance_map_);
+    buf.Sync(simulationTime_);
+    buf.Sync(trueTime_);
+    buf.Sync(frame_nr_);
+    buf.Sync(doOnce);
+
+    GhostMode ghost_mode = SE_Env::Inst().GetGhostMode();
+    buf.Sync(ghost_mode);
+    SE_Env::Inst().SetGhostMode(ghost_mode);
+    buf.Sync(SE_Env::Inst().GetRand());
+}
+
 int ScenarioEngine::step(double deltaSimTime)
 {
+    SE_PROFILE_SCOPE("Step");
+
+    // Apply states reported by other threads, e.g. UDP servers, before the reported states are fetched from the gateway below
+    scenarioGateway.SetSimulationThread();
+    scenarioGateway.ApplyQueuedUpdates();
+
     UpdateGhostMode();
 
     if (frame_nr_ == 0)
@@ -249,7 +396,10 @@ int ScenarioEngine::step(double deltaSimTime)
         }
     }
 
-    storyBoard.Step(simulationTime_, deltaSimTime);
+    {
+        SE_PROFILE_SCOPE("Storyboard");
+        storyBoard.Step(simulationTime_, deltaSimTime);
+    }
 
     if (storyBoard.GetCurrentState() == StoryBoardElement::State::RUNNING)
     {
@@ -268,6 +418,7 @@ int ScenarioEngine::step(double deltaSimTime)
     // Step any externally injected actions
     if (injected_actions_ && injected_actions_->size() > 0)
     {
+        SE_PROFILE_SCOPE("InjectedActions");
         for (OSCAction* action : *injected_actions_)
         {
             if (action->GetCurrentState() == StoryBoardElement::State::INIT || action->GetCurrentState() == StoryBoardElement::State::STANDBY)
@@ -299,6 +450,9 @@ int ScenarioEngine::step(double deltaSimTime)
         trueTime_ = simulationTime_;
     }
 
+    static const int profile_id_default_controller = SE_Profiler::Inst().RegisterScope("DefaultController");
+    SE_ProfileScope  profile_default_controller(profile_id_default_controller);
+
     for (size_t i = 0; i < entities_.object_.size(); i++)
     {
         Object* obj = entities_.object_[i];
@@ -309,7 +463,11 @@ int ScenarioEngine::step(double deltaSimTime)
         {
             if (o->ReadDirtyBits() & (Object::DirtyBit::LATERAL | Object::DirtyBit::LONGITUDINAL))
             {
-                obj->pos_.Duplicate(o->state_.pos);
+                // Skip position copy if state originates from the object itself, e.g. reported by its controller
+                if (!o->IsPosSourcedFrom(&obj->pos_))
+                {
+                    obj->pos_.Duplicate(o->state_.pos);
+                }
                 if (obj->pos_.route_ != nullptr)
                 {
                     // update assigned route info
@@ -457,17 +615,26 @@ int ScenarioEngine::step(double deltaSimTime)
         }
     }
 
-    for (size_t i = 0; i < scenarioReader->controller_.size(); i++)
+    profile_default_controller.Stop();
+
     {
-        if (scenarioReader->controller_[i]->Active())
+        SE_PROFILE_SCOPE("Controllers");
+        for (size_t i = 0; i < scenarioReader->controller_.size(); i++)
         {
-            if (SE_Env::Inst().GetGhostMode() != GhostMode::RESTARTING)
+            if (scenarioReader->controller_[i]->Active())
             {
-                scenarioReader->controller_[i]->Step(deltaSimTime);
+                if (SE_Env::Inst().GetGhostMode() != GhostMode::RESTARTING)
+                {
+                    SE_ProfileScope profile_scope(SE_Profiler::Level::ALL, scenarioReader->controller_[i]->GetTypeName());
+                    scenarioReader->controller_[i]->Step(deltaSimTime);
+                }
             }
         }
     }
 
+    static const int profile_id_trailers = SE_Profiler::Inst().RegisterScope("TrailersAndAxles");
+    SE_ProfileScope  profile_trailers(profile_id_trailers);
+
     // Update any trailers now that tow vehicles have been updated by Default or custom controllers
     for (size_t i = 0; i < entities_.object_.size(); i++)
     {
@@ -551,6 +718,8 @@ int ScenarioEngine::step(double deltaSimTime)
         }
     }
 
+    profile_trailers.Stop();
+
     // Check some states
     for (size_t i = 0; i < entities_.object_.size(); i++)
     {
@@ -690,8 +859,15 @@ int ScenarioEngine::parseScenario()
 
         if (found)
         {
+            if (share_road_network_ && roadmanager::Position::GetOpenDrive()->GetOpenDriveFilename() == file_path &&
+                roadmanager::Position::GetOpenDrive()->GetNumOfRoads() > 0)
+            {
+                // keep the road network already loaded by another engine instance
+                roadNetwork.logicFile.filepath = file_path;
+                LOG_INFO("Reusing loaded OpenDRIVE: {}", getOdrFilename());
+            }
             // Load OpenDRIVE file, add scenario file directory as additional search path
-            if (roadmanager::Position::LoadOpenDrive(file_path.c_str()) == true)
+            else if (roadmanager::Position::LoadOpenDrive(file_path.c_str()) == true)
             {
                 // update file reference to actual resolved path
                 roadNetwork.logicFile.filepath = file_path;
@@ -823,6 +999,8 @@ int ScenarioEngine::defaultController(Object* obj, double dt)
 
 void ScenarioEngine::prepareGroundTruth(double dt)
 {
+    SE_PROFILE_SCOPE("PrepareGroundTruth");
+
     for (size_t i = 0; i < entities_.object_.size(); i++)
     {
         // Fetch external states from gateway
@@ -837,7 +1015,11 @@ void ScenarioEngine::prepareGroundTruth(double dt)
         {
             if (o->ReadDirtyBits() & (Object::DirtyBit::LATERAL | Object::DirtyBit::LONGITUDINAL))
             {
-                obj->pos_.Duplicate(o->state_.pos);
+                // The object already holds the state if it was the source of the update, then skip the copy
+                if (!o->IsPosSourcedFrom(&obj->pos_))
+                {
+                    obj->pos_.Duplicate(o->state_.pos);
+                }
                 if (obj->pos_.route_ != nullptr)
                 {
                     // update assigned route info
@@ -1004,6 +1186,23 @@ void ScenarioEngine::prepareGroundTruth(double dt)
                                                roadmanager::Position::PosMode::H_REL,
                                                0.0,
                                                obj->GetWheelAngle()});
+
+                        if (ghost_trail_retention_ > SMALL_NUMBER)
+                        {
+                            // Discard outdated part of trail, but keep any part still in use by objects following the ghost
+                            idx_t keep_index = IDX_UNDEFINED;
+                            if (obj->IsGhost())
+                            {
+                                for (auto* follower : entities_.object_)
+                                {
+                                    if (follower->GetGhost() == obj)
+                                    {
+                                        keep_index = MIN(keep_index, follower->trail_follow_index_);
+                                    }
+                                }
+                            }
+                            obj->trail_.DiscardVertices(simulationTime_ - ghost_trail_retention_, keep_index);
+                        }
                     }
                 }
             }
@@ -1018,9 +1217,13 @@ void ScenarioEngine::prepareGroundTruth(double dt)
             auto*                   vehicle    = dynamic_cast<Vehicle*>(obj);
             std::vector<WheelData>& wheel_data = vehicle->GetWheelData();
 
+            double                friction_global = roadmanager::Position::GetOpenDrive()->GetFriction();
             roadmanager::Position wp;
-            wp.Duplicate(obj->pos_);
-            double friction_global = roadmanager::Position::GetOpenDrive()->GetFriction();
+            if (std::isnan(friction_global))
+            {
+                // helper position for wheel friction lookup, only needed when friction varies over the road network
+                wp.Duplicate(obj->pos_);
+            }
 
             // Update wheel positions
             for (auto& wheel : wheel_data)
@@ -1084,6 +1287,9 @@ void ScenarioEngine::prepareGroundTruth(double dt)
         obj->ClearDirtyBits(Object::DirtyBit::VELOCITY | Object::DirtyBit::ANGULAR_RATE | Object::DirtyBit::ACCELERATION |
                             Object::DirtyBit::ANGULAR_ACC | Object::DirtyBit::TELEPORT);
     }
+
+    // Make resulting states available to consumers, e.g. plot window
+    scenarioGateway.PublishSnapshot(simulationTime_);
 }
 
 void ScenarioEngine::ReplaceObjectInTrigger(Trigger* trigger, Object* obj1, Object* obj2, double timeOffset, Event* event)
@@ -1382,6 +1588,8 @@ void ScenarioEngine::ResetEvents() const
 
 int ScenarioEngine::DetectCollisions()
 {
+    SE_PROFILE_SCOPE("Collisions");
+
     collision_pair_.clear();
     for (size_t i = 0; i < entities_.object_.size(); i++)
     {
@@ -159,6 +159,34 @@ namespace scenarioengine
             return init_status_;
         }
 
+        /**
+        Store complete runtime state of the scenario, e.g. entities, storyboard, controllers and random generator, for later restore
+        @param buf Buffer to store the state into, any previous content is discarded
+        @param include_global Also store state shared by all engines of the process: scenario parameters, variables and
+        dynamic traffic signals. Leave out when several engines run side by side, see ScenarioBatch.
+        @return 0 on success, -1 if the scenario contains elements which state can't be captured (see log)
+        */
+        int StoreState(SE_StateBuffer &buf, bool include_global = true);
+
+        /**
+        Restore runtime state previously stored by StoreState. The set of entities must be the same as when stored.
+        @param buf Buffer containing the stored state
+        @return 0 on success, -1 on failure. Current state is kept if the buffer is empty, holds unsupported elements or the set
+        of entities and controllers differs. Any other failure, e.g. a buffer stored by another scenario, is detected only
+        part-way through, leaving the state undefined. The scenario then needs to be reloaded.
+        */
+        int RestoreState(SE_StateBuffer &buf);
+
+        /**
+        Keep an already loaded road network if the scenario refers to the same OpenDRIVE file, instead of parsing it again.
+        Affects engines created while set. Since the road network is global, they will all share it, see ScenarioBatch.
+        @param share true to reuse the loaded road network, false (default) to always load it
+        */
+        static void SetShareRoadNetwork(bool share)
+        {
+            share_road_network_ = share;
+        }
+
 #ifdef _USE_OSI
         void SetOSIReporter(OSIReporter *osi_reporter)
         {
@@ -185,6 +213,7 @@ namespace scenarioengine
         ScenarioGateway scenarioGateway;
         Object         *ghost_;
         double          ghost_trail_dt_;
+        double          ghost_trail_retention_;  // max age of trail samples [s], 0 means keep all
 
         // Distance map
         struct DistanceMeasurement
@@ -210,7 +239,10 @@ namespace scenarioengine
         unsigned int frame_nr_;
         int          init_status_;
 
-        int parseScenario();
+        int  parseScenario();
+        void SyncState(SE_StateBuffer &buf, bool include_global);
+
+        static bool share_road_network_;
     };
 
 }  // namespace scenarioengine
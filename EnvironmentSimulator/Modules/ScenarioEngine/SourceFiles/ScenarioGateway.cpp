@@ -274,10 +274,59 @@ void ObjectState::Print()
         static_cast<double>(state_.info.visibilityMask));
 }
 
+// WorldSnapshot
+
+int WorldSnapshot::GetIndexById(int obj_id) const
+{
+    for (size_t i = 0; i < id.size(); i++)
+    {
+        if (id[i] == obj_id)
+        {
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+void WorldSnapshot::Resize(size_t size)
+{
+    id.resize(size);
+    name.resize(size);
+    obj_type.resize(size);
+    obj_category.resize(size);
+    ctrl_type.resize(size);
+    visibility_mask.resize(size);
+    x.resize(size);
+    y.resize(size);
+    z.resize(size);
+    h.resize(size);
+    p.resize(size);
+    r.resize(size);
+    vel_x.resize(size);
+    vel_y.resize(size);
+    vel_z.resize(size);
+    acc_x.resize(size);
+    acc_y.resize(size);
+    acc_z.resize(size);
+    h_rate.resize(size);
+    speed.resize(size);
+    road_id.resize(size);
+    junction_id.resize(size);
+    lane_id.resize(size);
+    s.resize(size);
+    t.resize(size);
+    lane_offset.resize(size);
+    wheel_angle.resize(size);
+    wheel_rot.resize(size);
+    boundingbox.resize(size);
+}
+
 // ScenarioGateway
 
 ScenarioGateway::ScenarioGateway()
 {
+    SetSimulationThread();
 }
 
 ScenarioGateway::~ScenarioGateway()
@@ -290,26 +339,238 @@ ScenarioGateway::~ScenarioGateway()
 
 ObjectState* ScenarioGateway::getObjectStatePtrById(int id)
 {
-    for (size_t i = 0; i < objectState_.size(); i++)
+    auto it = id_index_.find(id);
+
+    return it != id_index_.end() ? it->second : nullptr;
+}
+
+void ScenarioGateway::AddObjectState(ObjectState* obj_state)
+{
+    objectState_.push_back(std::unique_ptr<ObjectState>{obj_state});
+    id_index_[obj_state->state_.info.id] = obj_state;
+}
+
+void ScenarioGateway::UpdateIdIndex()
+{
+    id_index_.clear();
+    for (auto& state : objectState_)
+    {
+        id_index_[state->state_.info.id] = state.get();
+    }
+}
+
+void ScenarioGateway::SyncState(SE_StateBuffer& buf)
+{
+    std::vector<ObjectState> states;
+    if (!buf.IsRestoring())
     {
-        if (objectState_[i]->state_.info.id == id)
+        states.reserve(objectState_.size());
+        for (auto& state : objectState_)
         {
-            return objectState_[i].get();
+            states.push_back(*state);
         }
     }
 
+    buf.Sync(states);
+
+    if (buf.IsRestoring())
+    {
+        if (states.size() == objectState_.size())
+        {
+            // update in place, avoiding re-allocation
+            for (size_t i = 0; i < states.size(); i++)
+            {
+                *objectState_[i] = states[i];
+            }
+        }
+        else
+        {
+            objectState_.clear();
+            for (auto& state : states)
+            {
+                objectState_.push_back(std::make_unique<ObjectState>(state));
+            }
+        }
+        UpdateIdIndex();
+    }
+
+    buf.Sync(storyboard_state_changes_);
+}
+
+int ScenarioGateway::ReportUpdate(const ObjectStateUpdate& update)
+{
+    if (IsSimulationThread())
+    {
+        return ApplyUpdate(update);
+    }
+
+    update_queue_.Push(update);
+
     return 0;
 }
 
-int ScenarioGateway::getObjectStateById(int id, ObjectState& objectState) const
+int ScenarioGateway::ApplyUpdate(const ObjectStateUpdate& update)
 {
+    const double* v = update.value;
+
+    switch (update.type)
+    {
+        case ObjectStateUpdate::Type::WORLD_POS:
+            return updateObjectWorldPos(update.id, update.timestamp, v[0], v[1], v[2], v[3], v[4], v[5]);
+        case ObjectStateUpdate::Type::WORLD_POS_MODE:
+            return updateObjectWorldPosMode(update.id, update.timestamp, v[0], v[1], v[2], v[3], v[4], v[5], update.mode);
+        case ObjectStateUpdate::Type::WORLD_POS_XYH:
+            return updateObjectWorldPosXYH(update.id, update.timestamp, v[0], v[1], v[2]);
+        case ObjectStateUpdate::Type::LANE_POS:
+            return updateObjectLanePos(update.id, update.timestamp, update.road_id, update.lane_id, v[0], v[1]);
+        case ObjectStateUpdate::Type::LATERAL_ROAD_POS:
+            return updateObjectLateralRoadPos(update.id, update.timestamp, v[0]);
+        case ObjectStateUpdate::Type::LATERAL_LANE_POS:
+            return updateObjectLateralLanePos(update.id, update.timestamp, v[0]);
+        case ObjectStateUpdate::Type::SPEED:
+            return updateObjectSpeed(update.id, update.timestamp, v[0]);
+        case ObjectStateUpdate::Type::VEL:
+            return updateObjectVel(update.id, update.timestamp, v[0], v[1], v[2]);
+        case ObjectStateUpdate::Type::ANGULAR_VEL:
+            return updateObjectAngularVel(update.id, update.timestamp, v[0], v[1], v[2]);
+        case ObjectStateUpdate::Type::ACC:
+            return updateObjectAcc(update.id, update.timestamp, v[0], v[1], v[2]);
+        case ObjectStateUpdate::Type::ANGULAR_ACC:
+            return updateObjectAngularAcc(update.id, update.timestamp, v[0], v[1], v[2]);
+        case ObjectStateUpdate::Type::WHEEL_ANGLE:
+            return updateObjectWheelAngle(update.id, update.timestamp, v[0]);
+        case ObjectStateUpdate::Type::WHEEL_ROTATION:
+            return updateObjectWheelRotation(update.id, update.timestamp, v[0]);
+        case ObjectStateUpdate::Type::LANE_TYPE_SNAP_MASK:
+            return updateObjectLaneTypeSnapMask(update.id, update.timestamp, update.mode);
+    }
+
+    return -1;
+}
+
+int ScenarioGateway::ApplyQueuedUpdates()
+{
+    int               n_updates = 0;
+    ObjectStateUpdate update;
+
+    while (update_queue_.Pop(update))
+    {
+        ApplyUpdate(update);  // any failure, e.g. object removed meanwhile, is logged by the update function
+        n_updates++;
+    }
+
+    return n_updates;
+}
+
+int ScenarioGateway::InternName(const std::string& name)
+{
+    auto it = snapshot_name_index_.find(name);
+    if (it != snapshot_name_index_.end())
+    {
+        return it->second;
+    }
+
+    // Copy on write, already published snapshots keep referring to the previous table
+    auto names = snapshot_names_ != nullptr ? std::make_shared<std::vector<std::string>>(*snapshot_names_)
+                                            : std::make_shared<std::vector<std::string>>();
+    names->push_back(name);
+    snapshot_names_ = names;
+
+    int index                  = static_cast<int>(names->size()) - 1;
+    snapshot_name_index_[name] = index;
+
+    return index;
+}
+
+void ScenarioGateway::PublishSnapshot(double time)
+{
+    if (!snapshot_requested_)
+    {
+        return;  // no consumer, skip the work
+    }
+
+    std::shared_ptr<WorldSnapshot> snapshot;
+
+    // Recycle the buffer of the snapshot before last, unless some reader still refers to it
+    if (snapshot_spare_ != nullptr && snapshot_spare_.use_count() == 1)
+    {
+        snapshot = std::move(snapshot_spare_);
+    }
+    else
+    {
+        snapshot = std::make_shared<WorldSnapshot>();
+    }
+
+    snapshot->Resize(objectState_.size());
     for (size_t i = 0; i < objectState_.size(); i++)
     {
-        if (objectState_[i]->state_.info.id == id)
+        ObjectState*                 obj_state = objectState_[i].get();
+        const ObjectInfoStruct&      info      = obj_state->state_.info;
+        const roadmanager::Position& pos       = obj_state->state_.pos;
+
+        if (obj_state->name_index_ < 0)
         {
-            objectState = *objectState_[i];
-            return 0;
+            obj_state->name_index_ = InternName(info.name);
         }
+
+        snapshot->id[i]              = info.id;
+        snapshot->name[i]            = obj_state->name_index_;
+        snapshot->obj_type[i]        = info.obj_type;
+        snapshot->obj_category[i]    = info.obj_category;
+        snapshot->ctrl_type[i]       = info.ctrl_type;
+        snapshot->visibility_mask[i] = info.visibilityMask;
+        snapshot->x[i]               = pos.GetX();
+        snapshot->y[i]               = pos.GetY();
+        snapshot->z[i]               = pos.GetZ();
+        snapshot->h[i]               = pos.GetH();
+        snapshot->p[i]               = pos.GetP();
+        snapshot->r[i]               = pos.GetR();
+        snapshot->vel_x[i]           = pos.GetVelX();
+        snapshot->vel_y[i]           = pos.GetVelY();
+        snapshot->vel_z[i]           = pos.GetVelZ();
+        snapshot->acc_x[i]           = pos.GetAccX();
+        snapshot->acc_y[i]           = pos.GetAccY();
+        snapshot->acc_z[i]           = pos.GetAccZ();
+        snapshot->h_rate[i]          = pos.GetHRate();
+        snapshot->speed[i]           = info.speed;
+        snapshot->road_id[i]         = pos.GetTrackId();
+        snapshot->junction_id[i]     = pos.GetJunctionId();
+        snapshot->lane_id[i]         = pos.GetLaneId();
+        snapshot->s[i]               = pos.GetS();
+        snapshot->t[i]               = pos.GetT();
+        snapshot->lane_offset[i]     = pos.GetOffset();
+        snapshot->wheel_angle[i]     = info.wheel_data.empty() ? 0.0 : info.wheel_data[0].h;
+        snapshot->wheel_rot[i]       = info.wheel_data.empty() ? 0.0 : info.wheel_data[0].p;
+        snapshot->boundingbox[i]     = info.boundingbox;
+    }
+    snapshot->time     = time;
+    snapshot->sequence = snapshot_ != nullptr ? snapshot_->sequence + 1 : 0;
+    snapshot->names    = snapshot_names_;
+
+    snapshot_mutex_.Lock();
+    snapshot_spare_ = std::move(snapshot_);
+    snapshot_       = std::move(snapshot);
+    snapshot_mutex_.Unlock();
+}
+
+std::shared_ptr<const WorldSnapshot> ScenarioGateway::GetSnapshot() const
+{
+    snapshot_requested_ = true;
+
+    snapshot_mutex_.Lock();
+    std::shared_ptr<const WorldSnapshot> snapshot = snapshot_;
+    snapshot_mutex_.Unlock();
+
+    return snapshot;
+}
+
+int ScenarioGateway::getObjectStateById(int id, ObjectState& objectState) const
+{
+    auto it = id_index_.find(id);
+    if (it != id_index_.end())
+    {
+        objectState = *it->second;
+        return 0;
     }
 
     // Indicate not found by returning non zero
@@ -401,12 +662,14 @@ int ScenarioGateway::reportObjectPos(int                      id,
 
         // Add object to collection
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
-        objectState_.push_back(std::unique_ptr<ObjectState>{obj_state});
+        obj_state->pos_source_ = pos;
+        AddObjectState(obj_state);
     }
     else
     {
         // Update status
-        obj_state->state_.pos = *pos;
+        obj_state->state_.pos  = *pos;
+        obj_state->pos_source_ = pos;
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
         updateObjectInfo(obj_state, timestamp, visibilityMask, speed, wheel_angle, wheel_rot);
     }
@@ -470,12 +733,13 @@ int ScenarioGateway::reportObjectXYZHPR(int            id,
 
         // Add object to collection
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
-        objectState_.push_back(std::unique_ptr<ObjectState>{obj_state});
+        AddObjectState(obj_state);
     }
     else
     {
         // Update status
         obj_state->state_.pos.SetInertiaPos(x, y, z, h, p, r);
+        obj_state->pos_source_ = nullptr;
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
 
         updateObjectInfo(obj_state, timestamp, visibilityMask, speed, wheel_angle, wheel_rot);
@@ -537,12 +801,13 @@ int ScenarioGateway::reportObjectXYH(int            id,
 
         // Add object to collection
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
-        objectState_.push_back(std::unique_ptr<ObjectState>{obj_state});
+        AddObjectState(obj_state);
     }
     else
     {
         // Update status
         obj_state->state_.pos.SetInertiaPos(x, y, h);
+        obj_state->pos_source_ = nullptr;
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
 
         updateObjectInfo(obj_state, timestamp, visibilityMask, speed, wheel_angle, wheel_rot);
@@ -603,12 +868,13 @@ int ScenarioGateway::reportObjectLanePos(int            id,
 
         // Add object to collection
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
-        objectState_.push_back(std::unique_ptr<ObjectState>{obj_state});
+        AddObjectState(obj_state);
     }
     else
     {
         // Update status
         obj_state->state_.pos.SetLanePos(roadId, laneId, s, laneOffset);
+        obj_state->pos_source_ = nullptr;
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
 
         updateObjectInfo(obj_state, timestamp, visibilityMask, speed, wheel_angle, wheel_rot);
@@ -667,12 +933,13 @@ int ScenarioGateway::reportObjectRoadPos(int            id,
 
         // Add object to collection
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
-        objectState_.push_back(std::unique_ptr<ObjectState>{obj_state});
+        AddObjectState(obj_state);
     }
     else
     {
         // Update status
         obj_state->state_.pos.SetTrackPos(roadId, s, lateralOffset);
+        obj_state->pos_source_ = nullptr;
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
 
         updateObjectInfo(obj_state, timestamp, visibilityMask, speed, wheel_angle, wheel_rot);
@@ -696,6 +963,7 @@ int ScenarioGateway::updateObjectPos(int id, double timestamp, const roadmanager
         // Update status
         obj_state->state_.pos            = *pos;
         obj_state->state_.info.timeStamp = timestamp;
+        obj_state->pos_source_           = pos;
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
     }
 
@@ -717,6 +985,7 @@ int ScenarioGateway::updateObjectRoadPos(int id, double timestamp, id_t roadId,
         // Update status
         obj_state->state_.pos.SetTrackPos(roadId, s, lateralOffset);
         obj_state->state_.info.timeStamp = timestamp;
+        obj_state->pos_source_           = nullptr;
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
     }
 
@@ -737,12 +1006,43 @@ int ScenarioGateway::updateObjectLanePos(int id, double timestamp, id_t roadId,
         // Update status
         obj_state->state_.pos.SetLanePos(roadId, laneId, s, offset);
         obj_state->state_.info.timeStamp = timestamp;
+        obj_state->pos_source_           = nullptr;
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
     }
 
     return 0;
 }
 
+int ScenarioGateway::updateObjectLateralRoadPos(int id, double timestamp, double lateralOffset)
+{
+    ObjectState* obj_state = getObjectStatePtrById(id);
+
+    if (obj_state == 0)
+    {
+        LOG_ERROR("Object id: {} must be reported before updated", id);
+        return -1;
+    }
+
+    const roadmanager::Position& pos = obj_state->state_.pos;
+
+    return updateObjectRoadPos(id, timestamp, pos.GetTrackId(), lateralOffset, pos.GetS());
+}
+
+int ScenarioGateway::updateObjectLateralLanePos(int id, double timestamp, double offset)
+{
+    ObjectState* obj_state = getObjectStatePtrById(id);
+
+    if (obj_state == 0)
+    {
+        LOG_ERROR("Object id: {} must be reported before updated", id);
+        return -1;
+    }
+
+    const roadmanager::Position& pos = obj_state->state_.pos;
+
+    return updateObjectLanePos(id, timestamp, pos.GetTrackId(), pos.GetLaneId(), offset, pos.GetS());
+}
+
 int ScenarioGateway::updateObjectWorldPosXYH(int id, double timestamp, double x, double y, double h)
 {
     ObjectState* obj_state = getObjectStatePtrById(id);
@@ -757,6 +1057,7 @@ int ScenarioGateway::updateObjectWorldPosXYH(int id, double timestamp, double x,
         // Update status
         obj_state->state_.pos.SetInertiaPos(x, y, h);
         obj_state->state_.info.timeStamp = timestamp;
+        obj_state->pos_source_           = nullptr;
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
     }
 
@@ -777,6 +1078,7 @@ int ScenarioGateway::updateObjectWorldPosXYHMode(int id, double timestamp, doubl
         // Update status
         obj_state->state_.pos.SetInertiaPosMode(x, y, h, mode);
         obj_state->state_.info.timeStamp = timestamp;
+        obj_state->pos_source_           = nullptr;
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
     }
 
@@ -797,6 +1099,7 @@ int ScenarioGateway::updateObjectWorldPos(int id, double timestamp, double x, do
         // Update status
         obj_state->state_.pos.SetInertiaPos(x, y, z, h, p, r);
         obj_state->state_.info.timeStamp = timestamp;
+        obj_state->pos_source_           = nullptr;
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
     }
 
@@ -817,6 +1120,7 @@ int ScenarioGateway::updateObjectWorldPosMode(int id, double timestamp, double x
         // Update status
         obj_state->state_.pos.SetInertiaPosMode(x, y, z, h, p, r, mode);
         obj_state->state_.info.timeStamp = timestamp;
+        obj_state->pos_source_           = nullptr;
         obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
     }
 
@@ -852,6 +1156,7 @@ int ScenarioGateway::updateObjectVel(int id, double timestamp, double x_vel, dou
     }
 
     obj_state->state_.pos.SetVel(x_vel, y_vel, z_vel);
+    obj_state->pos_source_ = nullptr;
     obj_state->dirty_ |= Object::DirtyBit::VELOCITY;
 
     return 0;
@@ -869,6 +1174,7 @@ int ScenarioGateway::updateObjectAcc(int id, double timestamp, double x_acc, dou
     }
 
     obj_state->state_.pos.SetAcc(x_acc, y_acc, z_acc);
+    obj_state->pos_source_ = nullptr;
     obj_state->dirty_ |= Object::DirtyBit::ACCELERATION;
 
     return 0;
@@ -886,6 +1192,7 @@ int ScenarioGateway::updateObjectAngularVel(int id, double timestamp, double h_r
     }
 
     obj_state->state_.pos.SetAngularVel(h_rate, p_rate, r_rate);
+    obj_state->pos_source_ = nullptr;
     obj_state->dirty_ |= Object::DirtyBit::ANGULAR_RATE;
 
     return 0;
@@ -903,6 +1210,7 @@ int ScenarioGateway::updateObjectAngularAcc(int id, double timestamp, double h_a
     }
 
     obj_state->state_.pos.SetAngularAcc(h_acc, p_acc, r_acc);
+    obj_state->pos_source_ = nullptr;
     obj_state->dirty_ |= Object::DirtyBit::ANGULAR_ACC;
 
     return 0;
@@ -944,6 +1252,7 @@ int ScenarioGateway::updateObjectLaneTypeSnapMask(int id, double timestamp, int
     }
 
     obj_state->state_.pos.SetSnapLaneTypes(laneTypeMask);
+    obj_state->pos_source_ = nullptr;
     obj_state->dirty_ |= Object::DirtyBit::LANE_TYPE_SNAP_MASK;
 
     return 0;
@@ -1018,7 +1327,7 @@ int ScenarioGateway::updateObjectBoundingBox(int id, OSCBoundingBox bb)
     return 0;
 }
 
-int ScenarioGateway::updateObjectWheelData(int id, std::vector<WheelData> wheel_data)
+int ScenarioGateway::updateObjectWheelData(int id, const std::vector<WheelData>& wheel_data)
 {
     ObjectState* obj_state = getObjectStatePtrById(id);
 
@@ -1033,12 +1342,12 @@ int ScenarioGateway::updateObjectWheelData(int id, std::vector<WheelData> wheel_
         if (obj_state->state_.info.wheel_data.size() <= i)
         {
             // push first time
-            obj_state->state_.info.wheel_data.push_back(std::move(wheel_data[i]));
+            obj_state->state_.info.wheel_data.push_back(wheel_data[i]);
         }
         else
         {
             // update existing
-            obj_state->state_.info.wheel_data[i] = std::move(wheel_data[i]);
+            obj_state->state_.info.wheel_data[i] = wheel_data[i];
         }
     }
 
@@ -1064,6 +1373,7 @@ int ScenarioGateway::setObjectPositionMode(int id, int type, int mode)
     }
 
     obj_state->state_.pos.SetModes(type, mode);
+    obj_state->pos_source_ = nullptr;
 
     if ((mode & roadmanager::Position::PosMode::Z_SET) != 0)
     {
@@ -1104,6 +1414,7 @@ int ScenarioGateway::setObjectPositionModeDefault(int id, int type)
     }
 
     obj_state->state_.pos.SetModeDefault(static_cast<roadmanager::Position::PosModeType>(type));
+    obj_state->pos_source_ = nullptr;
     if (type == static_cast<int>(roadmanager::Position::PosModeType::SET))
     {
         obj_state->dirty_ |= (Object::DirtyBit::ALIGN_MODE_H_SET | Object::DirtyBit::ALIGN_MODE_P_SET | Object::DirtyBit::ALIGN_MODE_R_SET |
@@ -1144,6 +1455,7 @@ void ScenarioGateway::removeObject(int id)
             ++objectIt;
         }
     }
+    UpdateIdIndex();
 }
 
 void ScenarioGateway::removeObject(std::string name)
@@ -1159,6 +1471,7 @@ void ScenarioGateway::removeObject(std::string name)
             ++objectIt;
         }
     }
+    UpdateIdIndex();
 }
 
 void ScenarioGateway::WriteStatesToFile(const double simulation_time, const double dt)
@@ -1174,7 +1487,7 @@ void ScenarioGateway::WriteStatesToFile(const double simulation_time, const doub
     }
 }
 
-int ScenarioGateway::RecordToFile(std::string filename, std::string odr_filename, std::string model_filename, std::string git_rev)
+int ScenarioGateway::RecordToFile(std::string filename, std::string odr_filename, std::string model_filename, std::string git_rev, Dat::Format format)
 {
     if (filename.empty())
     {
@@ -1182,5 +1495,5 @@ int ScenarioGateway::RecordToFile(std::string filename, std::string odr_filename
         return -1;
     }
 
-    return dat_writer_.Init(filename, odr_filename, model_filename, git_rev);
+    return dat_writer_.Init(filename, odr_filename, model_filename, git_rev, format);
 }
@@ -11,6 +11,12 @@
  */
 
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <initializer_list>
+#include <memory>
+#include <thread>
+#include <unordered_map>
 #include "RoadManager.hpp"
 #include "OSCBoundingBox.hpp"
 #include "Entities.hpp"
@@ -215,13 +221,127 @@ namespace scenarioengine
             osi_index_ = osi_index;
         }
 
+        /**
+        Check whether the position was last reported from given position object and not modified since, e.g. by API calls.
+        Then the position object already holds the true state and there is no need to fetch it back from the gateway.
+        @param pos Position object to compare with, typically the entity's own position
+        @return true if position state originates from given object, else false
+        */
+        bool IsPosSourcedFrom(const roadmanager::Position *pos) const
+        {
+            return pos_source_ != nullptr && pos_source_ == pos;
+        }
+
         ObjectStateStruct state_;
 
     private:
         friend class ScenarioGateway;
-        unsigned int dirty_;
-        bool         osi_update_flag_ = true;
-        int          osi_index_       = -1;
+        unsigned int                 dirty_;
+        bool                         osi_update_flag_ = true;
+        int                          osi_index_       = -1;
+        const roadmanager::Position *pos_source_      = nullptr;  // origin of last position update, nullptr if set by other means
+        int                          name_index_      = -1;       // index of interned name in snapshots
+    };
+
+    /**
+    Structure-of-arrays copy of all object states at a given time, one array per attribute indexed by object.
+    Object names are interned, i.e. stored once in a table shared between snapshots and referred to by index.
+    Once published a snapshot is never modified, so it can be read by any thread as long as a reference is held.
+    */
+    struct WorldSnapshot
+    {
+        double       time     = 0.0;
+        unsigned int sequence = 0;  // incremented for each published snapshot
+
+        std::vector<int>            id;
+        std::vector<int>            name;  // index into names table
+        std::vector<int>            obj_type;
+        std::vector<int>            obj_category;
+        std::vector<int>            ctrl_type;
+        std::vector<int>            visibility_mask;
+        std::vector<double>         x;
+        std::vector<double>         y;
+        std::vector<double>         z;
+        std::vector<double>         h;
+        std::vector<double>         p;
+        std::vector<double>         r;
+        std::vector<double>         vel_x;
+        std::vector<double>         vel_y;
+        std::vector<double>         vel_z;
+        std::vector<double>         acc_x;
+        std::vector<double>         acc_y;
+        std::vector<double>         acc_z;
+        std::vector<double>         h_rate;
+        std::vector<double>         speed;
+        std::vector<id_t>           road_id;
+        std::vector<id_t>           junction_id;
+        std::vector<int>            lane_id;
+        std::vector<double>         s;
+        std::vector<double>         t;
+        std::vector<double>         lane_offset;
+        std::vector<double>         wheel_angle;
+        std::vector<double>         wheel_rot;
+        std::vector<OSCBoundingBox> boundingbox;
+
+        std::shared_ptr<const std::vector<std::string>> names;
+
+        size_t Size() const
+        {
+            return id.size();
+        }
+
+        const std::string &GetName(size_t idx) const
+        {
+            return (*names)[static_cast<size_t>(name[idx])];
+        }
+
+        /**
+        Find index of object in the snapshot
+        @param obj_id Id of the object
+        @return index of the object, or -1 if not found
+        */
+        int GetIndexById(int obj_id) const;
+
+        void Resize(size_t size);
+    };
+
+    // Typed state update of an object, for reporting from other threads than the simulation one, see ScenarioGateway::ReportUpdate()
+    struct ObjectStateUpdate
+    {
+        enum class Type
+        {
+            WORLD_POS,            // value: x, y, z, h, p, r
+            WORLD_POS_MODE,       // value: x, y, z, h, p, r + mode
+            WORLD_POS_XYH,        // value: x, y, h
+            LANE_POS,             // road_id, lane_id + value: offset, s
+            LATERAL_ROAD_POS,     // value: t, keeping current road and s
+            LATERAL_LANE_POS,     // value: offset, keeping current road, lane and s
+            SPEED,                // value: speed
+            VEL,                  // value: x_vel, y_vel, z_vel
+            ANGULAR_VEL,          // value: h_rate, p_rate, r_rate
+            ACC,                  // value: x_acc, y_acc, z_acc
+            ANGULAR_ACC,          // value: h_acc, p_acc, r_acc
+            WHEEL_ANGLE,          // value: angle
+            WHEEL_ROTATION,       // value: rotation
+            LANE_TYPE_SNAP_MASK,  // mode: lane type mask
+        };
+
+        Type   type      = Type::WORLD_POS;
+        int    id        = -1;
+        double timestamp = 0.0;
+        double value[6]  = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        id_t   road_id   = ID_UNDEFINED;
+        int    lane_id   = 0;
+        int    mode      = 0;
+
+        ObjectStateUpdate() = default;
+        ObjectStateUpdate(Type update_type, int object_id, double time, std::initializer_list<double> values)
+            : type(update_type),
+              id(object_id),
+              timestamp(time)
+        {
+            std::copy(values.begin(), values.begin() + MIN(values.size(), sizeof(value) / sizeof(value[0])), value);
+        }
     };
 
     class ScenarioGateway
@@ -345,6 +465,8 @@ namespace scenarioengine
         int updateObjectPos(int id, double timestamp, const roadmanager::Position *pos);
         int updateObjectRoadPos(int id, double timestamp, id_t roadId, double lateralOffset, double s);
         int updateObjectLanePos(int id, double timestamp, id_t roadId, int laneId, double offset, double s);
+        int updateObjectLateralRoadPos(int id, double timestamp, double lateralOffset);
+        int updateObjectLateralLanePos(int id, double timestamp, double offset);
         int updateObjectWorldPos(int id, double timestamp, double x, double y, double z, double h, double p, double r);
         int updateObjectWorldPosMode(int id, double timestamp, double x, double y, double z, double h, double p, double r, int mode);
         int updateObjectWorldPosXYH(int id, double timestamp, double x, double y, double h);
@@ -360,7 +482,7 @@ namespace scenarioengine
         int updateObjectVisibilityMask(int id, int visibilityMask);
         int updateObjectControllerType(int id, int controllerType);
         int updateObjectBoundingBox(int id, OSCBoundingBox bb);
-        int updateObjectWheelData(int id, std::vector<WheelData> wheel_data);
+        int updateObjectWheelData(int id, const std::vector<WheelData> &wheel_data);
 
         /**
         Specify if and how position object will align to the road. The setting is done for individual components:
@@ -404,7 +526,11 @@ namespace scenarioengine
         ObjectState *getObjectStatePtrById(int id);
         int          getObjectStateById(int id, ObjectState &objectState) const;
         void         WriteStatesToFile(const double simulation_time, const double dt);
-        int          RecordToFile(std::string filename, std::string odr_filename, std::string model_filename, std::string git_rev);
+        int          RecordToFile(std::string filename,
+                                  std::string odr_filename,
+                                  std::string model_filename,
+                                  std::string git_rev,
+                                  Dat::Format format = Dat::Format::PER_FIELD);
 
         std::vector<std::unique_ptr<ObjectState>> objectState_;
 
@@ -417,12 +543,68 @@ namespace scenarioengine
             storyboard_state_changes_ = storyboard_state_changes;
         }
 
+        // Store or restore all object states, see SE_StateBuffer
+        void SyncState(SE_StateBuffer &buf);
+
+        /**
+        Report state update from any thread. When called from the simulation thread, i.e. the one stepping the scenario, the
+        update is applied immediately. From other threads it's queued, without blocking, and applied at start of next step.
+        @param update The update
+        @return 0 if applied or queued, -1 if applied immediately and failed, e.g. object not found
+        */
+        int ReportUpdate(const ObjectStateUpdate &update);
+
+        // Apply update immediately, only from the simulation thread. Return 0 on success, -1 if object not found.
+        int ApplyUpdate(const ObjectStateUpdate &update);
+
+        // Apply updates queued by other threads, in order of reporting. Call from the simulation thread. Return number of updates.
+        int ApplyQueuedUpdates();
+
+        // Register calling thread as the simulation thread, by default the one that created the gateway
+        void SetSimulationThread()
+        {
+            sim_thread_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        }
+
+        bool IsSimulationThread() const
+        {
+            return sim_thread_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+        }
+
+        /**
+        Publish current object states as a new snapshot, replacing the previous one. See WorldSnapshot.
+        Snapshots are only created once asked for, i.e. after the first call to GetSnapshot().
+        @param time Simulation time of the states
+        */
+        void PublishSnapshot(double time);
+
+        /**
+        Get most recently published snapshot. It stays valid, and unchanged, as long as the returned reference is kept.
+        @return Snapshot, or nullptr if none has been published yet
+        */
+        std::shared_ptr<const WorldSnapshot> GetSnapshot() const;
+
     private:
-        int updateObjectInfo(ObjectState *obj_state, double timestamp, int visibilityMask, double speed, double wheel_angle, double wheel_rot);
-        std::ofstream                      data_file_;
-        Dat::DatWriter                     dat_writer_;
-        std::vector<roadmanager::Signal *> dynamic_signals_;
-        std::vector<std::string>           storyboard_state_changes_;
+        void AddObjectState(ObjectState *obj_state);
+        void UpdateIdIndex();
+        int  updateObjectInfo(ObjectState *obj_state, double timestamp, int visibilityMask, double speed, double wheel_angle, double wheel_rot);
+        std::ofstream                          data_file_;
+        Dat::DatWriter                         dat_writer_;
+        std::vector<roadmanager::Signal *>     dynamic_signals_;
+        std::vector<std::string>               storyboard_state_changes_;
+        std::unordered_map<int, ObjectState *> id_index_;  // object id -> state, for constant time lookup
+
+        // Snapshot handling. Buffers are recycled as soon as no reader is referring to them anymore.
+        int InternName(const std::string &name);
+        std::shared_ptr<WorldSnapshot>            snapshot_;
+        std::shared_ptr<WorldSnapshot>            snapshot_spare_;
+        std::shared_ptr<std::vector<std::string>> snapshot_names_;
+        std::unordered_map<std::string, int>      snapshot_name_index_;
+        mutable SE_Mutex                          snapshot_mutex_;  // only protecting the handover of snapshot pointer
+        mutable std::atomic<bool>                 snapshot_requested_{false};
+
+        SE_MPSCQueue<ObjectStateUpdate> update_queue_;  // updates from other threads than the simulation one
+        std::atomic<std::thread::id>    sim_thread_;
     };
 
 }  // namespace scenarioengine
@@ -33,7 +33,6 @@ enum
 
 static int              state = SERV_NOT_STARTED;
 static SE_Thread        thread;
-static SE_Mutex         mutex;
 static ScenarioGateway *scenarioGateway = 0;
 
 namespace scenarioengine
@@ -83,36 +82,12 @@ namespace scenarioengine
                        static_cast<double>(buf.wheel_angle),
                        180 * static_cast<double>(buf.wheel_angle) / M_PI);
 
-                // Update Ego state
-                mutex.Lock();
-
-                OSCBoundingBox bbox = {0, 0, 0, 0, 0, 0};  // dummy bariable just to feed into the function
-
-                scenarioGateway->reportObjectXYZHPR(0,
-                                                    ID_UNDEFINED,  // no global id
-                                                    "Ego",
-                                                    static_cast<int>(Object::Type::VEHICLE),
-                                                    static_cast<int>(Vehicle::Category::CAR),
-                                                    static_cast<int>(Vehicle::Role::NONE),
-                                                    0,
-                                                    "",  // no model3d filename
-                                                    1,
-                                                    bbox,
-                                                    static_cast<int>(EntityScaleMode::NONE),
-                                                    0xff,
-                                                    0.0,
-                                                    buf.speed,
-                                                    buf.wheel_angle,
-                                                    0.0,
-                                                    wheel_rot,
-                                                    buf.x,
-                                                    buf.y,
-                                                    buf.z,
-                                                    buf.h,
-                                                    buf.p,
-                                                    buf.r);
-
-                mutex.Unlock();
+                // Update Ego state, queued to be applied by the simulation thread at start of next step
+                scenarioGateway->ReportUpdate(
+                    ObjectStateUpdate(ObjectStateUpdate::Type::WORLD_POS, 0, 0.0, {buf.x, buf.y, buf.z, buf.h, buf.p, buf.r}));
+                scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::SPEED, 0, 0.0, {buf.speed}));
+                scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::WHEEL_ANGLE, 0, 0.0, {buf.wheel_angle}));
+                scenarioGateway->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::WHEEL_ROTATION, 0, 0.0, {wheel_rot}));
             }
         }
 
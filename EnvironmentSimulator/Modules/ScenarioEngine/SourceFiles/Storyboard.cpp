@@ -97,35 +97,96 @@ void StoryBoard::Step(double simTime, double dt)
 {
     EvalTriggers(simTime);
 
+    ForEachActive(init_.global_action_,
+                  active_global_action_,
+                  [&](OSCGlobalAction* action)
+                  {
+                      // skip update for during ghost restart phases
+                      if (action->GetCurrentState() == StoryBoardElement::State::RUNNING && !(SE_Env::Inst().GetGhostMode() == GhostMode::RESTARTING))
+                      {
+                          action->Step(simTime, dt);
+                      }
+                  });
+
+    ForEachActive(init_.user_defined_action_,
+                  active_user_defined_action_,
+                  [&](OSCUserDefinedAction* action)
+                  {
+                      // skip update for during ghost restart phases
+                      if (action->GetCurrentState() == StoryBoardElement::State::RUNNING && !(SE_Env::Inst().GetGhostMode() == GhostMode::RESTARTING))
+                      {
+                          action->Step(simTime, dt);
+                      }
+                  });
+
+    ForEachActive(init_.private_action_,
+                  active_private_action_,
+                  [&](OSCPrivateAction* action)
+                  {
+                      if (action->GetCurrentState() == StoryBoardElement::State::RUNNING &&
+                          // skip update for non ghost objects during ghost restart phases
+                          !(!action->object_->IsGhost() && SE_Env::Inst().GetGhostMode() == GhostMode::RESTARTING))
+                      {
+                          action->Step(simTime, dt);
+                      }
+                  });
+
+    StoryBoardElement::Step(simTime, dt);
+}
+
+void StoryBoard::UpdateActiveSet()
+{
+    CollectActive(init_.global_action_, active_global_action_);
+    CollectActive(init_.user_defined_action_, active_user_defined_action_);
+    CollectActive(init_.private_action_, active_private_action_);
+    StoryBoardElement::UpdateActiveSet();
+}
+
+void StoryBoard::SyncState(SE_StateBuffer& buf)
+{
     for (auto action : init_.global_action_)
     {
-        // skip update for during ghost restart phases
-        if (action->GetCurrentState() == StoryBoardElement::State::RUNNING && !(SE_Env::Inst().GetGhostMode() == GhostMode::RESTARTING))
-        {
-            action->Step(simTime, dt);
-        }
+        action->SyncState(buf);
     }
 
     for (auto action : init_.user_defined_action_)
     {
-        // skip update for during ghost restart phases
-        if (action->GetCurrentState() == StoryBoardElement::State::RUNNING && !(SE_Env::Inst().GetGhostMode() == GhostMode::RESTARTING))
-        {
-            action->Step(simTime, dt);
-        }
+        action->SyncState(buf);
     }
 
     for (auto action : init_.private_action_)
     {
-        if (action->GetCurrentState() == StoryBoardElement::State::RUNNING &&
-            // skip update for non ghost objects during ghost restart phases
-            !(!action->object_->IsGhost() && SE_Env::Inst().GetGhostMode() == GhostMode::RESTARTING))
+        action->SyncState(buf);
+    }
+
+    StoryBoardElement::SyncState(buf);
+}
+
+void Event::SyncState(SE_StateBuffer& buf)
+{
+    // the action list might change over time, e.g. by injected ghost restart teleport actions
+    std::vector<OSCAction*> action = action_;
+    buf.Sync(action);
+
+    if (buf.IsRestoring())
+    {
+        for (auto* entry : action_)
         {
-            action->Step(simTime, dt);
+            if (std::find(action.begin(), action.end(), entry) == action.end())
+            {
+                detached_action_.push_back(entry);
+            }
+        }
+
+        for (auto* entry : action)
+        {
+            detached_action_.erase(std::remove(detached_action_.begin(), detached_action_.end(), entry), detached_action_.end());
         }
+
+        action_ = action;
     }
 
-    StoryBoardElement::Step(simTime, dt);
+    StoryBoardElement::SyncState(buf);
 }
 
 void Event::Start(double simTime)
@@ -276,34 +337,38 @@ void Event::Start(double simTime)
 
 void Event::Step(double simTime, double dt)
 {
-    for (auto action : action_)
-    {
-        if (action->GetCurrentState() == StoryBoardElement::State::RUNNING)
-        {
-            bool is_private_ghost = [&]()
-            {
-                if (action->GetBaseType() == OSCAction::BaseType::PRIVATE)
-                {
-                    return (static_cast<OSCPrivateAction*>(action)->object_->IsGhost());
-                }
+    ForEachActive(action_,
+                  active_children_,
+                  [&](OSCAction* action)
+                  {
+                      if (action->GetCurrentState() != StoryBoardElement::State::RUNNING)
+                      {
+                          return;
+                      }
 
-                return false;
-            }();
-            if (SE_Env::Inst().GetGhostMode() != GhostMode::RESTARTING || is_private_ghost)
-            {
-                if (SE_Env::Inst().GetGhostMode() == GhostMode::RESTART && is_private_ghost)
-                {
-                    // The very step during which the ghost is restarting the
-                    // simulation time has not yet been adjusted (need to keep
-                    // same simulation time all actions throughout the step)
-                    // special case for the restarting ghost, which needs the adjusted time
-                    action->Step(simTime - SE_Env::Inst().GetGhostHeadstart(), dt);
-                }
-                else
-                {
-                    action->Step(simTime, dt);
-                }
-            }
-        }
-    }
+                      bool is_private_ghost = [&]()
+                      {
+                          if (action->GetBaseType() == OSCAction::BaseType::PRIVATE)
+                          {
+                              return (static_cast<OSCPrivateAction*>(action)->object_->IsGhost());
+                          }
+
+                          return false;
+                      }();
+                      if (SE_Env::Inst().GetGhostMode() != GhostMode::RESTARTING || is_private_ghost)
+                      {
+                          if (SE_Env::Inst().GetGhostMode() == GhostMode::RESTART && is_private_ghost)
+                          {
+                              // The very step during which the ghost is restarting the
+                              // simulation time has not yet been adjusted (need to keep
+                              // same simulation time all actions throughout the step)
+                              // special case for the restarting ghost, which needs the adjusted time
+                              action->Step(simTime - SE_Env::Inst().GetGhostHeadstart(), dt);
+                          }
+                          else
+                          {
+                              action->Step(simTime, dt);
+                          }
+                      }
+                  });
 }
@@ -86,16 +86,27 @@ namespace scenarioengine
             {
                 delete entry;
             }
+
+            for (auto* entry : detached_action_)
+            {
+                delete entry;
+            }
         }
 
         void Start(double simTime) override;
 
         void Step(double simTime, double dt) override;
 
+        void SyncState(SE_StateBuffer& buf) override;
+
         std::vector<StoryBoardElement*>* GetChildren() override
         {
             return reinterpret_cast<std::vector<StoryBoardElement*>*>(&action_);
         }
+
+    private:
+        // actions removed from the list on state restore, e.g. ghost restart teleports, kept alive for any other checkpoint referring them
+        std::vector<OSCAction*> detached_action_;
     };
 
     class Maneuver : public StoryBoardElement
@@ -253,6 +264,7 @@ namespace scenarioengine
         void      Print();
         void      Start(double simTime) override;
         void      Step(double simTime, double dt) override;
+        void      SyncState(SE_StateBuffer& buf) override;
 
         std::vector<StoryBoardElement*>* GetChildren() override
         {
@@ -260,5 +272,18 @@ namespace scenarioengine
         }
 
         std::vector<Story*> story_;
+
+    protected:
+        void   UpdateActiveSet() override;
+        size_t GetActiveSetCandidates() override
+        {
+            return story_.size() + init_.global_action_.size() + init_.user_defined_action_.size() + init_.private_action_.size();
+        }
+
+    private:
+        // running or standby init actions, by index in respective init action list
+        std::vector<size_t> active_global_action_;
+        std::vector<size_t> active_user_defined_action_;
+        std::vector<size_t> active_private_action_;
     };
 }  // namespace scenarioengine
\ No newline at end of file
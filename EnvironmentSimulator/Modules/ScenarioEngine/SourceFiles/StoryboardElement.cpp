@@ -164,10 +164,7 @@ void StoryBoardElement::Step(double simTime, double dt)
 {
     if (state_ == State::RUNNING)
     {
-        for (auto child : *GetChildren())
-        {
-            child->Step(simTime, dt);
-        }
+        ForEachActive(*GetChildren(), active_children_, [&](StoryBoardElement* child) { child->Step(simTime, dt); });
     }
 }
 
@@ -197,13 +194,17 @@ void StoryBoardElement::EvalTriggers(double simTime)
 
     if (GetCurrentState() == State::RUNNING)
     {
-        for (auto child : *GetChildren())
-        {
-            child->EvalTriggers(simTime);
-        }
+        ForEachActive(*GetChildren(), active_children_, [&](StoryBoardElement* child) { child->EvalTriggers(simTime); });
     }
 }
 
+void StoryBoardElement::UpdateActiveSet()
+{
+    CollectActive(*GetChildren(), active_children_);
+    active_set_candidates_ = GetActiveSetCandidates();
+    active_set_dirty_      = false;
+}
+
 void StoryBoardElement::Stop()
 {
     for (auto child : *GetChildren())
@@ -361,6 +362,7 @@ void StoryBoardElement::SetState(StoryBoardElement::State state)
 #endif
 
         state_ = state;
+        NotifyActiveSetOwner();
     }
 }
 
@@ -385,6 +387,38 @@ void StoryBoardElement::Reset(State state)
     }
 }
 
+void StoryBoardElement::SyncState(SE_StateBuffer& buf)
+{
+    if (element_type_ == STORY_BOARD)
+    {
+        buf.Sync(state_changes_);
+    }
+
+    buf.Sync(state_);
+    buf.Sync(transition_);
+    buf.Sync(num_executions_);
+
+    if (buf.IsRestoring())
+    {
+        active_set_dirty_ = true;
+    }
+
+    if (start_trigger_ != nullptr)
+    {
+        start_trigger_->SyncState(buf);
+    }
+
+    if (stop_trigger_ != nullptr)
+    {
+        stop_trigger_->SyncState(buf);
+    }
+
+    for (auto child : *GetChildren())
+    {
+        child->SyncState(buf);
+    }
+}
+
 void StoryBoardElement::SetName(std::string name)
 {
     name_ = name;
@@ -15,6 +15,7 @@
 #include "CommonMini.hpp"
 #include "logger.hpp"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -100,6 +101,7 @@ namespace scenarioengine
         void ResetState(State state = State::INIT)
         {
             state_ = state;
+            NotifyActiveSetOwner();
         }
 
         void SetTransition(Transition transition)
@@ -128,7 +130,8 @@ namespace scenarioengine
               num_executions_(0),
               max_num_executions_(max_num_executions),
               start_trigger_(nullptr),
-              stop_trigger_(nullptr)
+              stop_trigger_(nullptr),
+              active_set_owner_(parent)
         {
             ResetState();
             ResetTransition();
@@ -181,6 +184,9 @@ namespace scenarioengine
 
         virtual void Reset(State state = State::INIT);
 
+        // Store or restore runtime state of the element, its triggers and children, see SE_StateBuffer
+        virtual void SyncState(SE_StateBuffer& buf);
+
         void SetName(std::string name);
 
         const std::string GetName() const
@@ -208,6 +214,72 @@ namespace scenarioengine
             state_changes_.clear();
         }
 
+        // Force rebuild of the active set, e.g. after elements have been added to or removed from the child lists
+        void InvalidateActiveSet()
+        {
+            active_set_dirty_ = true;
+        }
+
+    protected:
+        // Indices of children in STANDBY or RUNNING state, in child order. Only these need trigger evaluation and stepping,
+        // so per frame cost scales with the active part of the storyboard instead of its full size. The set is rebuilt on
+        // demand after any child changed state.
+        std::vector<size_t> active_children_;
+
+        virtual void   UpdateActiveSet();
+        virtual size_t GetActiveSetCandidates()
+        {
+            return GetChildren()->size();
+        }
+
+        bool IsActiveSetOutdated()
+        {
+            return active_set_dirty_ || active_set_candidates_ != GetActiveSetCandidates();
+        }
+
+        // Register given elements as owned by this one and collect indices of the ones in STANDBY or RUNNING state
+        template <class T>
+        void CollectActive(std::vector<T*>& elements, std::vector<size_t>& active)
+        {
+            active.clear();
+            for (size_t i = 0; i < elements.size(); i++)
+            {
+                StoryBoardElement* element = elements[i];
+                element->active_set_owner_ = this;
+                if (element->GetCurrentState() == State::STANDBY || element->GetCurrentState() == State::RUNNING)
+                {
+                    active.push_back(i);
+                }
+            }
+        }
+
+        // Call func for active elements in order. Any state change on the way updates the set, and iteration resumes
+        // after the last visited element, same as a traversal of all elements checking state on the fly.
+        template <class T, class F>
+        void ForEachActive(std::vector<T*>& elements, std::vector<size_t>& active, F func)
+        {
+            if (IsActiveSetOutdated())
+            {
+                UpdateActiveSet();
+            }
+
+            for (size_t i = 0; i < active.size();)
+            {
+                size_t index = active[i];
+                func(elements[index]);
+
+                if (IsActiveSetOutdated())
+                {
+                    UpdateActiveSet();
+                    i = static_cast<size_t>(std::upper_bound(active.begin(), active.end(), index) - active.begin());
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
+
     private:
         std::string name_;
         std::string full_path_;
@@ -215,6 +287,18 @@ namespace scenarioengine
         State                           state_;
         Transition                      transition_;
         static std::vector<std::string> state_changes_;
+
+        StoryBoardElement* active_set_owner_;  // element keeping this one in its active set, normally the parent
+        bool               active_set_dirty_      = true;
+        size_t             active_set_candidates_ = 0;
+
+        void NotifyActiveSetOwner()
+        {
+            if (active_set_owner_ != nullptr)
+            {
+                active_set_owner_->active_set_dirty_ = true;
+            }
+        }
     };
 
 }  // namespace scenarioengine
\ No newline at end of file
@@ -34,6 +34,19 @@
 
 #include "CommonMini.hpp"
 
+#include <fstream>
+#include <thread>
+
+#if __has_include(<filesystem>)
+#include <filesystem>
+namespace fs = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem;
+#else
+#error "Missing <filesystem> header"
+#endif
+
 // cppcheck-suppress [unknownMacro]
 USE_OSGPLUGIN(osg2)
 USE_OSGPLUGIN(jpeg)
@@ -54,6 +67,8 @@ USE_COMPRESSOR_WRAPPER(ZLibCompressor)
 
 #define ROADMARK_Z_OFFSET 0.02
 
+#define ROAD_MODEL_CACHE_VERSION "1"  // increase when generated road model changes, to invalidate cached models
+
 #define DEFAULT_LENGTH_FOR_CONTINUOUS_OBJS 10.0
 #define LOD_DIST_ROAD_FEATURES             500
 
@@ -101,6 +116,48 @@ namespace roadgeom
         osg::ref_ptr<osg::Group> _node;
     };
 
+    // Collect all materials of the scene graph, e.g. to register materials of a model loaded from file
+    class CollectMaterials : public osg::NodeVisitor
+    {
+    public:
+        CollectMaterials() : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN)
+        {
+        }
+
+        using osg::NodeVisitor::apply;
+        void apply(osg::Node& node) override
+        {
+            if (node.getStateSet() != nullptr)
+            {
+                osg::Material* material = dynamic_cast<osg::Material*>(node.getStateSet()->getAttribute(osg::StateAttribute::MATERIAL));
+                if (material != nullptr)
+                {
+                    materials_.push_back(material);
+                }
+            }
+            traverse(node);
+        }
+
+        std::vector<osg::ref_ptr<osg::Material>> materials_;
+    };
+
+    // FNV-1a, 64 bit
+    uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    uint64_t HashString(const std::string& str, uint64_t hash = 0xcbf29ce484222325ULL)
+    {
+        return HashBytes(str.data(), str.size(), hash);
+    }
+
     bool compare_s_values(double s0, double s1)
     {
         return (fabs(s1 - s0) < 0.1);
@@ -293,7 +350,7 @@ namespace roadgeom
         rm_group->addChild(geode);
     }
 
-    int RoadGeom::AddRoadMarks(roadmanager::Lane* lane, osg::Group* rm_group, const osg::Vec3d& origin)
+    void RoadGeom::CreateRoadMarkMeshes(roadmanager::Lane* lane, const osg::Vec3d& origin, std::vector<RoadMarkMesh>& road_marks) const
     {
         for (unsigned int i = 0; i < lane->GetNumberOfRoadMarks(); i++)
         {
@@ -317,32 +374,14 @@ namespace roadgeom
                     {
                         for (unsigned int q = 0; q < curr_osi_rm->GetPoints().size(); q++)
                         {
-                            const double                    botts_dot_size = 0.15;
-                            static osg::ref_ptr<osg::Geode> dot            = 0;
-
-                            if (dot == 0)
-                            {
-                                osg::ref_ptr<osg::TessellationHints> th = new osg::TessellationHints();
-                                th->setDetailRatio(0.3f);
-                                osg::ref_ptr<osg::ShapeDrawable> shape =
-                                    new osg::ShapeDrawable(new osg::Cylinder(osg::Vec3(0.0, 0.0, 0.0),
-                                                                             static_cast<float>(botts_dot_size),
-                                                                             0.3f * static_cast<float>(botts_dot_size)),
-                                                           th);
-                                shape->setColor(ODR2OSGColor(lane_roadmark->GetColor()));
-                                dot = new osg::Geode;
-                                dot->addDrawable(shape);
-                            }
-
                             roadmanager::PointStruct osi_point0 = curr_osi_rm->GetPoint(q);
 
-                            osg::ref_ptr<osg::PositionAttitudeTransform> tx = new osg::PositionAttitudeTransform;
-                            tx->setPosition(osg::Vec3(static_cast<float>(osi_point0.x - origin[0]),
-                                                      static_cast<float>(osi_point0.y - origin[1]),
-                                                      static_cast<float>(osi_point0.z + ROADMARK_Z_OFFSET)));
-                            tx->addChild(dot);
-                            SetNodeName(*tx, prefix_roadmark, rm_group->getNumChildren(), lane_roadmark->Type2Str());
-                            rm_group->addChild(tx);
+                            road_marks.push_back({lane_roadmark,
+                                                  nullptr,
+                                                  nullptr,
+                                                  osg::Vec3(static_cast<float>(osi_point0.x - origin[0]),
+                                                            static_cast<float>(osi_point0.y - origin[1]),
+                                                            static_cast<float>(osi_point0.z + ROADMARK_Z_OFFSET))});
                         }
                     }
                     else
@@ -497,8 +536,8 @@ namespace roadgeom
 
                             if (osi_points[q].endpoint)
                             {
-                                // create and add OSG geometry for the line sequence
-                                AddRoadMarkGeom(vertices, indices, rm_group, *lane_roadmark, lane_roadmark->GetFade());
+                                // register the line sequence, OSG geometry is created when added to the scene graph
+                                road_marks.push_back({lane_roadmark, vertices, indices, osg::Vec3()});
                                 startpoint = q + 1;
                             }
                         }
@@ -506,10 +545,451 @@ namespace roadgeom
                 }
             }
         }
+    }
+
+    void RoadGeom::AddRoadMarkMeshes(const std::vector<RoadMarkMesh>& road_marks, osg::Group* rm_group)
+    {
+        for (auto& road_mark : road_marks)
+        {
+            if (!road_mark.vertices.valid())
+            {
+                const double                    botts_dot_size = 0.15;
+                static osg::ref_ptr<osg::Geode> dot            = 0;
+
+                if (dot == 0)
+                {
+                    osg::ref_ptr<osg::TessellationHints> th = new osg::TessellationHints();
+                    th->setDetailRatio(0.3f);
+                    osg::ref_ptr<osg::ShapeDrawable> shape = new osg::ShapeDrawable(
+                        new osg::Cylinder(osg::Vec3(0.0, 0.0, 0.0), static_cast<float>(botts_dot_size), 0.3f * static_cast<float>(botts_dot_size)),
+                        th);
+                    shape->setColor(ODR2OSGColor(road_mark.road_mark->GetColor()));
+                    dot = new osg::Geode;
+                    dot->addDrawable(shape);
+                }
+
+                osg::ref_ptr<osg::PositionAttitudeTransform> tx = new osg::PositionAttitudeTransform;
+                tx->setPosition(road_mark.dot_pos);
+                tx->addChild(dot);
+                SetNodeName(*tx, prefix_roadmark, rm_group->getNumChildren(), road_mark.road_mark->Type2Str());
+                rm_group->addChild(tx);
+            }
+            else
+            {
+                AddRoadMarkGeom(road_mark.vertices, road_mark.indices, rm_group, *road_mark.road_mark, road_mark.road_mark->GetFade());
+            }
+        }
+    }
+
+    int RoadGeom::AddRoadMarks(roadmanager::Lane* lane, osg::Group* rm_group, const osg::Vec3d& origin)
+    {
+        std::vector<RoadMarkMesh> road_marks;
+
+        CreateRoadMarkMeshes(lane, origin, road_marks);
+        AddRoadMarkMeshes(road_marks, rm_group);
 
         return 0;
     }
 
+    void RoadGeom::CreateRoadMesh(roadmanager::Road* road, const osg::Vec3d& origin, RoadMesh& mesh) const
+    {
+        mesh.road_id = road->GetId();
+
+        // algorithm:
+        // for each road and lane section:
+        // - establish first point of each lane at s value = 0, set to current
+        // - loop until reaching end of lane section:
+        //   - for each lane:
+        //     - find next OSI point along the lane, from the current section s value
+        //       - register s value as lane current and as candidate section current
+        //   - sort the list of section s value candidates
+        //   - for each candidate:
+        //     - for each lane:
+        //       - calculate point at candidate s value
+        //       - measure error from tangent of current section s-value point
+        //       - if error is too large:
+        //         - break
+        //       - else, if error is OK:
+        //         - register as new current section s value
+        //     - if no OK point was found, pick the first candiate (lowest s-value)
+        //   - establish points for all lanes at this s-value
+
+        for (size_t j = 0; j < static_cast<unsigned int>(road->GetNumberOfLaneSections()); j++)
+        {
+            roadmanager::LaneSection* lsec = road->GetLaneSectionByIdx(static_cast<int>(j));
+            if (lsec->GetNumberOfLanes() < 2)
+            {
+                // need at least reference lane plus another lane to form a road geometry
+                continue;
+            }
+
+            // First make sure there are OSI points of the center lane
+            roadmanager::Lane* lane = lsec->GetLaneById(0);
+            if (lane->GetOSIPoints() == 0)
+            {
+                LOG_ERROR("Missing OSI points of centerlane road {} section {}", road->GetId(), j);
+                throw std::runtime_error("Missing OSI points");
+            }
+
+            // create a 2d list of positions for vertices, nr_of_s-values x nr_of_lanes
+            typedef struct
+            {
+                double x;
+                double y;
+                double z;
+                double h;
+                double slope;
+                double s;
+            } GeomPoint;
+
+            typedef struct
+            {
+                int    geom_point_index;
+                double friction;
+            } GeomStrip;  // could be multiple of these per lane
+
+            struct GeomCacheEntry
+            {
+                GeomPoint point;
+                double    friction = 1.0;
+            };
+
+            struct CandidatePos
+            {
+                double x;
+                double y;
+            };
+
+            std::vector<std::vector<GeomPoint>> geom_points_list;                              // one list of points per lane
+            std::vector<std::vector<GeomStrip>> geom_strips_list;                              // one list of strips info per lane
+            std::vector<GeomCacheEntry>         geom_cache(lsec->GetNumberOfLanes());          // one cache entry per lane
+            std::vector<int>                    lane_osi_index(lsec->GetNumberOfLanes());      // current osi point per lane
+            std::vector<double>                 s_value_candidates(lsec->GetNumberOfLanes());  // candidates for next current s-value
+            std::vector<CandidatePos>           candidates_pos(lsec->GetNumberOfLanes());      // candidates for next current s-value
+            double                              section_current_s = lsec->GetS();
+
+            roadmanager::Position pos;  // used for calculating points along the road
+
+            // First populate s values of the material elements
+            //   - for each material a new friction segment is to be added
+            //   - loop over material friction segments, insert new vertices if needed
+            std::vector<double> friction_s_list;
+            for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
+            {
+                lane = lsec->GetLaneByIdx(k);
+                for (size_t l = 0; l < lane->GetNumberOfMaterials(); l++)
+                {
+                    friction_s_list.push_back(lsec->GetS() + lane->GetMaterialByIdx(l)->s_offset);
+                }
+            }
+
+            // sort friction s-values and remove duplicates
+            std::sort(friction_s_list.begin(), friction_s_list.end());
+            friction_s_list.erase(std::unique(friction_s_list.begin(), friction_s_list.end(), compare_s_values), friction_s_list.end());
+
+            // collect a list of s values where vertices are needed, considering all lanes
+            int                   friction_s_list_index = friction_s_list.size() > 0 ? 1 : -1;
+            bool                  done_section          = false;
+            roadmanager::Position pos2;
+
+            for (int counter = 0; !done_section; counter++)
+            {
+                if (counter == 0)
+                {
+                    // First add s = start of lane section, to set start of mesh
+                    done_section = false;
+                    for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
+                    {
+                        lane_osi_index[k]     = 0;
+                        s_value_candidates[k] = lsec->GetS();
+                    }
+                }
+                else
+                {
+                    // for each lane, find next s-value in and register it as candidate section current s-value
+                    for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
+                    {
+                        lane                                            = lsec->GetLaneByIdx(static_cast<int>(k));
+                        std::vector<roadmanager::PointStruct> osiPoints = lane->GetOSIPoints()->GetPoints();
+
+                        for (size_t l = lane_osi_index[k]; l < osiPoints.size(); l++)
+                        {
+                            if (l == osiPoints.size() - 1 || osiPoints[l].s > section_current_s + SMALL_NUMBER)
+                            {
+                                lane_osi_index[k]     = l;
+                                s_value_candidates[k] = osiPoints[l].s;
+
+                                // generate point at osi index s-value
+                                lane = lsec->GetLaneByIdx(static_cast<int>(k));
+                                pos2.SetTrackPos(road->GetId(),
+                                                 s_value_candidates[k],
+                                                 SIGN(lane->GetId()) * lsec->GetOuterOffset(s_value_candidates[k], lane->GetId()),
+                                                 true);
+                                candidates_pos[k].x = pos2.GetX();
+                                candidates_pos[k].y = pos2.GetY();
+
+                                break;
+                            }
+                        }
+                    }
+
+                    // sort candidates
+                    std::sort(s_value_candidates.begin(), s_value_candidates.end());
+
+                    // find highest s-value not exceeding the tolerated error, over all lanes
+                    size_t k = 0;
+                    for (; k < s_value_candidates.size(); k++)
+                    {
+                        size_t l = 0;
+                        for (; l < static_cast<unsigned int>(lsec->GetNumberOfLanes()); l++)
+                        {
+                            lane = lsec->GetLaneByIdx(static_cast<int>(l));
+
+                            // generate point at pivot s-value
+                            double t = road->GetLaneOffset(s_value_candidates[k]) +
+                                       SIGN(lane->GetId()) * lsec->GetOuterOffset(s_value_candidates[k], lane->GetId());
+                            pos.SetTrackPos(road->GetId(), s_value_candidates[k], t, true);
+
+                            // calculate horizontal error at this s value
+                            // find out heading of the previous calculated vertex point
+                            double h                = lane_osi_index[l] > 0 ? GetAngleOfVector(candidates_pos[l].x - geom_cache[l].point.x,
+                                                                                candidates_pos[l].y - geom_cache[l].point.y)
+                                                                            : geom_cache[l].point.h;
+                            double error_horizontal = abs(
+                                DistanceFromPointToLine2DWithAngle(pos.GetX(), pos.GetY(), geom_cache[l].point.x, geom_cache[l].point.y, h));
+
+                            // calculate vertical error at this s value
+                            double error_vertical =
+                                abs((pos.GetZ() - geom_cache[l].point.z) - geom_cache[l].point.slope * (pos.GetS() - geom_cache[l].point.s));
+
+                            if (error_horizontal > MAX_GEOM_ERROR || error_vertical > MAX_GEOM_ERROR)
+                            {
+                                break;
+                            }
+                        }
+
+                        if (l == static_cast<unsigned int>(lsec->GetNumberOfLanes()))
+                        {
+                            // no error, register preliminary section current s value
+                            section_current_s = s_value_candidates[k];
+                        }
+                        else
+                        {
+                            // error too large, stop searching
+                            if (k == 0)
+                            {
+                                // no candidate was OK, pick the first one
+                                section_current_s = s_value_candidates[k];
+                            }
+                            break;
+                        }
+
+                        // we have s-value of a OSI point, check if there is a new friction value before that
+                        // also check for maximum length
+                        double s_next_friction     = (friction_s_list_index > -1 && friction_s_list_index < friction_s_list.size())
+                                                         ? friction_s_list[friction_s_list_index]
+                                                         : lsec->GetS() + lsec->GetLength();
+                        double s_next_geom_max_len = geom_cache[k].point.s + MAX_GEOM_LENGTH;
+
+                        if (s_next_friction < section_current_s &&
+                            s_next_friction < s_next_geom_max_len + MIN_GEOM_LENGTH)  // add min geom len to avoid mini patches
+                        {
+                            section_current_s = s_next_friction;
+                            friction_s_list_index++;
+                            break;
+                        }
+                        else if (s_next_geom_max_len < section_current_s - SMALL_NUMBER &&
+                                 s_next_geom_max_len + MIN_GEOM_LENGTH < s_next_friction)  // add min geom len to avoid mini patches
+                        {
+                            section_current_s = s_next_geom_max_len;
+                            break;
+                        }
+                    }
+                }
+
+                if (section_current_s > lsec->GetS() + lsec->GetLength() - SMALL_NUMBER)
+                {
+                    done_section = true;
+                }
+
+                // s-value for next point established, create vertices for each lane
+                for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
+                {
+                    roadmanager::Lane::Material* mat            = nullptr;
+                    int                          lane_id        = lsec->GetLaneIdByIdx(static_cast<int>(k));
+                    int                          friction_index = k;
+
+                    if (k > 0)  // skip friction for first vertex strip (leftmost outer lane boundary)
+                    {
+                        // For friction we need to work from left to right. For left lanes, it means shifting friction one lane right
+                        if (lane_id >= 0)
+                        {
+                            friction_index = k - 1;
+                        }
+                    }
+                    else
+                    {
+                        friction_index = lsec->GetLaneIdxById(0);
+                    }
+
+                    roadmanager::Lane* lane_for_friction;
+                    lane_for_friction = lsec->GetLaneByIdx(static_cast<int>(friction_index));
+                    mat               = lane_for_friction->GetMaterialByS(section_current_s - lsec->GetS());
+                    double friction   = mat != nullptr ? mat->friction : FRICTION_DEFAULT;
+
+                    // retrieve position at s-value
+                    double t = road->GetLaneOffset(section_current_s) + SIGN(lane_id) * lsec->GetOuterOffset(section_current_s, lane_id);
+                    pos.SetTrackPos(road->GetId(), section_current_s, t, true);
+                    GeomPoint gp = {pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetH(), pos.GetZRoadPrim(), pos.GetS()};
+
+                    if (counter == 0)
+                    {
+                        // add geometry and strip list for the lane to
+                        std::vector<GeomPoint> geom_points;
+                        geom_points_list.push_back(geom_points);
+
+                        std::vector<GeomStrip> geom_strips;
+                        geom_strips_list.push_back(geom_strips);
+                    }
+
+                    if (counter == 0 || !NEAR_NUMBERS(friction, geom_cache[k].friction))
+                    {
+                        // create initial strip or strip with new friction value
+                        geom_strips_list[k].push_back({static_cast<int>(geom_points_list[k].size()), friction});
+                    }
+
+                    geom_points_list[k].push_back(gp);
+
+                    if (geom_cache.size() <= k)
+                    {
+                        geom_cache.push_back({{pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetH(), pos.GetZRoadPrim(), pos.GetS()}, friction});
+                    }
+                    else
+                    {
+                        geom_cache[k].point    = {pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetH(), pos.GetZRoadPrim(), pos.GetS()};
+                        geom_cache[k].friction = friction;
+                    }
+                }
+            }
+
+            // Then create actual vertices and triangle strips for the lane section
+            // Each strip is made of two lanes, so we need to create a separate geometry for each pair of lanes
+            // Also within each lane, we need to create a separate geometry for each material segment
+            unsigned int nr_vertices =
+                static_cast<unsigned int>(geom_points_list[0].size() * geom_strips_list.size());  // same nr vertices in all lanes
+            osg::ref_ptr<osg::Vec3Array> verticesAll  = new osg::Vec3Array(nr_vertices);
+            osg::ref_ptr<osg::Vec2Array> texcoordsAll = new osg::Vec2Array(nr_vertices);
+
+            // Potential optimization: Swap loops, creating all vertices for same s-value for each step
+            int vertex_index_left_local_next = 0;
+            int vertex_idx_all               = 0;
+
+            for (size_t k = 0; k < geom_strips_list.size(); k++)  // loop over lanes
+            {
+                osg::ref_ptr<osg::Vec3Array>        verticesLocal;
+                osg::ref_ptr<osg::Vec2Array>        texcoordsLocal;
+                osg::ref_ptr<osg::Vec4Array>        colorLocal;
+                osg::ref_ptr<osg::DrawElementsUInt> indices;
+                lane                               = lsec->GetLaneByIdx(static_cast<int>(k));
+                roadmanager::Lane* laneForMaterial = nullptr;
+
+                int vertex_index_left_local  = vertex_index_left_local_next;
+                int vertex_index_right_local = vertex_idx_all;
+                vertex_index_left_local_next = vertex_index_right_local;
+
+                for (size_t m = 0; m < geom_strips_list[k].size(); m++)  // loop over lane patches with constant friction
+                {
+                    double                  friction    = geom_strips_list[k][m].friction;
+                    unsigned int            gpi         = geom_strips_list[k][m].geom_point_index;
+                    std::vector<GeomPoint>& geom_points = geom_points_list[k];
+                    unsigned int            n_points    = 0;
+
+                    if (m < geom_strips_list[k].size() - 1)
+                    {
+                        n_points = geom_strips_list[k][m + 1].geom_point_index - gpi + 1;  // +
+                    }
+                    else
+                    {
+                        n_points = geom_points.size() - gpi;
+                    }
+
+                    if (k > 0)
+                    {
+                        verticesLocal   = new osg::Vec3Array(static_cast<unsigned int>(n_points * 2));
+                        indices         = new osg::DrawElementsUInt(GL_TRIANGLE_STRIP, static_cast<unsigned int>(n_points * 2));
+                        texcoordsLocal  = new osg::Vec2Array(static_cast<unsigned int>(n_points * 2));
+                        laneForMaterial = lsec->GetLaneByIdx(lane->GetId() < 0 ? static_cast<int>(k) : static_cast<int>(k) - 1);
+                    }
+
+                    int index_counter = 0;
+
+                    for (size_t l = 0; l < n_points; l++)
+                    {
+                        if (m == 0 || l > 0)
+                        {
+                            GeomPoint& gp = geom_points[gpi + l];
+                            (*verticesAll)[static_cast<unsigned int>(vertex_idx_all)].set(static_cast<float>(gp.x - origin[0]),
+                                                                                          static_cast<float>(gp.y - origin[1]),
+                                                                                          static_cast<float>(gp.z));
+                            double texscale = 1.0 / TEXTURE_SCALE;
+                            (*texcoordsAll)[static_cast<unsigned int>(vertex_idx_all)].set(
+                                osg::Vec2(static_cast<float>(texscale * (gp.x - origin[0])),
+                                          static_cast<float>(texscale * (gp.y - origin[1]))));
+                            vertex_idx_all++;
+                        }
+                        else
+                        {
+                            vertex_index_right_local--;  // reuse previous vertex
+                            vertex_index_left_local--;   // reuse previous vertex
+                        }
+
+                        // Create indices for the lane strip, referring to the vertex list
+                        if (k > 0)
+                        {
+                            // vertex of left lane border
+                            (*verticesLocal)[static_cast<unsigned int>(index_counter)]  = (*verticesAll)[vertex_index_left_local];
+                            (*texcoordsLocal)[static_cast<unsigned int>(index_counter)] = (*texcoordsAll)[vertex_index_left_local];
+                            (*indices)[index_counter]                                   = static_cast<unsigned int>(index_counter);
+                            if (l < geom_points.size() - 1)
+                            {
+                                vertex_index_left_local++;
+                            }
+                            index_counter++;
+
+                            // vertex of right
+                            (*verticesLocal)[static_cast<unsigned int>(index_counter)]  = (*verticesAll)[vertex_index_right_local];
+                            (*texcoordsLocal)[static_cast<unsigned int>(index_counter)] = (*texcoordsAll)[vertex_index_right_local];
+                            (*indices)[index_counter]                                   = static_cast<unsigned int>(index_counter);
+                            if (l < geom_points.size() - 1)
+                            {
+                                vertex_index_right_local++;
+                            }
+                            index_counter++;
+                        }
+                    }
+
+                    if (k != 0)
+                    {
+                        // Create geometry for the strip made of this and previous lane, material is applied when added to the scene graph
+                        osg::ref_ptr<osg::Geometry> geom = new osg::Geometry;
+                        geom->setUseDisplayList(true);
+                        geom->setVertexArray(verticesLocal.get());
+                        geom->addPrimitiveSet(indices.get());
+                        geom->setTexCoordArray(0, texcoordsLocal.get());
+                        osgUtil::SmoothingVisitor::smooth(*geom, 0.5);
+
+                        mesh.strips.push_back({geom,
+                                               laneForMaterial,
+                                               k == 1 || k == static_cast<unsigned int>(lsec->GetNumberOfLanes()) - 1,
+                                               friction,
+                                               std::to_string(k - 1) + "_" + std::to_string(m)});
+                    }
+                }
+                CreateRoadMarkMeshes(lane, origin, mesh.road_marks);
+            }
+        }
+    }
+
     RoadGeom::RoadGeom(roadmanager::OpenDrive* odr,
                        osg::Node*              environment,
                        osg::Vec3d              origin,
@@ -540,8 +1020,6 @@ namespace roadgeom
 
         if (generate_road_surface)
         {
-            LOG_INFO("Generating a simplistic 3D model of the road network");
-
             if (!SE_Env::Inst().GetOptions().GetOptionSet("generate_without_textures"))
             {
                 texture_map_[MaterialType::ASPHALT]  = ReadTexture("asphalt.jpg");
@@ -574,459 +1052,97 @@ namespace roadgeom
             color_concrete->push_back(osg::Vec4(0.61f, 0.61f, 0.61f, 1.0f));
             color_border_inner->push_back(osg::Vec4(0.45f, 0.45f, 0.45f, 1.0f));
 
-            // algorithm:
-            // for each road and lane section:
-            // - establish first point of each lane at s value = 0, set to current
-            // - loop until reaching end of lane section:
-            //   - for each lane:
-            //     - find next OSI point along the lane, from the current section s value
-            //       - register s value as lane current and as candidate section current
-            //   - sort the list of section s value candidates
-            //   - for each candidate:
-            //     - for each lane:
-            //       - calculate point at candidate s value
-            //       - measure error from tangent of current section s-value point
-            //       - if error is too large:
-            //         - break
-            //       - else, if error is OK:
-            //         - register as new current section s value
-            //     - if no OK point was found, pick the first candiate (lowest s-value)
-            //   - establish points for all lanes at this s-value
-
-            for (size_t i = 0; i < static_cast<unsigned int>(odr->GetNumOfRoads()); i++)
-            {
-                roadmanager::Road* road = odr->GetRoadByIdx(static_cast<int>(i));
+            std::string cache_filename = GetRoadModelCacheFilename(origin);
 
-                for (size_t j = 0; j < static_cast<unsigned int>(road->GetNumberOfLaneSections()); j++)
-                {
-                    roadmanager::LaneSection* lsec = road->GetLaneSectionByIdx(static_cast<int>(j));
-                    if (lsec->GetNumberOfLanes() < 2)
-                    {
-                        // need at least reference lane plus another lane to form a road geometry
-                        continue;
-                    }
+            if (!cache_filename.empty() && LoadRoadModelCache(cache_filename, rm_group_, r_group_) == 0)
+            {
+                LOG_INFO("Loaded 3D model of the road network from cache {}", cache_filename);
+            }
+            else
+            {
+                LOG_INFO("Generating a simplistic 3D model of the road network");
 
-                    // First make sure there are OSI points of the center lane
-                    roadmanager::Lane* lane = lsec->GetLaneById(0);
-                    if (lane->GetOSIPoints() == 0)
-                    {
-                        LOG_ERROR("Missing OSI points of centerlane road {} section {}", road->GetId(), j);
-                        throw std::runtime_error("Missing OSI points");
-                    }
+                // road mark OSI points might have been deferred, make sure they are available
+                odr->EnsureRoadMarkOSIPoints();
 
-                    // create a 2d list of positions for vertices, nr_of_s-values x nr_of_lanes
-                    typedef struct
-                    {
-                        double x;
-                        double y;
-                        double z;
-                        double h;
-                        double slope;
-                        double s;
-                    } GeomPoint;
+                // calculate vertices and indices of the roads in parallel, then add them to the scene graph in road order
+                std::vector<RoadMesh> road_meshes(odr->GetNumOfRoads());
+                SE_ThreadPool         pool;
+                pool.ParallelFor(road_meshes.size(),
+                                 [&](size_t i) { CreateRoadMesh(odr->GetRoadByIdx(static_cast<int>(i)), origin, road_meshes[i]); });
 
-                    typedef struct
+                for (auto& mesh : road_meshes)
+                {
+                    for (auto& strip : mesh.strips)
                     {
-                        int    geom_point_index;
-                        double friction;
-                    } GeomStrip;  // could be multiple of these per lane
+                        MaterialType material_t;
 
-                    struct GeomCacheEntry
-                    {
-                        GeomPoint point;
-                        double    friction = 1.0;
-                    };
+                        if (strip.lane_for_material->IsType(roadmanager::Lane::LaneType::LANE_TYPE_ANY_ROAD))
+                        {
+                            material_t = MaterialType::ASPHALT;
+                            osg::ref_ptr<osg::Material> materialAsphalt_ =
+                                GetOrCreateMaterial("Asphalt", GetFrictionColor(strip.friction), static_cast<uint8_t>(material_t), 1);
 
-                    struct CandidatePos
-                    {
-                        double x;
-                        double y;
-                    };
-
-                    std::vector<std::vector<GeomPoint>> geom_points_list;                              // one list of points per lane
-                    std::vector<std::vector<GeomStrip>> geom_strips_list;                              // one list of strips info per lane
-                    std::vector<GeomCacheEntry>         geom_cache(lsec->GetNumberOfLanes());          // one cache entry per lane
-                    std::vector<int>                    lane_osi_index(lsec->GetNumberOfLanes());      // current osi point per lane
-                    std::vector<double>                 s_value_candidates(lsec->GetNumberOfLanes());  // candidates for next current s-value
-                    std::vector<CandidatePos>           candidates_pos(lsec->GetNumberOfLanes());      // candidates for next current s-value
-                    double                              section_current_s = lsec->GetS();
-
-                    roadmanager::Position pos;  // used for calculating points along the road
-
-                    // First populate s values of the material elements
-                    //   - for each material a new friction segment is to be added
-                    //   - loop over material friction segments, insert new vertices if needed
-                    std::vector<double> friction_s_list;
-                    for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
-                    {
-                        lane = lsec->GetLaneByIdx(k);
-                        for (size_t l = 0; l < lane->GetNumberOfMaterials(); l++)
+                            strip.geom->getOrCreateStateSet()->setAttributeAndModes(materialAsphalt_.get());
+                        }
+                        else if (strip.lane_for_material->IsType(roadmanager::Lane::LaneType::LANE_TYPE_BIKING) ||
+                                 strip.lane_for_material->IsType(roadmanager::Lane::LaneType::LANE_TYPE_SIDEWALK))
                         {
-                            friction_s_list.push_back(lsec->GetS() + lane->GetMaterialByIdx(l)->s_offset);
+                            material_t = MaterialType::CONCRETE;
+                            osg::ref_ptr<osg::Material> materialConcrete_ =
+                                GetOrCreateMaterial("Concrete", color_concrete->at(0), static_cast<uint8_t>(material_t));
+                            strip.geom->getOrCreateStateSet()->setAttributeAndModes(materialConcrete_.get());
+
+                            // Use PolygonOffset feature to avoid z-fighting with road surface
+                            strip.geom->getOrCreateStateSet()->setAttributeAndModes(
+                                new osg::PolygonOffset(-POLYGON_OFFSET_SIDEWALK, -SIGN(POLYGON_OFFSET_SIDEWALK)));
                         }
-                    }
-
-                    // sort friction s-values and remove duplicates
-                    std::sort(friction_s_list.begin(), friction_s_list.end());
-                    friction_s_list.erase(std::unique(friction_s_list.begin(), friction_s_list.end(), compare_s_values), friction_s_list.end());
-
-                    // collect a list of s values where vertices are needed, considering all lanes
-                    int                   friction_s_list_index = friction_s_list.size() > 0 ? 1 : -1;
-                    bool                  done_section          = false;
-                    roadmanager::Position pos2;
-
-                    for (int counter = 0; !done_section; counter++)
-                    {
-                        if (counter == 0)
+                        else if (strip.lane_for_material->IsType(roadmanager::Lane::LaneType::LANE_TYPE_BORDER) && !strip.outer)
                         {
-                            // First add s = start of lane section, to set start of mesh
-                            done_section = false;
-                            for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
-                            {
-                                lane_osi_index[k]     = 0;
-                                s_value_candidates[k] = lsec->GetS();
-                            }
+                            material_t = MaterialType::BORDER;
+                            osg::ref_ptr<osg::Material> materialBorderInner_ =
+                                GetOrCreateMaterial("Border", color_border_inner->at(0), static_cast<uint8_t>(material_t));
+                            strip.geom->getOrCreateStateSet()->setAttributeAndModes(materialBorderInner_.get());
+
+                            // Use PolygonOffset feature to avoid z-fighting with road surface
+                            strip.geom->getOrCreateStateSet()->setAttributeAndModes(
+                                new osg::PolygonOffset(-POLYGON_OFFSET_BORDER, -SIGN(POLYGON_OFFSET_BORDER)));
                         }
                         else
                         {
-                            // for each lane, find next s-value in and register it as candidate section current s-value
-                            for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
-                            {
-                                lane                                            = lsec->GetLaneByIdx(static_cast<int>(k));
-                                std::vector<roadmanager::PointStruct> osiPoints = lane->GetOSIPoints()->GetPoints();
+                            material_t = MaterialType::GRASS;
+                            osg::ref_ptr<osg::Material> materialGrass_ =
+                                GetOrCreateMaterial("Grass", color_grass->at(0), static_cast<uint8_t>(material_t));
 
-                                for (size_t l = lane_osi_index[k]; l < osiPoints.size(); l++)
-                                {
-                                    if (l == osiPoints.size() - 1 || osiPoints[l].s > section_current_s + SMALL_NUMBER)
-                                    {
-                                        lane_osi_index[k]     = l;
-                                        s_value_candidates[k] = osiPoints[l].s;
-
-                                        // generate point at osi index s-value
-                                        lane = lsec->GetLaneByIdx(static_cast<int>(k));
-                                        pos2.SetTrackPos(road->GetId(),
-                                                         s_value_candidates[k],
-                                                         SIGN(lane->GetId()) * lsec->GetOuterOffset(s_value_candidates[k], lane->GetId()),
-                                                         true);
-                                        candidates_pos[k].x = pos2.GetX();
-                                        candidates_pos[k].y = pos2.GetY();
-
-                                        break;
-                                    }
-                                }
-                            }
-
-                            // sort candidates
-                            std::sort(s_value_candidates.begin(), s_value_candidates.end());
-
-                            // find highest s-value not exceeding the tolerated error, over all lanes
-                            size_t k = 0;
-                            for (; k < s_value_candidates.size(); k++)
-                            {
-                                size_t l = 0;
-                                for (; l < static_cast<unsigned int>(lsec->GetNumberOfLanes()); l++)
-                                {
-                                    lane = lsec->GetLaneByIdx(static_cast<int>(l));
-
-                                    // generate point at pivot s-value
-                                    double t = road->GetLaneOffset(s_value_candidates[k]) +
-                                               SIGN(lane->GetId()) * lsec->GetOuterOffset(s_value_candidates[k], lane->GetId());
-                                    pos.SetTrackPos(road->GetId(), s_value_candidates[k], t, true);
-
-                                    // calculate horizontal error at this s value
-                                    // find out heading of the previous calculated vertex point
-                                    double h                = lane_osi_index[l] > 0 ? GetAngleOfVector(candidates_pos[l].x - geom_cache[l].point.x,
-                                                                                        candidates_pos[l].y - geom_cache[l].point.y)
-                                                                                    : geom_cache[l].point.h;
-                                    double error_horizontal = abs(
-                                        DistanceFromPointToLine2DWithAngle(pos.GetX(), pos.GetY(), geom_cache[l].point.x, geom_cache[l].point.y, h));
-
-                                    // calculate vertical error at this s value
-                                    double error_vertical =
-                                        abs((pos.GetZ() - geom_cache[l].point.z) - geom_cache[l].point.slope * (pos.GetS() - geom_cache[l].point.s));
-
-                                    if (error_horizontal > MAX_GEOM_ERROR || error_vertical > MAX_GEOM_ERROR)
-                                    {
-                                        break;
-                                    }
-                                }
+                            strip.geom->getOrCreateStateSet()->setAttributeAndModes(materialGrass_.get());
 
-                                if (l == static_cast<unsigned int>(lsec->GetNumberOfLanes()))
-                                {
-                                    // no error, register preliminary section current s value
-                                    section_current_s = s_value_candidates[k];
-                                }
-                                else
-                                {
-                                    // error too large, stop searching
-                                    if (k == 0)
-                                    {
-                                        // no candidate was OK, pick the first one
-                                        section_current_s = s_value_candidates[k];
-                                    }
-                                    break;
-                                }
-
-                                // we have s-value of a OSI point, check if there is a new friction value before that
-                                // also check for maximum length
-                                double s_next_friction     = (friction_s_list_index > -1 && friction_s_list_index < friction_s_list.size())
-                                                                 ? friction_s_list[friction_s_list_index]
-                                                                 : lsec->GetS() + lsec->GetLength();
-                                double s_next_geom_max_len = geom_cache[k].point.s + MAX_GEOM_LENGTH;
-
-                                if (s_next_friction < section_current_s &&
-                                    s_next_friction < s_next_geom_max_len + MIN_GEOM_LENGTH)  // add min geom len to avoid mini patches
-                                {
-                                    section_current_s = s_next_friction;
-                                    friction_s_list_index++;
-                                    break;
-                                }
-                                else if (s_next_geom_max_len < section_current_s - SMALL_NUMBER &&
-                                         s_next_geom_max_len + MIN_GEOM_LENGTH < s_next_friction)  // add min geom len to avoid mini patches
-                                {
-                                    section_current_s = s_next_geom_max_len;
-                                    break;
-                                }
-                            }
+                            // Use PolygonOffset feature to avoid z-fighting with road surface
+                            strip.geom->getOrCreateStateSet()->setAttributeAndModes(
+                                new osg::PolygonOffset(-POLYGON_OFFSET_GRASS, -SIGN(POLYGON_OFFSET_GRASS)));
                         }
+                        strip.geom->setColorBinding(osg::Geometry::BIND_OVERALL);
 
-                        if (section_current_s > lsec->GetS() + lsec->GetLength() - SMALL_NUMBER)
+                        // See if the material type has a texture associated with it, if so, apply it
+                        auto texture_it = texture_map_.find(material_t);
+                        if (texture_it != texture_map_.end())
                         {
-                            done_section = true;
+                            strip.geom->getOrCreateStateSet()->setTextureAttributeAndModes(0, texture_it->second.get());
                         }
 
-                        // s-value for next point established, create vertices for each lane
-                        for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
-                        {
-                            roadmanager::Lane::Material* mat            = nullptr;
-                            int                          lane_id        = lsec->GetLaneIdByIdx(static_cast<int>(k));
-                            int                          friction_index = k;
-
-                            if (k > 0)  // skip friction for first vertex strip (leftmost outer lane boundary)
-                            {
-                                // For friction we need to work from left to right. For left lanes, it means shifting friction one lane right
-                                if (lane_id >= 0)
-                                {
-                                    friction_index = k - 1;
-                                }
-                            }
-                            else
-                            {
-                                friction_index = lsec->GetLaneIdxById(0);
-                            }
-
-                            roadmanager::Lane* lane_for_friction;
-                            lane_for_friction = lsec->GetLaneByIdx(static_cast<int>(friction_index));
-                            mat               = lane_for_friction->GetMaterialByS(section_current_s - lsec->GetS());
-                            double friction   = mat != nullptr ? mat->friction : FRICTION_DEFAULT;
-
-                            // retrieve position at s-value
-                            double t = road->GetLaneOffset(section_current_s) + SIGN(lane_id) * lsec->GetOuterOffset(section_current_s, lane_id);
-                            pos.SetTrackPos(road->GetId(), section_current_s, t, true);
-                            GeomPoint gp = {pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetH(), pos.GetZRoadPrim(), pos.GetS()};
+                        osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+                        geode->addDrawable(strip.geom.get());
 
-                            if (counter == 0)
-                            {
-                                // add geometry and strip list for the lane to
-                                std::vector<GeomPoint> geom_points;
-                                geom_points_list.push_back(geom_points);
-
-                                std::vector<GeomStrip> geom_strips;
-                                geom_strips_list.push_back(geom_strips);
-                            }
-
-                            if (counter == 0 || !NEAR_NUMBERS(friction, geom_cache[k].friction))
-                            {
-                                // create initial strip or strip with new friction value
-                                geom_strips_list[k].push_back({static_cast<int>(geom_points_list[k].size()), friction});
-                            }
-
-                            geom_points_list[k].push_back(gp);
-
-                            if (geom_cache.size() <= k)
-                            {
-                                geom_cache.push_back({{pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetH(), pos.GetZRoadPrim(), pos.GetS()}, friction});
-                            }
-                            else
-                            {
-                                geom_cache[k].point    = {pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetH(), pos.GetZRoadPrim(), pos.GetS()};
-                                geom_cache[k].friction = friction;
-                            }
-                        }
+                        // osgUtil::Optimizer optimizer;
+                        // optimizer.optimize(geode);
+                        SetNodeName(*geode, prefix_road, mesh.road_id, strip.label);
+                        r_group_->addChild(geode);
                     }
+                    AddRoadMarkMeshes(mesh.road_marks, rm_group_);
+                }
 
-                    // Then create actual vertices and triangle strips for the lane section
-                    // Each strip is made of two lanes, so we need to create a separate geometry for each pair of lanes
-                    // Also within each lane, we need to create a separate geometry for each material segment
-                    unsigned int nr_vertices =
-                        static_cast<unsigned int>(geom_points_list[0].size() * geom_strips_list.size());  // same nr vertices in all lanes
-                    osg::ref_ptr<osg::Vec3Array> verticesAll  = new osg::Vec3Array(nr_vertices);
-                    osg::ref_ptr<osg::Vec2Array> texcoordsAll = new osg::Vec2Array(nr_vertices);
-
-                    // Potential optimization: Swap loops, creating all vertices for same s-value for each step
-                    int vertex_index_left_local_next = 0;
-                    int vertex_idx_all               = 0;
-
-                    for (size_t k = 0; k < geom_strips_list.size(); k++)  // loop over lanes
-                    {
-                        osg::ref_ptr<osg::Vec3Array>        verticesLocal;
-                        osg::ref_ptr<osg::Vec2Array>        texcoordsLocal;
-                        osg::ref_ptr<osg::Vec4Array>        colorLocal;
-                        osg::ref_ptr<osg::DrawElementsUInt> indices;
-                        lane                               = lsec->GetLaneByIdx(static_cast<int>(k));
-                        roadmanager::Lane* laneForMaterial = nullptr;
-
-                        int vertex_index_left_local  = vertex_index_left_local_next;
-                        int vertex_index_right_local = vertex_idx_all;
-                        vertex_index_left_local_next = vertex_index_right_local;
-
-                        for (size_t m = 0; m < geom_strips_list[k].size(); m++)  // loop over lane patches with constant friction
-                        {
-                            lane_friction_                      = geom_strips_list[k][m].friction;
-                            unsigned int            gpi         = geom_strips_list[k][m].geom_point_index;
-                            std::vector<GeomPoint>& geom_points = geom_points_list[k];
-                            unsigned int            n_points    = 0;
-
-                            if (m < geom_strips_list[k].size() - 1)
-                            {
-                                n_points = geom_strips_list[k][m + 1].geom_point_index - gpi + 1;  // +
-                            }
-                            else
-                            {
-                                n_points = geom_points.size() - gpi;
-                            }
-
-                            if (k > 0)
-                            {
-                                verticesLocal   = new osg::Vec3Array(static_cast<unsigned int>(n_points * 2));
-                                indices         = new osg::DrawElementsUInt(GL_TRIANGLE_STRIP, static_cast<unsigned int>(n_points * 2));
-                                texcoordsLocal  = new osg::Vec2Array(static_cast<unsigned int>(n_points * 2));
-                                laneForMaterial = lsec->GetLaneByIdx(lane->GetId() < 0 ? static_cast<int>(k) : static_cast<int>(k) - 1);
-                            }
-
-                            int index_counter = 0;
-
-                            for (size_t l = 0; l < n_points; l++)
-                            {
-                                if (m == 0 || l > 0)
-                                {
-                                    GeomPoint& gp = geom_points[gpi + l];
-                                    (*verticesAll)[static_cast<unsigned int>(vertex_idx_all)].set(static_cast<float>(gp.x - origin[0]),
-                                                                                                  static_cast<float>(gp.y - origin[1]),
-                                                                                                  static_cast<float>(gp.z));
-                                    double texscale = 1.0 / TEXTURE_SCALE;
-                                    (*texcoordsAll)[static_cast<unsigned int>(vertex_idx_all)].set(
-                                        osg::Vec2(static_cast<float>(texscale * (gp.x - origin[0])),
-                                                  static_cast<float>(texscale * (gp.y - origin[1]))));
-                                    vertex_idx_all++;
-                                }
-                                else
-                                {
-                                    vertex_index_right_local--;  // reuse previous vertex
-                                    vertex_index_left_local--;   // reuse previous vertex
-                                }
-
-                                // Create indices for the lane strip, referring to the vertex list
-                                if (k > 0)
-                                {
-                                    // vertex of left lane border
-                                    (*verticesLocal)[static_cast<unsigned int>(index_counter)]  = (*verticesAll)[vertex_index_left_local];
-                                    (*texcoordsLocal)[static_cast<unsigned int>(index_counter)] = (*texcoordsAll)[vertex_index_left_local];
-                                    (*indices)[index_counter]                                   = static_cast<unsigned int>(index_counter);
-                                    if (l < geom_points.size() - 1)
-                                    {
-                                        vertex_index_left_local++;
-                                    }
-                                    index_counter++;
-
-                                    // vertex of right
-                                    (*verticesLocal)[static_cast<unsigned int>(index_counter)]  = (*verticesAll)[vertex_index_right_local];
-                                    (*texcoordsLocal)[static_cast<unsigned int>(index_counter)] = (*texcoordsAll)[vertex_index_right_local];
-                                    (*indices)[index_counter]                                   = static_cast<unsigned int>(index_counter);
-                                    if (l < geom_points.size() - 1)
-                                    {
-                                        vertex_index_right_local++;
-                                    }
-                                    index_counter++;
-                                }
-                            }
-
-                            if (k != 0)
-                            {
-                                // Create geometry for the strip made of this and previous lane
-                                osg::ref_ptr<osg::Geometry> geom = new osg::Geometry;
-                                geom->setUseDisplayList(true);
-                                geom->setVertexArray(verticesLocal.get());
-                                geom->addPrimitiveSet(indices.get());
-                                geom->setTexCoordArray(0, texcoordsLocal.get());
-                                osgUtil::SmoothingVisitor::smooth(*geom, 0.5);
-
-                                MaterialType material_t;
-
-                                if (laneForMaterial->IsType(roadmanager::Lane::LaneType::LANE_TYPE_ANY_ROAD))
-                                {
-                                    material_t = MaterialType::ASPHALT;
-                                    osg::ref_ptr<osg::Material> materialAsphalt_ =
-                                        GetOrCreateMaterial("Asphalt", GetFrictionColor(lane_friction_), static_cast<uint8_t>(material_t), 1);
-
-                                    geom->getOrCreateStateSet()->setAttributeAndModes(materialAsphalt_.get());
-                                }
-                                else if (laneForMaterial->IsType(roadmanager::Lane::LaneType::LANE_TYPE_BIKING) ||
-                                         laneForMaterial->IsType(roadmanager::Lane::LaneType::LANE_TYPE_SIDEWALK))
-                                {
-                                    material_t = MaterialType::CONCRETE;
-                                    osg::ref_ptr<osg::Material> materialConcrete_ =
-                                        GetOrCreateMaterial("Concrete", color_concrete->at(0), static_cast<uint8_t>(material_t));
-                                    geom->getOrCreateStateSet()->setAttributeAndModes(materialConcrete_.get());
-
-                                    // Use PolygonOffset feature to avoid z-fighting with road surface
-                                    geom->getOrCreateStateSet()->setAttributeAndModes(
-                                        new osg::PolygonOffset(-POLYGON_OFFSET_SIDEWALK, -SIGN(POLYGON_OFFSET_SIDEWALK)));
-                                }
-                                else if (laneForMaterial->IsType(roadmanager::Lane::LaneType::LANE_TYPE_BORDER) && k != 1 &&
-                                         k != static_cast<unsigned int>(lsec->GetNumberOfLanes()) - 1)
-                                {
-                                    material_t = MaterialType::BORDER;
-                                    osg::ref_ptr<osg::Material> materialBorderInner_ =
-                                        GetOrCreateMaterial("Border", color_border_inner->at(0), static_cast<uint8_t>(material_t));
-                                    geom->getOrCreateStateSet()->setAttributeAndModes(materialBorderInner_.get());
-
-                                    // Use PolygonOffset feature to avoid z-fighting with road surface
-                                    geom->getOrCreateStateSet()->setAttributeAndModes(
-                                        new osg::PolygonOffset(-POLYGON_OFFSET_BORDER, -SIGN(POLYGON_OFFSET_BORDER)));
-                                }
-                                else
-                                {
-                                    material_t = MaterialType::GRASS;
-                                    osg::ref_ptr<osg::Material> materialGrass_ =
-                                        GetOrCreateMaterial("Grass", color_grass->at(0), static_cast<uint8_t>(material_t));
-
-                                    geom->getOrCreateStateSet()->setAttributeAndModes(materialGrass_.get());
-
-                                    // Use PolygonOffset feature to avoid z-fighting with road surface
-                                    geom->getOrCreateStateSet()->setAttributeAndModes(
-                                        new osg::PolygonOffset(-POLYGON_OFFSET_GRASS, -SIGN(POLYGON_OFFSET_GRASS)));
-                                }
-                                geom->setColorBinding(osg::Geometry::BIND_OVERALL);
-
-                                // See if the material type has a texture associated with it, if so, apply it
-                                auto texture_it = texture_map_.find(material_t);
-                                if (texture_it != texture_map_.end())
-                                {
-                                    geom->getOrCreateStateSet()->setTextureAttributeAndModes(0, texture_it->second.get());
-                                }
-
-                                osg::ref_ptr<osg::Geode> geode = new osg::Geode;
-                                geode->addDrawable(geom.get());
-
-                                // osgUtil::Optimizer optimizer;
-                                // optimizer.optimize(geode);
-                                SetNodeName(*geode, prefix_road, road->GetId(), std::to_string(k - 1) + "_" + std::to_string(m));
-                                r_group_->addChild(geode);
-                            }
-                        }
-                        AddRoadMarks(lane, rm_group_, origin);
-                    }
+                if (!cache_filename.empty())
+                {
+                    SaveRoadModelCache(cache_filename, rm_group_, r_group_);
                 }
             }
         }
@@ -1863,6 +1979,128 @@ namespace roadgeom
         return 0;
     }
 
+    std::string RoadGeom::GetRoadModelCacheFilename(const osg::Vec3d& origin)
+    {
+        // opt-in, since cache files are never cleaned up
+        std::string dir = SE_Env::Inst().GetOptions().GetOptionValue("road_model_cache");
+        if (dir.empty() || odrManager_->GetOpenDriveFilename().empty())
+        {
+            return "";
+        }
+
+        std::ifstream file(odrManager_->GetOpenDriveFilename(), std::ios::binary);
+        if (!file.is_open())
+        {
+            return "";
+        }
+        std::string odr_content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        // any change of OpenDRIVE, esmini version, textures or settings affecting the road surface results in a new cache file
+        std::string settings = fmt::format("{} {:.6f} {:.6f} {:.6f} {:d}",
+                                           ROAD_MODEL_CACHE_VERSION,
+                                           origin[0],
+                                           origin[1],
+                                           origin[2],
+                                           SE_Env::Inst().GetOptions().GetOptionSet("generate_without_textures"));
+        uint64_t    hash     = HashString(odr_content, HashString(settings + GetVersionInfoForLog()));
+        for (MaterialType type : {MaterialType::ASPHALT, MaterialType::GRASS, MaterialType::ROADMARK})
+        {
+            auto it = texture_map_.find(type);
+            if (it != texture_map_.end() && it->second != nullptr && it->second->getImage() != nullptr)
+            {
+                const osg::Image* img = it->second->getImage();
+                hash                  = HashBytes(img->data(), img->getTotalSizeInBytes(), hash);
+            }
+            else
+            {
+                hash = HashString("no texture", hash);
+            }
+        }
+
+        return (fs::path(dir) / fmt::format("{}_{:016x}.osgb", FileNameWithoutExtOf(odrManager_->GetOpenDriveFilename()), hash)).string();
+    }
+
+    int RoadGeom::LoadRoadModelCache(const std::string& filename, osg::Group* rm_group, osg::Group* r_group)
+    {
+        if (!fs::exists(filename))
+        {
+            return -1;
+        }
+
+        osg::ref_ptr<osg::Node> node  = osgDB::readNodeFile(filename);
+        osg::Group*             group = node != nullptr ? node->asGroup() : nullptr;
+
+        if (group == nullptr || group->getNumChildren() != 2 || group->getChild(0)->asGroup() == nullptr || group->getChild(1)->asGroup() == nullptr)
+        {
+            LOG_WARN("Failed to load cached road model {}, generating a new one", filename);
+            return -1;
+        }
+
+        for (unsigned int i = 0; i < group->getChild(0)->asGroup()->getNumChildren(); i++)
+        {
+            rm_group->addChild(group->getChild(0)->asGroup()->getChild(i));
+        }
+        for (unsigned int i = 0; i < group->getChild(1)->asGroup()->getNumChildren(); i++)
+        {
+            r_group->addChild(group->getChild(1)->asGroup()->getChild(i));
+        }
+
+        // register materials, e.g. for friction visualization. Key is restored from name, see GetOrCreateMaterial()
+        CollectMaterials collect_materials;
+        group->accept(collect_materials);
+        for (auto& material : collect_materials.materials_)
+        {
+            const std::string& name = material->getName();
+            size_t             len  = name.size();
+            if (len < 16 || name.compare(len - 16, 2, "0x") != 0)
+            {
+                continue;
+            }
+
+            uint64_t rgba         = std::stoull(name.substr(len - 14, 8), nullptr, 16);
+            uint64_t texture_type = std::stoull(name.substr(len - 5, 2), nullptr, 16);
+            uint64_t has_friction = std::stoull(name.substr(len - 2, 2), nullptr, 16);
+
+            std_materials_[(rgba << 16) | (texture_type << 8) | has_friction] = material;
+        }
+        number_of_materials = static_cast<unsigned int>(std_materials_.size());
+
+        return 0;
+    }
+
+    int RoadGeom::SaveRoadModelCache(const std::string& filename, osg::Group* rm_group, osg::Group* r_group)
+    {
+        std::error_code ec;
+        fs::create_directories(fs::path(filename).parent_path(), ec);
+
+        osg::ref_ptr<osg::Group> group = new osg::Group;
+        group->setName("esmini_road_model_cache");
+        group->addChild(rm_group);
+        group->addChild(r_group);
+
+        // write to a temporary file first, so that other processes will not read a partially written cache file
+        std::string tmp_filename = fmt::format("{}.{}.tmp.osgb", filename, std::hash<std::thread::id>()(std::this_thread::get_id()));
+        osg::ref_ptr<osgDB::Options> options = new osgDB::Options("Compressor=zlib WriteImageHint=IncludeFile");
+
+        if (!osgDB::writeNodeFile(*group, tmp_filename, options.get()))
+        {
+            LOG_WARN("Failed to write road model cache {}", tmp_filename);
+            fs::remove(tmp_filename, ec);
+            return -1;
+        }
+
+        fs::rename(tmp_filename, filename, ec);
+        if (ec)
+        {
+            fs::remove(tmp_filename, ec);
+            return -1;
+        }
+
+        LOG_INFO("Saved road model to cache {}", filename);
+
+        return 0;
+    }
+
     TrafficLightModel* RoadGeom::GetTrafficLightModel(int id)
     {
         auto it = traffic_light_.find(id);
@@ -110,6 +110,48 @@ namespace roadgeom
         std::unordered_map<int, TrafficLightModel> traffic_light_;
 
     private:
+        // Geometry of one strip of road surface between two lane borders, material is applied when added to the scene graph
+        typedef struct
+        {
+            osg::ref_ptr<osg::Geometry> geom;
+            roadmanager::Lane*          lane_for_material;
+            bool                        outer;     // leftmost or rightmost strip of the lane section
+            double                      friction;  // constant along the strip
+            std::string                 label;     // node name label, <strip index>_<friction patch index>
+        } StripMesh;
+
+        // Line sequence of a road mark, or position of a single botts dot (vertices == nullptr)
+        typedef struct
+        {
+            roadmanager::LaneRoadMark*          road_mark;
+            osg::ref_ptr<osg::Vec3Array>        vertices;
+            osg::ref_ptr<osg::DrawElementsUInt> indices;
+            osg::Vec3                           dot_pos;
+        } RoadMarkMesh;
+
+        // Vertices and indices of all lane sections of a road, independent of other roads
+        typedef struct
+        {
+            id_t                      road_id;
+            std::vector<StripMesh>    strips;
+            std::vector<RoadMarkMesh> road_marks;
+        } RoadMesh;
+
+        /**
+            Calculate road surface and road mark geometries of a road. Does not modify any shared state, so roads can be processed in parallel.
+        */
+        void CreateRoadMesh(roadmanager::Road* road, const osg::Vec3d& origin, RoadMesh& mesh) const;
+        void CreateRoadMarkMeshes(roadmanager::Lane* lane, const osg::Vec3d& origin, std::vector<RoadMarkMesh>& road_marks) const;
+        void AddRoadMarkMeshes(const std::vector<RoadMarkMesh>& road_marks, osg::Group* rm_group);
+
+        /**
+            Establish road model cache file, named by a hash of the OpenDRIVE file content, textures, esmini version and generation settings
+            @return Cache file path, or empty string if caching is disabled or not applicable
+        */
+        std::string GetRoadModelCacheFilename(const osg::Vec3d& origin);
+        int         LoadRoadModelCache(const std::string& filename, osg::Group* rm_group, osg::Group* r_group);
+        int         SaveRoadModelCache(const std::string& filename, osg::Group* rm_group, osg::Group* r_group);
+
         unsigned int                                                   number_of_materials     = 0;
         std::unordered_map<MaterialType, osg::ref_ptr<osg::Texture2D>> texture_map_            = {};
         double                                                         lane_friction_          = 1.0;
@@ -2553,6 +2553,8 @@ bool Viewer::CreateRoadMarkLines(roadmanager::OpenDrive* od)
     double    z_offset = 0.10;
     osg::Vec3 point(0, 0, 0);
 
+    od->EnsureRoadMarkOSIPoints();
+
     for (unsigned int r = 0; r < od->GetNumOfRoads(); r++)
     {
         roadmanager::Road* road = od->GetRoadByIdx(r);
@@ -1,10 +1,14 @@
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
 
 #include "CommonMini.hpp"
 #include "logger.hpp"
 #include "esminiLib.hpp"
 #include "Config.hpp"
+#include "SharedState.hpp"
 
 struct Coordinate2D
 {
@@ -426,6 +430,301 @@ TEST(FilenameOperations, TestNormalizePath)
     EXPECT_EQ(LexicallyNormalizePath("/a/b/c/../../.."), "/");
 }
 
+TEST(Threading, TestThreadPoolParallelFor)
+{
+    for (unsigned int n_threads : {1u, 2u, 5u})
+    {
+        SE_ThreadPool pool(n_threads);
+        EXPECT_EQ(pool.GetNumberOfThreads(), n_threads);
+
+        // reuse pool for several jobs, each item should be visited exactly once
+        for (size_t n : std::vector<size_t>{0, 1, 7, 1000})
+        {
+            std::vector<int> visits(n, 0);
+            pool.ParallelFor(n, [&visits](size_t i) { visits[i]++; });
+            EXPECT_EQ(std::count(visits.begin(), visits.end(), 1), static_cast<long>(n));
+        }
+
+        EXPECT_THROW(pool.ParallelFor(100,
+                                      [](size_t i)
+                                      {
+                                          if (i == 50)
+                                          {
+                                              throw std::runtime_error("error");
+                                          }
+                                      }),
+                     std::runtime_error);
+
+        // pool still usable after exception
+        std::vector<int> visits(10, 0);
+        pool.ParallelFor(visits.size(), [&visits](size_t i) { visits[i]++; });
+        EXPECT_EQ(std::count(visits.begin(), visits.end(), 1), 10);
+    }
+}
+
+TEST(Threading, TestMPSCQueue)
+{
+    SE_MPSCQueue<int> queue;
+    int               value = 0;
+
+    EXPECT_FALSE(queue.Pop(value));
+    queue.Push(1);
+    queue.Push(2);
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(queue.Pop(value));
+
+    // several producers, consuming meanwhile. Each producer's elements should come in order, none lost.
+    const int                n_producers = 4;
+    const int                n_items     = 20000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < n_producers; p++)
+    {
+        producers.emplace_back(
+            [&queue, p]()
+            {
+                for (int i = 0; i < n_items; i++)
+                {
+                    queue.Push(p * n_items + i);
+                }
+            });
+    }
+
+    std::vector<int> next(n_producers, 0);
+    int              n_popped = 0;
+    while (n_popped < n_producers * n_items)
+    {
+        if (queue.Pop(value))
+        {
+            int p = value / n_items;
+            ASSERT_EQ(value % n_items, next[static_cast<size_t>(p)]);
+            next[static_cast<size_t>(p)]++;
+            n_popped++;
+        }
+    }
+    for (auto& t : producers)
+    {
+        t.join();
+    }
+    EXPECT_FALSE(queue.Pop(value));
+
+    // elements left in the queue are released by the destructor
+    for (int i = 0; i < 10; i++)
+    {
+        queue.Push(i);
+    }
+}
+
+TEST(Threading, TestTimeSeries)
+{
+    SE_TimeSeries          series(1, 16, 3, 4);
+    SE_TimeSeries::Samples samples;
+    float                  time  = 0.0f;
+    float                  value = 0.0f;
+
+    EXPECT_FALSE(series.GetLatest(0, time, value));
+    EXPECT_EQ(series.Read(0, 0, -LARGE_NUMBERF, samples), 0u);
+
+    for (int i = 0; i < 100; i++)
+    {
+        float v = static_cast<float>(i);
+        series.Add(v, &v);
+    }
+    EXPECT_EQ(series.GetNumberOfSamples(), 100u);
+    EXPECT_TRUE(series.GetLatest(0, time, value));
+    EXPECT_EQ(time, 99.0f);
+    EXPECT_EQ(value, 99.0f);
+
+    // raw level keeps the latest 16 samples
+    ASSERT_EQ(series.Read(0, 0, -LARGE_NUMBERF, samples), 16u);
+    EXPECT_EQ(samples.time[0], 84.0f);
+    EXPECT_EQ(samples.min[15], 99.0f);
+    EXPECT_EQ(samples.max[15], 99.0f);
+
+    // buckets of 4 samples, the 16 latest ones
+    ASSERT_EQ(series.Read(1, 0, -LARGE_NUMBERF, samples), 16u);
+    EXPECT_EQ(samples.time[0], 36.0f);
+    EXPECT_EQ(samples.min[0], 36.0f);
+    EXPECT_EQ(samples.max[0], 39.0f);
+    EXPECT_EQ(samples.max[15], 99.0f);
+
+    // buckets of 16 samples, completed by the newer level 1 entry
+    ASSERT_EQ(series.Read(2, 0, -LARGE_NUMBERF, samples), 7u);
+    EXPECT_EQ(samples.time[0], 0.0f);
+    EXPECT_EQ(samples.max[0], 15.0f);
+    EXPECT_EQ(samples.time[6], 96.0f);
+    EXPECT_EQ(samples.min[6], 96.0f);
+
+    // incomplete buckets are filled in by raw samples
+    float v = 100.0f;
+    series.Add(v, &v);
+    ASSERT_EQ(series.Read(2, 0, -LARGE_NUMBERF, samples), 8u);
+    EXPECT_EQ(samples.time[7], 100.0f);
+    EXPECT_EQ(samples.max[7], 100.0f);
+
+    EXPECT_EQ(series.Read(0, 0, 90.0f, samples), 11u);
+    EXPECT_EQ(samples.time[0], 90.0f);
+    EXPECT_EQ(series.Read(3, 0, -LARGE_NUMBERF, samples), 0u);
+    EXPECT_EQ(series.Read(0, 1, -LARGE_NUMBERF, samples), 0u);
+
+    // raw samples don't reach back to time 0, level 1 is too dense for the range
+    EXPECT_EQ(series.SelectLevel(0.0f, 100.0f, 1000), 2u);
+    EXPECT_EQ(series.SelectLevel(90.0f, 100.0f, 1000), 0u);
+    EXPECT_EQ(series.SelectLevel(90.0f, 100.0f, 5), 1u);
+
+    // one writer, several readers. All channels carry time, in reverse for second one. Torn entries would break this.
+    SE_TimeSeries            series2(2, 256, 4, 4);
+    const int                n_samples = 200000;
+    std::atomic<bool>        done{false};
+    std::vector<std::thread> readers;
+    std::atomic<int>         n_errors{0};
+    for (unsigned int r = 0; r < 3; r++)
+    {
+        readers.emplace_back(
+            [&series2, &done, &n_errors, r]()
+            {
+                SE_TimeSeries::Samples s;
+                while (!done)
+                {
+                    for (unsigned int channel = 0; channel < 2; channel++)
+                    {
+                        series2.Read(r + 1, channel, -LARGE_NUMBERF, s);
+                        for (size_t i = 0; i < s.time.size(); i++)
+                        {
+                            float expected = channel == 0 ? s.min[i] : -s.max[i];
+                            if (expected != s.time[i] || s.min[i] > s.max[i] || (i > 0 && s.time[i] <= s.time[i - 1]))
+                            {
+                                n_errors++;
+                            }
+                        }
+                    }
+                }
+            });
+    }
+    for (int i = 0; i < n_samples; i++)
+    {
+        float values[2] = {static_cast<float>(i), static_cast<float>(-i)};
+        series2.Add(values[0], values);
+    }
+    done = true;
+    for (auto& t : readers)
+    {
+        t.join();
+    }
+    EXPECT_EQ(n_errors, 0);
+    EXPECT_EQ(series2.Read(0, 1, -LARGE_NUMBERF, samples), 256u);
+    EXPECT_EQ(samples.min.back(), static_cast<float>(-(n_samples - 1)));
+}
+
+#ifndef _WIN32
+TEST(SharedState, TestWriteAndRead)
+{
+    std::string          name = "/esmini_test_" + std::to_string(getpid());
+    SE_SharedStateWriter writer;
+    SE_SharedStateReader reader;
+    SE_SharedFrameCopy   copy;
+
+    ASSERT_EQ(writer.Open(name, 3, 64, 2), 0);
+    ASSERT_EQ(reader.Open(name), 0);
+    EXPECT_EQ(reader.GetHeader()->max_entities, 3u);
+    EXPECT_EQ(reader.CopyLatest(copy), -1);  // nothing published yet
+
+    // publish more frames than slots, the latest one is read
+    for (int frame = 0; frame < 5; frame++)
+    {
+        SE_SharedEntityState* entities = writer.BeginFrame(0.1 * frame);
+        for (int i = 0; i < 3; i++)
+        {
+            entities[i].id = i;
+            entities[i].x  = frame + 0.5 * i;
+            StrCopy(entities[i].name, ("obj" + std::to_string(i)).c_str(), SHARED_STATE_NAME_SIZE);
+        }
+        std::string osi = "osi" + std::to_string(frame);
+        writer.EndFrame(3, osi.c_str(), osi.size());
+    }
+
+    EXPECT_EQ(reader.GetFrameCount(), 5u);
+    ASSERT_EQ(reader.CopyLatest(copy), 0);
+    EXPECT_EQ(copy.frame, 4u);
+    EXPECT_NEAR(copy.time, 0.4, 1e-10);
+    EXPECT_EQ(copy.flags, 0u);
+    ASSERT_EQ(copy.entities.size(), 3u);
+    EXPECT_EQ(copy.entities[2].id, 2);
+    EXPECT_NEAR(copy.entities[2].x, 5.0, 1e-10);
+    EXPECT_STREQ(copy.entities[1].name, "obj1");
+    EXPECT_EQ(std::string(copy.osi.begin(), copy.osi.end()), "osi4");
+
+    // zero copy read
+    double x = 0.0;
+    EXPECT_EQ(reader.ReadLatest([&x](const SE_SharedFrame& frame) { x = frame.entities[1].x; }), 0);
+    EXPECT_NEAR(x, 4.5, 1e-10);
+
+    // exceeding capacity is flagged
+    writer.BeginFrame(0.5);
+    writer.EndFrame(4, std::string(65, 'x').c_str(), 65);
+    ASSERT_EQ(reader.CopyLatest(copy), 0);
+    EXPECT_EQ(copy.entities.size(), 3u);
+    EXPECT_EQ(copy.osi.size(), 0u);
+    EXPECT_EQ(copy.flags, static_cast<uint32_t>(SHARED_STATE_FLAG_ENTITIES_TRUNCATED | SHARED_STATE_FLAG_OSI_TRUNCATED));
+
+    // the object is removed by the writer, while the reader keeps its mapping
+    writer.Close();
+    EXPECT_EQ(reader.CopyLatest(copy), 0);
+    EXPECT_EQ(copy.frame, 5u);
+    SE_SharedStateReader reader2;
+    EXPECT_EQ(reader2.Open(name), -1);
+}
+
+TEST(SharedState, TestConcurrentReadIsConsistent)
+{
+    std::string          name = "/esmini_test_concurrent_" + std::to_string(getpid());
+    SE_SharedStateWriter writer;
+    SE_SharedStateReader reader;
+    const uint32_t       n_entities = 100;
+    const int            n_frames   = 20000;
+
+    ASSERT_EQ(writer.Open(name, n_entities, 0, 2), 0);
+    ASSERT_EQ(reader.Open(name), 0);
+
+    // all entities of a frame carry the frame number, a torn read would mix frames
+    std::thread writer_thread(
+        [&]()
+        {
+            for (int frame = 0; frame < n_frames; frame++)
+            {
+                SE_SharedEntityState* entities = writer.BeginFrame(frame);
+                for (uint32_t i = 0; i < n_entities; i++)
+                {
+                    entities[i].x = frame;
+                }
+                writer.EndFrame(n_entities);
+            }
+        });
+
+    SE_SharedFrameCopy copy;
+    int                n_reads = 0;
+    while (reader.GetFrameCount() < n_frames)
+    {
+        if (reader.CopyLatest(copy) == 0)
+        {
+            n_reads++;
+            ASSERT_EQ(copy.entities.size(), n_entities);
+            for (auto& e : copy.entities)
+            {
+                ASSERT_EQ(e.x, copy.time);
+            }
+        }
+    }
+    writer_thread.join();
+
+    ASSERT_EQ(reader.CopyLatest(copy), 0);
+    EXPECT_EQ(copy.frame, static_cast<uint64_t>(n_frames - 1));
+    EXPECT_GT(n_reads, 0);
+}
+#endif  // _WIN32
+
 int main(int argc, char** argv)
 {
     // testing::GTEST_FLAG(filter) = "*TestIsPointWithinSectorBetweenTwoLines*";
@@ -258,6 +258,75 @@ TEST_F(FollowRouteTestMedium, FindPathTimeMedium)
     ASSERT_EQ(path.back().road->GetId(), 209);
 }
 
+TEST_F(FollowRouteTestMedium, PathCacheAndRepair)
+{
+    ASSERT_NE(Position::GetOpenDrive(), nullptr);
+    ASSERT_EQ(Position::GetOpenDrive()->GetOpenDriveFilename(), "../../../resources/xodr/multi_intersections.xodr");
+
+    Position start(217, -1, 50, 0);
+    start.SetHeadingRelativeRoadDirection(0);
+    Position target(275, -1, 50, 0);
+    target.SetRouteStrategy(Position::RouteStrategy::SHORTEST);
+
+    LaneIndependentRouter::ClearPathCache();
+    LaneIndependentRouter router(Position::GetOpenDrive());
+    std::vector<Node>     path = router.CalculatePath(start, target);
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(LaneIndependentRouter::GetPathCacheSize(), 1);
+
+    // Another router, from another s on the same road and lane, gets the cached path with updated weights
+    Position start2(217, -1, 30, 0);
+    start2.SetHeadingRelativeRoadDirection(0);
+    LaneIndependentRouter router2(Position::GetOpenDrive());
+    std::vector<Node>     path2 = router2.CalculatePath(start2, target);
+    EXPECT_EQ(LaneIndependentRouter::GetPathCacheSize(), 1);
+    ASSERT_EQ(path2.size(), path.size());
+    for (size_t i = 0; i < path.size(); i++)
+    {
+        EXPECT_EQ(path2[i].road, path[i].road);
+        EXPECT_EQ(path2[i].currentLaneId, path[i].currentLaneId);
+        EXPECT_NEAR(path2[i].weight, path[i].weight + 20.0, 1e-6);
+        EXPECT_EQ(path2[i].previous, i > 0 ? &path2[i - 1] : nullptr);
+    }
+
+    // Same result as from scratch
+    LaneIndependentRouter::ClearPathCache();
+    std::vector<Node> path3 = router2.CalculatePath(start2, target);
+    ASSERT_EQ(path3.size(), path2.size());
+    EXPECT_NEAR(path3.back().weight, path2.back().weight, 1e-6);
+
+    // Repair from positions off the path gives as good path as a new search
+    int n_repaired = 0;
+    for (unsigned int i = 0; i < Position::GetOpenDrive()->GetNumOfRoads(); i++)
+    {
+        Road *road = Position::GetOpenDrive()->GetRoadByIdx(i);
+        if (road->GetId() == target.GetTrackId() || road->GetJunction() != ID_UNDEFINED)
+        {
+            continue;
+        }
+        for (int lane_id : {-1, 1})
+        {
+            Position deviated(road->GetId(), lane_id, road->GetLength() / 2, 0);
+            deviated.SetHeadingRelativeRoadDirection(lane_id < 0 ? 0.0 : M_PI);
+
+            LaneIndependentRouter router3(Position::GetOpenDrive());
+            std::vector<Node>     expected = router3.CalculatePath(deviated, target);
+
+            router.CalculatePath(start, target);
+            std::vector<Node> repaired = router.RepairPath(deviated, target);
+            ASSERT_EQ(repaired.empty(), expected.empty());
+            if (!repaired.empty())
+            {
+                EXPECT_EQ(repaired.front().road, road);
+                EXPECT_EQ(repaired.back().road, path.back().road);
+                EXPECT_NEAR(repaired.back().weight, expected.back().weight, 1e-6);
+                n_repaired++;
+            }
+        }
+    }
+    EXPECT_GT(n_repaired, 10);
+}
+
 TEST_F(FollowRouteTestMedium, CreateWaypointMedium)
 {
     ASSERT_NE(Position::GetOpenDrive(), nullptr);
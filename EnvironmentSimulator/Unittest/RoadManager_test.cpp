@@ -1645,6 +1645,79 @@ TEST(TrajectoryTest, PolyLineBase_YawInterpolation)
     EXPECT_NEAR(v.h, 0.958407, 1e-5);
 }
 
+TEST(TrajectoryTest, PolyLineBase_IndexedQueries)
+{
+    PolyLineBase pline;
+    TrajVertex   v = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, ID_UNDEFINED, 0.0, 0.0, 0.0, 0.0, 0};
+    idx_t        index;
+
+    // brute force closest distance to the polyline
+    auto closest_dist = [&pline](double x, double y)
+    {
+        double dist_min = LARGE_NUMBER;
+        for (unsigned int i = 0; i + 1 < pline.GetNumberOfVertices(); i++)
+        {
+            TrajVertex& v0 = pline.vertex_[i];
+            TrajVertex& v1 = pline.vertex_[i + 1];
+            double      dx = v1.x - v0.x;
+            double      dy = v1.y - v0.y;
+            double      a  = CLAMP(((x - v0.x) * dx + (y - v0.y) * dy) / (dx * dx + dy * dy), 0.0, 1.0);
+            dist_min       = MIN(dist_min, PointDistance2D(x, y, v0.x + a * dx, v0.y + a * dy));
+        }
+        return dist_min;
+    };
+
+    // spiral of 10 laps, added in two steps to check that the segment index is extended
+    for (int i = 0; i < 20000; i++)
+    {
+        if (i == 5000)
+        {
+            EXPECT_EQ(pline.FindClosestPoint(0.0, 0.0, v, index), 0);
+            EXPECT_EQ(index, 0);
+        }
+        double a = 2 * M_PI * i / 2000.0;
+        double r = 10.0 + 5.0 * i / 2000.0;
+        pline.AddVertex({std::nan(""), r * cos(a), r * sin(a), 0.0, 0.0, 0.0, 0.0, ID_UNDEFINED, 0.1 * i, 0.0, 0.0, 0.0, 0});
+    }
+
+    double points[][2] = {{0.0, 0.0}, {23.1, -4.0}, {-61.7, 3.3}, {40.0, 40.0}, {200.0, -150.0}};
+    for (auto& p : points)
+    {
+        ASSERT_EQ(pline.FindClosestPoint(p[0], p[1], v, index), 0);
+        EXPECT_NEAR(PointDistance2D(p[0], p[1], v.x, v.y), closest_dist(p[0], p[1]), 1e-6);
+    }
+
+    // global search from a start index beyond the end, e.g. after trail reset
+    ASSERT_EQ(pline.FindClosestPoint(59.9, 0.0, v, index, 100000), 0);
+    EXPECT_NEAR(PointDistance2D(59.9, 0.0, v.x, v.y), closest_dist(59.9, 0.0), 1e-6);
+    EXPECT_EQ(index, 19998);
+
+    // evaluate far from start index, in both directions
+    double s = pline.vertex_[12345].s + 0.3 * (pline.vertex_[12346].s - pline.vertex_[12345].s);
+    EXPECT_EQ(pline.Evaluate(s, v, 10), 12345);
+    EXPECT_NEAR(v.s, s, 1e-10);
+    EXPECT_EQ(pline.Evaluate(s, v, 19000), 12345);
+    EXPECT_EQ(pline.Evaluate(pline.vertex_[100].s, v, 15000), 99);
+
+    // lookup by time, in both directions
+    EXPECT_EQ(pline.FindPointAtTime(1234.55, v, index), 0);
+    EXPECT_EQ(index, 12345);
+    EXPECT_NEAR(v.time, 1234.55, 1e-6);
+    index = 19000;
+    EXPECT_EQ(pline.FindPointAtTime(10.05, v, index), 0);
+    EXPECT_EQ(index, 100);
+    EXPECT_NEAR(v.time, 10.05, 1e-6);
+
+    // index is dropped on reset
+    pline.Reset(true);
+    pline.AddVertex({std::nan(""), 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, ID_UNDEFINED, 0.0, 0.0, 0.0, 0.0, 0});
+    EXPECT_EQ(pline.FindClosestPoint(1.0, 1.0, v, index), -1);
+    pline.AddVertex({std::nan(""), 10.0, 0.0, 0.0, 0.0, 0.0, 0.0, ID_UNDEFINED, 1.0, 0.0, 0.0, 0.0, 0});
+    ASSERT_EQ(pline.FindClosestPoint(3.0, 1.0, v, index), 0);
+    EXPECT_NEAR(v.x, 3.0, 1e-10);
+    EXPECT_NEAR(v.y, 0.0, 1e-10);
+}
+
 TEST(TrajectoryTest, PolyLineShape_Filter)
 {
     PolyLineShape shape;
@@ -2108,6 +2181,56 @@ TEST(DeltaTest, TestDelta)
     EXPECT_EQ(pos_pivot.Delta(&pos_target, pos_diff), false);
 }
 
+TEST(DeltaTest, TestReusedPathWorkspaces)
+{
+    Position::GetOpenDrive()->LoadOpenDriveFile("../../../resources/xodr/fabriksgatan.xodr");
+
+    Position pos_a = Position(0, 1, 5.0, 0.0);
+    pos_a.SetHeadingRelative(M_PI);
+    Position pos_b = Position(2, 1, 250.0, 0.0);
+    Position pos_c = Position(3, -1, 100.0, 0.0);
+
+    double dist_b = 0.0;
+    double dist_c = 0.0;
+
+    // Two paths alive at the same time must not share search state
+    RoadPath path_b(&pos_a, &pos_b);
+    RoadPath path_c(&pos_a, &pos_c);
+    EXPECT_EQ(path_b.Calculate(dist_b), 0);
+    EXPECT_EQ(path_c.Calculate(dist_c), 0);
+    EXPECT_NEAR(fabs(dist_b), 74.56580, 1E-5);
+    EXPECT_NEAR(fabs(dist_c), 34.31779, 1E-5);
+    ASSERT_GT(path_b.visited_.size(), 0);
+    EXPECT_EQ(path_b.visited_.back()->fromRoad->GetId(), 9);
+
+    // Repeated searches reuse released workspaces and give same result
+    for (int i = 0; i < 3; i++)
+    {
+        PositionDiff diff;
+        EXPECT_EQ(pos_a.Delta(&pos_c, diff), true);
+        EXPECT_NEAR(diff.ds, 34.31779, 1E-5);
+    }
+
+    // Link indices restart with each road network, so the per link search state doesn't grow with reloads
+    auto max_link_idx = []()
+    {
+        idx_t max_idx = 0;
+        for (unsigned int i = 0; i < Position::GetOpenDrive()->GetNumOfRoads(); i++)
+        {
+            for (LinkType type : {LinkType::SUCCESSOR, LinkType::PREDECESSOR})
+            {
+                RoadLink* link = Position::GetOpenDrive()->GetRoadByIdx(i)->GetLink(type);
+                max_idx        = link != nullptr ? MAX(max_idx, link->GetIdx()) : max_idx;
+            }
+        }
+        return max_idx;
+    };
+    idx_t max_idx = max_link_idx();
+    EXPECT_LT(max_idx, 2 * Position::GetOpenDrive()->GetNumOfRoads());
+    Position::GetOpenDrive()->LoadOpenDriveFile("../../../resources/xodr/fabriksgatan.xodr");
+    EXPECT_EQ(max_link_idx(), max_idx);
+}
+
 TEST(PositionTest, TestJunctionId)
 {
     Position::GetOpenDrive()->LoadOpenDriveFile("../../../resources/xodr/fabriksgatan.xodr");
@@ -4374,6 +4497,153 @@ TEST(LaneOffset, TestGetClosestLaneIdxWithLaneOffsetAndLocKOnLane)
     EXPECT_EQ(pos.GetLaneId(), -2);
 }
 
+TEST(PiecewiseLookup, TestGetPieceIdxByS)
+{
+    std::vector<double> starts = {0.0, 10.0, 20.0, 50.0};
+    auto                get_s  = [](double start) { return start; };
+
+    EXPECT_EQ(GetPieceIdxByS(std::vector<double>(), 5.0, get_s), IDX_UNDEFINED);
+
+    // plain binary search
+    EXPECT_EQ(GetPieceIdxByS(starts, -1.0, get_s), 0);
+    EXPECT_EQ(GetPieceIdxByS(starts, 0.0, get_s), 0);
+    EXPECT_EQ(GetPieceIdxByS(starts, 9.9, get_s), 0);
+    EXPECT_EQ(GetPieceIdxByS(starts, 10.0, get_s), 1);
+    EXPECT_EQ(GetPieceIdxByS(starts, 35.0, get_s), 2);
+    EXPECT_EQ(GetPieceIdxByS(starts, 50.0, get_s), 3);
+    EXPECT_EQ(GetPieceIdxByS(starts, 1000.0, get_s), 3);
+
+    // result must not depend on the hint, whether close or far away or invalid
+    for (idx_t hint : {0u, 1u, 2u, 3u, 4u, IDX_UNDEFINED})
+    {
+        EXPECT_EQ(GetPieceIdxByS(starts, 5.0, get_s, hint), 0);
+        EXPECT_EQ(GetPieceIdxByS(starts, 15.0, get_s, hint), 1);
+        EXPECT_EQ(GetPieceIdxByS(starts, 20.0, get_s, hint), 2);
+        EXPECT_EQ(GetPieceIdxByS(starts, 60.0, get_s, hint), 3);
+    }
+}
+
+TEST(PiecewiseLookup, TestLaneOffsetAndElevationIndex)
+{
+    for (const char* filename :
+         {"../../../EnvironmentSimulator/Unittest/xodr/lane_offset_intersection.xodr", "../../../resources/xodr/curves_elevation.xodr"})
+    {
+        ASSERT_EQ(Position::LoadOpenDrive(filename), true);
+        OpenDrive* odr = Position::GetOpenDrive();
+
+        for (unsigned int i = 0; i < odr->GetNumOfRoads(); i++)
+        {
+            Road* road = odr->GetRoadByIdx(i);
+
+            idx_t lane_offset_idx = IDX_UNDEFINED;
+            idx_t elevation_idx   = 0;
+            idx_t elevation_idx2  = 0;
+            idx_t ls_idx          = 0;
+            for (double s = 0.0; s < road->GetLength(); s += 7.3)
+            {
+                // cursor based lookups must give same result as lookups without history
+                EXPECT_DOUBLE_EQ(road->GetLaneOffset(s, &lane_offset_idx), road->GetLaneOffset(s));
+                EXPECT_DOUBLE_EQ(road->GetLaneOffsetPrim(s, &lane_offset_idx), road->GetLaneOffsetPrim(s));
+
+                ls_idx = road->GetLaneSectionIdxByS(s, ls_idx);
+                EXPECT_EQ(ls_idx, road->GetLaneSectionIdxByS(s));
+
+                double z[2], z_prim[2], z_prim_prim[2], pitch[2];
+                road->GetZAndPitchByS(s, &z[0], &z_prim[0], &z_prim_prim[0], &pitch[0], &elevation_idx);
+                elevation_idx2 = 0;
+                road->GetZAndPitchByS(s, &z[1], &z_prim[1], &z_prim_prim[1], &pitch[1], &elevation_idx2);
+                EXPECT_EQ(elevation_idx, elevation_idx2);
+                EXPECT_DOUBLE_EQ(z[0], z[1]);
+            }
+        }
+    }
+}
+
+static void CollectOSIPoints(OpenDrive* odr, std::vector<double>& values, std::vector<id_t>& ids)
+{
+    auto add_points = [&values](OSIPoints* osi_points)
+    {
+        for (auto& p : osi_points->GetPoints())
+        {
+            values.insert(values.end(), {p.s, p.x, p.y, p.z, p.h, p.endpoint ? 1.0 : 0.0});
+        }
+    };
+
+    for (unsigned int i = 0; i < odr->GetNumOfRoads(); i++)
+    {
+        Road* road = odr->GetRoadByIdx(i);
+        for (unsigned int j = 0; j < road->GetNumberOfLaneSections(); j++)
+        {
+            LaneSection* lsec = road->GetLaneSectionByIdx(j);
+            add_points(&lsec->GetRefLineOSIPoints());
+            for (unsigned int k = 0; k < lsec->GetNumberOfLanes(); k++)
+            {
+                Lane* lane = lsec->GetLaneByIdx(k);
+                ids.push_back(lane->GetGlobalId());
+                add_points(lane->GetOSIPoints());
+                if (lane->GetLaneBoundary() != nullptr)
+                {
+                    ids.push_back(lane->GetLaneBoundaryGlobalId());
+                    add_points(lane->GetLaneBoundary()->GetOSIPoints());
+                }
+                for (unsigned int m = 0; m < lane->GetNumberOfRoadMarks(); m++)
+                {
+                    LaneRoadMark* road_mark = lane->GetLaneRoadMarkByIdx(m);
+                    for (unsigned int n = 0; n < road_mark->GetNumberOfRoadMarkTypes(); n++)
+                    {
+                        LaneRoadMarkType* type = road_mark->GetLaneRoadMarkTypeByIdx(n);
+                        for (unsigned int q = 0; q < type->GetNumberOfRoadMarkTypeLines(); q++)
+                        {
+                            add_points(type->GetLaneRoadMarkTypeLineByIdx(q)->GetOSIPoints());
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(OSIPoints, TestParallelAndLazyCreation)
+{
+    const char* filename = "../../../resources/xodr/fabriksgatan.xodr";
+
+    // reference: single thread
+    SE_Env::Inst().GetOptions().SetOptionValue("osi_point_threads", "1");
+    ASSERT_EQ(Position::LoadOpenDrive(filename), true);
+    std::vector<double> values_ref;
+    std::vector<id_t>   ids_ref;
+    CollectOSIPoints(Position::GetOpenDrive(), values_ref, ids_ref);
+    ASSERT_GT(values_ref.size(), 1000);
+
+    // multiple threads must give identical points and global ids
+    SE_Env::Inst().GetOptions().SetOptionValue("osi_point_threads", "4");
+    ASSERT_EQ(Position::LoadOpenDrive(filename), true);
+    std::vector<double> values;
+    std::vector<id_t>   ids;
+    CollectOSIPoints(Position::GetOpenDrive(), values, ids);
+    EXPECT_EQ(values, values_ref);
+    EXPECT_EQ(ids, ids_ref);
+
+    // lazy road marks, created on request
+    SE_Env::Inst().GetOptions().SetOptionValue("osi_lazy_roadmarks", "");
+    ASSERT_EQ(Position::LoadOpenDrive(filename), true);
+    OpenDrive*   odr  = Position::GetOpenDrive();
+    LaneSection* lsec = odr->GetRoadById(0)->GetLaneSectionByIdx(0);
+    EXPECT_EQ(lsec->GetLaneById(0)->GetLaneRoadMarkByIdx(0)->GetLaneRoadMarkTypeByIdx(0)->GetLaneRoadMarkTypeLineByIdx(0)->GetOSIPoints()->GetNumOfOSIPoints(),
+              0);
+    odr->EnsureRoadMarkOSIPoints(odr->GetRoadById(0));
+    EXPECT_GT(lsec->GetLaneById(0)->GetLaneRoadMarkByIdx(0)->GetLaneRoadMarkTypeByIdx(0)->GetLaneRoadMarkTypeLineByIdx(0)->GetOSIPoints()->GetNumOfOSIPoints(),
+              0);
+    odr->EnsureRoadMarkOSIPoints();
+    values.clear();
+    ids.clear();
+    CollectOSIPoints(odr, values, ids);
+    EXPECT_EQ(values, values_ref);
+    EXPECT_EQ(ids, ids_ref);
+
+    SE_Env::Inst().GetOptions().Reset();  // clean up
+}
+
 int main(int argc, char **argv)
 {
     // testing::GTEST_FLAG(filter) = "*RoadWidthAllLanes*";
@@ -4396,3 +4666,98 @@ int main(int argc, char **argv)
 
     return RUN_ALL_TESTS();
 }
+
+TEST(RoadFeatures, TestFeaturesAhead)
+{
+    ASSERT_EQ(Position::LoadOpenDrive("../../../EnvironmentSimulator/Unittest/xodr/straight_500m_signs.xodr"), true);
+
+    RoadFeatureCursor cursor;
+    Position          pos(1, 50.0, 0.0);
+    pos.SetHeadingRelative(0.0);
+
+    // two signals facing traffic along the road
+    ASSERT_EQ(cursor.Update(pos, 100.0, RoadFeature::SIGNAL), 2);
+    EXPECT_EQ(cursor.GetHit(0)->id, 1);
+    EXPECT_EQ(cursor.GetHit(1)->id, 2);
+    EXPECT_NEAR(cursor.GetHit(0)->distance, 50.0, 1E-5);
+    EXPECT_EQ(cursor.GetHit(0)->direction, 1);
+    EXPECT_EQ(cursor.GetHit(2), nullptr);
+
+    // all features, in order of distance
+    ASSERT_EQ(cursor.Update(pos, 1000.0), 17);
+    for (unsigned int i = 1; i < cursor.GetNumberOfHits(); i++)
+    {
+        EXPECT_GE(cursor.GetHit(i)->distance, cursor.GetHit(i - 1)->distance);
+    }
+    EXPECT_EQ(cursor.GetHit(2)->type, RoadFeature::OBJECT);
+    EXPECT_EQ(cursor.GetHit(4)->type, RoadFeature::OBJECT);
+    EXPECT_NEAR(cursor.GetHit(4)->distance, 60.0, 1E-5);
+    EXPECT_EQ(cursor.GetHit(5)->type, RoadFeature::SPEED_LIMIT);
+    EXPECT_NEAR(cursor.GetHit(5)->distance, 175.0, 1E-5);
+    EXPECT_NEAR(cursor.GetHit(5)->value, 8.9408, 1E-5);  // 20 mph
+    EXPECT_NEAR(cursor.GetHit(16)->distance, 450.0, 1E-5);
+    EXPECT_NEAR(cursor.GetHit(16)->value, 36.11111, 1E-5);  // 130 km/h
+
+    // limited number of hits, and lookahead distance
+    ASSERT_EQ(cursor.Update(pos, 1000.0, RoadFeature::SPEED_LIMIT, 2), 2);
+    EXPECT_NEAR(cursor.GetHit(1)->distance, 200.0, 1E-5);
+    EXPECT_EQ(cursor.Update(pos, 199.0, RoadFeature::SPEED_LIMIT), 1);
+
+    // moving on, features passed are not reported. The signal at 110 faces opposite traffic, but the object is valid
+    pos.SetTrackPos(1, 105.0, 0.0);
+    ASSERT_EQ(cursor.Update(pos, 100.0, RoadFeature::SIGNAL | RoadFeature::OBJECT), 1);
+    EXPECT_EQ(cursor.GetHit(0)->type, RoadFeature::OBJECT);
+    EXPECT_EQ(cursor.GetHit(0)->id, 3);
+    EXPECT_NEAR(cursor.GetHit(0)->distance, 5.0, 1E-5);
+
+    // turning around, only the signal facing opposite traffic is reported
+    pos.SetTrackPos(1, 150.0, 0.0);
+    pos.SetHeadingRelative(M_PI);
+    ASSERT_EQ(cursor.Update(pos, 1000.0), 1);
+    EXPECT_EQ(cursor.GetHit(0)->type, RoadFeature::SIGNAL);
+    EXPECT_EQ(cursor.GetHit(0)->id, 3);
+    EXPECT_EQ(cursor.GetHit(0)->direction, -1);
+    EXPECT_NEAR(cursor.GetHit(0)->distance, 40.0, 1E-5);
+
+    // two driving lanes split into one lane each through the junction, which way depends on the route
+    ASSERT_EQ(Position::LoadOpenDrive("../../../EnvironmentSimulator/Unittest/xodr/highway_split.xodr"), true);
+
+    // roads ahead of the previous road network are dropped without explicit reset
+    pos.SetLanePos(0, -1, 50.0, 0.0);
+    pos.SetHeadingRelative(0.0);
+    EXPECT_GE(cursor.Update(pos, 1000.0), 0);
+    for (unsigned int i = 0; i < cursor.GetNumberOfHits(); i++)
+    {
+        EXPECT_NE(Position::GetOpenDrive()->GetRoadById(cursor.GetHit(i)->road_id), nullptr);
+    }
+
+    for (id_t road_id : {0u, 1u, 2u})
+    {
+        int lane_id = road_id == 2 ? -2 : -1;
+        cursor.Reset();
+        pos.SetLanePos(0, lane_id, 50.0, 0.0);
+        pos.SetHeadingRelative(0.0);
+
+        Route route;
+        if (road_id > 0)
+        {
+            Position wp_start(0, lane_id, 50.0, 0.0);
+            Position wp_end(road_id, -1, 50.0, 0.0);
+            route.AddWaypoint(wp_start);
+            route.AddWaypoint(wp_end);
+            ASSERT_EQ(pos.SetRoute(&route), 0);
+        }
+
+        ASSERT_EQ(cursor.Update(pos, 300.0), 1);
+        EXPECT_EQ(cursor.GetHit(0)->type, RoadFeature::LANE_COUNT);
+        EXPECT_EQ(cursor.GetHit(0)->road_id, road_id == 2 ? 4 : 3);
+        EXPECT_NEAR(cursor.GetHit(0)->distance, 50.0, 1E-5);
+        EXPECT_NEAR(cursor.GetHit(0)->value, 1.0, 1E-5);
+
+        pos.SetLanePos(0, lane_id, 90.0, 0.0);
+        ASSERT_EQ(cursor.Update(pos, 300.0), 1);
+        EXPECT_NEAR(cursor.GetHit(0)->distance, 10.0, 1E-5);
+
+        pos.SetRoute(nullptr);
+    }
+}
@@ -8,6 +8,8 @@
 #include "osi_version.pb.h"
 #endif  // _USE_OSI
 #include "Replay.hpp"
+#include "PacketHandler.hpp"
+#include "SafetyMetrics.hpp"
 #include "CommonMini.hpp"
 #include "esminiLib.hpp"
 #include "RoadManager.hpp"
@@ -1594,6 +1596,41 @@ TEST(GroundTruthTests, check_GroundTruth_including_init_state)
     fclose(file);
 }
 
+TEST(GroundTruthTests, check_static_and_dynamic_parts)
+{
+    ASSERT_EQ(SE_Init("../../../resources/xosc/cut-in_simple.xosc", 0, 0, 0, 0), 0);
+    SE_SetOSIStaticReportMode(SE_OSIStaticReportMode::API);
+
+    int first_revision = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        int         revision   = 0;
+        const auto* dynamic_gt = reinterpret_cast<const osi3::GroundTruth*>(SE_GetOSIDynamicGroundTruthRaw());
+        const auto* static_gt  = reinterpret_cast<const osi3::GroundTruth*>(SE_GetOSIStaticGroundTruthRaw(&revision));
+        ASSERT_NE(dynamic_gt, nullptr);
+        ASSERT_NE(static_gt, nullptr);
+
+        // no misc objects, static data should be untouched
+        if (i == 0)
+        {
+            first_revision = revision;
+        }
+        EXPECT_EQ(revision, first_revision);
+
+        // concatenated serializations should parse into the combined ground truth
+        osi3::GroundTruth gt;
+        ASSERT_TRUE(gt.ParseFromString(dynamic_gt->SerializeAsString() + static_gt->SerializeAsString()));
+        const auto* combined_gt = reinterpret_cast<const osi3::GroundTruth*>(SE_GetOSIGroundTruthRaw());
+        EXPECT_EQ(gt.moving_object_size(), 2);
+        EXPECT_GT(gt.lane_size(), 0);
+        EXPECT_EQ(gt.SerializeAsString(), combined_gt->SerializeAsString());
+
+        SE_StepDT(0.01f);
+    }
+
+    SE_Close();
+}
+
 TEST(GroundTruthTests, check_frequency_implicit)
 {
     const osi3::GroundTruth* osi_gt_ptr;
@@ -5888,6 +5925,387 @@ INSTANTIATE_TEST_SUITE_P(
     testing::Values(std::make_tuple("position", 71.0, -6.0, 64, 0.0445, 79.9937, -5.7766, 8, 0.1624, 84.8936, -4.8236, 2, 0.0118),
                     std::make_tuple("time", 60.9999, -5.994, 64, 0.2758, 65.9984, -5.8872, 8, 0.1624, 70.9764, -5.4374, 2, -0.0157)));
 
+static void RunAndRecordStates(int n_steps, std::vector<SE_ScenarioObjectState>& states)
+{
+    states.clear();
+    for (int i = 0; i < n_steps; i++)
+    {
+        SE_StepDT(0.05f);
+        for (int j = 0; j < SE_GetNumberOfObjects(); j++)
+        {
+            SE_ScenarioObjectState state;
+            SE_GetObjectState(SE_GetId(j), &state);
+            states.push_back(state);
+        }
+    }
+}
+
+TEST(Checkpoint, RestoreIsDeterministic)
+{
+    for (const char* filename : {"../../../resources/xosc/cut-in.xosc", "../../../resources/xosc/cut-in_sloppy.xosc"})
+    {
+        SE_SetOption("disable_stdout");
+        ASSERT_EQ(SE_Init(filename, 0, 0, 0, 0), 0);
+
+        while (SE_GetSimulationTime() < 2.0f - SMALL_NUMBERF)
+        {
+            SE_StepDT(0.05f);
+        }
+
+        int handle = SE_CreateCheckpoint();
+        ASSERT_GE(handle, 0);
+        double checkpoint_time = SE_GetSimulationTimeDouble();
+
+        std::vector<SE_ScenarioObjectState> states_first;
+        std::vector<SE_ScenarioObjectState> states_second;
+        RunAndRecordStates(200, states_first);
+
+        // restore twice, both runs should reproduce the original one exactly
+        for (int k = 0; k < 2; k++)
+        {
+            ASSERT_EQ(SE_RestoreCheckpoint(handle), 0);
+            EXPECT_EQ(SE_GetSimulationTimeDouble(), checkpoint_time);
+            RunAndRecordStates(200, states_second);
+
+            ASSERT_EQ(states_first.size(), states_second.size());
+            for (size_t i = 0; i < states_first.size(); i++)
+            {
+                EXPECT_EQ(states_first[i].x, states_second[i].x);
+                EXPECT_EQ(states_first[i].y, states_second[i].y);
+                EXPECT_EQ(states_first[i].h, states_second[i].h);
+                EXPECT_EQ(states_first[i].speed, states_second[i].speed);
+                EXPECT_EQ(states_first[i].laneId, states_second[i].laneId);
+                EXPECT_EQ(states_first[i].timestamp, states_second[i].timestamp);
+            }
+        }
+
+        // changed set of entities is not supported, expect state to be kept
+        double time = SE_GetSimulationTimeDouble();
+        EXPECT_GE(SE_AddObject("extra", 0, 0, 0, 0, nullptr), 0);
+        EXPECT_EQ(SE_RestoreCheckpoint(handle), -1);
+        EXPECT_EQ(SE_GetSimulationTimeDouble(), time);
+
+        EXPECT_EQ(SE_DeleteCheckpoint(handle), 0);
+        EXPECT_EQ(SE_DeleteCheckpoint(handle), -1);
+        EXPECT_EQ(SE_RestoreCheckpoint(handle), -1);
+
+        SE_Close();
+    }
+}
+
+static void RunBatchAndRecordStates(int n_steps, int max_objects, std::vector<SE_ScenarioObjectState>& states)
+{
+    int                                 n_instances = SE_BatchGetNumberOfInstances();
+    std::vector<SE_ScenarioObjectState> frame(static_cast<size_t>(n_instances * max_objects));
+    std::vector<int>                    n_objects(static_cast<size_t>(n_instances));
+
+    states.clear();
+    for (int i = 0; i < n_steps; i++)
+    {
+        ASSERT_EQ(SE_BatchStepDT(0.05f), 0);
+        ASSERT_EQ(SE_BatchGetObjectStates(max_objects, frame.data(), n_objects.data()), 0);
+        for (int j = 0; j < n_instances; j++)
+        {
+            ASSERT_EQ(n_objects[static_cast<size_t>(j)], max_objects);
+        }
+        states.insert(states.end(), frame.begin(), frame.end());
+    }
+}
+
+TEST(Batch, StepAndResetInstances)
+{
+    const int max_objects = 2;
+    const int n_steps     = 100;
+
+    SE_SetOption("disable_stdout");
+    SE_SetSeed(5);
+    ASSERT_EQ(SE_BatchInit("../../../resources/xosc/cut-in_sloppy.xosc", 4, 2, 0), 0);
+    ASSERT_EQ(SE_BatchGetNumberOfInstances(), 4);
+
+    std::vector<SE_ScenarioObjectState> states_first;
+    std::vector<SE_ScenarioObjectState> states_second;
+    RunBatchAndRecordStates(n_steps, max_objects, states_first);
+
+    // instances have individual random generators, the sloppy driver of the second object should make them diverge
+    const SE_ScenarioObjectState* last = &states_first[static_cast<size_t>((n_steps - 1) * 4 * max_objects)];
+    EXPECT_NE(last[1].speed, last[max_objects + 1].speed);
+
+    // reset only instance 2, then it should repeat its first run while the others continue
+    std::vector<int> quit_flags(4, -1);
+    ASSERT_EQ(SE_BatchGetQuitFlags(quit_flags.data()), 0);
+    EXPECT_EQ(quit_flags, std::vector<int>({0, 0, 0, 0}));
+    EXPECT_EQ(SE_BatchResetInstance(4), -1);
+    ASSERT_EQ(SE_BatchResetInstance(2), 0);
+    RunBatchAndRecordStates(n_steps, max_objects, states_second);
+
+    ASSERT_EQ(states_first.size(), states_second.size());
+    for (size_t i = 0; i < states_first.size(); i++)
+    {
+        size_t instance = (i / max_objects) % 4;
+        if (instance == 2)
+        {
+            EXPECT_EQ(states_first[i].x, states_second[i].x);
+            EXPECT_EQ(states_first[i].y, states_second[i].y);
+            EXPECT_EQ(states_first[i].speed, states_second[i].speed);
+            EXPECT_EQ(states_first[i].timestamp, states_second[i].timestamp);
+        }
+        else if (i % (4 * max_objects) == 0)
+        {
+            EXPECT_GT(states_second[i].timestamp, states_first[i].timestamp);
+        }
+    }
+
+    // result should not depend on the number of threads
+    ASSERT_EQ(SE_BatchInit("../../../resources/xosc/cut-in_sloppy.xosc", 4, 1, 0), 0);
+    RunBatchAndRecordStates(n_steps, max_objects, states_second);
+    ASSERT_EQ(states_first.size(), states_second.size());
+    for (size_t i = 0; i < states_first.size(); i++)
+    {
+        EXPECT_EQ(states_first[i].x, states_second[i].x);
+        EXPECT_EQ(states_first[i].speed, states_second[i].speed);
+    }
+
+    // batch and ordinary scenario share the road network, so can't be active at the same time
+    EXPECT_EQ(SE_Init("../../../resources/xosc/cut-in.xosc", 0, 0, 0, 0), -1);
+    EXPECT_EQ(SE_BatchGetNumberOfInstances(), 4);
+    SE_BatchClose();
+    ASSERT_EQ(SE_Init("../../../resources/xosc/cut-in.xosc", 0, 0, 0, 0), 0);
+    EXPECT_EQ(SE_BatchInit("../../../resources/xosc/cut-in_sloppy.xosc", 4, 1, 0), -1);
+    SE_Close();
+
+    // variables and traffic signals are shared by instances, scenarios modifying them are rejected
+    EXPECT_EQ(SE_BatchInit("../../../EnvironmentSimulator/Unittest/xosc/variable_modify.xosc", 2, 1, 0), -1);
+    EXPECT_EQ(SE_BatchGetNumberOfInstances(), 0);
+    EXPECT_EQ(SE_BatchInit("../../../resources/xosc/traffic_lights.xosc", 2, 1, 0), -1);
+    EXPECT_EQ(SE_BatchGetNumberOfInstances(), 0);
+
+    SE_BatchClose();
+    EXPECT_EQ(SE_BatchGetNumberOfInstances(), 0);
+    EXPECT_EQ(SE_BatchStepDT(0.05f), -1);
+}
+
+TEST(FrameProfile, CollectPhasesAndTypes)
+{
+    EXPECT_EQ(SE_GetNumberOfFrameProfileEntries(), 0);
+
+    SE_SetOptionValue("profile", "all");
+    SE_SetOptionValue("profile_trace", "profile_test.json");
+    ASSERT_EQ(SE_Init("../../../resources/xosc/cut-in.xosc", 0, 0, 0, 0), 0);
+
+    for (int i = 0; i < 100; i++)
+    {
+        SE_StepDT(0.05f);
+    }
+
+    SE_FrameProfileEntry entry;
+    bool                 storyboard_found = false;
+    bool                 condition_found  = false;
+    for (int i = 0; i < SE_GetNumberOfFrameProfileEntries(); i++)
+    {
+        ASSERT_EQ(SE_GetFrameProfile(i, &entry), 0);
+        if (std::string(entry.name) == "Storyboard")
+        {
+            storyboard_found = true;
+            EXPECT_GE(entry.count, 100);
+            EXPECT_GE(entry.total, entry.max);
+            EXPECT_GE(entry.max, entry.p50);
+
+            int histogram_sum = 0;
+            for (int j = 0; j < SE_PROFILE_HISTOGRAM_SIZE; j++)
+            {
+                histogram_sum += entry.histogram[j];
+            }
+            EXPECT_EQ(histogram_sum, entry.count);
+        }
+        else if (std::string(entry.name) == "SimulationTimeCondition")
+        {
+            condition_found = true;
+            EXPECT_GT(entry.count, 0);
+        }
+    }
+    EXPECT_TRUE(storyboard_found);
+    EXPECT_TRUE(condition_found);
+    EXPECT_EQ(SE_GetFrameProfile(SE_GetNumberOfFrameProfileEntries(), &entry), -1);
+
+    EXPECT_EQ(SE_WriteFrameProfileTrace("profile_test.json"), 0);
+    std::ifstream file("profile_test.json");
+    std::string   content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(content.find("\"name\":\"Storyboard\""), std::string::npos);
+
+    SE_Close();
+
+    // profiling stops with the scenario
+    EXPECT_EQ(SE_GetNumberOfFrameProfileEntries(), 0);
+}
+
+TEST(ReplayTest, TestCompactDatFormats)
+{
+    const char* formats[] = {"per_field", "compact", "compressed"};
+    std::string filenames[3];
+
+    for (int i = 0; i < 3; i++)
+    {
+        filenames[i]       = std::string("dat_format_") + formats[i] + ".dat";
+        const char* args[] =
+            {"--osc", "../../../resources/xosc/cut-in.xosc", "--headless", "--record", filenames[i].c_str(), "--record_format", formats[i]};
+        ASSERT_EQ(SE_InitWithArgs(sizeof(args) / sizeof(char*), args), 0);
+
+        for (int j = 0; j < 200 && SE_GetQuitFlag() != 1; j++)
+        {
+            SE_StepDT(0.05f);
+        }
+        SE_Close();
+    }
+
+    // compact formats are smaller
+    std::uintmax_t size_per_field = fs::file_size(filenames[0]);
+    EXPECT_LT(fs::file_size(filenames[1]), size_per_field / 2);
+    EXPECT_LT(fs::file_size(filenames[2]), fs::file_size(filenames[1]));
+
+    // and give the same replay, within the resolution
+    scenarioengine::Replay reference(filenames[0]);
+    for (int i = 1; i < 3; i++)
+    {
+        scenarioengine::Replay replay(filenames[i]);
+        ASSERT_EQ(replay.timestamps_.size(), reference.timestamps_.size());
+        ASSERT_EQ(replay.GetAllObjectIDs(), reference.GetAllObjectIDs());
+
+        for (size_t j = 0; j < reference.timestamps_.size(); j += 10)
+        {
+            double time = reference.timestamps_[j];
+            EXPECT_NEAR(replay.timestamps_[j], time, 1e-6);
+
+            for (int id : reference.GetAllObjectIDs())
+            {
+                scenarioengine::ReplayEntry e0 = reference.GetReplayEntryAtTimeBinary(id, time);
+                scenarioengine::ReplayEntry e1 = replay.GetReplayEntryAtTimeBinary(id, time);
+                EXPECT_EQ(e1.state.info.active, e0.state.info.active);
+                EXPECT_EQ(e1.state.info.name, e0.state.info.name);
+                EXPECT_EQ(e1.state.info.model_id, e0.state.info.model_id);
+                EXPECT_EQ(e1.state.info.ctrl_type, e0.state.info.ctrl_type);
+                EXPECT_EQ(e1.state.pos.roadId, e0.state.pos.roadId);
+                EXPECT_EQ(e1.state.pos.laneId, e0.state.pos.laneId);
+                EXPECT_NEAR(e1.state.pos.x, e0.state.pos.x, 1e-3);
+                EXPECT_NEAR(e1.state.pos.y, e0.state.pos.y, 1e-3);
+                EXPECT_NEAR(e1.state.pos.h, e0.state.pos.h, 1e-4);
+                EXPECT_NEAR(e1.state.pos.s, e0.state.pos.s, 1e-3);
+                EXPECT_NEAR(e1.state.info.speed, e0.state.info.speed, 1e-3);
+                EXPECT_NEAR(e1.state.info.boundingbox.dimensions_.length_, e0.state.info.boundingbox.dimensions_.length_, 1e-6);
+            }
+        }
+    }
+}
+
+TEST(ReplayTest, TestCompressBlock)
+{
+    // packet like records with a counter, followed by a long run of zeros
+    std::vector<char> data;
+    for (int i = 0; i < 2000; i++)
+    {
+        const char record[] = "header";
+        data.insert(data.end(), record, record + sizeof(record));
+        data.insert(data.end(), reinterpret_cast<char*>(&i), reinterpret_cast<char*>(&i) + sizeof(i));
+    }
+    data.resize(data.size() + 1000, 0);
+
+    std::vector<char> compressed;
+    std::vector<char> decompressed;
+    ASSERT_EQ(Dat::CompressBlock(data.data(), data.size(), compressed), 0);
+    EXPECT_LT(compressed.size(), data.size() / 2);
+    ASSERT_EQ(Dat::DecompressBlock(compressed.data(), compressed.size(), decompressed, data.size()), 0);
+    EXPECT_EQ(decompressed, data);
+
+    // corrupt data is detected, and sizes beyond the block size are rejected without allocating
+    EXPECT_EQ(Dat::DecompressBlock(compressed.data(), compressed.size() / 2, decompressed, data.size()), -1);
+    EXPECT_EQ(Dat::DecompressBlock(compressed.data(), compressed.size(), decompressed, 0xffffffff), -1);
+
+    // varint and zigzag
+    std::string buf;
+    Dat::WriteVarint(buf, Dat::ZigZagEncode(-123456789));
+    Dat::WriteVarint(buf, 5);
+    const char* read_ptr = buf.data();
+    uint64_t    value    = 0;
+    ASSERT_EQ(Dat::ReadVarint(read_ptr, buf.data() + buf.size(), value), 0);
+    EXPECT_EQ(Dat::ZigZagDecode(value), -123456789);
+    ASSERT_EQ(Dat::ReadVarint(read_ptr, buf.data() + buf.size(), value), 0);
+    EXPECT_EQ(value, 5);
+    EXPECT_EQ(Dat::ReadVarint(read_ptr, buf.data() + buf.size(), value), -1);
+}
+
+TEST(SafetyMetrics, ApproachAndCrossing)
+{
+    scenarioengine::OSCBoundingBox                 bb = {{1.0f, 0.0f, 0.5f}, {2.0f, 4.0f, 1.5f}};
+    scenarioengine::SafetyAnalyzer                 analyzer;
+    scenarioengine::SafetyRunMetrics               metrics;
+    std::vector<scenarioengine::SafetyEntityState> entities;
+
+    // Entity 0 drives east at 10 m/s, entity 1 stands still 50.5 m ahead, entity 2 drives north crossing the path of
+    // entity 0 at x = 20 about 3 s after entity 0. Entity 0 hits entity 1 after (50.5 - 4) / 10 = 4.65 s.
+    double dt = 0.1;
+    for (int i = 0; i < 60; i++)
+    {
+        double t = i * dt;
+        entities = {{0, 10.0 * t, 0.0, 0.0, 10.0, bb}, {1, 50.5, 0.0, 0.0, 0.0, bb}, {2, 20.0, 4.0 * (t - 5.0), M_PI_2, 4.0, bb}};
+        analyzer.AddFrame(t, entities);
+    }
+    analyzer.Finish(metrics);
+
+    EXPECT_EQ(metrics.n_frames, 60);
+    EXPECT_EQ(metrics.n_entities, 3);
+    EXPECT_EQ(metrics.collisions, 1);
+    EXPECT_NEAR(metrics.first_collision_time, 4.7, 1e-5);
+    EXPECT_NEAR(metrics.min_distance, 0.0, 1e-5);
+
+    ASSERT_EQ(metrics.pairs.size(), 3);
+    const scenarioengine::SafetyPairMetrics& pair01 = metrics.pairs[0];
+    EXPECT_EQ(pair01.id0, 0);
+    EXPECT_EQ(pair01.id1, 1);
+    EXPECT_EQ(pair01.collisions, 1);
+    EXPECT_NEAR(pair01.min_ttc, 0.05, 1e-5);
+    EXPECT_NEAR(pair01.min_ttc_time, 4.6, 1e-5);
+
+    // entity 0 passes the crossing spot at about 1.9 s, entity 2 at about 4.75 s
+    const scenarioengine::SafetyPairMetrics& pair02 = metrics.pairs[1];
+    EXPECT_EQ(pair02.id1, 2);
+    EXPECT_EQ(pair02.collisions, 0);
+    EXPECT_GT(pair02.pet, 1.5);
+    EXPECT_LT(pair02.pet, 3.5);
+    EXPECT_GT(pair02.min_distance, 1.0);
+
+    // bounding box distance, rotated boxes
+    bool                              overlap = false;
+    scenarioengine::SafetyEntityState e0      = {0, 0.0, 0.0, 0.0, 0.0, bb};
+    scenarioengine::SafetyEntityState e1      = {1, 10.0, 0.0, M_PI_2, 0.0, bb};
+    EXPECT_NEAR(scenarioengine::SafetyAnalyzer::BoundingBoxDistance(e0, e1, overlap), 6.0, 1e-5);
+    EXPECT_FALSE(overlap);
+    e1.x = 3.5;
+    EXPECT_NEAR(scenarioengine::SafetyAnalyzer::BoundingBoxDistance(e0, e1, overlap), 0.0, 1e-5);
+    EXPECT_TRUE(overlap);
+}
+
+TEST(SafetyMetrics, AnalyzeRecording)
+{
+    const char* args[] = {"--osc", "../../../resources/xosc/pedestrian_collision.xosc", "--headless", "--record", "safety_metrics_test.dat"};
+    ASSERT_EQ(SE_InitWithArgs(sizeof(args) / sizeof(char*), args), 0);
+
+    while (SE_GetQuitFlag() != 1 && SE_GetSimulationTime() < 20.0f)
+    {
+        SE_StepDT(0.05f);
+    }
+    SE_Close();
+
+    scenarioengine::SafetyRunMetrics metrics;
+    ASSERT_EQ(scenarioengine::SafetyAnalyzer::AnalyzeFile("safety_metrics_test.dat", metrics), 0);
+    EXPECT_EQ(metrics.n_entities, 2);
+    EXPECT_GT(metrics.n_frames, 100);
+    EXPECT_EQ(metrics.collisions, 1);
+    EXPECT_NEAR(metrics.min_distance, 0.0, 1e-5);
+    EXPECT_LT(metrics.min_ttc, 1.0);
+
+    EXPECT_EQ(scenarioengine::SafetyAnalyzer::AnalyzeFile("non_existing.dat", metrics), -1);
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -4,6 +4,7 @@
 #include <vector>
 #include <stdexcept>
 #include <array>
+#include <thread>
 
 #include "CommonMini.hpp"
 #include "ScenarioEngine.hpp"
@@ -5203,6 +5204,50 @@ TEST(GhostConcept, TestMultipleRestartAtCorrectPosition)
     delete se;
 }
 
+TEST(GhostConcept, TestTrailRetention)
+{
+    // same scenario as above, but keeping only latest few seconds of trail
+    SE_Env::Inst().GetOptions().SetOptionValue("ghost_trail_retention", "4.0");
+
+    ScenarioEngine* se = new ScenarioEngine("../../../EnvironmentSimulator/Unittest/xosc/driver_lane_bouncing_scenario.xosc");
+    const double    dt = 0.1;
+    ASSERT_NE(se, nullptr);
+    scenario_step(se, 0.0);
+
+    scenarioengine::Entities* entities = &se->entities_;
+    ASSERT_EQ(entities->object_.size(), 2);
+    Object* ghost = entities->object_[0]->GetGhost();
+    ASSERT_NE(ghost, nullptr);
+
+    unsigned int max_vertices = 0;
+    idx_t        max_offset   = 0;
+    while (se->getSimulationTime() < 28.0 - SMALL_NUMBER)
+    {
+        scenario_step(se, dt);
+        max_vertices = MAX(max_vertices, ghost->trail_.GetNumberOfVertices());
+        max_offset   = MAX(max_offset, ghost->trail_.GetIndexOffset());
+
+        // part of trail in use by the follower is never discarded
+        if (entities->object_[0]->trail_follow_index_ != IDX_UNDEFINED)
+        {
+            EXPECT_GE(entities->object_[0]->trail_follow_index_, ghost->trail_.GetIndexOffset());
+        }
+    }
+
+    // trail storage is bounded to about twice the retention window, while indices keep counting
+    EXPECT_LE(max_vertices, 2 * 4.0 / GHOST_TRAIL_SAMPLE_TIME + 3);
+    EXPECT_GT(max_offset, 0);
+
+    // and the result is still the same
+    EXPECT_NEAR(entities->object_[0]->pos_.GetX(), 609.49, 1E-2);
+    EXPECT_NEAR(entities->object_[0]->pos_.GetY(), -3.49, 1E-2);
+    EXPECT_NEAR(entities->object_[0]->pos_.GetH(), 0.03, 1E-2);
+    EXPECT_NEAR(entities->object_[0]->GetSpeed(), 72.0 / 3.6, 1E-2);
+
+    delete se;
+    SE_Env::Inst().GetOptions().UnsetOption("ghost_trail_retention");
+}
+
 TEST(EnvironmentTest, Basic)
 {
     OSCEnvironment environment;
@@ -5911,6 +5956,317 @@ TEST(InitActions, TestInitActionsReorderingNoGhost)
     delete se;
 }
 
+// Update last active state of all allocated swarm vehicles, trailers excluded. Collect the active ones.
+// Return number of vehicles activated again, i.e. inactive at previous call.
+static int UpdateSwarmVehicles(ScenarioEngine* se, std::map<Object*, bool>& active, std::vector<Object*>& active_now)
+{
+    int n_activated = 0;
+
+    active_now.clear();
+    for (auto list : {&se->entities_.object_, &se->entities_.object_pool_})
+    {
+        for (auto obj : *list)
+        {
+            if (obj->GetName().rfind("swarm_", 0) != 0 || obj->TowVehicle() != nullptr)
+            {
+                continue;  // skip Ego and trailers
+            }
+            if (active.count(obj) > 0 && !active[obj] && obj->IsActive())
+            {
+                n_activated++;
+            }
+            if (obj->IsActive())
+            {
+                active_now.push_back(obj);
+            }
+            active[obj] = obj->IsActive();
+        }
+    }
+
+    return n_activated;
+}
+
+TEST(SwarmTraffic, TestVehicleRecycling)
+{
+    ScenarioEngine* se = new ScenarioEngine("../../../resources/xosc/swarm.xosc");
+    ASSERT_NE(se, nullptr);
+    const double            dt         = 0.05;
+    const size_t            max_cars   = 75;  // numberOfVehicles in swarm.xosc
+    int                     n_respawns = 0;
+    std::map<Object*, bool> active;  // swarm vehicle -> last active state
+    std::vector<Object*>    active_now;
+
+    while (se->getSimulationTime() < 20.0 - SMALL_NUMBER)
+    {
+        scenario_step(se, dt);
+        n_respawns += UpdateSwarmVehicles(se, active, active_now);
+    }
+
+    // vehicles are despawned and spawned again, without allocating more than the max number of vehicles
+    EXPECT_GT(n_respawns, 0);
+    EXPECT_LE(active.size(), max_cars);
+
+    // same for controllers, just one ACC controller per swarm vehicle
+    size_t n_acc = 0;
+    for (auto ctrl : se->scenarioReader->controller_)
+    {
+        if (ctrl->GetType() == scenarioengine::Controller::Type::CONTROLLER_TYPE_ACC)
+        {
+            n_acc++;
+            EXPECT_NE(ctrl->GetLinkedObject(), nullptr);
+        }
+    }
+    EXPECT_EQ(n_acc, active.size());
+
+    delete se;
+}
+
+TEST(SwarmTraffic, TestLevelOfDetail)
+{
+    const double lod_radius = 150.0;
+    SE_Env::Inst().GetOptions().SetOptionValue("swarm_lod_radius", std::to_string(lod_radius));
+
+    ScenarioEngine* se = new ScenarioEngine("../../../resources/xosc/swarm.xosc");
+    ASSERT_NE(se, nullptr);
+    const double            dt           = 0.05;
+    double                  max_dist     = 0.0;
+    int                     n_promoted   = 0;
+    size_t                  max_vehicles = 0;
+    Object*                 ego          = se->entities_.GetObjectByName("Ego");
+    std::map<Object*, bool> active;  // swarm vehicle -> last active state
+    std::vector<Object*>    active_now;
+    ASSERT_NE(ego, nullptr);
+
+    while (se->getSimulationTime() < 30.0 - SMALL_NUMBER)
+    {
+        scenario_step(se, dt);
+
+        n_promoted += UpdateSwarmVehicles(se, active, active_now);
+        for (auto obj : active_now)
+        {
+            max_dist = MAX(max_dist, PointDistance2D(obj->pos_.GetX(), obj->pos_.GetY(), ego->pos_.GetX(), ego->pos_.GetY()));
+        }
+        max_vehicles = MAX(max_vehicles, active_now.size());
+    }
+
+    // only vehicles close to central object are fully simulated, far field vehicles move in and out of LOD radius
+    EXPECT_GT(max_vehicles, 5);
+    EXPECT_GT(n_promoted, 0);
+    EXPECT_LT(max_dist, lod_radius + 20.0);  // 10 m margin plus movement between swarm updates
+
+    delete se;
+    SE_Env::Inst().GetOptions().UnsetOption("swarm_lod_radius");
+}
+
+TEST(ScenarioGateway, TestPositionSourceAndLookup)
+{
+    ScenarioEngine* se = new ScenarioEngine("../../../EnvironmentSimulator/Unittest/xosc/friction_and_lane_change_edge_case.xosc");
+    ASSERT_NE(se, nullptr);
+    scenario_step(se, 0.0);
+
+    ScenarioGateway* gw = se->getScenarioGateway();
+    ASSERT_EQ(se->entities_.object_.size(), 2);
+    ASSERT_EQ(gw->getNumberOfObjects(), 2);
+
+    Object* obj0 = se->entities_.object_[0];
+    Object* obj1 = se->entities_.object_[1];
+
+    // gateway state of engine driven objects originates from the objects themselves
+    ObjectState* state = gw->getObjectStatePtrById(obj1->GetId());
+    ASSERT_NE(state, nullptr);
+    EXPECT_EQ(state->state_.info.id, obj1->GetId());
+    EXPECT_TRUE(state->IsPosSourcedFrom(&obj1->pos_));
+    EXPECT_FALSE(state->IsPosSourcedFrom(&obj0->pos_));
+
+    // external update takes precedence over object state
+    double x = obj1->pos_.GetX() + 5.0;
+    double y = obj1->pos_.GetY();
+    double h = obj1->pos_.GetH();
+    gw->updateObjectWorldPosXYH(obj1->GetId(), 0.0, x, y, h);
+    EXPECT_FALSE(state->IsPosSourcedFrom(&obj1->pos_));
+    scenario_step(se, 0.0);
+    EXPECT_NEAR(obj1->pos_.GetX(), x, 1e-5);
+    EXPECT_NEAR(obj1->pos_.GetY(), y, 1e-5);
+    EXPECT_TRUE(state->IsPosSourcedFrom(&obj1->pos_));
+
+    // lookup by id still valid after removal of other objects
+    gw->removeObject(obj0->GetId());
+    EXPECT_EQ(gw->getObjectStatePtrById(obj0->GetId()), nullptr);
+    EXPECT_EQ(gw->getObjectStatePtrById(obj1->GetId()), state);
+    EXPECT_TRUE(gw->isObjectReported(obj1->GetId()));
+
+    delete se;
+}
+
+TEST(ScenarioGateway, TestWorldSnapshot)
+{
+    ScenarioEngine* se = new ScenarioEngine("../../../EnvironmentSimulator/Unittest/xosc/friction_and_lane_change_edge_case.xosc");
+    ASSERT_NE(se, nullptr);
+    ScenarioGateway* gw = se->getScenarioGateway();
+    EXPECT_EQ(gw->GetSnapshot(), nullptr);
+
+    scenario_step(se, 0.0);
+    scenario_step(se, 0.1);
+
+    std::shared_ptr<const WorldSnapshot> snapshot = gw->GetSnapshot();
+    ASSERT_NE(snapshot, nullptr);
+    ASSERT_EQ(snapshot->Size(), 2);
+    EXPECT_NEAR(snapshot->time, 0.1, 1e-5);
+
+    for (size_t i = 0; i < se->entities_.object_.size(); i++)
+    {
+        Object* obj = se->entities_.object_[i];
+        int     idx = snapshot->GetIndexById(obj->GetId());
+        ASSERT_GE(idx, 0);
+        size_t index = static_cast<size_t>(idx);
+        EXPECT_EQ(snapshot->GetName(index), obj->GetName());
+        EXPECT_DOUBLE_EQ(snapshot->x[index], obj->pos_.GetX());
+        EXPECT_DOUBLE_EQ(snapshot->y[index], obj->pos_.GetY());
+        EXPECT_DOUBLE_EQ(snapshot->h[index], obj->pos_.GetH());
+        EXPECT_DOUBLE_EQ(snapshot->vel_x[index], obj->pos_.GetVelX());
+        EXPECT_EQ(snapshot->lane_id[index], obj->pos_.GetLaneId());
+        EXPECT_DOUBLE_EQ(snapshot->speed[index], obj->GetSpeed());
+    }
+    EXPECT_EQ(snapshot->GetIndexById(100), -1);
+
+    // a held snapshot is not affected by later frames
+    double       x        = snapshot->x[0];
+    unsigned int sequence = snapshot->sequence;
+    for (int i = 0; i < 3; i++)
+    {
+        scenario_step(se, 0.1);
+    }
+    EXPECT_DOUBLE_EQ(snapshot->x[0], x);
+    EXPECT_NEAR(snapshot->time, 0.1, 1e-5);
+
+    std::shared_ptr<const WorldSnapshot> latest = gw->GetSnapshot();
+    EXPECT_EQ(latest->sequence, sequence + 3);
+    EXPECT_NEAR(latest->time, 0.4, 1e-5);
+    EXPECT_GT(latest->x[0], x);
+    EXPECT_EQ(latest->names, snapshot->names);  // no new names, table is shared
+
+    delete se;
+}
+
+TEST(ScenarioGateway, TestUpdatesFromOtherThreadAreQueued)
+{
+    ScenarioEngine* se = new ScenarioEngine("../../../EnvironmentSimulator/Unittest/xosc/friction_and_lane_change_edge_case.xosc");
+    ASSERT_NE(se, nullptr);
+    scenario_step(se, 0.0);
+
+    ScenarioGateway* gw    = se->getScenarioGateway();
+    Object*          obj   = se->entities_.object_[1];
+    ObjectState*     state = gw->getObjectStatePtrById(obj->GetId());
+    ASSERT_NE(state, nullptr);
+    EXPECT_TRUE(gw->IsSimulationThread());
+
+    double x = obj->pos_.GetX() + 5.0;
+    double y = obj->pos_.GetY();
+    double h = obj->pos_.GetH();
+
+    // reported by another thread, not applied until next step
+    std::thread producer(
+        [&]()
+        {
+            EXPECT_FALSE(gw->IsSimulationThread());
+            gw->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::WORLD_POS_XYH, obj->GetId(), 0.0, {x, y, h}));
+            gw->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::SPEED, obj->GetId(), 0.0, {12.0}));
+        });
+    producer.join();
+    EXPECT_NEAR(state->state_.pos.GetX(), x - 5.0, 1e-5);
+    EXPECT_TRUE(state->IsPosSourcedFrom(&obj->pos_));
+
+    scenario_step(se, 0.0);
+    EXPECT_NEAR(obj->pos_.GetX(), x, 1e-5);
+    EXPECT_NEAR(obj->pos_.GetY(), y, 1e-5);
+    EXPECT_NEAR(obj->GetSpeed(), 12.0, 1e-5);
+    EXPECT_EQ(gw->ApplyQueuedUpdates(), 0);
+
+    // reported by the simulation thread, applied immediately
+    gw->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::WORLD_POS_XYH, obj->GetId(), 0.0, {x + 1.0, y, h}));
+    EXPECT_NEAR(state->state_.pos.GetX(), x + 1.0, 1e-5);
+    EXPECT_EQ(gw->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::SPEED, 100, 0.0, {1.0})), -1);
+
+    // lateral position and lane type snap mask, relative current road position
+    scenario_step(se, 0.0);
+    double s = obj->pos_.GetS();
+    std::thread lateral_producer(
+        [&]()
+        {
+            gw->ReportUpdate(ObjectStateUpdate(ObjectStateUpdate::Type::LATERAL_LANE_POS, obj->GetId(), 0.0, {0.5}));
+            ObjectStateUpdate update(ObjectStateUpdate::Type::LANE_TYPE_SNAP_MASK, obj->GetId(), 0.0, {});
+            update.mode = roadmanager::Lane::LaneType::LANE_TYPE_ANY;
+            gw->ReportUpdate(update);
+        });
+    lateral_producer.join();
+    EXPECT_NE(state->state_.pos.GetSnapLaneTypes(), roadmanager::Lane::LaneType::LANE_TYPE_ANY);
+
+    scenario_step(se, 0.0);
+    EXPECT_NEAR(obj->pos_.GetOffset(), 0.5, 1e-5);
+    EXPECT_NEAR(obj->pos_.GetS(), s, 1e-5);
+    EXPECT_EQ(state->state_.pos.GetSnapLaneTypes(), roadmanager::Lane::LaneType::LANE_TYPE_ANY);
+
+    delete se;
+}
+
+static int storyboard_test_event_starts[2] = {0, 0};
+
+static void StoryboardTestStateChangeCallback(const char* name, int type, int state, const char* full_path)
+{
+    (void)full_path;
+    if (type == StoryBoardElement::ElementType::EVENT && state == StoryBoardElement::State::RUNNING)
+    {
+        if (!strcmp(name, "MyEvent1"))
+        {
+            storyboard_test_event_starts[0]++;
+        }
+        else if (!strcmp(name, "MyEvent2"))
+        {
+            storyboard_test_event_starts[1]++;
+        }
+    }
+}
+
+TEST(Storyboard, TestActiveSetFollowsStateChanges)
+{
+    ScenarioEngine* se = new ScenarioEngine("../../../EnvironmentSimulator/Unittest/xosc/maneuver_groups_x_3.xosc");
+    ASSERT_NE(se, nullptr);
+
+    std::vector<StoryBoardElement*> mg = se->storyBoard.FindChildByTypeAndName(StoryBoardElement::ElementType::MANEUVER_GROUP, "MyMG");
+    ASSERT_EQ(mg.size(), 1);
+    std::vector<StoryBoardElement*> event2 = se->storyBoard.FindChildByTypeAndName(StoryBoardElement::ElementType::EVENT, "MyEvent2");
+    ASSERT_EQ(event2.size(), 1);
+
+    storyboard_test_event_starts[0]        = 0;
+    storyboard_test_event_starts[1]        = 0;
+    StoryBoardElement::stateChangeCallback = StoryboardTestStateChangeCallback;
+
+    StoryBoardElement::State event2_prev_state = event2[0]->GetCurrentState();
+    int                      event2_resets     = 0;
+
+    while (se->getSimulationTime() < 8.5 && se->storyBoard.GetCurrentState() != StoryBoardElement::State::COMPLETE)
+    {
+        scenario_step(se, 0.05);
+
+        // maneuver group restarts reset the events to INIT, then they need to be picked up again
+        if (event2_prev_state != StoryBoardElement::State::INIT && event2[0]->GetCurrentState() == StoryBoardElement::State::INIT)
+        {
+            event2_resets++;
+        }
+        event2_prev_state = event2[0]->GetCurrentState();
+    }
+    StoryBoardElement::stateChangeCallback = nullptr;
+
+    // each maneuver group execution runs both events in sequence
+    EXPECT_EQ(mg[0]->num_executions_, 3);
+    EXPECT_EQ(storyboard_test_event_starts[0], 3);
+    EXPECT_EQ(storyboard_test_event_starts[1], 3);
+    EXPECT_EQ(event2_resets, 2);
+    EXPECT_EQ(mg[0]->GetCurrentState(), StoryBoardElement::State::COMPLETE);
+
+    delete se;
+}
+
 int main(int argc, char** argv)
 {
 #if 0  // set to 1 and modify filter to run one single test
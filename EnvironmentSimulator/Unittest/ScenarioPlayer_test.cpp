@@ -514,6 +514,37 @@ TEST(Controllers, TestSeparateControllersOnLatLong)
     delete player;
 }
 
+#ifndef _WIN32
+TEST(SharedState, TestFirstFramePublished)
+{
+    std::string name   = "/esmini_player_test_" + std::to_string(getpid());
+    const char* args[] = {"esmini", "--osc", "../../../resources/xosc/cut-in.xosc", "--headless", "--disable_stdout", "--shm", name.c_str()};
+    int         argc   = sizeof(args) / sizeof(char*);
+
+    ScenarioPlayer* player = new ScenarioPlayer(argc, const_cast<char**>(args));
+    ASSERT_EQ(player->Init(), 0);
+
+    // the initial frame, run by Init(), is available before any further step
+    SE_SharedStateReader reader;
+    SE_SharedFrameCopy   copy;
+    ASSERT_EQ(reader.Open(name), 0);
+    EXPECT_EQ(reader.GetFrameCount(), 1u);
+    ASSERT_EQ(reader.CopyLatest(copy), 0);
+    EXPECT_EQ(copy.frame, 0u);
+    EXPECT_NEAR(copy.time, 0.0, 1e-10);
+    ASSERT_EQ(copy.entities.size(), 2u);
+    EXPECT_STREQ(copy.entities[0].name, "Ego");
+    EXPECT_NEAR(copy.entities[0].x, player->scenarioEngine->entities_.object_[0]->pos_.GetX(), 1e-5);
+
+    player->Frame(0.05);
+    EXPECT_EQ(reader.GetFrameCount(), 2u);
+    ASSERT_EQ(reader.CopyLatest(copy), 0);
+    EXPECT_EQ(copy.frame, 1u);
+
+    delete player;
+}
+#endif  // _WIN32
+
 TEST(TrafficSignals, TestTrafficSignalActions)
 {
     const char*     args[] = {"esmini", "--osc", "../../../resources/xosc/traffic_lights.xosc", "--headless", "--disable_stdout"};
@@ -1354,6 +1385,43 @@ TEST_F(OSITunnelTestFixture, TestOSITunnelBoundary)
     EXPECT_EQ(lane_boundary->boundary_line_size(), 23);
 }
 
+static void RunAndRecordOSI(ScenarioPlayer* player, int n_frames, std::vector<std::pair<long long, double>>& samples)
+{
+    samples.clear();
+    for (int i = 0; i < n_frames; i++)
+    {
+        player->Frame(0.05);
+        const osi3::GroundTruth* gt = reinterpret_cast<const osi3::GroundTruth*>(player->osiReporter->GetOSIGroundTruthRaw());
+        ASSERT_GT(gt->moving_object_size(), 1);
+        samples.push_back({gt->timestamp().seconds() * 1000000000LL + gt->timestamp().nanos(), gt->moving_object(1).base().position().x()});
+    }
+}
+
+TEST(OSI, TestRestoreState)
+{
+    const char* args[] = {"esmini", "--osc", "../../../resources/xosc/cut-in.xosc", "--headless", "--osi_freq", "3", "--disable_stdout"};
+    int         argc   = sizeof(args) / sizeof(char*);
+
+    ScenarioPlayer* player = new ScenarioPlayer(argc, const_cast<char**>(args));
+    ASSERT_EQ(player->Init(), 0);
+
+    std::vector<std::pair<long long, double>> samples_first;
+    std::vector<std::pair<long long, double>> samples_second;
+    RunAndRecordOSI(player, 4, samples_first);
+
+    // ground truth is updated every third frame, in the same frames after restore
+    SE_StateBuffer buf;
+    ASSERT_EQ(player->StoreState(buf), 0);
+    RunAndRecordOSI(player, 20, samples_first);
+    ASSERT_EQ(player->RestoreState(buf), 0);
+    RunAndRecordOSI(player, 20, samples_second);
+    EXPECT_EQ(samples_first, samples_second);
+    EXPECT_EQ(samples_first[1], samples_first[3]);
+    EXPECT_NE(samples_first[0], samples_first[1]);
+
+    delete player;
+}
+
 #endif  // _USE_OSI
 
 int main(int argc, char** argv)
@@ -131,9 +131,58 @@ bool EsminiOsiSource::get_fmi_traffic_update_in(osi3::TrafficUpdate& data)
     }
 }
 
-void EsminiOsiSource::set_fmi_sensor_view_out(const osi3::SensorView& data)
+static void append_varint(string& buffer, uint64_t value)
 {
-    data.SerializeToString(currentBufferSVOut);
+    while (value >= 0x80)
+    {
+        buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+/*
+ * Append message as a length-delimited field, i.e. the same encoding as if it was set as sub message
+ * of the field_number field. A non-repeated message field occurring several times is merged when parsed,
+ * which makes it possible to compose the SensorView encoding from separately encoded parts.
+ */
+static void append_message_field(string& buffer, int field_number, const google::protobuf::MessageLite& msg)
+{
+    append_varint(buffer, (static_cast<uint64_t>(field_number) << 3) | 2);  // wire type 2 = length-delimited
+    size_t size = msg.ByteSizeLong();
+    append_varint(buffer, size);
+    size_t offset = buffer.size();
+    buffer.resize(offset + size);
+    msg.SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t*>(&buffer[offset]));
+}
+
+void EsminiOsiSource::set_fmi_sensor_view_out(const osi3::SensorView& header,
+                                              const osi3::GroundTruth* dynamic_gt,
+                                              const osi3::GroundTruth* static_gt,
+                                              int static_gt_revision)
+{
+    // The static ground truth, e.g. road network, is only encoded when changed
+    if (static_gt == nullptr)
+    {
+        staticBufferSVOut.clear();
+        staticGTSVOut = nullptr;
+    }
+    else if (static_gt != staticGTSVOut || static_gt_revision != staticGTRevisionSVOut)
+    {
+        staticBufferSVOut.clear();
+        append_message_field(staticBufferSVOut, osi3::SensorView::kGlobalGroundTruthFieldNumber, *static_gt);
+        staticGTSVOut         = static_gt;
+        staticGTRevisionSVOut = static_gt_revision;
+    }
+
+    // SensorView = header + dynamic ground truth + static ground truth, latter two merged into global_ground_truth when parsed.
+    // Buffers alternate between steps, keeping the previous output valid according to OSMP rules
+    header.SerializeToString(currentBufferSVOut);
+    if (dynamic_gt != nullptr)
+    {
+        append_message_field(*currentBufferSVOut, osi3::SensorView::kGlobalGroundTruthFieldNumber, *dynamic_gt);
+    }
+    currentBufferSVOut->append(staticBufferSVOut);
     encode_pointer_to_integer(currentBufferSVOut->data(),
                               integer_vars[FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX],
                               integer_vars[FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX]);
@@ -182,40 +231,47 @@ void EsminiOsiSource::reset_fmi_traffic_command_out()
 void EsminiOsiSource::update_osmp_output(double time)
 {
     normal_log("OSMP", "update_osmp_output called for time: %f", time);
-    const void* raw_gt = SE_GetOSIGroundTruthRaw();
-    normal_log("OSMP", "SE_GetOSIGroundTruthRaw returned: %p", raw_gt);
+    // Fetch static and dynamic ground truth separately, the SensorView is composed from their encodings without copying
+    int         static_gt_revision = 0;
+    const void* raw_gt             = SE_GetOSIDynamicGroundTruthRaw();
+    const void* raw_static_gt      = SE_GetOSIStaticGroundTruthRaw(&static_gt_revision);
+    normal_log("OSMP", "SE_GetOSIDynamicGroundTruthRaw returned: %p, static: %p", raw_gt, raw_static_gt);
 
     osi3::SensorView currentOut;
     currentOut.Clear();
     currentOut.mutable_sensor_id()->set_value(0);
 
+    const auto* se_osi_ground_truth = reinterpret_cast<const osi3::GroundTruth*>(raw_gt);
+    const auto* se_osi_static_gt    = reinterpret_cast<const osi3::GroundTruth*>(raw_static_gt);
+
     if (raw_gt != nullptr)
     {
         // [GT_MOD] DIAGNOSTIC: Validate pointer somewhat (basic check)
         // In a real scenario we can't easily validate a raw pointer, but we can check if it looks like a valid address (not small int)
         // For now, trusting standard nullptr check.
-        
-        const auto* se_osi_ground_truth = reinterpret_cast<const osi3::GroundTruth*>(raw_gt);  // Fetch OSI struct
-        if (se_osi_ground_truth->has_host_vehicle_id())
+
+        if (se_osi_static_gt != nullptr && se_osi_static_gt->has_host_vehicle_id())
+        {
+            currentOut.mutable_host_vehicle_id()->set_value(se_osi_static_gt->host_vehicle_id().value());
+        }
+        else if (se_osi_ground_truth->has_host_vehicle_id())
         {
             currentOut.mutable_host_vehicle_id()->set_value(se_osi_ground_truth->host_vehicle_id().value());
         }
-        
-        osi3::GroundTruth* currentGT = currentOut.mutable_global_ground_truth();
-        currentGT->CopyFrom(*se_osi_ground_truth);
     }
     else
     {
         // [GT_MOD] DIAGNOSTIC LOG
-        std::cerr << "[OSMP] ERROR: SE_GetOSIGroundTruthRaw returned nullptr at time " << time << std::endl;
+        std::cerr << "[OSMP] ERROR: SE_GetOSIDynamicGroundTruthRaw returned nullptr at time " << time << std::endl;
         normal_log("OSMP", "Warning: No ground truth available at time %f. Creating empty SensorView.", time);
+        se_osi_static_gt = nullptr;
     }
-    
+
     currentOut.mutable_timestamp()->set_seconds((long long int)floor(time));
     const double sec_to_nanos = 1000000000.0;
     currentOut.mutable_timestamp()->set_nanos((int)((time - floor(time)) * sec_to_nanos));
-    
-    set_fmi_sensor_view_out(currentOut);
+
+    set_fmi_sensor_view_out(currentOut, se_osi_ground_truth, se_osi_static_gt, static_gt_revision);
 
     // Handle OSI TrafficCommand output
     const void* raw_tc = SE_GetOSITrafficCommandRaw();
@@ -677,6 +733,8 @@ EsminiOsiSource::EsminiOsiSource(fmi2String                   theinstanceName,
     currentBufferSVOut = new string();
     currentBufferTCOut = new string();
     lastBufferSVOut = new string();
+    staticGTSVOut = nullptr;
+    staticGTRevisionSVOut = 0;
     lastBufferTCOut = new string();
     loggingCategories.clear();
     loggingCategories.insert("FMI");
@@ -20,6 +20,7 @@
 #include <string>
 #include <utility>
 #include <array>
+#include <unordered_map>
 #include <map>
 
 #ifdef _WIN32
@@ -87,9 +88,11 @@ static struct
 
 static struct
 {
-    osi3::GroundTruth    *gt;
-    osi3::SensorView     *sv;
-    osi3::TrafficCommand *tc;
+    osi3::GroundTruth       *gt;
+    osi3::SensorView        *sv;
+    osi3::TrafficCommand    *tc;
+    const osi3::GroundTruth *gt_static_part;  // static data to merge into dynamic data for the combined ground truth, or nullptr
+    bool                     gt_merged;       // whether gt reflects latest update
 } obj_osi_external;
 
 using namespace scenarioengine;
@@ -125,6 +128,557 @@ OSIReporter* GT_GetCurrentOSIReporter()
     return g_current_osi_reporter_;
 }
 
+// [GT_MOD] Helper function to get target lane ID from route for a given road
+static int GetTargetLaneIdFromRoute(const roadmanager::Route* route, id_t roadId)
+{
+    if (!route || !route->IsValid())
+    {
+        return 0;  // Default to lane 0 if no route
+    }
+
+    // Search for the road in route waypoints
+    for (size_t i = 0; i < route->minimal_waypoints_.size(); i++)
+    {
+        if (route->minimal_waypoints_[i].GetTrackId() == roadId)
+        {
+            return route->minimal_waypoints_[i].GetLaneId();
+        }
+    }
+
+    return 0;  // Not found in route, default to lane 0
+}
+
+// [GT_MOD] Projected future trajectory (shadow simulation) based on road geometry and active actions.
+// State is kept per object between OSI updates, so the ghost position and route copy are reused instead of allocated
+// each time. While an object cruises along its lane at constant speed, the path is stored at a finer resolution. As long
+// as the object follows it, the path is advanced by the elapsed time and future points are interpolated from it, instead
+// of being projected from scratch.
+// Objects following a route are predicted in parallel. Junction choices of the others are random, drawing from the
+// shared random generator, so they are predicted on the calling thread in object order.
+class TrajectoryPredictor
+{
+public:
+    TrajectoryPredictor(double horizon, double resolution, unsigned int n_threads)
+        : resolution_(resolution > SMALL_NUMBER ? resolution : 0.5),
+          n_samples_(static_cast<unsigned int>(MAX(1, static_cast<int>(std::round(horizon / resolution_))))),
+          n_threads_(n_threads)
+    {
+    }
+
+    double GetResolution() const
+    {
+        return resolution_;
+    }
+
+    unsigned int GetNumberOfSamples() const
+    {
+        return n_samples_;
+    }
+
+    // Forget requests of previous update
+    void BeginUpdate();
+
+    // Request prediction of the object in upcoming Run()
+    void Request(Object* obj);
+
+    // Predict all requested objects from current state
+    void Run(double time);
+
+    // Add prediction of the object, if requested in this update, to the OSI moving object
+    void AddFutureTrajectory(int id, osi3::MovingObject* mobj) const;
+
+private:
+    struct Sample
+    {
+        double t;
+        double x;
+        double y;
+        double z;
+        double h;
+        double p;
+        double r;
+        id_t   road_id;
+        int    lane_id;
+        double s;
+    };
+
+    static constexpr unsigned int PATH_STEPS = 5;  // path points per trajectory resolution step
+
+    struct ObjectPredictor
+    {
+        ObjectPredictor()                                  = default;
+        ObjectPredictor(const ObjectPredictor&)            = delete;
+        ObjectPredictor& operator=(const ObjectPredictor&) = delete;
+        ~ObjectPredictor()
+        {
+            ghost.SetRoute(nullptr);  // route copy is owned by the predictor, not the ghost
+        }
+
+        Object*                   object            = nullptr;
+        bool                      requested         = false;
+        roadmanager::Position     ghost;                        // state at last sample, continued when horizon is shifted
+        roadmanager::Route        route;                        // copy of object route, advanced by the ghost only
+        const roadmanager::Route* source_route      = nullptr;  // object route at time of prediction
+        size_t                    source_route_size = 0;
+        std::vector<Sample>       samples;
+        std::vector<Sample>       path;                         // fine resolution path while cruising, ghost is at last point
+        bool                      cruising          = false;    // constant speed along lane center, path can be advanced
+        double                    cruise_speed      = 0.0;
+        bool                      has_target_speed  = false;    // memory of last known target speed, e.g. sustaining WaitOnRed
+        double                    target_speed      = 0.0;
+    };
+
+    void Predict(ObjectPredictor& p, double time);
+    bool AdvancePath(ObjectPredictor& p, double time);
+    void ExtendPath(ObjectPredictor& p, size_t n_points);
+    void SamplePath(ObjectPredictor& p, double time, double fraction);
+    void MoveGhost(ObjectPredictor& p, double ds, double dLaneOffset);
+    void SetSample(const roadmanager::Position& pos, double time, Sample& sample);
+
+    double                                   resolution_;
+    unsigned int                             n_samples_;
+    unsigned int                             n_threads_;
+    std::unordered_map<int, ObjectPredictor> predictors_;
+    std::vector<ObjectPredictor*>            requested_;
+    std::vector<ObjectPredictor*>            parallel_;
+    std::unique_ptr<SE_ThreadPool>           pool_;
+};
+
+void TrajectoryPredictor::BeginUpdate()
+{
+    for (ObjectPredictor* p : requested_)
+    {
+        p->requested = false;
+    }
+    requested_.clear();
+}
+
+void TrajectoryPredictor::Request(Object* obj)
+{
+    ObjectPredictor& p = predictors_[obj->GetId()];
+    if (!p.requested)
+    {
+        p.object    = obj;
+        p.requested = true;
+        requested_.push_back(&p);
+    }
+}
+
+void TrajectoryPredictor::Run(double time)
+{
+    parallel_.clear();
+    for (ObjectPredictor* p : requested_)
+    {
+        if (p->object->pos_.GetRoute() != nullptr && p->object->pos_.GetRoute()->IsValid())
+        {
+            parallel_.push_back(p);
+        }
+        else
+        {
+            Predict(*p, time);
+        }
+    }
+
+    if (parallel_.size() > 1)
+    {
+        if (pool_ == nullptr)
+        {
+            pool_ = std::make_unique<SE_ThreadPool>(n_threads_);
+        }
+        pool_->ParallelFor(parallel_.size(), [this, time](size_t i) { Predict(*parallel_[i], time); });
+    }
+    else if (parallel_.size() == 1)
+    {
+        Predict(*parallel_[0], time);
+    }
+}
+
+void TrajectoryPredictor::AddFutureTrajectory(int id, osi3::MovingObject* mobj) const
+{
+    auto it = predictors_.find(id);
+    if (it == predictors_.end() || !it->second.requested)
+    {
+        return;
+    }
+
+    for (const Sample& sample : it->second.samples)
+    {
+        auto* point = mobj->add_future_trajectory();
+        point->mutable_timestamp()->set_seconds(static_cast<int64_t>(sample.t));
+        point->mutable_timestamp()->set_nanos(static_cast<uint32_t>((sample.t - static_cast<int64_t>(sample.t)) * 1e9));
+
+        point->mutable_position()->set_x(sample.x);
+        point->mutable_position()->set_y(sample.y);
+        point->mutable_position()->set_z(sample.z);
+
+        point->mutable_orientation()->set_yaw(sample.h);
+        point->mutable_orientation()->set_roll(sample.r);
+        point->mutable_orientation()->set_pitch(sample.p);
+    }
+}
+
+void TrajectoryPredictor::SetSample(const roadmanager::Position& pos, double time, Sample& sample)
+{
+    sample.t       = time;
+    sample.x       = pos.GetX();
+    sample.y       = pos.GetY();
+    sample.z       = pos.GetZ();
+    sample.h       = pos.GetH();
+    sample.p       = pos.GetP();
+    sample.r       = pos.GetR();
+    sample.road_id = pos.GetTrackId();
+    sample.lane_id = pos.GetLaneId();
+    sample.s       = pos.GetS();
+}
+
+void TrajectoryPredictor::MoveGhost(ObjectPredictor& p, double ds, double dLaneOffset)
+{
+    id_t prevRoadId = p.ghost.GetTrackId();
+    auto ret        = p.ghost.MoveAlongS(ds, dLaneOffset, -1.0, true, roadmanager::Position::MoveDirectionMode::HEADING_DIRECTION, true);
+
+    if (static_cast<int>(ret) < 0)
+    {
+        // retry without updating the route
+        ret = p.ghost.MoveAlongS(ds, dLaneOffset, -1.0, true, roadmanager::Position::MoveDirectionMode::HEADING_DIRECTION, false);
+    }
+
+    // [GT_MOD] When passing a junction, correct lane ID according to the route
+    id_t roadId = p.ghost.GetTrackId();
+    if (roadId != prevRoadId && p.ghost.GetRoute())
+    {
+        int targetLaneId = GetTargetLaneIdFromRoute(p.ghost.GetRoute(), roadId);
+        if (targetLaneId != p.ghost.GetLaneId())
+        {
+            p.ghost.SetLanePos(roadId, targetLaneId, p.ghost.GetS(), 0.0);
+        }
+    }
+}
+
+void TrajectoryPredictor::ExtendPath(ObjectPredictor& p, size_t n_points)
+{
+    double dt = resolution_ / PATH_STEPS;
+
+    for (size_t i = 0; i < n_points; i++)
+    {
+        p.ghost.SetHeadingRelative(0.0);
+        MoveGhost(p, p.cruise_speed * dt, -p.ghost.GetOffset());
+        double t = p.path.back().t + dt;
+        p.path.emplace_back();
+        SetSample(p.ghost, t, p.path.back());
+    }
+}
+
+void TrajectoryPredictor::SamplePath(ObjectPredictor& p, double time, double fraction)
+{
+    for (unsigned int i = 1; i <= n_samples_; i++)
+    {
+        const Sample& s0     = p.path[i * PATH_STEPS];
+        const Sample& s1     = p.path[i * PATH_STEPS + 1];
+        Sample&       sample = p.samples[i - 1];
+
+        sample   = s0;
+        sample.t = time + i * resolution_;
+        if (fraction > 0.0)
+        {
+            sample.x += fraction * (s1.x - s0.x);
+            sample.y += fraction * (s1.y - s0.y);
+            sample.z += fraction * (s1.z - s0.z);
+
+            sample.h = GetAngleSum(s0.h, fraction * GetAngleDifference(s1.h, s0.h));
+            sample.p = GetAngleSum(s0.p, fraction * GetAngleDifference(s1.p, s0.p));
+            sample.r = GetAngleSum(s0.r, fraction * GetAngleDifference(s1.r, s0.r));
+        }
+    }
+}
+
+bool TrajectoryPredictor::AdvancePath(ObjectPredictor& p, double time)
+{
+    double dt    = resolution_ / PATH_STEPS;
+    double steps = (time - p.path[0].t) / dt;
+
+    if (steps < -SMALL_NUMBER || steps > n_samples_ * PATH_STEPS)
+    {
+        return false;
+    }
+
+    // the object is expected between path points n and n + 1
+    size_t n        = static_cast<size_t>(MAX(0.0, floor(steps + SMALL_NUMBER)));
+    double fraction = MAX(0.0, steps - static_cast<double>(n));
+    if (fraction < SMALL_NUMBER)
+    {
+        fraction = 0.0;
+    }
+
+    const Sample&                s0  = p.path[n];
+    const Sample&                s1  = p.path[n + 1];
+    const roadmanager::Position& pos = p.object->pos_;
+    if (pos.GetTrackId() != s0.road_id || s1.road_id != s0.road_id || pos.GetLaneId() != s0.lane_id ||
+        fabs(pos.GetS() - (s0.s + fraction * (s1.s - s0.s))) > 0.1)
+    {
+        return false;
+    }
+
+    if (n > 0)
+    {
+        p.path.erase(p.path.begin(), p.path.begin() + static_cast<std::ptrdiff_t>(n));
+        ExtendPath(p, n);
+    }
+    SamplePath(p, time, fraction);
+
+    return true;
+}
+
+void TrajectoryPredictor::Predict(ObjectPredictor& p, double time)
+{
+    Object* obj = p.object;
+
+    // Introspect active actions
+    LatLaneChangeAction* activeLcAction    = nullptr;
+    LongSpeedAction*     activeSpeedAction = nullptr;
+    for (Event* event : obj->objectEvents_)
+    {
+        for (OSCAction* action : event->action_)
+        {
+            if (action->GetBaseType() != OSCAction::BaseType::PRIVATE ||
+                (action->GetCurrentState() != StoryBoardElement::State::RUNNING && action->GetCurrentState() != StoryBoardElement::State::STANDBY))
+            {
+                continue;
+            }
+
+            if (action->action_type_ == OSCAction::ActionType::LAT_LANE_CHANGE && activeLcAction == nullptr)
+            {
+                activeLcAction = static_cast<LatLaneChangeAction*>(action);
+            }
+            else if (action->action_type_ == OSCAction::ActionType::LONG_SPEED && activeSpeedAction == nullptr)
+            {
+                activeSpeedAction = static_cast<LongSpeedAction*>(action);
+            }
+        }
+    }
+
+    // [GT_MOD] Without active SpeedAction, use last known target speed, else latest SpeedAction of init. Physical speed is
+    // not used as fallback, without any definition the object is expected to stop.
+    double fallbackSpeed = 0.0;
+    if (activeSpeedAction == nullptr)
+    {
+        if (p.has_target_speed)
+        {
+            fallbackSpeed = p.target_speed;
+        }
+        else
+        {
+            for (OSCPrivateAction* action : obj->initActions_)
+            {
+                if (action->action_type_ == OSCAction::ActionType::LONG_SPEED)
+                {
+                    activeSpeedAction = static_cast<LongSpeedAction*>(action);
+                }
+            }
+        }
+    }
+
+    // Constant speed along lane center is kept as a fine resolution path, see AdvancePath()
+    OSCPrivateAction::TransitionDynamics speedDynamics;
+    bool                                 laneFollowing = activeLcAction == nullptr && obj->pos_.GetTrackId() != ID_UNDEFINED;
+    bool                                 cruising      = laneFollowing;
+    double                               cruiseSpeed   = fallbackSpeed;
+
+    if (activeSpeedAction != nullptr)
+    {
+        speedDynamics = activeSpeedAction->transition_;
+        cruising      = false;
+
+        if (activeSpeedAction->target_)
+        {
+            double targetSpeed = activeSpeedAction->target_->GetValue();
+            double speed       = obj->GetSpeed();
+            p.has_target_speed = true;
+            p.target_speed     = targetSpeed;
+
+            // [GT_MOD] Predict a fresh transition from current to target speed over the original duration/shape. Reset()
+            // clears elapsed time, avoiding an instant jump if the action was previously completed.
+            speedDynamics.Reset();
+            speedDynamics.SetStartVal(speed);
+            speedDynamics.SetTargetVal(targetSpeed);
+            speedDynamics.UpdateRate();
+
+            cruising    = laneFollowing && fabs(speed - targetSpeed) < SMALL_NUMBER;
+            cruiseSpeed = targetSpeed;
+        }
+    }
+
+    const roadmanager::Route* route     = obj->pos_.GetRoute();
+    size_t                    routeSize = route ? route->minimal_waypoints_.size() : 0;
+
+    if (cruising && p.cruising && fabs(cruiseSpeed - p.cruise_speed) < SMALL_NUMBER && route == p.source_route &&
+        routeSize == p.source_route_size && AdvancePath(p, time))
+    {
+        return;
+    }
+
+    // Shadow simulation: Clone current position, without route since the route copy is reused
+    p.ghost.SetRoute(nullptr);
+    p.ghost = obj->pos_;
+
+    // [GT_MOD] Start at center of current lane. Real vehicle might be offset due to PID deviation (e.g. cutting corners),
+    // possibly snapping the ghost to wrong lane or maintaining the offset along the trajectory.
+    if (std::abs(p.ghost.GetOffset()) > 0.001)
+    {
+        p.ghost.SetLanePos(p.ghost.GetTrackId(), p.ghost.GetLaneId(), p.ghost.GetS(), 0.0);
+        p.ghost.SetHeadingRelative(0.0);
+    }
+
+    // [GT_MOD] Follow a copy of the route for correct branching at junctions. The ghost advances waypoints during
+    // prediction, which must not affect the object route.
+    if (route)
+    {
+        p.route = *route;
+        p.ghost.SetRoute(&p.route);
+
+        if (p.route.IsValid())
+        {
+            // [GT_MOD] Deviation from lane center might have snapped the object to wrong lane, which would make MoveAlongS
+            // select wrong road at junctions. Use lane of the current route waypoint instead.
+            id_t currentRoadId = p.ghost.GetTrackId();
+            for (const auto& wp : p.route.minimal_waypoints_)
+            {
+                if (wp.GetTrackId() == currentRoadId)
+                {
+                    if (wp.GetLaneId() != p.ghost.GetLaneId())
+                    {
+                        p.ghost.SetLanePos(currentRoadId, wp.GetLaneId(), p.ghost.GetS(), 0.0);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    p.samples.resize(n_samples_);
+    p.path.clear();
+    p.cruising          = cruising;
+    p.cruise_speed      = cruiseSpeed;
+    p.source_route      = route;
+    p.source_route_size = routeSize;
+
+    if (cruising)
+    {
+        p.path.emplace_back();
+        SetSample(p.ghost, time, p.path.back());
+        ExtendPath(p, n_samples_ * PATH_STEPS + 1);
+        SamplePath(p, time, 0.0);
+        return;
+    }
+
+    for (unsigned int i = 1; i <= n_samples_; ++i)
+    {
+        double speed = fallbackSpeed;
+
+        if (activeSpeedAction != nullptr)
+        {
+            // Advance the dynamics state to predict future speed
+            if (speedDynamics.dimension_ == OSCPrivateAction::DynamicsDimension::TIME)
+            {
+                speedDynamics.Step(resolution_);
+            }
+            else if (speedDynamics.dimension_ == OSCPrivateAction::DynamicsDimension::DISTANCE)
+            {
+                // assume constant speed over the step, from previous evaluation
+                speedDynamics.Step(speedDynamics.Evaluate() * resolution_);
+            }
+            speed = speedDynamics.Evaluate();
+        }
+
+        double ds          = speed * resolution_;
+        double dLaneOffset = 0.0;
+
+        if (activeLcAction != nullptr)
+        {
+            OSCPrivateAction::TransitionDynamics futureDynamics = activeLcAction->transition_;
+            if (futureDynamics.dimension_ == OSCPrivateAction::DynamicsDimension::TIME)
+            {
+                futureDynamics.Step(i * resolution_);
+            }
+            else if (futureDynamics.dimension_ == OSCPrivateAction::DynamicsDimension::DISTANCE)
+            {
+                futureDynamics.Step(i * ds);
+            }
+            dLaneOffset = futureDynamics.Evaluate() - p.ghost.GetOffset();
+        }
+        else
+        {
+            // [GT_MOD] Not changing lane, steer back to lane center and align heading
+            dLaneOffset = -p.ghost.GetOffset();
+            p.ghost.SetHeadingRelative(0.0);
+        }
+
+        MoveGhost(p, ds, dLaneOffset);
+        SetSample(p.ghost, time + i * resolution_, p.samples[i - 1]);
+    }
+}
+
+// [GT_MOD] Whether future trajectory of the object is projected by the TrajectoryPredictor: Ghost lacking trail to sample
+// from, or Ego/External/Interactive vehicles. ID 0 is typically Ego.
+static bool UseProjectedTrajectory(const ObjectState* objectState, const Object* obj)
+{
+    int ctrlType = objectState->state_.info.ctrl_type;
+
+    if (ctrlType == Controller::Type::GHOST_RESERVED_TYPE)
+    {
+        return obj->trail_.GetNumberOfVertices() == 0;
+    }
+
+    return objectState->state_.info.id == 0 || ctrlType == Controller::CONTROLLER_TYPE_EXTERNAL ||
+           ctrlType == Controller::CONTROLLER_TYPE_UDP_DRIVER || ctrlType == Controller::CONTROLLER_TYPE_INTERACTIVE;
+}
+
+// [GT_MOD] Prevent "Wrong Road Snap" (e.g. Road 7 vs Road 13 in Junction 4). If the object is snapped to a road NOT in
+// its route, move it to the closest road that IS in the route, within 5 m lateral distance.
+static void SnapToRouteRoad(Object* obj)
+{
+    if (obj->pos_.GetRoute() == nullptr || !obj->pos_.GetRoute()->IsValid())
+    {
+        return;
+    }
+
+    id_t        currentRoadId = obj->pos_.GetTrackId();
+    const auto& waypoints     = obj->pos_.GetRoute()->minimal_waypoints_;
+
+    for (const auto& wp : waypoints)
+    {
+        if (wp.GetTrackId() == currentRoadId)
+        {
+            return;
+        }
+    }
+
+    double bestT      = 1e9;
+    id_t   bestRoadId = 0;
+    double curX       = obj->pos_.GetX();
+    double curY       = obj->pos_.GetY();
+    double curZ       = obj->pos_.GetZ();
+
+    for (const auto& wp : waypoints)
+    {
+        // probe the candidate road, using lateral offset as metric
+        roadmanager::Position tempPos;
+        tempPos.XYZ2TrackPos(curX, curY, curZ, roadmanager::Position::PosMode::UNDEFINED, false, wp.GetTrackId());
+
+        double t = std::abs(tempPos.GetT());
+        if (t < bestT)
+        {
+            bestT      = t;
+            bestRoadId = wp.GetTrackId();
+        }
+    }
+
+    if (bestRoadId != currentRoadId && bestT < 5.0)
+    {
+        // Apply correction to the actual object state, affecting next frame as well as current reporting
+        obj->pos_.XYZ2TrackPos(curX, curY, curZ, roadmanager::Position::PosMode::UNDEFINED, false, bestRoadId);
+    }
+}
+
 // ScenarioGateway
 
 OSIReporter::OSIReporter(ScenarioEngine *scenarioengine)
@@ -154,6 +708,15 @@ OSIReporter::OSIReporter(ScenarioEngine *scenarioengine)
 
     // Sensor Data
     obj_osi_internal.sd = new osi3::SensorData();
+
+    // [GT_MOD] Projected future trajectories
+    std::string horizon    = SE_Env::Inst().GetOptions().GetOptionValue("osi_traj_horizon");
+    std::string resolution = SE_Env::Inst().GetOptions().GetOptionValue("osi_traj_dt");
+    std::string threads    = SE_Env::Inst().GetOptions().GetOptionValue("osi_traj_threads");
+    trajectory_predictor_  = {new TrajectoryPredictor(horizon.empty() ? 10.0 : strtod(horizon),
+                                                     resolution.empty() ? 0.5 : strtod(resolution),
+                                                     threads.empty() ? 0 : static_cast<unsigned int>(MAX(0, strtoi(threads)))),
+                              [](TrajectoryPredictor* p) { delete p; }};
 }
 
 OSIReporter::~OSIReporter()
@@ -342,9 +905,9 @@ int OSIReporter::UpdateOSIGroundTruth(const std::vector<std::unique_ptr<ObjectSt
         {
             SerializeDynamicAndStaticData();
         }
-        // Merge for API
-        obj_osi_external.gt->CopyFrom(*obj_osi_internal.dynamic_gt);
-        obj_osi_external.gt->MergeFrom(*obj_osi_internal.static_gt);
+        // Static data for API
+        obj_osi_external.gt_static_part = obj_osi_internal.static_gt;
+        static_gt_revision_++;
 
         counter_offset_  = GetCounter();
         osi_initialized_ = true;
@@ -353,10 +916,14 @@ int OSIReporter::UpdateOSIGroundTruth(const std::vector<std::unique_ptr<ObjectSt
     {
         // We always want to update the dynamic ground truth
         UpdateOSIDynamicGroundTruth(objectState);
-        obj_osi_external.gt->CopyFrom(*obj_osi_internal.dynamic_gt);
-
         UpdateOSIStaticGroundTruth(objectState);
 
+        if (obj_osi_internal.static_updated_gt->stationary_object_size() > 0)
+        {
+            // added misc objects have been merged into the static ground truth
+            static_gt_revision_++;
+        }
+
         switch (static_update_mode_)
         {
             case OSIStaticReportMode::DEFAULT:  // Only log and transmit dynamic ground truth
@@ -367,22 +934,33 @@ int OSIReporter::UpdateOSIGroundTruth(const std::vector<std::unique_ptr<ObjectSt
                 // include any added misc objects
                 if (obj_osi_internal.static_updated_gt->stationary_object_size() > 0)
                 {
-                    obj_osi_external.gt->MergeFrom(*obj_osi_internal.static_updated_gt);
+                    obj_osi_external.gt_static_part = obj_osi_internal.static_updated_gt;
+                }
+                else
+                {
+                    obj_osi_external.gt_static_part = nullptr;
                 }
                 break;
             case OSIStaticReportMode::API:  // Log dynamic ground truth, serialize and transmit combined ground truth
                 SerializeDynamicData();
 
-                obj_osi_external.gt->MergeFrom(*obj_osi_internal.static_gt);  // Merge for API
+                obj_osi_external.gt_static_part = obj_osi_internal.static_gt;  // Merge for API
                 break;
             case OSIStaticReportMode::API_AND_LOG:  // Log combined ground truth, serialze and transmit combined ground truth
                 SerializeDynamicAndStaticData();
 
-                obj_osi_external.gt->MergeFrom(*obj_osi_internal.static_gt);  // Merge for API
+                obj_osi_external.gt_static_part = obj_osi_internal.static_gt;  // Merge for API
                 break;
         }
     }
 
+    // Combined ground truth for API. Skipped if user fetches static and dynamic parts separately, then merged only on request.
+    obj_osi_external.gt_merged = false;
+    if (!lazy_gt_merge_)
+    {
+        MergeOSIGroundTruth();
+    }
+
     if (IsFileOpen())
     {
         WriteOSIFile();
@@ -469,6 +1047,7 @@ int OSIReporter::CreateOSIStaticGroundTruthFromODR()
         }
     }
 
+    opendrive->EnsureRoadMarkOSIPoints();
     UpdateOSIRoadLane();
     UpdateOSILaneBoundary();
     UpdateOSIIntersection();
@@ -610,11 +1189,13 @@ int OSIReporter::UpdateOSIDynamicGroundTruth(const std::vector<std::unique_ptr<O
                                   obj->state_.info.boundingbox.center_.z_);
     }
 
+    // Collect objects to report first, for their future trajectories to be predicted together
+    reported_objects_.clear();
     if (osi_crop_.empty())
     {
         for (const auto &obj : objectState)
         {
-            CheckDynamicTypeAndUpdate(obj);
+            reported_objects_.push_back(&obj);
         }
     }
     else
@@ -658,13 +1239,43 @@ int OSIReporter::UpdateOSIDynamicGroundTruth(const std::vector<std::unique_ptr<O
                     }
                 }
 
-                if (update && !ids_added.count(obj->state_.info.id))  // Update only once
+                if (update && !ids_added.count(obj->state_.info.id))  // Update only once
+                {
+                    ids_added.insert(obj->state_.info.id);
+                    reported_objects_.push_back(&obj);
+                }
+            }
+        }
+    }
+
+    if (scenario_engine_ != nullptr)
+    {
+        trajectory_predictor_->BeginUpdate();
+        for (const std::unique_ptr<ObjectState> *state : reported_objects_)
+        {
+            const ObjectState *os = state->get();
+            if (os->state_.info.obj_type != static_cast<int>(Object::Type::VEHICLE) ||
+                (os->state_.info.ctrl_type == Controller::Type::GHOST_RESERVED_TYPE && !report_ghost_))
+            {
+                continue;
+            }
+
+            Object *obj = scenario_engine_->entities_.GetObjectById(os->state_.info.id);
+            if (obj != nullptr && UseProjectedTrajectory(os, obj))
+            {
+                if (os->state_.info.ctrl_type != Controller::Type::GHOST_RESERVED_TYPE)
                 {
-                    ids_added.insert(obj->state_.info.id);
-                    CheckDynamicTypeAndUpdate(obj);
+                    SnapToRouteRoad(obj);
                 }
+                trajectory_predictor_->Request(obj);
             }
         }
+        trajectory_predictor_->Run(scenario_engine_->getSimulationTime());
+    }
+
+    for (const std::unique_ptr<ObjectState> *state : reported_objects_)
+    {
+        CheckDynamicTypeAndUpdate(*state);
     }
 
     UpdateEnvironment(scenario_engine_->environment);
@@ -936,343 +1547,6 @@ int OSIReporter::UpdateOSIStationaryObject(ObjectState *objectState)
     return 1;
 }
 
-// [GT_MOD] Helper function to get target lane ID from route for a given road
-static int GetTargetLaneIdFromRoute(const roadmanager::Route* route, int roadId)
-{
-    if (!route || !route->IsValid())
-    {
-        return 0; // Default to lane 0 if no route
-    }
-
-    // Search for the road in route waypoints
-    for (size_t i = 0; i < route->minimal_waypoints_.size(); i++)
-    {
-        if (route->minimal_waypoints_[i].GetTrackId() == roadId)
-        {
-            return route->minimal_waypoints_[i].GetLaneId();
-        }
-    }
-
-    return 0; // Not found in route, default to lane 0
-}
-
-// [GT_MOD] Helper to generate projected trajectory based on road geometry and active actions (Shadow Simulation)
-static void GenerateProjectedTrajectory(scenarioengine::ObjectState* objectState, scenarioengine::ScenarioEngine* scenario_engine)
-{
-    if (!scenario_engine) return;
-    int id = objectState->state_.info.id;
-    
-    // [GT_MOD] State Memory for Speed Actions (Sustain WaitOnRed)
-    static std::map<int, double> lastTargetSpeedMap;
-
-    auto* simObj = scenario_engine->entities_.GetObjectById(id);
-    if (!simObj) return;
-
-    // Shadow simulation: Clone current position
-    // This maintains the current Route info if assigned
-    // Shadow simulation: Clone current position
-    // This maintains the current Route info if assigned
-    roadmanager::Position ghostPos = simObj->pos_;
-
-    // [GT_MOD] CRITICAL FIX: Reset lateral offset to 0.0
-    // Real vehicle might be offset due to PID deviation (e.g. cutting corners).
-    // If we keep this offset, ghostPos might snap to wrong lane (e.g. sidewalk)
-    // or generate a trajectory that maintains this offset.
-    // We force the ghost vehicle to start at the center of its current lane.
-    if (std::abs(ghostPos.GetOffset()) > 0.001)
-    {
-        ghostPos.SetLanePos(ghostPos.GetTrackId(), ghostPos.GetLaneId(), ghostPos.GetS(), 0.0);
-        // Also fix heading to align with road
-        ghostPos.SetHeadingRelative(0.0);
-    }
-
-    // [GT_MOD] Inject Route: Ensure ghost position has the route for correct branching at junctions
-    if (simObj->pos_.GetRoute())
-    {
-        // [GT_MOD] Clone Route to prevent shared state corruption and double-free
-    // ghostPos modifies the route (advances waypoints) during prediction. 
-    // If we share the pointer, simObj's route state gets corrupted (e.g. skips turns).
-    if (simObj->pos_.GetRoute())
-    {
-        roadmanager::Route* clonedRoute = new roadmanager::Route();
-        clonedRoute->CopyFrom(*simObj->pos_.GetRoute());
-        ghostPos.SetRoute(clonedRoute); 
-        // ghostPos now owns clonedRoute and will delete it in its destructor.
-    }
-    }
-
-    // [GT_MOD] Debug: Log trajectory state AFTER route cloning
-    printf("GT_TRAJ: After clone - roadId=%d, laneId=%d, hasRoute=%d\n",
-        ghostPos.GetTrackId(), ghostPos.GetLaneId(),
-        (ghostPos.GetRoute() && ghostPos.GetRoute()->IsValid()) ? 1 : 0);
-    if (ghostPos.GetRoute() && ghostPos.GetRoute()->IsValid())
-    {
-        printf("GT_TRAJ: Route waypoints=%d\n", (int)ghostPos.GetRoute()->minimal_waypoints_.size());
-        for (size_t i = 0; i < ghostPos.GetRoute()->minimal_waypoints_.size() && i < 5; i++)
-        {
-            printf("GT_TRAJ:   WP[%d] roadId=%d, laneId=%d\n", 
-                (int)i, ghostPos.GetRoute()->minimal_waypoints_[i].GetTrackId(),
-                ghostPos.GetRoute()->minimal_waypoints_[i].GetLaneId());
-        }
-        
-        // [GT_MOD] CRITICAL FIX: Correct ghostPos lane ID to match route
-        // Problem: PID control causes vehicle to deviate from lane center, causing esmini
-        // to snap to wrong lane (e.g. lane 1 instead of lane -1). This causes MoveAlongS
-        // to select wrong road at junctions (e.g. road 16 instead of road 13).
-        // Solution: Find current waypoint in route and force ghostPos to use that lane ID.
-        int currentRoadId = ghostPos.GetTrackId();
-        for (const auto& wp : ghostPos.GetRoute()->minimal_waypoints_)
-        {
-            if (wp.GetTrackId() == currentRoadId)
-            {
-                int routeLaneId = wp.GetLaneId();
-                int currentLaneId = ghostPos.GetLaneId();
-                if (routeLaneId != currentLaneId)
-                {
-                    printf("GT_TRAJ: Correcting ghostPos lane: %d -> %d (route)\n", 
-                        currentLaneId, routeLaneId);
-                    ghostPos.SetLanePos(currentRoadId, routeLaneId, ghostPos.GetS(), 0.0);
-                }
-                break;
-            }
-        }
-    }
-
-    // Introspect active actions
-    scenarioengine::LatLaneChangeAction* activeLcAction = nullptr;
-    scenarioengine::LongSpeedAction* activeSpeedAction = nullptr;
-    
-    auto privateActions = simObj->getPrivateActions();
-    
-    for (auto* action : privateActions)
-    {
-         std::string typeStr = action->Type2Str();
-         if (typeStr == "LaneChangeAction" && !activeLcAction)
-         {
-             activeLcAction = static_cast<scenarioengine::LatLaneChangeAction*>(action);
-         }
-         else if (typeStr == "SpeedAction" && !activeSpeedAction)
-         {
-             activeSpeedAction = static_cast<scenarioengine::LongSpeedAction*>(action);
-         }
-    }
-
-    // [GT_MOD] Fallback Speed Flag
-    double fallbackSpeed = 0.0;
-    bool useFallback = false;
-
-    if (activeSpeedAction)
-    {
-        // Case 1: Active Speed Action -> Update Memory
-        if (activeSpeedAction->target_)
-        {
-            lastTargetSpeedMap[id] = activeSpeedAction->target_->GetValue();
-        }
-    }
-    else
-    {
-        // Fallback: If no active SpeedAction found, check:
-        // 1. Memory (Last known target)
-        // 2. Init actions (History)
-        // 3. Default to 0.0 (Stop) - Physical speed is NOT used as fallback.
-        
-        if (lastTargetSpeedMap.count(id))
-        {
-             // Case 2: Use Memory
-             fallbackSpeed = lastTargetSpeedMap[id];
-             useFallback = true;
-        }
-        else
-        {
-             // Case 3: Check Init Actions
-             for (auto* action : simObj->initActions_)
-             {
-                 std::string typeStr = action->Type2Str();
-                 if (typeStr == "SpeedAction")
-                 {
-                     activeSpeedAction = static_cast<scenarioengine::LongSpeedAction*>(action);
-                 }
-             }
-
-             if (activeSpeedAction)
-             {
-                 // Found Init Action -> Update Memory and Use it
-                 if (activeSpeedAction->target_)
-                 {
-                     lastTargetSpeedMap[id] = activeSpeedAction->target_->GetValue();
-                 }
-             }
-             else
-             {
-                 // Case 4: No definition -> Stop
-                 fallbackSpeed = 0.0;
-                 useFallback = true;
-             }
-        }
-    }
-
-    // Shadow copy of speed action dynamics state if available
-    scenarioengine::OSCPrivateAction::TransitionDynamics speedDynamics;
-    bool usingSpeedAction = false;
-    double debugTargetSpeed = -1.0; 
-
-    if (activeSpeedAction)
-    {
-        speedDynamics = activeSpeedAction->transition_;
-        usingSpeedAction = true;
-
-        // [GT_MOD] Fix static trajectory:
-        // Identify intended target speed and reset dynamics to predict path from CURRENT speed to TARGET.
-        if (activeSpeedAction->target_)
-        {
-            double targetSpeed = activeSpeedAction->target_->GetValue();
-            double currentSpeed = simObj->GetSpeed();
-            debugTargetSpeed = targetSpeed;
-
-            // Re-initialize dynamics relative to current physical state
-            // [GT_MOD] Reset() is crucial to clear 'param_val_' (elapsed time).
-            // This ensures we predict a fresh transition from Current to Target over the original Duration/Shape,
-            // avoiding "Instant Jump" if the action was previously completed.
-            speedDynamics.Reset();
-            speedDynamics.SetStartVal(currentSpeed);
-            speedDynamics.SetTargetVal(targetSpeed);
-            // Ensure internal rate/parameters are updated
-            speedDynamics.UpdateRate();
-        }
-    }
-
-    double current_time = scenario_engine->getSimulationTime();
-    int samples = 20;
-    double dt = 0.5;
-
-    // [GT_DEBUG] Log once per second or frame (limiting output slightly effectively by loop)
-    // Actually, just log every time for now since we are stuck.
-    // printf("GT_DEBUG: Obj %d, ActiveSpeedAction: %d\n", id, usingSpeedAction);
-
-    for (int i = 1; i <= samples; ++i)
-    {
-        double t_future = current_time + i * dt;
-        double dt_step = dt;
-        
-        // Calculate speed for this step
-        double speed = 0.0; 
-
-        if (usingSpeedAction)
-        {
-            // Advance the dynamics state to predict future speed
-            if (activeSpeedAction->transition_.dimension_ == scenarioengine::OSCPrivateAction::DynamicsDimension::TIME)
-            {
-                speedDynamics.Step(dt_step); 
-            }
-            else if (activeSpeedAction->transition_.dimension_ == scenarioengine::OSCPrivateAction::DynamicsDimension::DISTANCE)
-            {
-                // Note: using 'speed' here is circular if speed is not yet set. 
-                // However, for trajectory prediction, we validly use the PREVIOUS step's speed or current state evaluation.
-                // But Evaluate() returns the speed for the CURRENT state.
-                // We should use the speed from *previous* evaluation for distance step.
-                // Assuming constant acc over step effectively.
-                double currentEvalSpeed = speedDynamics.Evaluate();
-                speedDynamics.Step(currentEvalSpeed * dt_step); 
-            }
-            // Update speed from dynamics
-            speed = speedDynamics.Evaluate();
-        }
-        else if (useFallback)
-        {
-            speed = fallbackSpeed;
-        }
-        else
-        {
-            // Should not be reached given logic above, but safely 0.0
-            speed = 0.0;
-        }
-
-        double ds = speed * dt_step;
-        
-        // [GT_DEBUG] Trace speed calculation
-        if (i == 1) {
-             printf("GT_DEBUG: Step 1, Speed: %.2f, ds: %.2f, UsingAction: %d, Tgt: %.2f\n", speed, ds, usingSpeedAction, debugTargetSpeed);
-        }
-        
-        // Lateral Logic (Lane Change)
-        double dLaneOffset = 0.0;
-        
-        if (activeLcAction)
-        {
-            scenarioengine::OSCPrivateAction::TransitionDynamics futureDynamics = activeLcAction->transition_;
-            if (futureDynamics.dimension_ == scenarioengine::OSCPrivateAction::DynamicsDimension::TIME)
-            {
-                futureDynamics.Step(i * dt);
-            }
-            else if (futureDynamics.dimension_ == scenarioengine::OSCPrivateAction::DynamicsDimension::DISTANCE)
-            {
-                futureDynamics.Step(i * ds);
-            }
-            double desiredOffset = futureDynamics.Evaluate();
-            double currentGhostOffset = ghostPos.GetOffset(); 
-            dLaneOffset = desiredOffset - currentGhostOffset; 
-        }
-        else
-        {
-            // [GT_MOD] Default behavior: Steer back to lane center and align heading
-            // If not changing lanes, we want trajectory to be centered and parallel to lane.
-            dLaneOffset = -ghostPos.GetOffset();
-            ghostPos.SetHeadingRelative(0.0);
-        }
-
-
-        // Move the ghost position forward
-        int prevRoadId = ghostPos.GetTrackId();
-        auto ret = ghostPos.MoveAlongS(ds, dLaneOffset, -1.0, true, roadmanager::Position::MoveDirectionMode::HEADING_DIRECTION, true);
-        
-        // [GT_MOD] Fallback
-        if (static_cast<int>(ret) < 0) 
-        {
-             // [GT_DEBUG]
-             if (i == 1) printf("GT_DEBUG: MoveAlongS failed (ret=%d), trying fallback.\n", static_cast<int>(ret));
-             ret = ghostPos.MoveAlongS(ds, dLaneOffset, -1.0, true, roadmanager::Position::MoveDirectionMode::HEADING_DIRECTION, false);
-             if (static_cast<int>(ret) < 0 && i == 1) {
-                 printf("GT_DEBUG: Fallback MoveAlongS also failed (ret=%d).\n", static_cast<int>(ret));
-             }
-        }
-        
-        // [GT_MOD] Detect road transition and correct lane ID based on route
-        int currentRoadId = ghostPos.GetTrackId();
-        if (currentRoadId != prevRoadId && ghostPos.GetRoute())
-        {
-            // Road transition detected (Junction passed)
-            int targetLaneId = GetTargetLaneIdFromRoute(ghostPos.GetRoute(), currentRoadId);
-            int currentLaneId = ghostPos.GetLaneId();
-            
-            if (targetLaneId != currentLaneId)
-            {
-                // Correct to target lane from route
-                double currentS = ghostPos.GetS();
-                ghostPos.SetLanePos(currentRoadId, targetLaneId, currentS, 0.0);
-                
-                // Debug log
-                if (i == 1) {
-                    printf("GT_TRAJ: Road transition %d->%d, Lane corrected %d->%d\n",
-                        prevRoadId, currentRoadId, currentLaneId, targetLaneId);
-                }
-            }
-        }
-        
-        // Add point to OSI message
-        auto* point = obj_osi_internal.mobj->add_future_trajectory();
-        point->mutable_timestamp()->set_seconds((long long)t_future);
-        point->mutable_timestamp()->set_nanos((int)((t_future - (long long)t_future) * 1e9));
-        
-        point->mutable_position()->set_x(ghostPos.GetX());
-        point->mutable_position()->set_y(ghostPos.GetY());
-        point->mutable_position()->set_z(ghostPos.GetZ());
-        
-        point->mutable_orientation()->set_yaw(ghostPos.GetH());
-        point->mutable_orientation()->set_roll(ghostPos.GetR()); 
-        point->mutable_orientation()->set_pitch(ghostPos.GetP());
-    }
-}
-
 int OSIReporter::UpdateOSIMovingObject(ObjectState *objectState)
 {
     // Create OSI Moving object
@@ -1463,142 +1737,41 @@ int OSIReporter::UpdateOSIMovingObject(ObjectState *objectState)
         // [New] Generate Future Trajectory
         if (this->scenario_engine_)
         {
-            int id = objectState->state_.info.id;
-            scenarioengine::Object* targetObj = this->scenario_engine_->entities_.GetObjectById(id);
+            scenarioengine::Object* targetObj = this->scenario_engine_->entities_.GetObjectById(objectState->state_.info.id);
 
             if (targetObj)
             {
-                // CASE 1: Ghost Object (Report its own future trajectory)
-                // targetObj->isGhost_ determines if it IS a ghost? Or logic check.
-                // Entities.hpp says isGhost_ is a member.
-                // Or check controllers specific type if needed.
-                // The original code checked: ctrl_type == GHOST_RESERVED_TYPE
-                
-                // Let's rely on simple checks suitable for the context.
-                // Check if it's the Ghost object itself.
-                bool is_ghost = false;
-                // Method 1: Check driver_id / ctrl_type from objectState (which is reliable for current frame)
-                if (objectState->state_.info.ctrl_type == Controller::Type::GHOST_RESERVED_TYPE) {
-                    is_ghost = true;
+                if (UseProjectedTrajectory(objectState, targetObj))
+                {
+                    // [GT_MOD] Predicted for all reported objects up front, see UpdateOSIDynamicGroundTruth()
+                    trajectory_predictor_->AddFutureTrajectory(objectState->state_.info.id, obj_osi_internal.mobj);
                 }
-                
-                if (is_ghost)
+                else if (objectState->state_.info.ctrl_type == Controller::Type::GHOST_RESERVED_TYPE)
                 {
-                    // Sample future points from trail_
-                    double current_time = this->scenario_engine_->getSimulationTime(); 
-                    
-                    if (targetObj->trail_.GetNumberOfVertices() > 0)
-                    {
-                        int samples = 20;
-                        double dt = 0.5; 
+                    // Ghost object, sample its own future trajectory from trail_
+                    double current_time = this->scenario_engine_->getSimulationTime();
+                    double dt           = trajectory_predictor_->GetResolution();
 
-                         for(int i=1; i<=samples; ++i)
-                        {
-                            double t_future = current_time + i*dt;
-                            roadmanager::TrajVertex v;
-                            idx_t index = -1; // Removed scenarioengine:: qualifier if idx_t is global
-                            
-                            if (targetObj->trail_.FindPointAtTime(t_future, v, index) == 0) 
-                            {
-                                auto* point = obj_osi_internal.mobj->add_future_trajectory();
-                                point->mutable_timestamp()->set_seconds((long long)t_future);
-                                point->mutable_timestamp()->set_nanos((int)((t_future - (long long)t_future) * 1e9));
-                                
-                                point->mutable_position()->set_x(v.x);
-                                point->mutable_position()->set_y(v.y);
-                                point->mutable_position()->set_z(v.z);
-                                
-                                point->mutable_orientation()->set_yaw(v.h);
-                                point->mutable_orientation()->set_roll(0); 
-                                point->mutable_orientation()->set_pitch(0);
-                            }
-                        }
-                    }
-                    else
+                    for (unsigned int i = 1; i <= trajectory_predictor_->GetNumberOfSamples(); ++i)
                     {
-                        // [GT_MOD] Fallback: Generate projected trajectory if trail is empty
-                        GenerateProjectedTrajectory(objectState, this->scenario_engine_);
-                    }
-                }
-                // CASE 2: Ego Object (Report Spline to Ghost)
+                        double                  t_future = current_time + i * dt;
+                        roadmanager::TrajVertex v;
+                        idx_t                   index = -1;
 
-                else
-                {
-                    // [GT_MOD] Universal Fallback: Optimized
-                    // Only generate for Ego/External/Interactive vehicles to save performance.
-                    // ID 0 is typically Ego.
-                    int ctrlType = objectState->state_.info.ctrl_type;
-                    bool isEgoOrExternal = (objectState->state_.info.id == 0) ||
-                                           (ctrlType == scenarioengine::Controller::CONTROLLER_TYPE_EXTERNAL) ||
-                                           (ctrlType == scenarioengine::Controller::CONTROLLER_TYPE_UDP_DRIVER) ||
-                                           (ctrlType == scenarioengine::Controller::CONTROLLER_TYPE_INTERACTIVE);
-
-                    if (isEgoOrExternal)
-                    {
-                        // [GT_MOD] LOGIC FIX: Prevent "Wrong Road Snap" (e.g. Road 7 vs Road 13 in Junction 4)
-                        // If vehicle snaps to a road NOT in the route, try to find a better road THAT IS in the route.
-                        if (targetObj && targetObj->pos_.GetRoute() && targetObj->pos_.GetRoute()->IsValid())
+                        if (targetObj->trail_.FindPointAtTime(t_future, v, index) == 0)
                         {
-                            id_t currentRoadId = targetObj->pos_.GetTrackId();
-                            
-                            // Check if current road is in the route
-                            bool roadOnRoute = false;
-                            const auto& waypoints = targetObj->pos_.GetRoute()->minimal_waypoints_;
-                            
-                            for (const auto& wp : waypoints)
-                            {
-                                if (wp.GetTrackId() == currentRoadId)
-                                {
-                                    roadOnRoute = true;
-                                    break;
-                                }
-                            }
+                            auto* point = obj_osi_internal.mobj->add_future_trajectory();
+                            point->mutable_timestamp()->set_seconds((long long)t_future);
+                            point->mutable_timestamp()->set_nanos((int)((t_future - (long long)t_future) * 1e9));
 
-                            // If snapped to a wrong road (e.g. Road 7), attempt to recover
-                            if (!roadOnRoute && !waypoints.empty())
-                            {
-                                double bestT = 1e9;
-                                id_t bestRoadId = 0;  // Use 0 instead of -1 for unsigned type
-                                
-                                double curX = targetObj->pos_.GetX();
-                                double curY = targetObj->pos_.GetY();
-                                double curZ = targetObj->pos_.GetZ();
-
-                                // Search for closest road among route waypoints
-                                for (const auto& wp : waypoints)
-                                {
-                                    id_t candidateId = wp.GetTrackId();
-                                    
-                                    // Use a temporary position to probe the candidate road
-                                    roadmanager::Position tempPos;
-                                    // XYZ2TrackPos: mode=UNDEFINED (defaults), connectedOnly=false, roadId=candidateId, CheckOverlapping=false, AlongRoute=false(since check specific)
-                                    tempPos.XYZ2TrackPos(curX, curY, curZ, roadmanager::Position::PosMode::UNDEFINED, false, candidateId);
-                                    
-                                    // Check lateral offset magnitude
-                                    double t = std::abs(tempPos.GetT());
-                                    
-                                    // Check if valid match (XYZ2TrackPos returns valid S for the road?)
-                                    // It clamps S if out of bounds usually.
-                                    // We use T as metric.
-                                    if (t < bestT)
-                                    {
-                                        bestT = t;
-                                        bestRoadId = candidateId;
-                                    }
-                                }
+                            point->mutable_position()->set_x(v.x);
+                            point->mutable_position()->set_y(v.y);
+                            point->mutable_position()->set_z(v.z);
 
-                                // Threshold: 5m tolerance (same lane or adjacent)
-                                // If we found a much better road on the route, force snap to it.
-                                if (bestRoadId != -1 && bestRoadId != currentRoadId && bestT < 5.0)
-                                {
-                                    // Apply correction to the ACTUAL object state
-                                    // This fixes "Entity Ego" behavior for the NEXT frame and current reporting
-                                    targetObj->pos_.XYZ2TrackPos(curX, curY, curZ, roadmanager::Position::PosMode::UNDEFINED, false, bestRoadId);
-                                }
-                            }
+                            point->mutable_orientation()->set_yaw(v.h);
+                            point->mutable_orientation()->set_roll(0);
+                            point->mutable_orientation()->set_pitch(0);
                         }
-
-                        GenerateProjectedTrajectory(objectState, this->scenario_engine_);
                     }
                 }
             }
@@ -1853,43 +2026,40 @@ int OSIReporter::UpdateOSIIntersection()
                     idx_t                          to_global_id   = lane_section_out->GetLaneGlobalIdById(to_lane_id);
 
                     // locate outgoing lane and register incoming lane
-                    for (unsigned int jj = 0; jj < obj_osi_internal.ln.size(); jj++)
+                    osi3::Lane *to_lane = GetOSILaneFromGlobalId(to_global_id);
+                    if (to_lane != nullptr)
                     {
-                        if (obj_osi_internal.ln[jj]->mutable_id()->value() == to_global_id)
-                        {
-                            osi_lane                                            = obj_osi_internal.ln[jj];
-                            osi3::Lane_Classification_LanePairing *lane_pairing = nullptr;
+                        osi_lane                                            = to_lane;
+                        osi3::Lane_Classification_LanePairing *lane_pairing = nullptr;
 
-                            if (osi_lane->mutable_classification()->mutable_lane_pairing()->size() == 0)
-                            {
-                                // create lane pairing element to add first connection to one of the ends
-                                lane_pairing = osi_lane->mutable_classification()->add_lane_pairing();
-                            }
-                            else
+                        if (osi_lane->mutable_classification()->mutable_lane_pairing()->size() == 0)
+                        {
+                            // create lane pairing element to add first connection to one of the ends
+                            lane_pairing = osi_lane->mutable_classification()->add_lane_pairing();
+                        }
+                        else
+                        {
+                            if (osi_lane->mutable_classification()->mutable_lane_pairing()->size() > 1)
                             {
-                                if (osi_lane->mutable_classification()->mutable_lane_pairing()->size() > 1)
-                                {
-                                    LOG_ERROR("Unexpected lane pairing size for osi lane {}", to_global_id);
-                                }
-                                // reuse existing lane pairing element to add connection for the other end
-                                lane_pairing = osi_lane->mutable_classification()->mutable_lane_pairing(0);
+                                LOG_ERROR("Unexpected lane pairing size for osi lane {}", to_global_id);
                             }
+                            // reuse existing lane pairing element to add connection for the other end
+                            lane_pairing = osi_lane->mutable_classification()->mutable_lane_pairing(0);
+                        }
 
-                            // all connections are mutual, i.e. any incoming->outgoing pair exists twice, one for each direction.
-                            // Hence, register only one way here. Register if for the to-lane, since that direction is known.
-                            if (c->GetContactPoint() == roadmanager::ContactPointType::CONTACT_POINT_END)
-                            {
-                                lane_pairing->mutable_successor_lane_id()->set_value(from_global_id);
-                            }
-                            else if (c->GetContactPoint() == roadmanager::ContactPointType::CONTACT_POINT_START)
-                            {
-                                lane_pairing->mutable_antecessor_lane_id()->set_value(from_global_id);
-                            }
-                            else
-                            {
-                                LOG_ERROR("Unexpected direct junction lane link contact point (junction {})", junction->GetId());
-                            }
-                            break;
+                        // all connections are mutual, i.e. any incoming->outgoing pair exists twice, one for each direction.
+                        // Hence, register only one way here. Register if for the to-lane, since that direction is known.
+                        if (c->GetContactPoint() == roadmanager::ContactPointType::CONTACT_POINT_END)
+                        {
+                            lane_pairing->mutable_successor_lane_id()->set_value(from_global_id);
+                        }
+                        else if (c->GetContactPoint() == roadmanager::ContactPointType::CONTACT_POINT_START)
+                        {
+                            lane_pairing->mutable_antecessor_lane_id()->set_value(from_global_id);
+                        }
+                        else
+                        {
+                            LOG_ERROR("Unexpected direct junction lane link contact point (junction {})", junction->GetId());
                         }
                     }
                 }
@@ -2267,59 +2437,46 @@ int OSIReporter::UpdateOSIIntersection()
 
     // Lets Update the antecessor and successor lanes of the lanes that are not intersections
     // Get all the intersection lanes, this lanes have the predecessor and successor lanes information
-    std::vector<osi3::Lane *> IntersectionLanes;
+    // Also index all lanes by global id, to look up the connected lanes directly instead of scanning all lanes per connection
+    std::vector<osi3::Lane *>                  IntersectionLanes;
+    std::unordered_map<uint64_t, osi3::Lane *> lane_by_id;
+    lane_by_id.reserve(static_cast<size_t>(obj_osi_internal.static_gt->lane_size()));
     for (int i = 0; i < obj_osi_internal.static_gt->lane_size(); ++i)
     {
+        lane_by_id.emplace(obj_osi_internal.static_gt->lane(i).id().value(), obj_osi_internal.static_gt->mutable_lane(i));
         if (obj_osi_internal.static_gt->lane(i).classification().type() == osi3::Lane_Classification_Type::Lane_Classification_Type_TYPE_INTERSECTION)
         {
             IntersectionLanes.push_back(obj_osi_internal.static_gt->mutable_lane(i));
         }
     }
 
-    // For each lane in OSI groundTruth
-    for (int i = 0; i < obj_osi_internal.static_gt->lane_size(); ++i)
+    // For each connection of the intersections, register the intersection as successor or predecessor of the connected lane
+    // Only the first connection found is registered, to lanes not having any connections yet
+    for (unsigned int j = 0; j < IntersectionLanes.size(); ++j)
     {
-        // Check if the lane is in the intersection
-        for (unsigned int j = 0; j < IntersectionLanes.size(); ++j)
+        for (int k = 0; k < IntersectionLanes[j]->classification().lane_pairing_size(); ++k)
         {
-            for (int k = 0; k < IntersectionLanes[j]->classification().lane_pairing_size(); ++k)
+            // Check predecessors
+            if (IntersectionLanes[j]->classification().lane_pairing()[k].has_antecessor_lane_id())
             {
-                // Check predecessors
-                if (IntersectionLanes[j]->classification().lane_pairing()[k].has_antecessor_lane_id())
+                // then we add the intersection ID to the successor of the lane
+                auto it = lane_by_id.find(IntersectionLanes[j]->classification().lane_pairing()[k].antecessor_lane_id().value());
+                if (it != lane_by_id.end() && it->second->classification().lane_pairing_size() == 0)
                 {
-                    // It lane is in predecesor of the intersection
-                    if (obj_osi_internal.static_gt->lane(i).id().value() ==
-                        IntersectionLanes[j]->classification().lane_pairing()[k].antecessor_lane_id().value())
-                    {
-                        // then we add the intersection ID to the successor of the lane
-                        if (obj_osi_internal.static_gt->mutable_lane(i)->mutable_classification()->lane_pairing_size() == 0)
-                        {
-                            obj_osi_internal.static_gt->mutable_lane(i)
-                                ->mutable_classification()
-                                ->add_lane_pairing()
-                                ->mutable_successor_lane_id()
-                                ->set_value(IntersectionLanes[j]->id().value());
-                        }
-                    }
+                    it->second->mutable_classification()->add_lane_pairing()->mutable_successor_lane_id()->set_value(
+                        IntersectionLanes[j]->id().value());
                 }
+            }
 
-                // Check successors
-                if (IntersectionLanes[j]->classification().lane_pairing()[k].has_successor_lane_id())
+            // Check successors
+            if (IntersectionLanes[j]->classification().lane_pairing()[k].has_successor_lane_id())
+            {
+                // then we add the intersection ID to the predecessor of the lane
+                auto it = lane_by_id.find(IntersectionLanes[j]->classification().lane_pairing()[k].successor_lane_id().value());
+                if (it != lane_by_id.end() && it->second->classification().lane_pairing_size() == 0)
                 {
-                    // It lane is in successor of the intersection
-                    if (obj_osi_internal.static_gt->lane(i).id().value() ==
-                        IntersectionLanes[j]->classification().lane_pairing()[k].successor_lane_id().value())
-                    {
-                        // then we add the intersection ID to the predecessor of the lane
-                        if (obj_osi_internal.static_gt->mutable_lane(i)->mutable_classification()->lane_pairing_size() == 0)
-                        {
-                            obj_osi_internal.static_gt->mutable_lane(i)
-                                ->mutable_classification()
-                                ->add_lane_pairing()
-                                ->mutable_antecessor_lane_id()
-                                ->set_value(IntersectionLanes[j]->id().value());
-                        }
-                    }
+                    it->second->mutable_classification()->add_lane_pairing()->mutable_antecessor_lane_id()->set_value(
+                        IntersectionLanes[j]->id().value());
                 }
             }
         }
@@ -3210,58 +3367,71 @@ int OSIReporter::UpdateOSIRoadLane()
                             }
                         }
 
-                        for (int l = 0; l < obj_osi_internal.static_gt->lane_size(); ++l)
+                        // look up the connected lanes directly by global id, both links might refer to the same lane
+                        osi3::Lane *osi_lane_predecessor = nullptr;
+                        osi3::Lane *osi_lane_successor   = nullptr;
+
+                        if (predecessorRoad && predecessor_lane_section && link_predecessor && driving_lane_predecessor)
                         {
-                            lane_pairing = nullptr;
+                            osi_lane_predecessor = GetOSILaneFromGlobalId(driving_lane_predecessor->GetGlobalId());
+                        }
+
+                        if (successorRoad && successor_lane_section && link_successor && driving_lane_successor)
+                        {
+                            osi_lane_successor = GetOSILaneFromGlobalId(driving_lane_successor->GetGlobalId());
+                        }
 
-                            if (predecessorRoad && predecessor_lane_section && link_predecessor && driving_lane_predecessor &&
-                                driving_lane_predecessor->GetGlobalId() == obj_osi_internal.static_gt->lane(l).id().value())
+                        if (osi_lane_predecessor != nullptr)
+                        {
+                            // find first empty pairing slot for successor lane
+                            lane_pairing = nullptr;
+                            for (int m = 0; m < osi_lane_predecessor->classification().lane_pairing_size(); ++m)
                             {
-                                // find first empty pairing slot for successor lane
-                                for (int m = 0; m < obj_osi_internal.static_gt->lane(l).classification().lane_pairing_size(); ++m)
+                                if (!osi_lane_predecessor->classification().lane_pairing(m).has_successor_lane_id())
                                 {
-                                    if (!obj_osi_internal.static_gt->lane(l).classification().lane_pairing(m).has_successor_lane_id())
-                                    {
-                                        lane_pairing = obj_osi_internal.static_gt->mutable_lane(l)->mutable_classification()->mutable_lane_pairing(m);
-                                        break;
-                                    }
+                                    lane_pairing = osi_lane_predecessor->mutable_classification()->mutable_lane_pairing(m);
+                                    break;
                                 }
+                            }
 
-                                if (lane_pairing == nullptr)
-                                {
-                                    // create a new lane pairing entry
-                                    lane_pairing = obj_osi_internal.static_gt->mutable_lane(l)->mutable_classification()->add_lane_pairing();
-                                }
+                            if (lane_pairing == nullptr)
+                            {
+                                // create a new lane pairing entry
+                                lane_pairing = osi_lane_predecessor->mutable_classification()->add_lane_pairing();
+                            }
 
-                                if ((road->GetLink(roadmanager::LinkType::PREDECESSOR) != 0))
-                                {
-                                    lane_pairing->mutable_successor_lane_id()->set_value(lane_global_id);
-                                }
+                            if ((road->GetLink(roadmanager::LinkType::PREDECESSOR) != 0))
+                            {
+                                lane_pairing->mutable_successor_lane_id()->set_value(lane_global_id);
                             }
+                        }
 
-                            if (successorRoad && successor_lane_section && link_successor && driving_lane_successor &&
-                                driving_lane_successor->GetGlobalId() == obj_osi_internal.static_gt->lane(l).id().value())
+                        if (osi_lane_successor != nullptr)
+                        {
+                            if (osi_lane_successor != osi_lane_predecessor)
                             {
-                                // find first empty pairing slot for successor lane
-                                for (int m = 0; m < obj_osi_internal.static_gt->lane(l).classification().lane_pairing_size(); ++m)
-                                {
-                                    if (!obj_osi_internal.static_gt->lane(l).classification().lane_pairing(m).has_antecessor_lane_id())
-                                    {
-                                        lane_pairing = obj_osi_internal.static_gt->mutable_lane(l)->mutable_classification()->mutable_lane_pairing(m);
-                                        break;
-                                    }
-                                }
+                                lane_pairing = nullptr;
+                            }
 
-                                if (lane_pairing == nullptr)
+                            // find first empty pairing slot for successor lane
+                            for (int m = 0; m < osi_lane_successor->classification().lane_pairing_size(); ++m)
+                            {
+                                if (!osi_lane_successor->classification().lane_pairing(m).has_antecessor_lane_id())
                                 {
-                                    // create a new lane pairing entry
-                                    lane_pairing = obj_osi_internal.static_gt->mutable_lane(l)->mutable_classification()->add_lane_pairing();
+                                    lane_pairing = osi_lane_successor->mutable_classification()->mutable_lane_pairing(m);
+                                    break;
                                 }
+                            }
 
-                                if ((road->GetLink(roadmanager::LinkType::SUCCESSOR) != 0))
-                                {
-                                    lane_pairing->mutable_antecessor_lane_id()->set_value(lane_global_id);
-                                }
+                            if (lane_pairing == nullptr)
+                            {
+                                // create a new lane pairing entry
+                                lane_pairing = osi_lane_successor->mutable_classification()->add_lane_pairing();
+                            }
+
+                            if ((road->GetLink(roadmanager::LinkType::SUCCESSOR) != 0))
+                            {
+                                lane_pairing->mutable_antecessor_lane_id()->set_value(lane_global_id);
                             }
                         }
                     }
@@ -3578,6 +3748,7 @@ const char *OSIReporter::GetOSIGroundTruth(int *size)
     if (!(GetUDPClientStatus() == 0 || IsFileOpen()))
     {
         // Data has not been serialized
+        MergeOSIGroundTruth();
         obj_osi_external.gt->SerializeToString(&osiGroundTruth.ground_truth);
         osiGroundTruth.size = static_cast<unsigned int>(obj_osi_external.gt->ByteSizeLong());
     }
@@ -3585,11 +3756,61 @@ const char *OSIReporter::GetOSIGroundTruth(int *size)
     return osiGroundTruth.ground_truth.data();
 }
 
+void OSIReporter::MergeOSIGroundTruth()
+{
+    if (!obj_osi_external.gt_merged)
+    {
+        obj_osi_external.gt->CopyFrom(*obj_osi_internal.dynamic_gt);
+        if (obj_osi_external.gt_static_part != nullptr)
+        {
+            obj_osi_external.gt->MergeFrom(*obj_osi_external.gt_static_part);
+        }
+        obj_osi_external.gt_merged = true;
+    }
+}
+
 const char *OSIReporter::GetOSIGroundTruthRaw()
 {
+    MergeOSIGroundTruth();
     return reinterpret_cast<char *>(obj_osi_external.gt);
 }
 
+void OSIReporter::SyncState(SE_StateBuffer &buf)
+{
+    buf.Sync(counter_offset_);
+    buf.Sync(osi_updated_);
+    buf.Sync(*obj_osi_internal.dynamic_gt);
+    buf.Sync(obj_osi_external.gt_static_part);
+    buf.Sync(osiGroundTruth.ground_truth);
+    buf.Sync(osiGroundTruth.size);
+
+    if (buf.IsRestoring())
+    {
+        // combined ground truth refers to the replaced dynamic part
+        obj_osi_external.gt_merged = false;
+        if (!lazy_gt_merge_)
+        {
+            MergeOSIGroundTruth();
+        }
+    }
+}
+
+const char *OSIReporter::GetOSIDynamicGroundTruthRaw()
+{
+    lazy_gt_merge_ = true;
+    return reinterpret_cast<const char *>(obj_osi_internal.dynamic_gt);
+}
+
+const char *OSIReporter::GetOSIStaticGroundTruthRaw(int *revision)
+{
+    lazy_gt_merge_ = true;
+    if (revision != nullptr)
+    {
+        *revision = static_gt_revision_;
+    }
+    return reinterpret_cast<const char *>(obj_osi_external.gt_static_part);
+}
+
 const char *OSIReporter::GetOSITrafficCommandRaw()
 {
     return reinterpret_cast<char *>(obj_osi_external.tc);
@@ -3618,17 +3839,7 @@ const char *OSIReporter::GetOSIRoadLane(const std::vector<std::unique_ptr<Object
 
     // find the lane in the sensor view and save its index in the sensor view
     id_t  lane_id_of_vehicle = pos.GetLaneGlobalId();
-    idx_t idx                = IDX_UNDEFINED;
-    for (unsigned int i = 0; i < obj_osi_internal.ln.size(); i++)
-    {
-        osi3::Identifier identifier = obj_osi_internal.ln[i]->id();
-        id_t             found_id   = static_cast<unsigned int>(identifier.value());
-        if (found_id == lane_id_of_vehicle)
-        {
-            idx = i;
-            break;
-        }
-    }
+    idx_t idx                = GetLaneIdxfromIdOSI(lane_id_of_vehicle);
     if (idx == IDX_UNDEFINED)
     {
         LOG_ERROR("Failed to locate vehicle lane id!");
@@ -3689,18 +3900,18 @@ bool OSIReporter::IsCentralOSILane(int lane_idx)
 
 idx_t OSIReporter::GetLaneIdxfromIdOSI(id_t lane_id)
 {
-    id_t idx = ID_UNDEFINED;
-    for (unsigned int i = 0; i < obj_osi_internal.ln.size(); i++)
+    // lanes are sorted by global id, see UpdateOSIRoadLane()
+    auto it = std::lower_bound(obj_osi_internal.ln.begin(),
+                               obj_osi_internal.ln.end(),
+                               lane_id,
+                               [](osi3::Lane *lane, id_t gid) { return lane->id().value() < gid; });
+
+    if (it != obj_osi_internal.ln.end() && (*it)->id().value() == lane_id)
     {
-        osi3::Identifier identifier = obj_osi_internal.ln[i]->id();
-        id_t             found_id   = static_cast<unsigned int>(identifier.value());
-        if (found_id == lane_id)
-        {
-            idx = i;
-            break;
-        }
+        return static_cast<idx_t>(it - obj_osi_internal.ln.begin());
     }
-    return idx;
+
+    return ID_UNDEFINED;
 }
 
 osi3::Lane *OSIReporter::GetOSILaneFromGlobalId(id_t g_id)
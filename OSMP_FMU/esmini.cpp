@@ -127,9 +127,58 @@ bool EsminiOsiSource::get_fmi_traffic_update_in(osi3::TrafficUpdate& data)
     }
 }
 
-void EsminiOsiSource::set_fmi_sensor_view_out(const osi3::SensorView& data)
+static void append_varint(string& buffer, uint64_t value)
 {
-    data.SerializeToString(currentBufferSVOut);
+    while (value >= 0x80)
+    {
+        buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+/*
+ * Append message as a length-delimited field, i.e. the same encoding as if it was set as sub message
+ * of the field_number field. A non-repeated message field occurring several times is merged when parsed,
+ * which makes it possible to compose the SensorView encoding from separately encoded parts.
+ */
+static void append_message_field(string& buffer, int field_number, const google::protobuf::MessageLite& msg)
+{
+    append_varint(buffer, (static_cast<uint64_t>(field_number) << 3) | 2);  // wire type 2 = length-delimited
+    size_t size = msg.ByteSizeLong();
+    append_varint(buffer, size);
+    size_t offset = buffer.size();
+    buffer.resize(offset + size);
+    msg.SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t*>(&buffer[offset]));
+}
+
+void EsminiOsiSource::set_fmi_sensor_view_out(const osi3::SensorView& header,
+                                              const osi3::GroundTruth* dynamic_gt,
+                                              const osi3::GroundTruth* static_gt,
+                                              int static_gt_revision)
+{
+    // The static ground truth, e.g. road network, is only encoded when changed
+    if (static_gt == nullptr)
+    {
+        staticBufferSVOut.clear();
+        staticGTSVOut = nullptr;
+    }
+    else if (static_gt != staticGTSVOut || static_gt_revision != staticGTRevisionSVOut)
+    {
+        staticBufferSVOut.clear();
+        append_message_field(staticBufferSVOut, osi3::SensorView::kGlobalGroundTruthFieldNumber, *static_gt);
+        staticGTSVOut         = static_gt;
+        staticGTRevisionSVOut = static_gt_revision;
+    }
+
+    // SensorView = header + dynamic ground truth + static ground truth, latter two merged into global_ground_truth when parsed.
+    // Buffers alternate between steps, keeping the previous output valid according to OSMP rules
+    header.SerializeToString(currentBufferSVOut);
+    if (dynamic_gt != nullptr)
+    {
+        append_message_field(*currentBufferSVOut, osi3::SensorView::kGlobalGroundTruthFieldNumber, *dynamic_gt);
+    }
+    currentBufferSVOut->append(staticBufferSVOut);
     encode_pointer_to_integer(currentBufferSVOut->data(),
                               integer_vars[FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX],
                               integer_vars[FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX]);
@@ -311,20 +360,22 @@ fmi2Status EsminiOsiSource::doCalc(fmi2Real currentCommunicationPoint, fmi2Real
         return fmi2Error;
     }
 
-    const auto* se_osi_ground_truth = reinterpret_cast<const osi3::GroundTruth*>(SE_GetOSIGroundTruthRaw());  // Fetch OSI struct
+    // Fetch OSI structs (via pointer, no copying of data), static and dynamic parts separately to skip merging them
+    int         static_gt_revision = 0;
+    const auto* dynamic_gt         = reinterpret_cast<const osi3::GroundTruth*>(SE_GetOSIDynamicGroundTruthRaw());
+    const auto* static_gt          = reinterpret_cast<const osi3::GroundTruth*>(SE_GetOSIStaticGroundTruthRaw(&static_gt_revision));
+    const auto* host_gt            = (static_gt != nullptr && static_gt->has_host_vehicle_id()) ? static_gt : dynamic_gt;
 
     osi3::SensorView currentOut;
     currentOut.Clear();
     currentOut.mutable_sensor_id()->set_value(0);
-    currentOut.mutable_host_vehicle_id()->set_value(se_osi_ground_truth->host_vehicle_id().value());
+    currentOut.mutable_host_vehicle_id()->set_value(host_gt->host_vehicle_id().value());
     double const time = currentCommunicationPoint + communicationStepSize;
     currentOut.mutable_timestamp()->set_seconds((long long int)floor(time));
     const double sec_to_nanos = 1000000000.0;
     currentOut.mutable_timestamp()->set_nanos((int)((time - floor(time)) * sec_to_nanos));
-    osi3::GroundTruth* currentGT = currentOut.mutable_global_ground_truth();
-    currentGT->CopyFrom(*se_osi_ground_truth);
 
-    set_fmi_sensor_view_out(currentOut);
+    set_fmi_sensor_view_out(currentOut, dynamic_gt, static_gt, static_gt_revision);
 
     // Handle OSI TrafficCommand output
     const auto* traffic_command =
@@ -374,6 +425,8 @@ EsminiOsiSource::EsminiOsiSource(fmi2String                   theinstanceName,
     currentBufferSVOut = new string();
     currentBufferTCOut = new string();
     lastBufferSVOut = new string();
+    staticGTSVOut = nullptr;
+    staticGTRevisionSVOut = 0;
     lastBufferTCOut = new string();
     loggingCategories.clear();
     loggingCategories.insert("FMI");
@@ -623,6 +676,121 @@ fmi2Status EsminiOsiSource::SetString(const fmi2ValueReference vr[], size_t nvr,
     return fmi2OK;
 }
 
+/*
+ * FMU state: esmini checkpoint, FMU variables and the currently provided output buffers
+ */
+struct EsminiOsiSourceState
+{
+    int                      checkpoint = -1;
+    fmi2Boolean              boolean_vars[FMI_BOOLEAN_VARS];
+    fmi2Integer              integer_vars[FMI_INTEGER_VARS];
+    fmi2Real                 real_vars[FMI_REAL_VARS];
+    string                   string_vars[FMI_STRING_VARS];
+    string                   bufferSVOut;
+    string                   staticBufferSVOut;
+    const osi3::GroundTruth* staticGTSVOut;
+    int                      staticGTRevisionSVOut;
+    string                   bufferTCOut;
+    bool                     fmiSlaveTerminated;
+};
+
+fmi2Status EsminiOsiSource::GetFMUstate(fmi2FMUstate* FMUstate)
+{
+    fmi_verbose_log("fmi2GetFMUstate(...)");
+
+    // A given state is updated in place
+    EsminiOsiSourceState* state = static_cast<EsminiOsiSourceState*>(*FMUstate);
+    if (state == nullptr)
+    {
+        state = new EsminiOsiSourceState;
+    }
+    else
+    {
+        SE_DeleteCheckpoint(state->checkpoint);
+    }
+    *FMUstate = state;
+
+    state->checkpoint = SE_CreateCheckpoint();
+    if (state->checkpoint < 0)
+    {
+        normal_log("OSMP", "Failed to store scenario state");
+        return fmi2Error;
+    }
+
+    copy(boolean_vars, boolean_vars + FMI_BOOLEAN_VARS, state->boolean_vars);
+    copy(integer_vars, integer_vars + FMI_INTEGER_VARS, state->integer_vars);
+    copy(real_vars, real_vars + FMI_REAL_VARS, state->real_vars);
+    copy(string_vars, string_vars + FMI_STRING_VARS, state->string_vars);
+
+    // Output buffers are swapped after being provided, hence the last ones are the current output
+    state->bufferSVOut           = integer_vars[FMI_INTEGER_SENSORVIEW_OUT_SIZE_IDX] > 0 ? *lastBufferSVOut : "";
+    state->staticBufferSVOut     = staticBufferSVOut;
+    state->staticGTSVOut         = staticGTSVOut;
+    state->staticGTRevisionSVOut = staticGTRevisionSVOut;
+    state->bufferTCOut           = integer_vars[FMI_INTEGER_TRAFFICCOMMAND_OUT_SIZE_IDX] > 0 ? *lastBufferTCOut : "";
+    state->fmiSlaveTerminated    = fmiSlaveTerminated;
+
+    return fmi2OK;
+}
+
+fmi2Status EsminiOsiSource::SetFMUstate(fmi2FMUstate FMUstate)
+{
+    fmi_verbose_log("fmi2SetFMUstate(...)");
+
+    const EsminiOsiSourceState* state = static_cast<const EsminiOsiSourceState*>(FMUstate);
+    if (state == nullptr || SE_RestoreCheckpoint(state->checkpoint) != 0)
+    {
+        normal_log("OSMP", "Failed to restore scenario state");
+        return fmi2Error;
+    }
+
+    copy(state->boolean_vars, state->boolean_vars + FMI_BOOLEAN_VARS, boolean_vars);
+    copy(state->integer_vars, state->integer_vars + FMI_INTEGER_VARS, integer_vars);
+    copy(state->real_vars, state->real_vars + FMI_REAL_VARS, real_vars);
+    copy(state->string_vars, state->string_vars + FMI_STRING_VARS, string_vars);
+
+    staticBufferSVOut     = state->staticBufferSVOut;
+    staticGTSVOut         = state->staticGTSVOut;
+    staticGTRevisionSVOut = state->staticGTRevisionSVOut;
+    fmiSlaveTerminated    = state->fmiSlaveTerminated;
+
+    // Provide stored output in the next buffers, like a step would, and point the output variables to them
+    if (integer_vars[FMI_INTEGER_SENSORVIEW_OUT_SIZE_IDX] > 0)
+    {
+        *currentBufferSVOut = state->bufferSVOut;
+        encode_pointer_to_integer(currentBufferSVOut->data(),
+                                  integer_vars[FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX],
+                                  integer_vars[FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX]);
+        swap(currentBufferSVOut, lastBufferSVOut);
+    }
+
+    if (integer_vars[FMI_INTEGER_TRAFFICCOMMAND_OUT_SIZE_IDX] > 0)
+    {
+        *currentBufferTCOut = state->bufferTCOut;
+        encode_pointer_to_integer(currentBufferTCOut->data(),
+                                  integer_vars[FMI_INTEGER_TRAFFICCOMMAND_OUT_BASEHI_IDX],
+                                  integer_vars[FMI_INTEGER_TRAFFICCOMMAND_OUT_BASELO_IDX]);
+        swap(currentBufferTCOut, lastBufferTCOut);
+    }
+
+    return fmi2OK;
+}
+
+fmi2Status EsminiOsiSource::FreeFMUstate(fmi2FMUstate* FMUstate)
+{
+    fmi_verbose_log("fmi2FreeFMUstate(...)");
+
+    EsminiOsiSourceState* state = static_cast<EsminiOsiSourceState*>(*FMUstate);
+    if (state != nullptr)
+    {
+        SE_DeleteCheckpoint(state->checkpoint);
+        delete state;
+        *FMUstate = nullptr;
+    }
+
+    return fmi2OK;
+}
+
 /*
  * FMI 2.0 Co-Simulation Interface API
  */
@@ -761,24 +929,27 @@ extern "C"
         return myc->SetString(vr, nvr, value);
     }
 
-    /*
-     * Unsupported Features (FMUState, Derivatives, Async DoStep, Status Enquiries)
-     */
     FMI2_Export fmi2Status fmi2GetFMUstate(fmi2Component c, fmi2FMUstate* FMUstate)
     {
-        return fmi2Error;
+        EsminiOsiSource* myc = (EsminiOsiSource*)c;
+        return myc->GetFMUstate(FMUstate);
     }
 
     FMI2_Export fmi2Status fmi2SetFMUstate(fmi2Component c, fmi2FMUstate FMUstate)
     {
-        return fmi2Error;
+        EsminiOsiSource* myc = (EsminiOsiSource*)c;
+        return myc->SetFMUstate(FMUstate);
     }
 
     FMI2_Export fmi2Status fmi2FreeFMUstate(fmi2Component c, fmi2FMUstate* FMUstate)
     {
-        return fmi2Error;
+        EsminiOsiSource* myc = (EsminiOsiSource*)c;
+        return myc->FreeFMUstate(FMUstate);
     }
 
+    /*
+     * Unsupported Features (FMUState serialization, Derivatives, Async DoStep, Status Enquiries)
+     */
     FMI2_Export fmi2Status fmi2SerializedFMUstateSize(fmi2Component c, fmi2FMUstate FMUstate, size_t* size)
     {
         return fmi2Error;
@@ -108,6 +108,9 @@ public:
     fmi2Status SetInteger(const fmi2ValueReference vr[], size_t nvr, const fmi2Integer value[]);
     fmi2Status SetBoolean(const fmi2ValueReference vr[], size_t nvr, const fmi2Boolean value[]);
     fmi2Status SetString(const fmi2ValueReference vr[], size_t nvr, const fmi2String value[]);
+    fmi2Status GetFMUstate(fmi2FMUstate* FMUstate);
+    fmi2Status SetFMUstate(fmi2FMUstate FMUstate);
+    fmi2Status FreeFMUstate(fmi2FMUstate* FMUstate);
     bool get_slave_terminated() { return fmiSlaveTerminated; };
 
 protected:
@@ -207,6 +210,9 @@ protected:
     string string_vars[FMI_STRING_VARS];
     string* currentBufferSVOut;
     string* lastBufferSVOut;
+    string staticBufferSVOut;                   // cached encoding of the static ground truth, appended to each SensorView
+    const osi3::GroundTruth* staticGTSVOut;     // static ground truth and revision of the cached encoding
+    int staticGTRevisionSVOut;
     string* currentBufferTCOut;
     string* lastBufferTCOut;
 
@@ -222,7 +228,7 @@ protected:
 
     /* Protocol Buffer Accessors */
     bool get_fmi_traffic_update_in(osi3::TrafficUpdate& data);
-    void set_fmi_sensor_view_out(const osi3::SensorView& data);
+    void set_fmi_sensor_view_out(const osi3::SensorView& header, const osi3::GroundTruth* dynamic_gt, const osi3::GroundTruth* static_gt, int static_gt_revision);
     void reset_fmi_sensor_view_out();
     //bool get_fmi_traffic_command_update_in(osi3::TrafficCommandUpdate& data);     //TODO: Wait for OSI update
     void set_fmi_traffic_command_out(const osi3::TrafficCommand& data);
@@ -1,5 +1,6 @@
 import argparse
 import struct
+import io
 import os
 import enum
 from collections import defaultdict
@@ -9,7 +10,7 @@ import bisect
 import ctypes
 
 VERSION_MAJOR = 4
-VERSION_MINOR = 3
+VERSION_MINOR = 4
 SMALL_NUMBER = 1e-6
 LARGE_NUMBER = 1e10
 
@@ -56,7 +57,46 @@ class PacketId(enum.Enum):
     MODEL_X_OFFSET    = 25
     OBJ_MODEL3D       = 26
     ELEM_STATE_CHANGE = 27
-    PACKET_ID_SIZE    = 28
+    OBJ_STATE         = 28
+    COMPRESSED_BLOCK  = 29
+    PACKET_ID_SIZE    = 30
+
+class CompactField(enum.IntEnum):
+    """
+    Fields of the OBJ_STATE packet, bit index in the field mask.
+
+    Shall mirror PacketHandler.hpp Dat::CompactField
+    """
+    SPEED             = 0
+    POSE_X            = 1
+    POSE_Y            = 2
+    POSE_Z            = 3
+    POSE_H            = 4
+    POSE_P            = 5
+    POSE_R            = 6
+    WHEEL_ANGLE       = 7
+    WHEEL_ROT         = 8
+    POS_S             = 9
+    POS_T             = 10
+    POS_OFFSET        = 11
+    REFPOINT_X_OFFSET = 12
+    MODEL_X_OFFSET    = 13
+    MODEL_ID          = 14
+    OBJ_TYPE          = 15
+    OBJ_CATEGORY      = 16
+    CTRL_TYPE         = 17
+    SCALE_MODE        = 18
+    VISIBILITY_MASK   = 19
+    ROAD_ID           = 20
+    LANE_ID           = 21
+    BOUNDING_BOX      = 22
+    NAME              = 23
+    MODEL3D           = 24
+
+COMPACT_N_SCALAR = 22  # fields before BOUNDING_BOX are integers or fixed point, stored as delta to previous value
+
+# Shall mirror PacketHandler.hpp Dat::compact_resolution
+COMPACT_RESOLUTION = [1e-4, 1e-4, 1e-4, 1e-4, 1e-5, 1e-5, 1e-5, 1e-5, 1e-4, 1e-4, 1e-4, 1e-4, 1e-4, 1e-4, 1, 1, 1, 1, 1, 1, 1, 1]
 
 class Pose:
     def __init__(self):
@@ -121,6 +161,65 @@ def read_string_packet(file):
     string_bytes = file.read(size)
     return string_bytes.decode('utf-8')
 
+def read_varint(data: bytes, pos: int) -> tuple:
+    """Read a varint from data at pos, return value and position after it"""
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(data):
+            raise ValueError("Unexpected end of data while reading varint")
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        if byte & 0x80 == 0:
+            return value, pos
+        shift += 7
+
+def zigzag_decode(value: int) -> int:
+    return (value >> 1) ^ -(value & 1)
+
+def decompress_block(data: bytes, uncompressed_size: int) -> bytes:
+    """Decompress a COMPRESSED_BLOCK packet, see PacketHandler.cpp Dat::DecompressBlock"""
+    out = bytearray()
+    pos = 0
+
+    def read_length(length):
+        nonlocal pos
+        byte = 255
+        while byte == 255:
+            byte = data[pos]
+            pos += 1
+            length += byte
+        return length
+
+    while pos < len(data):
+        token = data[pos]
+        pos += 1
+        n_literals = token >> 4
+        if n_literals == 15:
+            n_literals = read_length(n_literals)
+        out += data[pos:pos + n_literals]
+        pos += n_literals
+
+        if pos == len(data):
+            break  # last sequence, literals only
+
+        offset = data[pos] | (data[pos + 1] << 8)
+        pos += 2
+        length = token & 0x0f
+        if length == 15:
+            length = read_length(length)
+        length += 4
+
+        start = len(out) - offset
+        for i in range(length):  # byte by byte, since match may overlap
+            out.append(out[start + i])
+
+    if len(out) != uncompressed_size:
+        raise ValueError("Corrupt compressed block")
+
+    return bytes(out)
+
 def is_near(x: float, y: float) -> bool:
     """ Check if two floating point numbers are nearly equal """
     return abs(x - y) < SMALL_NUMBER
@@ -304,6 +403,7 @@ class DATFile():
         self.current_object_timeline = None
         self.objects_timeline = defaultdict()
         self.object_state_cache = defaultdict()
+        self.compact_state = {}
         self.dt = Timeline()
         self.current_timestamp = 0.0
         self.ghost_ghost_counter = -1
@@ -342,7 +442,7 @@ class DATFile():
             print(f'ERROR: Incompatible DAT major file version: {self.version_major}, supporting: {VERSION_MAJOR}')
             exit(-1)
 
-        if self.version_minor != VERSION_MINOR:
+        if self.version_minor > VERSION_MINOR:
             print(f"Warning: DAT-file has version {self.version_major}.{self.version_minor}. Some inconsistencies are expected.")
 
     def check_old_header(self, filename: str) -> int:
@@ -373,17 +473,112 @@ class DATFile():
             return -1
 
 
+    def set_current_object(self, obj_id: int) -> None:
+        """ Select object for following packets, create timelines for new objects """
+        self.current_object_id = obj_id
+
+        if self.objects_timeline.get(self.current_object_id) is None:
+            self.objects_timeline[self.current_object_id] = PropertyTimeline()
+            self.current_object_timeline = self.objects_timeline[self.current_object_id]
+
+            if self.current_timestamp > 0.0:
+                self.current_object_timeline.active.values.append([0.0, False])
+            self.current_object_timeline.active.values.append([self.current_timestamp, True])
+        else:
+            self.current_object_timeline = self.objects_timeline[self.current_object_id]
+
+            if self.current_object_timeline.active.values[-1][1] == False:
+                self.current_object_timeline.active.values.append([self.current_timestamp, True])
+
+    def add_object_state(self, data: bytes) -> None:
+        """ Parse an OBJ_STATE packet, see PacketHandler.hpp Dat::CompactField """
+        obj_id, pos = read_varint(data, 0)
+        mask, pos = read_varint(data, pos)
+        self.set_current_object(zigzag_decode(obj_id))
+
+        state = self.compact_state.setdefault(self.current_object_id, {"values": [0] * COMPACT_N_SCALAR, "bb": None, "name": "", "model3d": ""})
+        values = state["values"]
+
+        for i in range(COMPACT_N_SCALAR):
+            if mask & (1 << i):
+                delta, pos = read_varint(data, pos)
+                values[i] += zigzag_decode(delta)
+
+        if mask & (1 << CompactField.BOUNDING_BOX):
+            bb = BoundingBox()
+            bb.center_offset_x, bb.center_offset_y, bb.center_offset_z, bb.length, bb.width, bb.height = struct.unpack('<6f', data[pos:pos + 24])
+            state["bb"] = bb
+            pos += 24
+
+        for field in (CompactField.NAME, CompactField.MODEL3D):
+            if mask & (1 << field):
+                size, pos = read_varint(data, pos)
+                state["name" if field == CompactField.NAME else "model3d"] = data[pos:pos + size].decode('utf-8')
+                pos += size
+
+        def value(field):
+            return values[field] * COMPACT_RESOLUTION[field]
+
+        tl = self.current_object_timeline
+        t = self.current_timestamp
+        scalar_timelines = [
+            (CompactField.SPEED, tl.speed),
+            (CompactField.WHEEL_ANGLE, tl.wheel_angle),
+            (CompactField.WHEEL_ROT, tl.wheel_rot),
+            (CompactField.POS_S, tl.pos_s),
+            (CompactField.POS_T, tl.pos_t),
+            (CompactField.POS_OFFSET, tl.pos_offset),
+            (CompactField.REFPOINT_X_OFFSET, tl.refpoint_x_offset),
+            (CompactField.MODEL_X_OFFSET, tl.model_x_offset)]
+        integer_timelines = [
+            (CompactField.MODEL_ID, tl.model_id),
+            (CompactField.OBJ_TYPE, tl.obj_type),
+            (CompactField.OBJ_CATEGORY, tl.obj_category),
+            (CompactField.CTRL_TYPE, tl.ctrl_type),
+            (CompactField.SCALE_MODE, tl.scale_mode),
+            (CompactField.VISIBILITY_MASK, tl.visibility_mask),
+            (CompactField.ROAD_ID, tl.road_id),
+            (CompactField.LANE_ID, tl.lane_id)]
+
+        for field, timeline in scalar_timelines:
+            if mask & (1 << field):
+                timeline.values.append([t, value(field)])
+        for field, timeline in integer_timelines:
+            if mask & (1 << field):
+                timeline.values.append([t, values[field]])
+
+        if mask & (1 << CompactField.CTRL_TYPE) and values[CompactField.CTRL_TYPE] == 100:
+            self.ghost_controller_id = self.current_object_id
+
+        if mask & (0x3f << CompactField.POSE_X):
+            pose = Pose()
+            pose.x, pose.y, pose.z = value(CompactField.POSE_X), value(CompactField.POSE_Y), value(CompactField.POSE_Z)
+            pose.h, pose.p, pose.r = value(CompactField.POSE_H), value(CompactField.POSE_P), value(CompactField.POSE_R)
+            tl.pose.values.append([t, pose])
+        if mask & (1 << CompactField.BOUNDING_BOX):
+            tl.bounding_box.values.append([t, state["bb"]])
+        if mask & (1 << CompactField.NAME):
+            tl.name.values.append([t, state["name"]])
+        if mask & (1 << CompactField.MODEL3D):
+            tl.model3d.values.append([t, state["model3d"]])
+
     def parse_data(self) -> None:
         """
         Parse the .dat file and extract object states.
+        """
+        self.parse_packets(self.file, self.file_size)
+
+    def parse_packets(self, stream, size: int) -> None:
+        """
+        Parse packets of a file or a decompressed block.
         Packets are read in the order they are likely to appear in the file.
         """
-        while self.file.tell() < self.file_size:
-            p_id, data_size = read_packet_header(self.file)
+        while stream.tell() < size:
+            p_id, data_size = read_packet_header(stream)
 
             # TIMESTAMP packet
             if p_id == PacketId.TIMESTAMP.value:
-                self.current_timestamp = read_dtype(self.file, DataType.double)
+                self.current_timestamp = read_dtype(stream, DataType.double)
 
                 if len(self.timestamps) == 0 or self.current_timestamp > self.timestamps[-1]:
                     self.timestamps.append(self.current_timestamp)
@@ -394,90 +589,88 @@ class DATFile():
 
             # OBJ_ID packet
             elif p_id == PacketId.OBJ_ID.value:
-                self.current_object_id = read_dtype(self.file, DataType.int32)
-
-                if self.objects_timeline.get(self.current_object_id) is None:
-                    self.objects_timeline[self.current_object_id] = PropertyTimeline()
-                    self.current_object_timeline = self.objects_timeline[self.current_object_id]
+                self.set_current_object(read_dtype(stream, DataType.int32))
 
-                    if self.current_timestamp > 0.0:
-                        self.current_object_timeline.active.values.append([0.0, False])
-                    self.current_object_timeline.active.values.append([self.current_timestamp, True])
-                else:
-                    self.current_object_timeline = self.objects_timeline[self.current_object_id]
+            # OBJ_STATE packet, all changed fields of an object
+            elif p_id == PacketId.OBJ_STATE.value:
+                self.add_object_state(stream.read(data_size))
 
-                    if self.current_object_timeline.active.values[-1][1] == False:
-                        self.current_object_timeline.active.values.append([self.current_timestamp, True])
+            # COMPRESSED_BLOCK packet, containing other packets
+            elif p_id == PacketId.COMPRESSED_BLOCK.value:
+                uncompressed_size = read_dtype(stream, DataType.uint32)
+                block = decompress_block(stream.read(data_size - 4), uncompressed_size)
+                self.parse_packets(io.BytesIO(block), len(block))
 
             # POSE packet
             elif p_id == PacketId.POSE.value:
                 pose = Pose()
                 for k in list(pose.__dict__.keys()):
-                    setattr(pose, k, read_dtype(self.file, DataType.float))
+                    setattr(pose, k, read_dtype(stream, DataType.float))
                 self.current_object_timeline.pose.values.append([self.current_timestamp, pose])
 
             elif p_id == PacketId.DT.value:
-                dt = read_dtype(self.file, DataType.double)
+                dt = read_dtype(stream, DataType.double)
                 if not is_near(dt, 0.0):
                     self.dt.values.append([self.current_timestamp, dt])
             elif p_id == PacketId.SPEED.value:
-                self.current_object_timeline.speed.values.append([self.current_timestamp, read_dtype(self.file, DataType.float)])
+                self.current_object_timeline.speed.values.append([self.current_timestamp, read_dtype(stream, DataType.float)])
             elif p_id == PacketId.WHEEL_ANGLE.value:
-                self.current_object_timeline.wheel_angle.values.append([self.current_timestamp, read_dtype(self.file, DataType.float)])
+                self.current_object_timeline.wheel_angle.values.append([self.current_timestamp, read_dtype(stream, DataType.float)])
             elif p_id == PacketId.WHEEL_ROT.value:
-                self.current_object_timeline.wheel_rot.values.append([self.current_timestamp, read_dtype(self.file, DataType.float)])
+                self.current_object_timeline.wheel_rot.values.append([self.current_timestamp, read_dtype(stream, DataType.float)])
             elif p_id == PacketId.POS_OFFSET.value:
-                self.current_object_timeline.pos_offset.values.append([self.current_timestamp, read_dtype(self.file, DataType.float)])
+                self.current_object_timeline.pos_offset.values.append([self.current_timestamp, read_dtype(stream, DataType.float)])
             elif p_id == PacketId.POS_T.value:
-                self.current_object_timeline.pos_t.values.append([self.current_timestamp, read_dtype(self.file, DataType.float)])
+                self.current_object_timeline.pos_t.values.append([self.current_timestamp, read_dtype(stream, DataType.float)])
             elif p_id == PacketId.POS_S.value:
-                self.current_object_timeline.pos_s.values.append([self.current_timestamp, read_dtype(self.file, DataType.float)])
+                self.current_object_timeline.pos_s.values.append([self.current_timestamp, read_dtype(stream, DataType.float)])
             elif p_id == PacketId.MODEL_ID.value:
-                self.current_object_timeline.model_id.values.append([self.current_timestamp, read_dtype(self.file, DataType.int32)])
+                self.current_object_timeline.model_id.values.append([self.current_timestamp, read_dtype(stream, DataType.int32)])
             elif p_id == PacketId.OBJ_TYPE.value:
-                self.current_object_timeline.obj_type.values.append([self.current_timestamp, read_dtype(self.file, DataType.int32)])
+                self.current_object_timeline.obj_type.values.append([self.current_timestamp, read_dtype(stream, DataType.int32)])
             elif p_id == PacketId.OBJ_CATEGORY.value:
-                self.current_object_timeline.obj_category.values.append([self.current_timestamp, read_dtype(self.file, DataType.int32)])
+                self.current_object_timeline.obj_category.values.append([self.current_timestamp, read_dtype(stream, DataType.int32)])
             elif p_id == PacketId.CTRL_TYPE.value:
-                ctrl_type = read_dtype(self.file, DataType.int32)
+                ctrl_type = read_dtype(stream, DataType.int32)
                 self.current_object_timeline.ctrl_type.values.append([self.current_timestamp, ctrl_type])
                 if ctrl_type == 100:
                     self.ghost_controller_id = self.current_object_id
             elif p_id == PacketId.SCALE_MODE.value:
-                self.current_object_timeline.scale_mode.values.append([self.current_timestamp, read_dtype(self.file, DataType.int32)])
+                self.current_object_timeline.scale_mode.values.append([self.current_timestamp, read_dtype(stream, DataType.int32)])
             elif p_id == PacketId.VISIBILITY_MASK.value:
-                self.current_object_timeline.visibility_mask.values.append([self.current_timestamp, read_dtype(self.file, DataType.int32)])
+                self.current_object_timeline.visibility_mask.values.append([self.current_timestamp, read_dtype(stream, DataType.int32)])
             elif p_id == PacketId.ROAD_ID.value:
-                self.current_object_timeline.road_id.values.append([self.current_timestamp, read_dtype(self.file, DataType.uint32)])
+                self.current_object_timeline.road_id.values.append([self.current_timestamp, read_dtype(stream, DataType.uint32)])
             elif p_id == PacketId.LANE_ID.value:
-                self.current_object_timeline.lane_id.values.append([self.current_timestamp, read_dtype(self.file, DataType.int32)])
+                self.current_object_timeline.lane_id.values.append([self.current_timestamp, read_dtype(stream, DataType.int32)])
             elif p_id == PacketId.NAME.value:
-                name = read_string_packet(self.file)
+                name = read_string_packet(stream)
                 self.current_object_timeline.name.values.append([self.current_timestamp, name])
             elif p_id == PacketId.BOUNDING_BOX.value:
                 bb = BoundingBox()
                 for k in list(bb.__dict__.keys()):
-                    setattr(bb, k, read_dtype(self.file, DataType.float))
+                    setattr(bb, k, read_dtype(stream, DataType.float))
                 self.current_object_timeline.bounding_box.values.append([self.current_timestamp, bb])
             elif p_id == PacketId.TRAFFIC_LIGHT.value:
-                self.file.seek(data_size, 1) # Skip packet, not supported yet
+                stream.seek(data_size, 1) # Skip packet, not supported yet
             elif p_id == PacketId.REFPOINT_X_OFFSET.value:
-                self.current_object_timeline.refpoint_x_offset.values.append([self.current_timestamp, read_dtype(self.file, DataType.float)])
+                self.current_object_timeline.refpoint_x_offset.values.append([self.current_timestamp, read_dtype(stream, DataType.float)])
             elif p_id == PacketId.MODEL_X_OFFSET.value:
-                self.current_object_timeline.model_x_offset.values.append([self.current_timestamp, read_dtype(self.file, DataType.float)])
+                self.current_object_timeline.model_x_offset.values.append([self.current_timestamp, read_dtype(stream, DataType.float)])
             elif p_id == PacketId.OBJ_MODEL3D.value:
-                model3d = read_string_packet(self.file)
+                model3d = read_string_packet(stream)
                 self.current_object_timeline.model3d.values.append([self.current_timestamp, model3d])
             elif p_id == PacketId.ELEM_STATE_CHANGE.value:
-                self.file.seek(data_size, 1) # Skip packet, not supported yet
+                stream.seek(data_size, 1) # Skip packet, not supported yet
 
             # OBJ_DELETED packet
             elif p_id == PacketId.OBJ_DELETED.value:
                 self.current_object_timeline.active.values.append([self.current_timestamp, False])
+                self.compact_state.pop(self.current_object_id, None)
             
             # END_OF_SCENARIO packet
             elif p_id == PacketId.END_OF_SCENARIO.value:
-                self.end_time = read_dtype(self.file, DataType.double)
+                self.end_time = read_dtype(stream, DataType.double)
                 if not is_near(self.end_time, self.timestamps[-1]):
                     self.timestamps.append(self.end_time)
 
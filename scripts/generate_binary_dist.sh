@@ -176,6 +176,7 @@ bin/esmini?(.exe) \
 bin/odrviewer?(.exe) \
 bin/replayer?(.exe) \
 bin/dat2csv?(.exe) \
+bin/dat2metrics?(.exe) \
 bin/odrplot?(.exe) \
 bin/*esminiLib.* \
 EnvironmentSimulator/Applications/odrplot/xodr.py \